@@ -1,69 +1,87 @@
 #include "headers/ast_tools.h"
 #include "../lexer/headers/Lexer.h"
+#include "../lexer/headers/ParallelLexer.h"
 #include "../parser/headers/Parser.h"
+#include "../parser/headers/ASTCache.h"
 #include "../linker/headers/Linker.h"
+#include "../linker/headers/TreeShaker.h"
 #include "../includes/ASTDebugger.hpp"
 #include "../errors/headers/ErrorEngine.h"
 #include <iostream>
 #include <filesystem>
 
-std::vector<std::vector<Token>> tokenizeSource(const std::string& sourceCode, bool showTokens) {
-    Lexer lexer(sourceCode);
-    lexer.tokenize();
+std::shared_ptr<const TokenStream> tokenizeSource(std::string_view sourceCode, bool showTokens) {
+    // Большие файлы лексятся кусками на пуле потоков, маленькие - как раньше
+    auto tokens = std::make_shared<const TokenStream>(ParallelLexer::tokenize(sourceCode));
     
     if (showTokens) {
         std::cout << "\n--- Токены ---\n";
-        lexer.printTokens();
+        Lexer::printTokens(*tokens);
         std::cout << "--- Конец токенов ---\n\n";
     }
     
-    return lexer.getTokens();
+    return tokens;
 }
 
-std::shared_ptr<ProgramNode> parseAndLinkModules(
-    const std::vector<std::vector<Token>>& tokens, 
+NodePtr<ProgramNode> parseAndLinkModules(
+    std::string_view sourceCode,
+    std::shared_ptr<const TokenStream> tokens, 
     const std::string& inputFile, 
-    bool showAST
+    bool showAST,
+    bool showDeps
 ) {
-    Parser parser(tokens, inputFile);
-    auto program = parser.parse();
+    // AST из кэша, если исходник не менялся; иначе лексер и параллельный парсер
+    auto program = ASTCache::getInstance().parse(sourceCode, inputFile, tokens);
     
     // Получаем путь текущего файла
     std::string currentFilePath = std::filesystem::current_path().string();
     Linker linker(currentFilePath);
+    // Модули из use - из сводок .msi; тела дочитываются только для того, до чего дойдёт TreeShaker
+    linker.setUseSummaries(true);
+    // Тела функций модулей из use разбираются, когда до них дойдёт TreeShaker
+    linker.setLazyBodies(true);
     
     // Добавляем основной модуль
-    if (!linker.addModule(std::filesystem::path(inputFile).stem().string(), inputFile, program)) {
+    if (!linker.addModule(std::filesystem::path(inputFile).stem().string(), inputFile, program, tokens, sourceCode)) {
         throw std::runtime_error("Ошибка при добавлении модуля");
     }
     
     if (!linker.linkModules()) {
         throw std::runtime_error("Ошибка при линковке модулей");
     }
+
+    if (showDeps) {
+        linker.dumpGraph(std::cout);
+    }
     
+    // Из модулей use в объединённый AST идёт только то, до чего дотягивается программа
+    TreeShaker shaker(linker);
+
     // Создаем объединенный AST из всех модулей
-    std::shared_ptr<ProgramNode> combinedAST = std::make_shared<ProgramNode>();
+    NodePtr<ProgramNode> combinedAST = makeNode<ProgramNode>();
     combinedAST->moduleName = program->moduleName;
     
 #if DEBUG
 
     std::cout << "--- Модули ---" << std::endl;
 #endif     
-    // Выводим информацию о связанных модулях
-    for (const auto& [name, module] : linker.getModules()) {
+    // Выводим информацию о связанных модулях; зависимости идут раньше тех, кто их импортирует,
+    // чтобы проверка типов видела импортированные функции до вызовов
+    for (const auto& name : linker.getOrder()) {
+        const ModuleContext& module = linker.getModules().at(name);
 #if DEBUG
         std::cout << "Модуль: " << name << " (" << module.path << ")" << std::endl;
         std::cout << "  Функции: " << module.functions.size() << std::endl;
         std::cout << "  Глобальные переменные: " << module.globals.size() << std::endl;
-        std::cout << "  Импортировано: " << module.imports.size() << " символов" << std::endl;
+        std::cout << "  Импортировано: " << module.imports.size() << " символов, " << module.importedModules.size() << " модулей целиком" << std::endl;
 #endif
         // Копируем все узлы из текущего модуля в объединенный AST
         if (module.ast) {
             for (const auto& node : module.ast->body) {
                 // Пропускаем директивы импорта в объединенном AST, они уже обработаны
-                if (!std::dynamic_pointer_cast<ImportNode>(node)) {
+                if (!dyn_cast<ImportNode>(node) && shaker.isReachable(node)) {
                     // Добавляем метку модуля в объединенный AST
-                    auto newModuleMark = std::make_shared<ModuleMark>(module.path);
+                    auto newModuleMark = makeNode<ModuleMark>(module.path);
                     combinedAST->body.push_back(newModuleMark);
                     
                     combinedAST->body.push_back(node);
@@ -76,6 +94,10 @@ std::shared_ptr<ProgramNode> parseAndLinkModules(
     std::cout << "--- Конец модулей ---\n";
 #endif    
 
+    if (showDeps) {
+        std::cout << "Отброшено неиспользуемых объявлений из use: " << shaker.droppedCount() << std::endl;
+    }
+
     if (showAST && combinedAST) {
         std::cout << "\n--- Объединенный AST ---\n";
         ASTDebugger::debug(combinedAST);
@@ -83,28 +105,18 @@ std::shared_ptr<ProgramNode> parseAndLinkModules(
     }
 
     
-    // Инициализация ErrorEngine
-    std::vector<std::string>* sourceFromTokens = new std::vector<std::string>();
-    for (const auto& tokenList : tokens) {
-        std::string sourceLine;
-        for (const auto& token : tokenList) {
-            sourceLine += token.value + " ";
-        }
-        sourceFromTokens->push_back(sourceLine);
-    }
-
+    // Инициализация ErrorEngine: строки исходника восстанавливаются из потока токенов по запросу
+    // (если AST взят из кэша, поток строится при первой ошибке)
 #if DEBUG
     // Выводим для дебага
     std::cout << "\n--- Исходный код из токенов ---\n";
-    int lineNumber = 0;
-    for (const auto& line : *sourceFromTokens) {
-        std::cout << "#" << lineNumber << " " <<  line << "\n";
-        lineNumber++;
+    for (size_t lineNumber = 0; tokens && lineNumber < tokens->lineCount(); lineNumber++) {
+        std::cout << "#" << lineNumber << " " <<  tokens->lineText(lineNumber) << "\n";
     }
     std::cout << "--- Конец исходного кода из токенов ---\n";
 #endif
 
-    ErrorEngine::getInstance().initialize(*sourceFromTokens);
+    ErrorEngine::getInstance().initialize(sourceCode, tokens);
 
     return combinedAST;
 }
\ No newline at end of file
@@ -0,0 +1,427 @@
+#include "headers/bench.h"
+#include "../lexer/headers/Lexer.h"
+#include "../lexer/headers/ParallelLexer.h"
+#include "../includes/ThreadPool.hpp"
+#include "../parser/headers/Parser.h"
+#include "../parser/headers/ParallelParser.h"
+#include "../parser/headers/ASTCache.h"
+#include "../visitors/headers/TypeSymbolVisitor.h"
+#include "../runtime/headers/ASTVisitors.h"
+#include "../server/headers/IncrementalDocument.h"
+#include "../linker/headers/Linker.h"
+#include "headers/ast_tools.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace {
+    constexpr int minIterations = 5;
+    constexpr double minTotalSeconds = 0.5;
+    constexpr int passIterations = 3; // Семантика и кодогенерация: каждый прогон - с нового разбора
+    constexpr int generatedRules = 4000; // Функций в сгенерированном файле правил для замера парсера
+    constexpr int generatedModules = 32; // Модулей правил, которые импортирует главный файл в замере линкера
+    constexpr int scopeSizes[] = {500, 1000, 2000, 4000}; // Глобальных переменных и функций в замере областей видимости
+    constexpr int scopeDepth = 3; // Вложенность if/while в каждой функции
+    constexpr int overloadFamilies = 400; // Имён встроенных функций в замере разрешения перегрузок, по 9 перегрузок на имя
+    constexpr int overloadQueries = 100000;
+
+    // Гоняет замер, пока не наберётся minIterations прогонов и minTotalSeconds времени.
+    // Возвращает лучший прогон в секундах - он меньше всего зашумлён.
+    // after() вызывается после каждого прогона вне замера (например, сброс арены AST)
+    template <typename Fn, typename After>
+    double bestOf(Fn&& fn, After&& after) {
+        double best = 0, total = 0;
+        for (int i = 0; i < minIterations || total < minTotalSeconds; i++) {
+            auto start = std::chrono::high_resolution_clock::now();
+            fn();
+            auto end = std::chrono::high_resolution_clock::now();
+            after();
+            double seconds = std::chrono::duration<double>(end - start).count();
+            best = (i == 0 || seconds < best) ? seconds : best;
+            total += seconds;
+        }
+        return best;
+    }
+
+    template <typename Fn>
+    double bestOf(Fn&& fn) {
+        return bestOf(std::forward<Fn>(fn), [] {});
+    }
+
+    // Занятая куча процесса (0, если libc не умеет это сообщать)
+    size_t heapInUse() {
+#if defined(__GLIBC__)
+        return mallinfo2().uordblks;
+#else
+        return 0;
+#endif
+    }
+
+    double toMegabytes(size_t bytes) {
+        return static_cast<double>(bytes) / (1024.0 * 1024.0);
+    }
+
+    void printStage(const std::string& name, double seconds, double megabytes) {
+        std::cout << name << ": " << std::fixed << std::setprecision(3) << seconds * 1000.0 << " ms, "
+                  << std::setprecision(1) << megabytes / seconds << " MB/s" << std::endl;
+    }
+
+    // Файл правил, как их выдают генераторы: много коротких функций с длинными выражениями
+    // на арифметике, сравнениях, and/or, скобках и вызовах. Генератор детерминирован,
+    // поэтому замеры сравнимы между сборками.
+    std::string generateRuleSource(int rules) {
+        uint32_t seed = 2463534242u;
+        auto next = [&seed](uint32_t bound) {
+            seed ^= seed << 13; seed ^= seed >> 17; seed ^= seed << 5;
+            return seed % bound;
+        };
+        const char* operands[] = {"amount", "limit", "score", "weight"};
+        const char* arithmetic[] = {" + ", " - ", " * ", " / ", " % "};
+        const char* comparisons[] = {" == ", " != ", " < ", " > ", " <= ", " >= "};
+
+        // Арифметическое выражение глубины depth
+        std::function<void(std::string&, int)> term = [&](std::string& out, int depth) {
+            if (depth == 0 || next(4) == 0) {
+                if (next(3) == 0) out += std::to_string(next(100000));
+                else out += operands[next(4)];
+                return;
+            }
+            bool grouped = next(3) == 0;
+            if (grouped) out += "(";
+            term(out, depth - 1);
+            out += arithmetic[next(5)];
+            term(out, depth - 1);
+            if (grouped) out += ")";
+        };
+
+        std::string source;
+        source.reserve(static_cast<size_t>(rules) * 600);
+        for (int rule = 0; rule < rules; rule++) {
+            std::string name = "rule_" + std::to_string(rule);
+            source += "[i32]" + name + "(i32: amount, i32: limit, i32: score, i32: weight)\n";
+            source += "|   i32 total = ";
+            term(source, 5);
+            source += "\n|   i1 matched = ";
+            for (int clause = 0; clause < 4; clause++) {
+                if (clause > 0) source += next(2) ? " and " : " or ";
+                term(source, 2);
+                source += comparisons[next(6)];
+                term(source, 2);
+            }
+            source += "\n|   if matched\n|   |   return total * -weight + ";
+            if (rule > 0) source += "rule_" + std::to_string(rule - 1) + "(limit, amount, total, score - 1)";
+            else source += "score";
+            source += "\n|   return total\n";
+        }
+        return source;
+    }
+
+    // N глобальных переменных и N функций с вложенными if/while: каждая функция и каждый
+    // блок открывают область видимости при всех N глобальных в таблице
+    std::string generateScopeSource(int declarations) {
+        std::string source;
+        for (int i = 0; i < declarations; i++)
+            source += "i32 g_" + std::to_string(i) + " = " + std::to_string(i) + "\n";
+        for (int i = 0; i < declarations; i++) {
+            source += "[i32]f_" + std::to_string(i) + "(i32: x)\n|   i32 acc = x + g_" + std::to_string(i) + "\n";
+            std::string indent = "|   ";
+            for (int depth = 0; depth < scopeDepth; depth++) {
+                source += indent + "if acc > " + std::to_string(depth) + "\n";
+                indent += "|   ";
+                source += indent + "acc = acc - 1\n";
+                source += indent + "while acc > " + std::to_string(100 + depth) + "\n";
+                source += indent + "|   acc = acc - 2\n";
+            }
+            source += "|   return acc\n";
+        }
+        source += "[i32]main()\n|   echo(toString_int(f_0(50)))\n|   return 0\n";
+        return source;
+    }
+
+    // Время чистого разбора уже готового потока токенов; арена сбрасывается вне замера.
+    // threads = 1 - последовательный Parser
+    double parseSeconds(const TokenStream& tokens, size_t threads) {
+        return bestOf([&]() {
+            ParallelParser::parse(tokens, "bench", threads);
+        }, [] { ASTArena::getInstance().reset(); });
+    }
+}
+
+void runBenchmarks(std::string_view sourceCode, const std::string& inputFile) {
+    double megabytes = static_cast<double>(sourceCode.size()) / (1024.0 * 1024.0);
+
+    std::cout << "\n--- Бенчмарк ---\n";
+    std::cout << "Исходник: " << sourceCode.size() << " байт" << std::endl;
+    std::cout << "Сканер лексера: " << Scanner::backendName() << std::endl;
+
+    double lexSeconds = bestOf([&]() {
+        Lexer lexer(sourceCode);
+        lexer.tokenize();
+    });
+    printStage("Лексер", lexSeconds, megabytes);
+
+    // Масштабирование по числу потоков: 1, 2, 4, ... и весь пул
+    size_t poolSize = ThreadPool::getInstance().size();
+    if (sourceCode.size() < ParallelLexer::minParallelSize) {
+        std::cout << "Параллельный лексер: исходник меньше " << (ParallelLexer::minParallelSize >> 20)
+                  << " MB, лексится последовательно" << std::endl;
+    } else if (poolSize < 2) {
+        std::cout << "Параллельный лексер: в пуле один поток (MS_THREADS)" << std::endl;
+    } else {
+        for (size_t threads = 2; ; threads = std::min(threads * 2, poolSize)) {
+            double seconds = bestOf([&]() { ParallelLexer::tokenize(sourceCode, threads); });
+            printStage("Параллельный лексер (потоков " + std::to_string(threads) + ")", seconds, megabytes);
+            if (threads >= poolSize) break;
+        }
+    }
+
+    // Память AST: один разбор; куча включает и блоки арены, и строки/векторы внутри узлов
+    try {
+        TokenStream tokens = ParallelLexer::tokenize(sourceCode);
+        ASTArena& arena = ASTArena::getInstance();
+        size_t heapBefore = heapInUse();
+        Parser parser(tokens, "bench");
+        auto program = parser.parse();
+        size_t heapAfter = heapInUse();
+        std::cout << std::setprecision(1) << "AST: узлов " << arena.nodeCount()
+                  << ", арена " << toMegabytes(arena.bytesReserved()) << " MB (узлы " << toMegabytes(arena.bytesUsed()) << " MB)"
+                  << ", куча +" << toMegabytes(heapAfter - heapBefore) << " MB"
+                  << ", инструкций верхнего уровня " << program->body.size() << std::endl;
+        arena.reset();
+    } catch (const std::exception& e) {
+        std::cout << "AST: разбор не удался: " << e.what() << std::endl;
+    }
+
+    // Парсер: на переданном исходнике и на сгенерированном файле правил, где выражения
+    // занимают большую часть текста
+    // Параллельный разбор масштабируется так же, как лексер: 1, 2, 4, ... и весь пул
+    auto benchParser = [&](const std::string& name, const TokenStream& tokens, double sourceMegabytes) {
+        printStage(name, parseSeconds(tokens, 1), sourceMegabytes);
+        if (tokens.size() < ParallelParser::minParallelTokens || poolSize < 2)
+            return;
+        for (size_t threads = 2; ; threads = std::min(threads * 2, poolSize)) {
+            printStage(name + " (потоков " + std::to_string(threads) + ")", parseSeconds(tokens, threads), sourceMegabytes);
+            if (threads >= poolSize) break;
+        }
+    };
+    try {
+        TokenStream tokens = ParallelLexer::tokenize(sourceCode);
+        benchParser("Парсер", tokens, megabytes);
+    } catch (const std::exception& e) {
+        std::cout << "Парсер: разбор не удался: " << e.what() << std::endl;
+    }
+    try {
+        std::string rules = generateRuleSource(generatedRules);
+        TokenStream tokens = ParallelLexer::tokenize(rules);
+        benchParser("Парсер (правила, " + std::to_string(generatedRules) + " функций, " + std::to_string(rules.size()) + " байт)",
+                    tokens, static_cast<double>(rules.size()) / (1024.0 * 1024.0));
+    } catch (const std::exception& e) {
+        std::cout << "Парсер (правила): разбор не удался: " << e.what() << std::endl;
+    }
+
+    // Кэш AST: запись и чтение сериализованного модуля в памяти - то, что при попадании
+    // в кэш заменяет лексер и парсер (без чтения файла)
+    try {
+        TokenStream tokens = ParallelLexer::tokenize(sourceCode);
+        auto program = ParallelParser::parse(tokens, "bench");
+        std::string serialized;
+        double storeSeconds = bestOf([&]() { serialized = ASTCache::serialize(*program); });
+        ASTArena::getInstance().reset();
+        double loadSeconds = bestOf([&]() {
+            ASTCache::deserialize(serialized);
+        }, [] { ASTArena::getInstance().reset(); });
+        std::cout << std::setprecision(1) << "Кэш AST: запись " << toMegabytes(serialized.size()) << " MB" << std::endl;
+        printStage("Кэш AST: сериализация", storeSeconds, megabytes);
+        printStage("Кэш AST: загрузка", loadSeconds, megabytes);
+    } catch (const std::exception& e) {
+        std::cout << "Кэш AST: не удался: " << e.what() << std::endl;
+    }
+
+    // Линкер: главный файл импортирует generatedModules модулей правил из временного каталога,
+    // а каждый из них - целиком общий модуль rules_0 (как общую библиотеку правил).
+    // Кэш AST выключен, чтобы каждый прогон читал, лексил и разбирал модули заново
+    try {
+        std::filesystem::path directory = std::filesystem::temp_directory_path() / ("ms-bench-linker-" + std::to_string(generatedModules));
+        std::filesystem::create_directories(directory);
+        std::string mainSource = "use\n";
+        size_t modulesBytes = 0;
+        for (int i = 0; i < generatedModules; i++) {
+            std::string name = "rules_" + std::to_string(i);
+            std::string rules = (i > 0 ? "use\n|> rules_0\n" : "") + generateRuleSource(generatedRules / generatedModules);
+            std::ofstream(directory / (name + ".ms"), std::ios::binary | std::ios::trunc) << rules;
+            modulesBytes += rules.size();
+            mainSource += "|> " + name + "\n";
+        }
+        std::string mainPath = (directory / "main.ms").string();
+        auto mainTokens = std::make_shared<const TokenStream>(ParallelLexer::tokenize(mainSource));
+
+        bool cacheEnabled = ASTCache::getInstance().isEnabled();
+        ASTCache::getInstance().setEnabled(false);
+        auto linkSeconds = [&](size_t threads) {
+            return bestOf([&]() {
+                Linker linker(directory.string(), threads);
+                Parser parser(*mainTokens, "main");
+                if (!linker.addModule("main", mainPath, parser.parse(), mainTokens) || !linker.linkModules())
+                    throw std::runtime_error("линковка не удалась");
+            }, [] { ASTArena::getInstance().reset(); });
+        };
+        double modulesMegabytes = toMegabytes(modulesBytes);
+        std::string name = "Линкер (" + std::to_string(generatedModules) + " модулей правил)";
+        printStage(name, linkSeconds(1), modulesMegabytes);
+        if (poolSize > 1)
+            printStage(name + " (потоков " + std::to_string(poolSize) + ")", linkSeconds(0), modulesMegabytes);
+        ASTCache::getInstance().setEnabled(cacheEnabled);
+        std::filesystem::remove_all(directory);
+    } catch (const std::exception& e) {
+        std::cout << "Линкер: не удался: " << e.what() << std::endl;
+    }
+
+    // Семантика и кодогенерация меняют AST, поэтому замеряется только сам проход,
+    // а разбор и линковка перед ним повторяются вне замера
+    try {
+        auto tokens = std::make_shared<const TokenStream>(ParallelLexer::tokenize(sourceCode));
+        double semanticSeconds = 0, codegenSeconds = 0;
+        for (int i = 0; i < passIterations; i++) {
+            auto program = parseAndLinkModules(sourceCode, tokens, inputFile, false);
+
+            auto start = std::chrono::high_resolution_clock::now();
+            TypeSymbolVisitor typeSymbolVisitor;
+            program->accept(typeSymbolVisitor);
+            auto middle = std::chrono::high_resolution_clock::now();
+            CodeGenContext context(inputFile);
+            ASTGen codeGen(context);
+            program->accept(codeGen);
+            auto end = std::chrono::high_resolution_clock::now();
+
+            double semantic = std::chrono::duration<double>(middle - start).count();
+            double codegen = std::chrono::duration<double>(end - middle).count();
+            semanticSeconds = (i == 0 || semantic < semanticSeconds) ? semantic : semanticSeconds;
+            codegenSeconds = (i == 0 || codegen < codegenSeconds) ? codegen : codegenSeconds;
+            ASTArena::getInstance().reset();
+        }
+        printStage("Семантика", semanticSeconds, megabytes);
+        printStage("Кодогенерация (IR)", codegenSeconds, megabytes);
+    } catch (const std::exception& e) {
+        std::cout << "Семантика и кодогенерация: не удались: " << e.what() << std::endl;
+    }
+
+    // Области видимости: время семантики и кодогенерации на объявление не должно расти
+    // с размером программы (вложенная область не копирует внешние таблицы)
+    try {
+        for (int declarations : scopeSizes) {
+            std::string scopeSource = generateScopeSource(declarations);
+            auto tokens = ParallelLexer::tokenize(scopeSource);
+            double semanticSeconds = 0, codegenSeconds = 0;
+            for (int i = 0; i < passIterations; i++) {
+                auto program = ParallelParser::parse(tokens, "bench", 1);
+
+                auto start = std::chrono::high_resolution_clock::now();
+                TypeSymbolVisitor typeSymbolVisitor;
+                program->accept(typeSymbolVisitor);
+                auto middle = std::chrono::high_resolution_clock::now();
+                CodeGenContext context("bench");
+                ASTGen codeGen(context);
+                program->accept(codeGen);
+                auto end = std::chrono::high_resolution_clock::now();
+
+                double semantic = std::chrono::duration<double>(middle - start).count();
+                double codegen = std::chrono::duration<double>(end - middle).count();
+                semanticSeconds = (i == 0 || semantic < semanticSeconds) ? semantic : semanticSeconds;
+                codegenSeconds = (i == 0 || codegen < codegenSeconds) ? codegen : codegenSeconds;
+                ASTArena::getInstance().reset();
+            }
+            std::cout << std::setprecision(3) << "Области (" << declarations << " глобальных и функций): семантика "
+                      << semanticSeconds * 1000.0 << " ms, кодогенерация " << codegenSeconds * 1000.0 << " ms, на функцию "
+                      << (semanticSeconds + codegenSeconds) * 1e6 / declarations << " us" << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cout << "Области: не удались: " << e.what() << std::endl;
+    }
+
+    // Разрешение перегрузок встроенных функций: у каждого имени перегрузки по парам из i32, i64, float.
+    // Точный путь - аргументы (i32, i64), с приведением - (i8, i16), ближайшая перегрузка (i32, i32)
+    try {
+        Registry overloads;
+        TypeTable& types = TypeTable::getInstance();
+        const TypeId parameterTypes[] = {TypeTable::I32, TypeTable::I64, TypeTable::Float};
+        std::vector<Symbol> names;
+        for (int family = 0; family < overloadFamilies; family++) {
+            Symbol name("host_" + std::to_string(family));
+            names.push_back(name);
+            for (TypeId first : parameterTypes)
+                for (TypeId second : parameterTypes) {
+                    std::vector<std::pair<NodePtr<TypeNode>, Symbol>> parameters = {{types.node(first), "arg1"}, {types.node(second), "arg2"}};
+                    overloads.addBuiltinFunction(name, makeNode<FunctionNode>(name, "", types.node(TypeTable::I32), parameters, std::vector<std::string>(), nullptr));
+                }
+        }
+
+        std::vector<NodePtr<TypeNode>> exactArguments = {types.node(TypeTable::I32), types.node(TypeTable::I64)};
+        std::vector<NodePtr<TypeNode>> convertedArguments = {types.node(TypeTable::I8), types.node(TypeTable::I16)};
+        size_t resolved = 0;
+        auto resolveAll = [&](const std::vector<NodePtr<TypeNode>>& arguments) {
+            return bestOf([&]() {
+                for (int query = 0; query < overloadQueries; query++)
+                    resolved += overloads.resolveFunction(names[query % names.size()], arguments) ? 1 : 0;
+            });
+        };
+        double exactSeconds = resolveAll(exactArguments);
+        double convertedSeconds = resolveAll(convertedArguments);
+        ASTArena::getInstance().reset();
+
+        std::cout << std::setprecision(1) << "Перегрузки (" << overloadFamilies * 9 << " встроенных): точное совпадение "
+                  << exactSeconds * 1e9 / overloadQueries << " ns, с приведением " << convertedSeconds * 1e9 / overloadQueries
+                  << " ns на вызов" << (resolved ? "" : " (не разрешены)") << std::endl;
+    } catch (const std::exception& e) {
+        std::cout << "Перегрузки: не удались: " << e.what() << std::endl;
+    }
+
+    // Языковой сервер: файл правил открывается один раз, дальше правится тело функции
+    // в середине файла (сигнатура не меняется) - замеряется путь от правки до диагностики
+    try {
+        std::string rules = generateRuleSource(generatedRules);
+        double openSeconds = 0, editSeconds = 0;
+        IncrementalDocument::Stats stats;
+        ErrorEngine::getInstance().setQuiet(true); // Ошибки идут в диагностику, а не в cerr
+        {
+            IncrementalDocument document("bench.ms", rules);
+            auto start = std::chrono::high_resolution_clock::now();
+            document.diagnostics();
+            auto end = std::chrono::high_resolution_clock::now();
+            openSeconds = std::chrono::duration<double>(end - start).count();
+
+            std::string header = "[i32]rule_" + std::to_string(generatedRules / 2) + "(";
+            int line = 0;
+            while (line + 1 < static_cast<int>(document.lineCount()) && !document.lineText(line).starts_with(header))
+                line++;
+            line++; // "|   i32 total = ..."
+            int column = static_cast<int>(document.lineText(line).size());
+
+            // Правка и её отмена - два нажатия клавиш
+            editSeconds = bestOf([&]() {
+                document.edit(line, column, line, column, " + 1");
+                document.diagnostics();
+                document.edit(line, column, line, column + 4, "");
+                document.diagnostics();
+            }) / 2;
+            stats = document.getStats();
+        }
+        ErrorEngine::getInstance().setQuiet(false);
+        ASTArena::getInstance().reset();
+
+        std::cout << std::setprecision(3) << "LSP (правила, " << generatedRules << " функций): открытие "
+                  << openSeconds * 1000.0 << " ms, правка -> диагностика " << editSeconds * 1000.0 << " ms"
+                  << " (строк перелексировано " << stats.lexedLines << ", объявлений разобрано " << stats.parsedDeclarations
+                  << ", проверено " << stats.checkedDeclarations << ")" << std::endl;
+    } catch (const std::exception& e) {
+        ErrorEngine::getInstance().setQuiet(false);
+        std::cout << "LSP: не удался: " << e.what() << std::endl;
+    }
+
+    std::cout << "--- Конец бенчмарка ---\n";
+}
@@ -1,6 +1,5 @@
 #include "headers/cli.h"
 #include <iostream>
-#include <fstream>
 
 void printHelp(const char* programName) {
     std::cout << "🤔 Usage: " << programName << " [OPTIONS] [FILE]\n\n"
@@ -9,9 +8,15 @@ void printHelp(const char* programName) {
               << "  --tokens         🏷️  Show tokens\n"
               << "  --ast            🌳 Show AST\n"
               << "  --symantic       🔍 Show symantic analysis\n"
+              << "  --deps           🕸️  Show the module dependency graph and dropped declarations\n"
               << "  --run, run       ▶️  Execute the program via LLVM\n"
               << "  --compile        🏗️  Compile to executable\n"
               << "  --offOptimization 🛠️  Disable LLVM optimization\n"
+              << "  --bench          ⏱️  Benchmark compiler stages on FILE\n"
+              << "  --offCache       🗃️  Disable the parsed AST cache (MS_CACHE_DIR) and .msi summaries\n"
+              << "  --stream         🌊 With --run/--compile: check, generate and emit one function at a time\n"
+              << "  --modulePath DIR 📚 Also look for imported modules in DIR (repeatable; MS_MODULE_PATH)\n"
+              << "  lsp, --lsp       🧩 Run the language server (LSP over stdin/stdout)\n"
               << "\n⌨️ If FILE is not specified, input is read from standard input.\n"
               << std::endl;
 }
@@ -30,6 +35,8 @@ CLIOptions parseArgs(int argc, char* argv[]) {
             options.showAST = true;
         } else if (arg == "--symantic") {
             options.showSymantic = true;
+        } else if (arg == "--deps") {
+            options.showDeps = true;
         } else if (arg == "--run" || arg == "run") {
             options.runJIT = true;
         } else if (arg == "--compile") {
@@ -42,6 +49,21 @@ CLIOptions parseArgs(int argc, char* argv[]) {
             }
         } else if (arg == "--offOptimization") {
             options.offOptimization = true;
+        } else if (arg == "--bench") {
+            options.runBenchmark = true;
+        } else if (arg == "--offCache") {
+            options.offCache = true;
+        } else if (arg == "--stream") {
+            options.streaming = true;
+        } else if (arg == "--modulePath") {
+            if (i + 1 < argc) {
+                options.modulePaths.push_back(argv[++i]);
+            } else {
+                std::cerr << "Error: --modulePath requires a directory." << std::endl;
+                exit(1);
+            }
+        } else if (arg == "--lsp" || arg == "lsp") {
+            options.languageServer = true;
         } else if (arg[0] != '-') {
             options.inputFile = arg;
         } else {
@@ -57,26 +79,16 @@ CLIOptions parseArgs(int argc, char* argv[]) {
     return options;
 }
 
-std::string readSourceCode(const std::string& inputFile) {
-    std::string sourceCode;
-    
+std::shared_ptr<const SourceBuffer> readSourceCode(const std::string& inputFile) {
     if (!inputFile.empty()) {
-        std::ifstream file(inputFile);
-        if (!file) {
+        auto source = SourceManager::getInstance().open(inputFile);
+        if (!source) {
             std::cerr << "Error: could not open file " << inputFile << std::endl;
             exit(1);
         }
-        std::string line;
-        while (std::getline(file, line)) {
-            sourceCode += line + "\n";
-        }
-    } else {
-        std::cout << "Enter source code (Ctrl+D to finish):\n";
-        std::string line;
-        while (std::getline(std::cin, line)) {
-            sourceCode += line + "\n";
-        }
+        return source;
     }
-    
-    return sourceCode;
+
+    std::cout << "Enter source code (Ctrl+D to finish):\n";
+    return SourceManager::getInstance().readStdin();
 }
\ No newline at end of file
@@ -1,3 +1,4 @@
+#include "headers/compile.h"
 #include "headers/runner.h"
 #include "../runtime/headers/CodeGenContext.h"
 #include "../runtime/headers/ASTVisitors.h"
@@ -40,6 +41,18 @@ bool emitExecutable(llvm::Module* module, const std::string& outputPath, const s
         return false;
     }
 
+    if (!linkExecutable({objPath}, outputPath, entryFunction)) {
+        return false;
+    }
+
+    // Удаляем промежуточные файлы
+    std::remove(irPath.c_str());
+    std::remove(objPath.c_str());
+
+    return true;
+}
+
+bool linkExecutable(const std::vector<std::string>& objectFiles, const std::string& outputPath, const std::string& entryFunction) {
     std::string stdlibPath = loader::findLibraryPath();
     if (stdlibPath.empty()) {
         std::cerr << "Не удалось найти стандартную библиотеку" << std::endl;
@@ -76,8 +89,21 @@ bool emitExecutable(llvm::Module* module, const std::string& outputPath, const s
         wrapperFile.close();
     }
     
-    // Компилируем и линкуем
-    std::string gccCmd = "gcc -g -o " + outputPath + " " + objPath;
+    // Компилируем и линкуем; длинный список объектов (--stream) передаётся файлом ответов
+    std::string gccCmd = "gcc -g -o " + outputPath;
+    std::string responsePath;
+    if (objectFiles.size() > 1) {
+        responsePath = outputPath + ".objects";
+        std::ofstream responseFile(responsePath);
+        for (const auto& objectFile : objectFiles) {
+            responseFile << objectFile << "\n";
+        }
+        gccCmd += " @" + responsePath;
+    } else {
+        for (const auto& objectFile : objectFiles) {
+            gccCmd += " " + objectFile;
+        }
+    }
     
     if (needsWrapper) {
         gccCmd += " " + wrapperPath;
@@ -93,17 +119,17 @@ bool emitExecutable(llvm::Module* module, const std::string& outputPath, const s
         return false;
     }
     
-    // Удаляем промежуточные файлы
-    std::remove(irPath.c_str());
-    std::remove(objPath.c_str());
     if (needsWrapper) {
         std::remove(wrapperPath.c_str());
     }
+    if (!responsePath.empty()) {
+        std::remove(responsePath.c_str());
+    }
     
     return true;
 }
 
-void compileToExecutable(std::shared_ptr<ProgramNode> combinedAST, const std::string& outputFile) {
+void compileToExecutable(NodePtr<ProgramNode> combinedAST, const std::string& outputFile) {
     CodeGenContext context(outputFile);
     ASTGen codeGen(context);
     combinedAST->accept(codeGen);
@@ -113,7 +139,7 @@ void compileToExecutable(std::shared_ptr<ProgramNode> combinedAST, const std::st
         
         // Поиск функции с меткой @entry
         for (const auto& node : combinedAST->body) {
-            if (auto func = std::dynamic_pointer_cast<FunctionNode>(node)) {
+            if (auto func = dyn_cast<FunctionNode>(node)) {
                 for (const auto& label : func->labels) {
                     if (label == "@entry") {
                         entryFunctionName = func->name;
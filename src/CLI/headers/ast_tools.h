@@ -1,13 +1,18 @@
 #pragma once
-#include "../../lexer/headers/Token.h"
+#include "../../lexer/headers/TokenStream.h"
 #include "../../parser/headers/AST.h"
 #include <vector>
 #include <memory>
 #include <string>
 
-std::vector<std::vector<Token>> tokenizeSource(const std::string& sourceCode, bool showTokens);
-std::shared_ptr<ProgramNode> parseAndLinkModules(
-    const std::vector<std::vector<Token>>& tokens, 
+// Спаны токенов смотрят в sourceCode, поэтому он должен жить дольше потока
+std::shared_ptr<const TokenStream> tokenizeSource(std::string_view sourceCode, bool showTokens);
+// tokens - поток главного модуля, если он уже есть (--tokens), иначе nullptr:
+// при попадании в кэш AST лексер не запускается вовсе; showDeps - граф модулей (--deps)
+NodePtr<ProgramNode> parseAndLinkModules(
+    std::string_view sourceCode,
+    std::shared_ptr<const TokenStream> tokens, 
     const std::string& inputFile, 
-    bool showAST
+    bool showAST,
+    bool showDeps = false
 );
\ No newline at end of file
@@ -0,0 +1,7 @@
+#pragma once
+#include <string>
+#include <string_view>
+
+// Микро-бенчмарки стадий компилятора на переданном исходнике (флаг --bench).
+// inputFile нужен линковщику для импортов в замере семантики и кодогенерации
+void runBenchmarks(std::string_view sourceCode, const std::string& inputFile);
@@ -1,17 +1,27 @@
 #pragma once
+#include <memory>
 #include <string>
+#include <vector>
+#include "../../loader/headers/SourceManager.h"
 
 struct CLIOptions {
     bool showTokens = false;
     bool showAST = false;
     bool showSymantic = false;
+    bool showDeps = false; // Граф модулей после линковки
     bool runJIT = false; // LLVM JIT
     bool offOptimization = false; // LLVM Optimization
     bool compileExecutable = false; // LLVM Compile
+    bool runBenchmark = false; // Микро-бенчмарки стадий
+    bool offCache = false; // Не читать и не писать кэш AST
+    bool languageServer = false; // ms lsp: языковой сервер на stdin/stdout
+    bool streaming = false; // --stream: --run/--compile по одной функции с ограниченной памятью
+    std::vector<std::string> modulePaths; // --modulePath: каталоги поиска модулей (до MS_MODULE_PATH)
     std::string ExecutableFile;
     std::string inputFile;
 };
 
 void printHelp(const char* programName);
 CLIOptions parseArgs(int argc, char* argv[]);
-std::string readSourceCode(const std::string& inputFile);
\ No newline at end of file
+// Исходник отображается в память один раз и живёт до конца компиляции
+std::shared_ptr<const SourceBuffer> readSourceCode(const std::string& inputFile);
\ No newline at end of file
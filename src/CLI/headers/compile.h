@@ -1,6 +1,9 @@
 #pragma once
 #include <memory>
 #include <string>
+#include <vector>
 #include "../../parser/headers/AST.h"
 
-void compileToExecutable(std::shared_ptr<ProgramNode> combinedAST, const std::string& outputFile);
\ No newline at end of file
+void compileToExecutable(NodePtr<ProgramNode> combinedAST, const std::string& outputFile);
+// Линкует объектные файлы со стандартной библиотекой; если entryFunction не main, добавляется обёртка с main
+bool linkExecutable(const std::vector<std::string>& objectFiles, const std::string& outputPath, const std::string& entryFunction);
\ No newline at end of file
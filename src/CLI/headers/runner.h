@@ -5,7 +5,13 @@
 
 namespace llvm {
     class Module;
+    class ExitOnError;
+    namespace orc {
+        class LLJIT;
+    }
 }
 
+// LLJIT с подгруженной стандартной библиотекой (libm_std.so); nullptr, если она не загрузилась
+std::unique_ptr<llvm::orc::LLJIT> createJIT(llvm::ExitOnError& ExitOnErr);
 int executeModule(llvm::Module* module, std::string mainFunction = "main", bool offOptimization = false);
-int runProgram(std::shared_ptr<ProgramNode> combinedAST, const std::string& currentFilePath, bool showAST, bool offOptimization = false);
\ No newline at end of file
+int runProgram(NodePtr<ProgramNode> combinedAST, const std::string& currentFilePath, bool showAST, bool offOptimization = false);
\ No newline at end of file
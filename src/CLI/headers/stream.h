@@ -0,0 +1,22 @@
+#pragma once
+#include <string_view>
+#include "cli.h"
+
+/*
+Потоковая компиляция (--stream вместе с --run или --compile).
+Обычный путь держит весь объединённый AST и один модуль LLVM на всю программу, который
+оптимизируется и выпускается целиком, - пиковая память растёт вместе со скриптом.
+Здесь главный модуль проходит по одной функции верхнего уровня:
+
+    предварительный проход:  границы объявлений (как в ParallelParser), use и линковка,
+                             заголовки функций без тел (Parser::parseFunctionSignature)
+    для каждой функции:      разбор -> проверка типов -> IR в своём модуле LLVM -> O2
+                             -> объектный код; модуль удаляется, узлы откатываются
+                             в арене (ASTArena::rewind), для проверки остаётся сигнатура
+
+Объектный код пишется в файлы и линкуется (--compile) или сразу уходит в JIT (--run).
+Глобальные переменные, структуры и модули из use живут до конца в общем модуле LLVM:
+они нужны всем функциям. Функции, как и при обычной проверке, видят только объявленное
+выше. Оптимизатор видит одну функцию за раз, межпроцедурного встраивания нет.
+*/
+int streamProgram(std::string_view sourceCode, const CLIOptions& options);
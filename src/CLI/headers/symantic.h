@@ -3,7 +3,7 @@
 #include <memory>
 #include <string>
 
-std::shared_ptr<ProgramNode> symanticParseModule(
-    std::shared_ptr<ProgramNode> combinedAST,
+NodePtr<ProgramNode> symanticParseModule(
+    NodePtr<ProgramNode> combinedAST,
     bool showSymantic
 );
\ No newline at end of file
@@ -22,14 +22,11 @@
 #include <llvm/Passes/PassPlugin.h>
 #include <llvm/IR/LegacyPassManager.h>
 
-int executeModule(llvm::Module* module, std::string mainFunction, bool offOptimization) {
+std::unique_ptr<llvm::orc::LLJIT> createJIT(llvm::ExitOnError& ExitOnErr) {
     llvm::InitializeNativeTarget();
     llvm::InitializeNativeTargetAsmPrinter();
     llvm::InitializeNativeTargetAsmParser();
 
-    llvm::ExitOnError ExitOnErr;
-    ExitOnErr.setBanner("Error JIT: ");
-
     void* handle = nullptr;
     std::string lib_path_primary_attempt = loader::findLibraryPath();
     
@@ -41,7 +38,7 @@ int executeModule(llvm::Module* module, std::string mainFunction, bool offOptimi
     
     if (!handle) {
         std::cerr << "Error loading standard library (libm_std.so): " << dlerror() << std::endl;
-        return 1;
+        return nullptr;
     }
 
     // JIT
@@ -53,6 +50,18 @@ int executeModule(llvm::Module* module, std::string mainFunction, bool offOptimi
             JIT->getDataLayout().getGlobalPrefix()))
     );
 
+    return JIT;
+}
+
+int executeModule(llvm::Module* module, std::string mainFunction, bool offOptimization) {
+    llvm::ExitOnError ExitOnErr;
+    ExitOnErr.setBanner("Error JIT: ");
+
+    auto JIT = createJIT(ExitOnErr);
+    if (!JIT) {
+        return 1;
+    }
+
     // --- Клонирование модуля ---
     auto Ctx = std::make_unique<llvm::LLVMContext>();
     std::unique_ptr<llvm::Module> ClonedModule;
@@ -128,7 +137,7 @@ int executeModule(llvm::Module* module, std::string mainFunction, bool offOptimi
     return Result;
 }
 
-int runProgram(std::shared_ptr<ProgramNode> combinedAST, const std::string& currentFilePath, bool showAST, bool offOptimization) {
+int runProgram(NodePtr<ProgramNode> combinedAST, const std::string& currentFilePath, bool showAST, bool offOptimization) {
 #if DEBUG
     auto t_start = std::chrono::high_resolution_clock::now();
 #endif
@@ -150,7 +159,7 @@ int runProgram(std::shared_ptr<ProgramNode> combinedAST, const std::string& curr
             
             // Поиск функции с меткой @entry
             for (const auto& node : combinedAST->body) {
-                if (auto func = std::dynamic_pointer_cast<FunctionNode>(node)) {
+                if (auto func = dyn_cast<FunctionNode>(node)) {
                     for (const auto& label : func->labels) {
                         if (label == "@entry") {
                             entryFunctionName = func->name;
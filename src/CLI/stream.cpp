@@ -0,0 +1,342 @@
+#include "headers/stream.h"
+#include "headers/ast_tools.h"
+#include "headers/compile.h"
+#include "headers/runner.h"
+#include "../parser/headers/Parser.h"
+#include "../parser/headers/ParallelParser.h"
+#include "../linker/headers/Linker.h"
+#include "../runtime/headers/CodeGenContext.h"
+#include "../runtime/headers/ASTVisitors.h"
+#include "../visitors/headers/TypeSymbolVisitor.h"
+#include "../errors/headers/ErrorEngine.h"
+#include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/IR/Verifier.h>
+#include <llvm/Passes/PassBuilder.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Target/TargetMachine.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+
+namespace
+{
+    // Объявление верхнего уровня главного модуля: строки потока [firstLine, endLine)
+    struct Declaration {
+        int firstLine = 0;
+        int endLine = 0;
+        NodePtr<FunctionNode> signature; // Только у функций
+        bool imports = false;            // use - уже разобран предварительным проходом
+    };
+
+    // То же условие, по которому Parser::parseStatement узнаёт функцию
+    bool isFunctionHeader(const TokenStream& tokens, size_t line)
+    {
+        size_t size = tokens.lineSize(line);
+        if (size < 2 || tokens.typeAt(line, 0) != TokenType::LeftBracket)
+            return false;
+        TokenType last = tokens.typeAt(line, size - 1);
+        return last == TokenType::RightParen || last == TokenType::Label;
+    }
+
+    // Имена из строк объявления без повторов: по ним функции объявляются глобальные переменные
+    std::vector<Symbol> namesIn(const TokenStream& tokens, int firstLine, int endLine)
+    {
+        std::vector<Symbol> names;
+        for (int line = firstLine; line < endLine; line++)
+            for (size_t i = 0; i < tokens.lineSize(line); i++)
+                if (Symbol symbol = tokens.symbolAt(line, i); !symbol.empty())
+                    names.push_back(symbol);
+        std::sort(names.begin(), names.end(), [](Symbol left, Symbol right) { return left.getId() < right.getId(); });
+        names.erase(std::unique(names.begin(), names.end()), names.end());
+        return names;
+    }
+
+    bool hasEntryLabel(const FunctionNode& function)
+    {
+        return std::find(function.labels.begin(), function.labels.end(), "@entry") != function.labels.end();
+    }
+
+    void optimize(llvm::Module& module)
+    {
+        llvm::PassBuilder passBuilder;
+        llvm::LoopAnalysisManager LAM;
+        llvm::FunctionAnalysisManager FAM;
+        llvm::CGSCCAnalysisManager CGAM;
+        llvm::ModuleAnalysisManager MAM;
+
+        passBuilder.registerModuleAnalyses(MAM);
+        passBuilder.registerCGSCCAnalyses(CGAM);
+        passBuilder.registerFunctionAnalyses(FAM);
+        passBuilder.registerLoopAnalyses(LAM);
+        passBuilder.crossRegisterProxies(LAM, FAM, CGAM, MAM);
+
+        llvm::ModulePassManager MPM = passBuilder.buildPerModuleDefaultPipeline(llvm::OptimizationLevel::O2);
+        MPM.run(module, MAM);
+    }
+
+    class StreamCompiler
+    {
+    public:
+        // Получает объектный код каждого выпущенного модуля
+        using ObjectSink = std::function<void(const std::string& name, llvm::SmallVectorImpl<char>& object)>;
+
+        StreamCompiler(const std::string& moduleName, llvm::TargetMachine& machine, bool offOptimization, ObjectSink sink)
+            : context(moduleName), codeGen(context), machine(machine), offOptimization(offOptimization), sink(std::move(sink))
+        {
+            context.TheModule->setDataLayout(machine.createDataLayout());
+        }
+
+        // Узел, который живёт до конца (модули из use, глобальные переменные, структуры), - в общий модуль
+        void compileShared(const NodePtr<ASTNode>& node)
+        {
+            node->accept(checker);
+            node->accept(codeGen);
+
+            if (auto function = dyn_cast<FunctionNode>(node)) {
+                if (llvm::Function* generated = context.TheModule->getFunction(function->name.str()))
+                    context.externalFunctions[function->name] = generated->getFunctionType();
+            } else if (auto variable = dyn_cast<VariableAssignNode>(node)) {
+                // Переменную читают функции из других объектов: внешняя связь и имя, которое не совпадёт с библиотечным
+                auto value = context.NamedValues.find(variable->name);
+                if (value == context.NamedValues.end())
+                    return;
+                if (auto* global = llvm::dyn_cast<llvm::GlobalVariable>(value->second)) {
+                    global->setLinkage(llvm::GlobalValue::ExternalLinkage);
+                    global->setName("ms." + variable->name.str());
+                    globals[variable->name] = global;
+                }
+            }
+        }
+
+        // Функция главного модуля: проверка, свой модуль LLVM, оптимизация и объектный код.
+        // usedNames - имена из её строк (см. namesIn)
+        void compileFunction(const NodePtr<FunctionNode>& function, const std::vector<Symbol>& usedNames)
+        {
+            function->accept(checker);
+
+            auto shared = std::exchange(context.TheModule, std::make_unique<llvm::Module>(function->name.str(), context.TheContext));
+            context.TheModule->setDataLayout(machine.createDataLayout());
+
+            // Глобальные переменные общего модуля - внешние объявления в модуле функции
+            auto arrayElementTypes = context.arrayElementTypes;
+            std::vector<Symbol> declared;
+            for (Symbol name : usedNames) {
+                auto global = globals.find(name);
+                if (global == globals.end())
+                    continue;
+                llvm::GlobalVariable* definition = global->second;
+                auto* declaration = new llvm::GlobalVariable(*context.TheModule, definition->getValueType(), definition->isConstant(),
+                    llvm::GlobalValue::ExternalLinkage, nullptr, definition->getName());
+                context.NamedValues[name] = declaration;
+                if (auto elementType = arrayElementTypes.find(definition); elementType != arrayElementTypes.end())
+                    context.arrayElementTypes[declaration] = elementType->second;
+                declared.push_back(name);
+            }
+
+            function->accept(codeGen);
+            if (llvm::Function* generated = context.TheModule->getFunction(function->name.str()))
+                context.externalFunctions[function->name] = generated->getFunctionType();
+
+            emit(*context.TheModule);
+
+            // Модуль функции удаляется - на его значения не должно остаться ссылок
+            for (Symbol name : declared)
+                context.NamedValues[name] = globals[name];
+            context.arrayElementTypes = std::move(arrayElementTypes);
+            context.TheModule = std::move(shared);
+        }
+
+        void keepSignature(const NodePtr<FunctionNode>& signature)
+        {
+            checker.keepSignature(signature);
+        }
+
+        // Общий модуль выпускается последним: в нём всё, что не было отдельной функцией
+        void finish()
+        {
+            emit(*context.TheModule);
+        }
+
+    private:
+        CodeGenContext context; // TheModule - общий модуль, пока не генерируется функция
+        ASTGen codeGen;
+        TypeSymbolVisitor checker;
+        llvm::TargetMachine& machine;
+        bool offOptimization;
+        ObjectSink sink;
+        std::unordered_map<Symbol, llvm::GlobalVariable*> globals; // Определения в общем модуле
+
+        void emit(llvm::Module& module)
+        {
+            // Обычный путь отбрасывает неверный IR на разборе в executeModule, здесь его ловит верификатор
+            std::string problems;
+            llvm::raw_string_ostream problemStream(problems);
+            if (llvm::verifyModule(module, &problemStream))
+                throw std::runtime_error("Stream Error: invalid IR in module " + module.getName().str() + ": " + problemStream.str());
+
+            if (!offOptimization)
+                optimize(module);
+
+            llvm::SmallVector<char, 0> object;
+            llvm::raw_svector_ostream stream(object);
+            llvm::legacy::PassManager passes;
+            if (machine.addPassesToEmitFile(passes, stream, nullptr, llvm::CodeGenFileType::ObjectFile))
+                throw std::runtime_error("Stream Error: target machine cannot emit object files");
+            passes.run(module);
+
+            sink(module.getName().str(), object);
+        }
+    };
+}
+
+int streamProgram(std::string_view sourceCode, const CLIOptions& options)
+{
+    auto tokens = tokenizeSource(sourceCode, options.showTokens);
+    ErrorEngine::getInstance().initialize(sourceCode, tokens);
+    std::string moduleName = std::filesystem::path(options.inputFile).stem().string();
+
+    // Предварительный проход: границы объявлений, use и сигнатуры функций
+    std::vector<Declaration> declarations;
+    auto imports = makeNode<ProgramNode>();
+    imports->moduleName = moduleName;
+    for (size_t line = 0; line < tokens->lineCount();) {
+        size_t end = line + 1;
+        while (end < tokens->lineCount() && !ParallelParser::startsDeclaration(*tokens, end))
+            end++;
+
+        Declaration declaration{static_cast<int>(line), static_cast<int>(end)};
+        if (isFunctionHeader(*tokens, line)) {
+            Parser parser(*tokens, moduleName, declaration.firstLine, declaration.endLine);
+            declaration.signature = parser.parseFunctionSignature();
+        } else if (tokens->typeAt(line, 0) == TokenType::Keyword && tokens->valueAt(line, 0) == "use") {
+            Parser parser(*tokens, moduleName, declaration.firstLine, declaration.endLine);
+            for (const auto& node : parser.parse()->body)
+                if (isa<ImportNode>(node))
+                    imports->body.push_back(node);
+            declaration.imports = true;
+        }
+        declarations.push_back(declaration);
+        line = end;
+    }
+
+    // Модули из use линкуются так же, как в parseAndLinkModules
+    Linker linker(std::filesystem::current_path().string());
+    if (!imports->body.empty()) {
+        if (!linker.addModule(moduleName, options.inputFile, imports, tokens, sourceCode)) {
+            throw std::runtime_error("Ошибка при добавлении модуля");
+        }
+        if (!linker.linkModules()) {
+            throw std::runtime_error("Ошибка при линковке модулей");
+        }
+    }
+
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+    llvm::InitializeNativeTargetAsmParser();
+
+    llvm::ExitOnError ExitOnErr;
+    ExitOnErr.setBanner("Error stream: ");
+
+    // PIC подходит и для JIT, и для gcc, который по умолчанию собирает PIE
+    auto machineBuilder = ExitOnErr(llvm::orc::JITTargetMachineBuilder::detectHost());
+    machineBuilder.setRelocationModel(llvm::Reloc::PIC_);
+    auto machine = ExitOnErr(machineBuilder.createTargetMachine());
+
+    std::unique_ptr<llvm::orc::LLJIT> JIT;
+    std::string outputFile = options.ExecutableFile.empty() ? "output" : options.ExecutableFile;
+    std::filesystem::path objectDirectory = outputFile + ".stream";
+    std::vector<std::string> objectFiles;
+    StreamCompiler::ObjectSink sink;
+
+    if (options.runJIT) {
+        JIT = createJIT(ExitOnErr);
+        if (!JIT) {
+            return 1;
+        }
+        sink = [&](const std::string& name, llvm::SmallVectorImpl<char>& object) {
+            ExitOnErr(JIT->addObjectFile(llvm::MemoryBuffer::getMemBufferCopy(llvm::StringRef(object.data(), object.size()), name)));
+        };
+    } else {
+        std::filesystem::create_directories(objectDirectory);
+        sink = [&](const std::string&, llvm::SmallVectorImpl<char>& object) {
+            std::string path = (objectDirectory / (std::to_string(objectFiles.size()) + ".o")).string();
+            std::ofstream file(path, std::ios::binary);
+            file.write(object.data(), static_cast<std::streamsize>(object.size()));
+            if (!file) {
+                throw std::runtime_error("Не удалось записать объектный файл: " + path);
+            }
+            objectFiles.push_back(path);
+        };
+    }
+
+    std::string entryFunctionName = "main";
+    StreamCompiler compiler(moduleName, *machine, options.offOptimization, std::move(sink));
+
+    // Модули из use - целиком в общий модуль, как в объединённом AST (зависимости раньше)
+    for (const auto& name : linker.getOrder()) {
+        const ModuleContext& module = linker.getModules().at(name);
+        if (name == moduleName || !module.ast) {
+            continue;
+        }
+        compiler.compileShared(makeNode<ModuleMark>(module.path));
+        for (const auto& node : module.ast->body) {
+            if (isa<ImportNode>(node)) {
+                continue;
+            }
+            if (auto function = dyn_cast<FunctionNode>(node); function && hasEntryLabel(*function)) {
+                entryFunctionName = function->name.str();
+            }
+            compiler.compileShared(node);
+        }
+    }
+
+    // Главный модуль - по объявлению; AST функции живёт только до её объектного кода
+    ASTArena& arena = ASTArena::getInstance();
+    compiler.compileShared(makeNode<ModuleMark>(options.inputFile));
+    for (const auto& declaration : declarations) {
+        if (declaration.imports) {
+            continue;
+        }
+
+        ASTArena::Mark mark = arena.mark();
+        Parser parser(*tokens, moduleName, declaration.firstLine, declaration.endLine);
+        auto program = parser.parse();
+
+        if (declaration.signature && program->body.size() == 1 && isa<FunctionNode>(program->body[0])) {
+            if (hasEntryLabel(*declaration.signature)) {
+                entryFunctionName = declaration.signature->name.str();
+            }
+            compiler.compileFunction(cast<FunctionNode>(program->body[0]), namesIn(*tokens, declaration.firstLine, declaration.endLine));
+            arena.rewind(mark);
+            compiler.keepSignature(declaration.signature);
+            continue;
+        }
+
+        for (const auto& node : program->body) {
+            compiler.compileShared(node);
+        }
+    }
+    compiler.finish();
+
+    if (options.runJIT) {
+        auto MainSymbol = ExitOnErr(JIT->lookup(entryFunctionName));
+        auto MainFn = MainSymbol.toPtr<int(*)()>();
+        int result = MainFn();
+        std::cout << "[" << entryFunctionName << " exited with code " << result << "]" << std::endl;
+        return result;
+    }
+
+    bool linked = linkExecutable(objectFiles, outputFile, entryFunctionName);
+    std::filesystem::remove_all(objectDirectory);
+    if (!linked) {
+        std::cerr << "Ошибка при компиляции в исполняемый файл." << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -2,7 +2,7 @@
 #include "../visitors/headers/TypeSymbolVisitor.h"
 #include "../includes/ASTDebugger.hpp"
 
-std::shared_ptr<ProgramNode> symanticParseModule(std::shared_ptr<ProgramNode> combinedAST, bool showSymantic)
+NodePtr<ProgramNode> symanticParseModule(NodePtr<ProgramNode> combinedAST, bool showSymantic)
 {
     // Type checking
     TypeSymbolVisitor typeSymbolVisitor;
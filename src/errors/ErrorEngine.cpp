@@ -1,4 +1,5 @@
 #include "headers/ErrorEngine.h"
+#include "../lexer/headers/ParallelLexer.h"
 #include <iostream> // Используем cerr для ошибок
 #include <iomanip>
 #include <cctype> // Для isspace
@@ -35,10 +36,16 @@ void ErrorEngine::warn(int line, int column, const std::string& message) {
 // --- Приватные методы ---
 
 void ErrorEngine::printError(int line, int column, const std::string& errorType, const std::string& message, const std::string& hint) {
+    lastReport = Report{line, column, errorType, message};
+    if (quiet) {
+        throw std::runtime_error(message);
+    }
+
     // TODO: Добавить цвета
     std::cerr << errorType << " [line " << line + 1 << ", column " << column + 1 << "]: " << message << std::endl;
 
-    if (sourceLines && sourceLines->size() > 0) {
+    const TokenStream* tokens = getSourceTokens();
+    if (tokens && tokens->lineCount() > 0) {
         printSourceLine(line, column);
     }
 
@@ -49,16 +56,25 @@ void ErrorEngine::printError(int line, int column, const std::string& errorType,
     throw std::runtime_error("");
 }
 
+// Поток токенов главного модуля; если AST пришёл из кэша, лексер запускается здесь, один раз
+const TokenStream* ErrorEngine::getSourceTokens() {
+    if (!sourceTokens && !sourceCode.empty()) {
+        sourceTokens = std::make_shared<const TokenStream>(ParallelLexer::tokenize(sourceCode));
+    }
+    return sourceTokens.get();
+}
+
 void ErrorEngine::printSourceLine(int line, int column) {
+    const TokenStream* tokens = getSourceTokens();
     // Сначала проверяем, что указатель не NULL
-    if (!sourceLines) {
+    if (!tokens) {
         std::cerr << "    (Can't reach source code)" << std::endl;
         return;
     }
 
-    int lineCount = static_cast<int>(sourceLines->size());
+    int lineCount = static_cast<int>(tokens->lineCount());
 
-    // Проверяем границы перед доступом к sourceLines
+    // Проверяем границы перед доступом к tokens
     if (line >= 0 && line < lineCount) {
         // Лямбда теперь возвращает пару: очищенную строку и количество удаленных символов
         auto removeLeadingPipesAndSpaces = [](const std::string& line) -> std::pair<std::string, size_t> {
@@ -69,7 +85,7 @@ void ErrorEngine::printSourceLine(int line, int column) {
             return {line.substr(startPos), startPos};
         };
 
-        const std::string& originalLine = (*sourceLines)[line];
+        const std::string originalLine = tokens->lineText(line);
         auto [codeLine, removedCharsCount] = removeLeadingPipesAndSpaces(originalLine);
 
         // Вывод номера строки и самой строки
@@ -1,12 +1,24 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <iostream>
 #include <memory>
+#include <optional>
+#include <utility>
+#include "../../lexer/headers/TokenStream.h"
 
 class ErrorEngine {
 public:
+    // Последняя ошибка: report() бросает исключение, а тот, кто его ловит, может забрать детали
+    struct Report {
+        int line = 0;   // как в узлах AST - индекс строки потока токенов
+        int column = 0; // индекс токена в строке
+        std::string errorType;
+        std::string message;
+    };
+
     // Singleton pattern implementation
     ErrorEngine(const ErrorEngine&) = delete;
     ErrorEngine& operator=(const ErrorEngine&) = delete;
@@ -16,16 +28,19 @@ public:
         return instance;
     }
     
-    // Initialize with source code
-    void initialize(const std::vector<std::string>& sourceLinesParam) {
-        sourceLines = &sourceLinesParam;
+    // Initialize with source code (must outlive the engine's use) and its token stream.
+    // Tokens may be nullptr when the AST came from the cache: the source is lexed on the first error
+    void initialize(std::string_view sourceCodeParam, std::shared_ptr<const TokenStream> sourceTokensParam) {
+        sourceCode = sourceCodeParam;
+        sourceTokens = std::move(sourceTokensParam);
         errorCount = 0;
         warningCount = 0;
     }
 
     // Initialize without source code
     void initialize() {
-        sourceLines = {};
+        sourceCode = {};
+        sourceTokens = nullptr;
         errorCount = 0;
         warningCount = 0;
     }
@@ -35,20 +50,29 @@ public:
     void reportWithHint(int line, int column, const std::string& module, const std::string& message, const std::string& hint, const std::string& errorType = "Unknown Error");
     void warn(int line, int column, const std::string& message);
 
+    // quiet - не печатать ошибки в cerr, только запоминать (ms lsp: stdout и stderr не для людей)
+    void setQuiet(bool value) { quiet = value; }
+    // Последняя ошибка, если она была после предыдущего вызова; сбрасывает её
+    std::optional<Report> takeLastReport() { return std::exchange(lastReport, std::nullopt); }
+
     // Statistics
     int getErrorCount() const;
     int getWarningCount() const;
 
 private:
     // Private constructor for singleton
-    ErrorEngine() : sourceLines(nullptr), errorCount(0), warningCount(0) {}
+    ErrorEngine() : sourceTokens(nullptr), errorCount(0), warningCount(0) {}
     
-    const std::vector<std::string>* sourceLines = nullptr;
+    std::string_view sourceCode;
+    std::shared_ptr<const TokenStream> sourceTokens;
+    std::optional<Report> lastReport;
+    bool quiet = false;
     int errorCount;
     int warningCount;
 
     // Error formatting and output
     void printError(int line, int column, const std::string& errorType, const std::string& message, const std::string& hint = "");
     void printSourceLine(int line, int column);
+    const TokenStream* getSourceTokens();
     std::string generatePointer(const std::string& cleanedLine, int originalColumn, int removedCharsCount);
 };
\ No newline at end of file
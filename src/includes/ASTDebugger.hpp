@@ -4,18 +4,18 @@
 class ASTDebugger 
 {
     public:
-        static void debug(const std::shared_ptr<ASTNode>& node, int indent = 0) {
+        static void debug(const NodePtr<ASTNode>& node, int indent = 0) {
             if (!node) {
                 printIndent(indent);
                 std::cout << "(null node)\n";
                 return;
             }
     
-            if (auto prog = std::dynamic_pointer_cast<ProgramNode>(node)) {
+            if (auto prog = dyn_cast<ProgramNode>(node)) {
                 printIndent(indent); std::cout << "[Program] " << prog->moduleName << "\n";
                 for (const auto& stmt : prog->body) debug(stmt, indent + 2);
             }
-            else if (auto func = std::dynamic_pointer_cast<FunctionNode>(node)) { 
+            else if (auto func = dyn_cast<FunctionNode>(node)) { 
                 printIndent(indent); std::cout << "[Function] " << func->name << "[" << func->associated << "]" << "(...) Return";
                 if (func->inferredType) 
                     std::cout << " (inferred type: " << func->inferredType->toString() << ")\n";
@@ -34,11 +34,11 @@ class ASTDebugger
                 }
                 debug(func->body, indent + 2);
             }
-            else if (auto moduleMark = std::dynamic_pointer_cast<ModuleMark>(node))
+            else if (auto moduleMark = dyn_cast<ModuleMark>(node))
             {
                 printIndent(indent); std::cout << "[Module Mark] " << moduleMark->moduleName << "\n";
             }   
-            else if(auto ifNode = std::dynamic_pointer_cast<IfNode>(node))
+            else if(auto ifNode = dyn_cast<IfNode>(node))
             {
                 printIndent(indent); std::cout << "[IF CONDITION]: \n";
                 debug(ifNode->condition, indent + 2);
@@ -47,7 +47,7 @@ class ASTDebugger
                 printIndent(indent); std::cout << "[ELSE], Else Block: \n";
                 debug(ifNode->elseBlock, indent + 2);
             }
-            else if (auto lambda = std::dynamic_pointer_cast<LambdaNode>(node))
+            else if (auto lambda = dyn_cast<LambdaNode>(node))
             {
                 printIndent(indent); std::cout << "[Lambda], Return Type: " << lambda->returnType->toString() << "\n";
                 for (const auto& param : lambda->parameters) {
@@ -57,7 +57,7 @@ class ASTDebugger
                 printIndent(indent); std::cout << "[Lambda], Body: \n";
                 debug(lambda->body, indent + 2);
             }
-            else if (auto For = std::dynamic_pointer_cast<ForNode>(node))
+            else if (auto For = dyn_cast<ForNode>(node))
             {
                 printIndent(indent); std::cout << "[For], iter_var: " << For->varName << "(auto)\n";
                 printIndent(indent); std::cout << "[For], Iterable: \n";
@@ -66,7 +66,7 @@ class ASTDebugger
                 debug(For->body, indent + 2);
 
             }
-            else if (auto use = std::dynamic_pointer_cast<ImportNode>(node)) {
+            else if (auto use = dyn_cast<ImportNode>(node)) {
                 printIndent(indent); 
                 std::cout << "[Use], Paths:\n";
                 for (const auto& entry : use->paths) {
@@ -83,39 +83,39 @@ class ASTDebugger
                     std::cout << "\n";
                 }
             }
-            else if (auto block = std::dynamic_pointer_cast<BlockNode>(node)) {
+            else if (auto block = dyn_cast<BlockNode>(node)) {
                 printIndent(indent); std::cout << "[Block]:\n";
                 for (const auto& stmt : block->statements) debug(stmt, indent + 2);
             }
-            else if (auto memberReassign = std::dynamic_pointer_cast<ReassignMemberNode>(node))
+            else if (auto memberReassign = dyn_cast<ReassignMemberNode>(node))
             {
                 printIndent(indent); std::cout << "[Reassign], identifier: \n";
                 debug(memberReassign->accessExpression, indent+2);
                 printIndent(indent); std::cout << "[Reassign], value: \n";
                 debug(memberReassign->expression, indent+2);
             }
-            else if (auto assign = std::dynamic_pointer_cast<VariableAssignNode>(node)) {
+            else if (auto assign = dyn_cast<VariableAssignNode>(node)) {
                 printIndent(indent); std::cout << "[Assign], IsConst: " << (assign->isConst ? "Const" : "Regular") << ", Identifier: " << assign->name << ",";
                 debug(assign->type, 1);
                 printIndent(indent); std::cout << "[Assign], value: \n";
                 debug(assign->expression, indent + 2);
             }
-            else if (auto reassign = std::dynamic_pointer_cast<VariableReassignNode>(node))
+            else if (auto reassign = dyn_cast<VariableReassignNode>(node))
             {
                 printIndent(indent); std::cout << "[Reassign], identifier: " << reassign->name << "\n";
                 printIndent(indent); std::cout << "[Reassign], value: \n";
                 debug(reassign->expression, indent + 2); 
             }
-            else if (auto call = std::dynamic_pointer_cast<CallNode>(node)) {
+            else if (auto call = dyn_cast<CallNode>(node)) {
                 printIndent(indent); std::cout << "Call: " << call->callee << "(...)\n";
                 for (const auto& arg : call->arguments) debug(arg, indent + 2);
             }
-            else if (auto bin = std::dynamic_pointer_cast<BinaryOpNode>(node)) {
-                printIndent(indent); std::cout << "BinaryOp: " << bin->op << "\n";
+            else if (auto bin = dyn_cast<BinaryOpNode>(node)) {
+                printIndent(indent); std::cout << "BinaryOp: " << opcodeName(bin->op) << "\n";
                 debug(bin->left, indent + 2);
                 debug(bin->right, indent + 2);
             }
-            else if (auto access = std::dynamic_pointer_cast<AccessExpression>(node)) {
+            else if (auto access = dyn_cast<AccessExpression>(node)) {
                 printIndent(indent); std::cout << "[Access Notation]: " << access->notation << " Member: " << access->memberName << "\n";
                 if(access->expression)
                     debug(access->expression, indent + 2);
@@ -126,65 +126,65 @@ class ASTDebugger
                     debug(access->nextAccess, indent + 2);
                 }
             }
-            else if (auto un = std::dynamic_pointer_cast<UnaryOpNode>(node)) {
-                printIndent(indent); std::cout << "UnaryOp: " << un->op << "\n";
+            else if (auto un = dyn_cast<UnaryOpNode>(node)) {
+                printIndent(indent); std::cout << "UnaryOp: " << opcodeName(un->op) << "\n";
                 debug(un->operand, indent + 2);
             }
-            else if (auto ident = std::dynamic_pointer_cast<IdentifierNode>(node)) {
+            else if (auto ident = dyn_cast<IdentifierNode>(node)) {
                 printIndent(indent); std::cout << "Value: " << ident->name << " - <identifier>" << "\n";
                 if (ident->implicitCastTo) {
                     printIndent(indent+2); std::cout << "[Implicit Cast To]: " << ident->implicitCastTo->toString() << "\n";
                 }
             }
-            else if (auto structNode = std::dynamic_pointer_cast<StructNode>(node))
+            else if (auto structNode = dyn_cast<StructNode>(node))
             {
                 printIndent(indent); std::cout << "[Struct], name: " << structNode->name << "\n";
                 debug(structNode->body, indent+2);
             }
-            else if (auto num = std::dynamic_pointer_cast<NumberNode>(node)) {
+            else if (auto num = dyn_cast<NumberNode>(node)) {
                 printIndent(indent); std::cout << "Value: " << num->value << " - <" + num->type->toString() + ">" << "\n";
                 if (num->implicitCastTo) {
                     printIndent(indent+2); std::cout << "[Implicit Cast To]: " << num->implicitCastTo->toString() << "\n";
                 }
             }
-            else if (auto str = std::dynamic_pointer_cast<StringNode>(node)) {
+            else if (auto str = dyn_cast<StringNode>(node)) {
                 printIndent(indent); std::cout << "Value: " << str->value << " - <string>" << "\n";
                 if (str->implicitCastTo) {
                     printIndent(indent+2); std::cout << "[Implicit Cast To]: " << str->implicitCastTo->toString() << "\n";
                 }
             }
-            else if (auto floatNum = std::dynamic_pointer_cast<FloatNumberNode>(node)) {
+            else if (auto floatNum = dyn_cast<FloatNumberNode>(node)) {
                 printIndent(indent); std::cout << "Value: " << floatNum->value << " - <float>" << "\n";
                 if (floatNum->implicitCastTo) {
                     printIndent(indent+2); std::cout << "[Implicit Cast To]: " << floatNum->implicitCastTo->toString() << "\n";
                 }
             }
-            else if (auto null = std::dynamic_pointer_cast<NullNode>(node)) {
+            else if (auto null = dyn_cast<NullNode>(node)) {
                 printIndent(indent); std::cout << "Value: <null>" << "\n";
             }
-            else if (auto none = std::dynamic_pointer_cast<NoneNode>(node)){
+            else if (auto none = dyn_cast<NoneNode>(node)){
                 printIndent(indent); std::cout << "Value: <none>" << "\n";
             }
-            else if(auto retrn = std::dynamic_pointer_cast<ReturnNode>(node)) {
+            else if(auto retrn = dyn_cast<ReturnNode>(node)) {
                 printIndent(indent); std::cout << "[Return]: " << "\n";
                 debug(retrn->expression, indent+2);
             }
-            else if(auto breakNode = std::dynamic_pointer_cast<BreakNode>(node)) {
+            else if(auto breakNode = dyn_cast<BreakNode>(node)) {
                 printIndent(indent); std::cout << "[Break]: Break Statement" << "\n";
             }
-            else if(auto keyValue = std::dynamic_pointer_cast<KeyValueNode>(node)){
+            else if(auto keyValue = dyn_cast<KeyValueNode>(node)){
                 printIndent(indent); std::cout << "Key: " << "\n";
                 debug(keyValue->key, indent+2);
                 printIndent(indent); std::cout << "Value: " << "\n";
                 debug(keyValue->value, indent+2);
             }
-            else if(auto whileNode = std::dynamic_pointer_cast<WhileNode>(node)) {
+            else if(auto whileNode = dyn_cast<WhileNode>(node)) {
                 printIndent(indent); std::cout << "[While], Condition: \n";
                 debug(whileNode->condition, indent+2);
                 printIndent(indent); std::cout << "[While], Body: \n";
                 debug(whileNode->body, indent+2);
             }
-            else if(auto typeShi = std::dynamic_pointer_cast<TypeNode>(node))
+            else if(auto typeShi = dyn_cast<TypeNode>(node))
             {
                 printIndent(indent);
                 if (typeShi->inferredType)
@@ -0,0 +1,153 @@
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+Общий пул потоков компилятора.
+Размер - std::thread::hardware_concurrency(), переменная окружения MS_THREADS
+задаёт его явно (MS_THREADS=1 выключает параллельность).
+
+    ThreadPool::getInstance().parallelFor(chunks.size(), [&](size_t i) { lex(chunks[i]); });
+
+parallelFor работает и из задач самого пула: вызывающий поток сам разбирает индексы,
+а помощники из очереди лишь присоединяются, поэтому вложенный вызов не может зависнуть.
+*/
+class ThreadPool
+{
+public:
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    static ThreadPool& getInstance() {
+        static ThreadPool instance(defaultSize());
+        return instance;
+    }
+
+    // Потоков, которые могут работать одновременно (вместе с вызывающим)
+    size_t size() const { return workers.size() + 1; }
+
+    // Вызывает fn(0..count-1) параллельно и ждёт всех. maxThreads = 0 - весь пул.
+    // Первое исключение из fn пробрасывается после завершения остальных индексов.
+    template <typename Fn>
+    void parallelFor(size_t count, Fn&& fn, size_t maxThreads = 0)
+    {
+        if (count == 0)
+            return;
+
+        size_t threads = std::min(count, maxThreads == 0 ? size() : std::min(maxThreads, size()));
+        if (threads <= 1)
+        {
+            for (size_t i = 0; i < count; i++)
+                fn(i);
+            return;
+        }
+
+        struct Batch {
+            std::atomic<size_t> next{0};
+            size_t finished = 0;
+            size_t count = 0;
+            std::exception_ptr error;
+            std::mutex mutex;
+            std::condition_variable done;
+        };
+        auto batch = std::make_shared<Batch>();
+        batch->count = count;
+
+        // Разбор индексов: каждый участник берёт следующий свободный, пока они не кончатся
+        auto drain = [batch, &fn]() {
+            for (size_t i = batch->next++; i < batch->count; i = batch->next++)
+            {
+                std::exception_ptr error;
+                try { fn(i); } catch (...) { error = std::current_exception(); }
+
+                std::lock_guard<std::mutex> lock(batch->mutex);
+                if (error && !batch->error)
+                    batch->error = error;
+                if (++batch->finished == batch->count)
+                    batch->done.notify_all();
+            }
+        };
+
+        // Помощник, вставший в очередь после конца работы, сразу выходит; fn он не трогает,
+        // поэтому ссылка на fn живёт ровно столько, сколько нужно
+        for (size_t i = 0; i + 1 < threads; i++)
+            enqueue(drain);
+        drain();
+
+        std::unique_lock<std::mutex> lock(batch->mutex);
+        batch->done.wait(lock, [&] { return batch->finished == batch->count; });
+        if (batch->error)
+            std::rethrow_exception(batch->error);
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            stopping = true;
+        }
+        queueReady.notify_all();
+        for (auto& worker : workers)
+            worker.join();
+    }
+
+private:
+    explicit ThreadPool(size_t threads)
+    {
+        for (size_t i = 1; i < threads; i++) // Вызывающий поток - тоже участник
+            workers.emplace_back([this] { workerLoop(); });
+    }
+
+    static size_t defaultSize()
+    {
+        if (const char* forced = std::getenv("MS_THREADS"))
+            if (int value = std::atoi(forced); value > 0)
+                return static_cast<size_t>(value);
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    void enqueue(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            tasks.push_back(std::move(task));
+        }
+        queueReady.notify_one();
+    }
+
+    void workerLoop()
+    {
+        for (;;)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                queueReady.wait(lock, [this] { return stopping || !tasks.empty(); });
+                if (stopping && tasks.empty())
+                    return;
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::vector<std::thread>            workers;
+    std::deque<std::function<void()>>   tasks;
+    std::mutex                          queueMutex;
+    std::condition_variable             queueReady;
+    bool                                stopping = false;
+};
+
+#endif // THREADPOOL_HPP
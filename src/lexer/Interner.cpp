@@ -0,0 +1,50 @@
+#include "headers/Interner.h"
+#include <stdexcept>
+
+Interner::Interner() : pages(new std::atomic<std::string*>[maxPages]), shards(new Shard[shardCount]), count(0)
+{
+    for (uint32_t i = 0; i < maxPages; i++)
+        pages[i].store(nullptr, std::memory_order_relaxed);
+
+    intern(""); // id 0 - пустая строка, Symbol() по умолчанию
+}
+
+uint32_t Interner::intern(std::string_view text)
+{
+    Shard& shard = shards[std::hash<std::string_view>()(text) % shardCount];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.ids.find(text);
+    if (it != shard.ids.end())
+        return it->second;
+
+    uint32_t id = count.fetch_add(1, std::memory_order_relaxed);
+    uint32_t page = id >> pageBits;
+    if (page >= maxPages)
+        throw std::runtime_error("Interner Error: too many distinct names");
+
+    std::string* storage = pages[page].load(std::memory_order_acquire);
+    if (!storage)
+    {
+        std::lock_guard<std::mutex> pageLock(pagesMutex);
+        storage = pages[page].load(std::memory_order_relaxed);
+        if (!storage)
+        {
+            storage = new std::string[pageSize];
+            pages[page].store(storage, std::memory_order_release);
+        }
+    }
+
+    // Слот принадлежит только этому id; другие потоки узнают id через мьютекс шарда
+    // или от нас самих, так что запись строки видна им раньше, чем сам id
+    std::string& slot = storage[id & (pageSize - 1)];
+    slot.assign(text);
+    shard.ids.emplace(std::string_view(slot), id);
+    return id;
+}
+
+const std::string& Interner::lookup(uint32_t id) const
+{
+    std::string* storage = pages[id >> pageBits].load(std::memory_order_acquire);
+    return storage[id & (pageSize - 1)];
+}
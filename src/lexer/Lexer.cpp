@@ -1,377 +1,361 @@
 #include "headers/Lexer.h"
 #include "iostream"
 
-Lexer::Lexer(const std::string &sourceCode)
+Lexer::Lexer(std::string_view sourceCode, int firstLine, bool startsInComment)
 {
-    this->sourceCode = ParsingFunctions::split(sourceCode, "\n");
-    this->currentLine = 1;
+    this->sourceCode = sourceCode;
+    this->currentLine = firstLine;
     this->currentIndex = -1;
     this->currentTokenType = TokenType::None;
-    this->currentTokenValue = "";
+    this->currentTokenValue = {};
     this->isStringnotFinished = false;
-    this->isInMultilineComment = false;
+    this->isInMultilineComment = startsInComment;
 }
 
 void Lexer::tokenize()
 {
-    for(auto x : this->sourceCode)
-    {   
-        for(auto y : x)
+    // Один проход по непрерывному буферу: строки - это срезы между '\n', ничего не копируется
+    size_t lineStart = 0;
+    while (lineStart <= sourceCode.size())
+    {
+        size_t lineEnd = sourceCode.find('\n', lineStart);
+        if (lineEnd == std::string_view::npos)
+            lineEnd = sourceCode.size();
+
+        currentLineText = sourceCode.substr(lineStart, lineEnd - lineStart);
+        tokenizeLine();
+        lineStart = lineEnd + 1;
+    }
+}
+
+void Lexer::tokenizeLine()
+{
+    for (size_t position = 0; position < currentLineText.size(); position++)
+    {
+        if (size_t run = bulkRun(position); run > 0)
         {
-            currentIndex++;
-            if (this->isInMultilineComment)
-                if(y!='*' && peek(0)!='/')
-                    continue;
-                else
-                    this->isInMultilineComment=false;
-            else if (isStringnotFinished)
+            // Серия символов, каждый из которых посимвольный проход лишь добавил бы
+            // к токену или пропустил - поглощаем её целиком
+            if (!currentTokenValue.empty())
+                currentTokenValue = std::string_view(currentTokenValue.data(), currentTokenValue.size() + run);
+            currentIndex += static_cast<int>(run);
+            position += run - 1;
+            continue;
+        }
+
+        char y = currentLineText[position];
+        currentIndex++;
+        if (this->isInMultilineComment)
+            if(y!='*' && peek(0)!='/')
+                continue;
+            else
+                this->isInMultilineComment=false;
+        else if (isStringnotFinished)
+        {
+            if (y == '"' && currentTokenValue[currentTokenValue.size()-1] != '\\')
             {
-                if (y == '"' && currentTokenValue[currentTokenValue.size()-1] != '\\')
-                {
-                    currentTokenValue += y;
-                    isStringnotFinished = false;
-                    addToken(TokenType::String, currentTokenValue); // Add the token to the current line
-                    resetValues();
-                    continue;
-                }
-                else
-                    currentTokenValue += y;
+                extendToken(position);
+                isStringnotFinished = false;
+                addToken(TokenType::String, currentTokenValue); // Add the token to the current line
+                resetValues();
                 continue;
             }
+            else
+                extendToken(position);
+            continue;
+        }
 
-            TokenType type = IdentifyTokenType(y);
-            TokenType keywordCheck;
+        TokenType type = IdentifyTokenType(y);
+        TokenType keywordCheck;
 
-            if ((y == ' ' && y != '.') && (currentTokenType != TokenType::String)) // По какой то причине C++ перенаправляет . сюда 
+        if ((y == ' ' && y != '.') && (currentTokenType != TokenType::String)) // По какой то причине C++ перенаправляет . сюда 
+        {
+            if(!currentTokenValue.empty())
+            {
+                keywordCheck = IsKeyword(currentTokenValue); // Check if the current token is a keyword
+
+                keywordCheck==TokenType::Identifier ? addToken(currentTokenType, currentTokenValue) : addToken(keywordCheck, currentTokenValue);
+                
+                resetValues();
+            }
+            continue;
+        }
+
+        keywordCheck = IsKeyword(currentTokenValue); // Check if the current token is a keyword
+        if(keywordCheck != TokenType::Identifier)
+        {
+            std::optional<char> peekChar = peek(0);
+            if (currentTokenValue == "i1" && y == '6')
             {
-                if(currentTokenValue!="")
-                {
-                    keywordCheck = IsKeyword(currentTokenValue); // Check if the current token is a keyword
-
-                    keywordCheck==TokenType::Identifier ? addToken(currentTokenType, currentTokenValue) : addToken(keywordCheck, currentTokenValue);
-                    
-                    resetValues();
-                }
+                extendToken(position);
+                currentIndex++;
                 continue;
             }
+            if(peekChar.has_value() && IdentifyTokenType(peekChar.value())!=TokenType::Identifier)
+            {
+                addToken(keywordCheck, currentTokenValue);
+                resetValues();
+            }
+        }
 
-            keywordCheck = IsKeyword(currentTokenValue); // Check if the current token is a keyword
-            if(keywordCheck != TokenType::Identifier)
+
+        if (type != currentTokenType && (currentTokenType != TokenType::None && type != TokenType::Dot)) 
+        {
+            if (currentTokenType == TokenType::String && type != currentTokenType && isStringnotFinished)
             {
-                std::optional<char> peekChar = peek(0);
-                if (currentTokenValue == "i1" && y == '6')
-                {
-                    currentTokenValue += y;
-                    currentIndex++;
-                    continue;
-                }
-                if(peekChar.has_value() && IdentifyTokenType(peekChar.value())!=TokenType::Identifier)
-                {
-                    addToken(keywordCheck, currentTokenValue);
-                    resetValues();
-                }
+                currentTokenType = TokenType::String;
+                extendToken(position);
+                continue;
             }
 
+            if (currentTokenType == TokenType::Identifier && type == TokenType::Number)
+            {
+                extendToken(position);
+                continue; 
+            }
 
-            if (type != currentTokenType && (currentTokenType != TokenType::None && type != TokenType::Dot)) 
+            if(currentTokenValue.length() > 0) 
             {
-                if (currentTokenType == TokenType::String && type != currentTokenType && isStringnotFinished)
-                {
-                    currentTokenType = TokenType::String;
-                    currentTokenValue += y;
-                    continue;
-                }
-
-                if (currentTokenType == TokenType::Identifier && type == TokenType::Number)
-                {
-                    currentTokenValue += y;
-                    continue; 
-                }
-
-                if(currentTokenValue.length() > 0) 
-                {
-                    currentIndex--;
-                    addToken(currentTokenType, currentTokenValue); // Add the previous token if it has more than 1 character
-                    currentIndex++;
-                }
-
-                if (currentTokenType != TokenType::String)
-                {
-                    currentTokenType = type;
-                    currentTokenValue = y;
-                    if(type == TokenType::String)
-                        isStringnotFinished = true;
-                    continue;
-                }
+                currentIndex--;
+                addToken(currentTokenType, currentTokenValue); // Add the previous token if it has more than 1 character
+                currentIndex++;
             }
 
-            if (type == TokenType::Identifier && currentTokenType == TokenType::None)
+            if (currentTokenType != TokenType::String)
             {
                 currentTokenType = type;
-                currentTokenValue = y;
+                startToken(position);
+                if(type == TokenType::String)
+                    isStringnotFinished = true;
                 continue;
             }
+        }
+
+        if (type == TokenType::Identifier && currentTokenType == TokenType::None)
+        {
+            currentTokenType = type;
+            startToken(position);
+            continue;
+        }
+
+        else if (type == TokenType::Identifier && currentTokenType == TokenType::Identifier)
+        {
+            extendToken(position);
+            continue;
+        }
+
+        if (type == TokenType::Number && currentTokenType == TokenType::None)
+        {
+            currentTokenType = type;
+            startToken(position);
+            continue;
+        }
+        else if (type == TokenType::Number && currentTokenType == TokenType::Number)
+        {
+            extendToken(position);
+            continue;
+        }
+
+        if (type == TokenType::Dot && currentTokenType == TokenType::Number)
+        {
+            extendToken(position);
+            continue;
+        }
 
-            else if (type == TokenType::Identifier && currentTokenType == TokenType::Identifier)
+        if (type == TokenType::Operator && currentTokenType == TokenType::None)
+        {
+            /*
+            TODO: Проверь що всё намана ёпт
+            */
+            if ( y == '>' && !currentTokens.empty() && currentTokens.back().type == TokenType::Pipe )
             {
-                currentTokenValue += y;
+                currentTokenValue = "|>"; // '|' и '>' могут стоять не вплотную, поэтому литерал
+                currentTokens.pop_back();
+                addToken(TokenType::PipeArrow, currentTokenValue);
+                resetValues();
                 continue;
             }
 
-            if (type == TokenType::Number && currentTokenType == TokenType::None)
+            currentTokenType = type;
+            startToken(position);
+            continue;
+        }
+        else if (type == TokenType::Operator && currentTokenType == TokenType::Operator)
+        {
+            extendToken(position);
+
+            // Просто скипает */
+            if (currentTokenValue == "*/"){resetValues();continue;}
+            
+            if (currentTokenValue != "//" && currentTokenValue != "/*" && currentTokenValue != "->" && currentTokenValue != ">>")
             {
-                currentTokenType = type;
-                currentTokenValue = y;
+                addToken(currentTokenType, currentTokenValue); // Add the token to the current line
+                resetValues();
                 continue;
             }
-            else if (type == TokenType::Number && currentTokenType == TokenType::Number)
+            else if (currentTokenValue == ">>")
             {
-                currentTokenValue += y;
+                addToken(currentTokenType, currentTokenValue.substr(0, 1)); // Add the token to the current line
+                addToken(currentTokenType, currentTokenValue.substr(1, 1)); // Add the token to the current line
+                resetValues();
                 continue;
             }
-
-            if (type == TokenType::Dot && currentTokenType == TokenType::Number)
+            else if (currentTokenValue == "**")
             {
-                currentTokenValue += y;
+                addToken(TokenType::Operator, currentTokenValue); // Add the token to the current line
+                resetValues();
                 continue;
             }
-
-            if (type == TokenType::Operator && currentTokenType == TokenType::None)
+            else if (currentTokenValue == "->")
             {
-                /*
-                TODO: Проверь що всё намана ёпт
-                */
-                if ( y == '>' && currentTokens.back().type == TokenType::Pipe )
-                {
-                    currentTokenValue = "|>";
-                    currentTokens.pop_back();
-                    addToken(TokenType::PipeArrow, currentTokenValue);
-                    resetValues();
-                    continue;
-                }
-
-                currentTokenType = type;
-                currentTokenValue = y;
+                addToken(TokenType::Arrow, currentTokenValue); // Add the token to the current line
+                resetValues();
                 continue;
             }
-            else if (type == TokenType::Operator && currentTokenType == TokenType::Operator)
+            else if (currentTokenValue == "/*")
             {
-                currentTokenValue += y;
-
-                // Просто скипает */
-                if (currentTokenValue == "*/"){resetValues();continue;}
-                
-                if (currentTokenValue != "//" && currentTokenValue != "/*" && currentTokenValue != "->" && currentTokenValue != ">>")
-                {
-                    addToken(currentTokenType, currentTokenValue); // Add the token to the current line
-                    resetValues();
-                    continue;
-                }
-                else if (currentTokenValue == ">>")
-                {
-                    addToken(currentTokenType, ">"); // Add the token to the current line
-                    addToken(currentTokenType, ">"); // Add the token to the current line
-                    resetValues();
-                    continue;
-                }
-                else if (currentTokenValue == "**")
-                {
-                    addToken(TokenType::Operator, "**"); // Add the token to the current line
-                    resetValues();
-                    continue;
-                }
-                else if (currentTokenValue == "->")
-                {
-                    addToken(TokenType::Arrow, "->"); // Add the token to the current line
-                    resetValues();
-                    continue;
-                }
-                else if (currentTokenValue == "/*")
-                {
-                    resetValues();
-                    this->isInMultilineComment = true;
-                    continue;
-                }
-                else // Двойные слеши
-                {
-                    resetValues();
-                    break;
-                }
+                resetValues();
+                this->isInMultilineComment = true;
+                continue;
             }
-
-            if(type == TokenType::String && currentTokenType != TokenType::String)
+            else // Двойные слеши
             {
-                currentTokenType = type;
-                currentTokenValue = y;
-                isStringnotFinished = true;
-                continue;
+                resetValues();
+                break;
             }
+        }
 
-            //IC(currentTokenValue, TokenTypeToString(currentTokenType), y);
-            if(currentTokenValue.length() > 0) 
-            {            
-                currentIndex--;
-                addToken(currentTokenType, currentTokenValue); // Add the previous token if it has more than 1 character
-                currentIndex++;
-            }
+        if(type == TokenType::String && currentTokenType != TokenType::String)
+        {
             currentTokenType = type;
-            currentTokenValue = y;
-            addToken(currentTokenType, currentTokenValue); // Add the token to the current line
-            resetValues();
+            startToken(position);
+            isStringnotFinished = true;
+            continue;
         }
-        if(currentTokenType != TokenType::None)
-            if (currentTokenType == TokenType::Identifier)
-                addToken(IsKeyword(currentTokenValue), currentTokenValue); // Add the token to the current line
-            else 
-                addToken(currentTokenType, currentTokenValue); // Add the last token of the line to the current line
-        if (isStringnotFinished)
-            throw std::runtime_error("Tokenizer Error: String not finished properly at line " + std::to_string(currentLine));
-        allTokens.push_back(currentTokens); // Add the current line tokens to the allTokens vector
-        currentTokens.clear(); // Clear the current tokens for the next line
-        currentIndex = -1; // Reset the current index for the next line
-        currentTokenType = TokenType::None; // Reset the current token type for the next line
-        currentTokenValue = ""; // Reset the current token value for the next line
-        currentLine++; // Increment the line number
 
+        //IC(currentTokenValue, TokenTypeToString(currentTokenType), y);
+        if(currentTokenValue.length() > 0) 
+        {            
+            currentIndex--;
+            addToken(currentTokenType, currentTokenValue); // Add the previous token if it has more than 1 character
+            currentIndex++;
+        }
+        currentTokenType = type;
+        startToken(position);
+        addToken(currentTokenType, currentTokenValue); // Add the token to the current line
+        resetValues();
     }
-    removeEmpty();
+    if(currentTokenType != TokenType::None)
+        if (currentTokenType == TokenType::Identifier)
+            addToken(IsKeyword(currentTokenValue), currentTokenValue); // Add the token to the current line
+        else 
+            addToken(currentTokenType, currentTokenValue); // Add the last token of the line to the current line
+    if (isStringnotFinished)
+        throw std::runtime_error("Tokenizer Error: String not finished properly at line " + std::to_string(currentLine));
+    tokens.appendLine(currentTokens); // Add the current line tokens to the stream (empty lines are skipped)
+    currentTokens.clear(); // Clear the current tokens for the next line
+    currentIndex = -1; // Reset the current index for the next line
+    currentTokenType = TokenType::None; // Reset the current token type for the next line
+    currentTokenValue = {}; // Reset the current token value for the next line
+    currentLine++; // Increment the line number
+}
+
+const TokenStream &Lexer::getTokens() const
+{
+    return tokens;
 }
 
-const std::vector<std::vector<Token>> &Lexer::getTokens() const
+TokenStream Lexer::takeTokens()
 {
-    return allTokens;
+    return std::move(tokens);
 }
 
 void Lexer::printTokens()
+{
+    printTokens(tokens);
+}
+
+void Lexer::printTokens(const TokenStream& tokens)
 {
     std::cout << "\nTokens for each line:" << std::endl;
-    int currentLineFor = 1;
-    for (const auto &lineTokens : allTokens)
+    for (size_t line = 0; line < tokens.lineCount(); line++)
     {
-        std::cout << "Line " << currentLineFor << ": ";
-        for (const auto &token : lineTokens)
+        std::cout << "Line " << line + 1 << ": ";
+        for (size_t index = 0; index < tokens.lineSize(line); index++)
         {
-            std::cout << "{" << TokenTypeToString(token.type) << ", \"" << token.value << "\"} ";
+            std::cout << "{" << TokenTypeToString(tokens.typeAt(line, index)) << ", \"" << tokens.valueAt(line, index) << "\"} ";
         }
         std::cout << std::endl;
-        currentLineFor++;
     }
 }
 
-void Lexer::addToken(TokenType type, const std::string &value)
+void Lexer::addToken(TokenType type, std::string_view value)
 {
-    std::string trimmed = ParsingFunctions::trim(value); // for safety reasons
-    char first = trimmed[0]; if(first-0 < 33) return; // ёбанный компилятор сука
+    std::string_view trimmed = ParsingFunctions::trim(value); // for safety reasons
+    char first = trimmed.empty() ? '\0' : trimmed[0]; if(first-0 < 33) return; // ёбанный компилятор сука
     //IC(trimmed);
-    Token token = {type, trimmed, currentLine, currentIndex};
-    currentTokens.push_back(token);
+    // Имена интернируются сразу: дальше по конвейеру они сравниваются по id
+    Symbol symbol = (type == TokenType::Identifier || type == TokenType::Type) ? Symbol(trimmed) : Symbol();
+    currentTokens.push_back({type, trimmed, currentLine, currentIndex, symbol});
 }
 
-TokenType Lexer::IdentifyTokenType(const char &value) const
+size_t Lexer::bulkRun(size_t position) const
 {
-    if (isalpha(value) || value == '_')
-        return TokenType::Identifier;
-    else if (value == '.')
-    {
-        return TokenType::Dot;
-    }
-    else if (isdigit(value))
-        return TokenType::Number;
-    else if (value == '"')
-        return TokenType::String;
-    else if (value == '+' || value == '-' || value == '*' || value == '%' || value == '/' || value == '^' || value == '=' || value == '!' || value == '<' || value == '>' || value == '?')
-        return TokenType::Operator;
-    else if (value == '(')
-        return TokenType::LeftParen;
-    else if (value == ')')
-        return TokenType::RightParen;
-    else if (value == '[')
-        return TokenType::LeftBracket;
-    else if (value == ']')
-        return TokenType::RightBracket;
-    else if (value == '{')
-        return TokenType::LeftBrace;
-    else if (value == '}')
-        return TokenType::RightBrace;
-    else if (value == ',')
-        return TokenType::Comma;
-    else if (value == ';')
-        return TokenType::Semicolon;
-    else if (value == ':')
-        return TokenType::Colon;
-    else if (value == '|')
-        return TokenType::Pipe;
-
-    // Add more token types as needed
-    return TokenType::Identifier; // Default case, can be changed as needed
+    const char* data = currentLineText.data() + position;
+    size_t size = currentLineText.size() - position;
+    // peek(0) смотрит в currentIndex, который после "i16" уезжает вперёд позиции;
+    // серии, зависящие от peek, безопасны только без этого сдвига
+    bool aligned = currentIndex + 1 == static_cast<int>(position);
+
+    char first = data[0];
+
+    // Первый символ проверяем на месте: короткие токены не должны платить за вызов сканера
+    if (isInMultilineComment)
+        return aligned && first != '*' && first != '/' ? Scanner::findCommentStop(data, size) : 0;
+    if (isStringnotFinished)
+        return first != '"' ? Scanner::findQuote(data, size) : 0;
+    if (currentTokenValue.empty())
+        return first == ' ' ? Scanner::spaceRun(data, size) : 0;
+    if (currentTokenType == TokenType::Identifier)
+        return aligned && (std::isalpha(static_cast<unsigned char>(first)) || first == '_') ? Scanner::identifierRun(data, size) : 0;
+    if (currentTokenType == TokenType::Number)
+        return std::isdigit(static_cast<unsigned char>(first)) ? Scanner::digitRun(data, size) : 0;
+    return 0;
 }
 
-TokenType Lexer::IsKeyword(const std::string &value) const
+void Lexer::startToken(size_t position)
 {
-    std::vector <std::string> keywords = {
-        "if",  // If statement
-        "and", // Logical AND
-        "or", // Logical OR
-        "else",  // Else statement
-        "while",  // While loop
-        "for",  // For loop
-        "return", // Return statement
-        "break", // Break statement
-        "continue", // Continue statement
-        "true", // Boolean true
-        "false", // Boolean false
-        "null", // Null value
-        "use", // Import module
-        "const", // Constant declaration
-        "in", // In operator for iteration
-        "is", // Type check operator
-        "final", // Final keyword for initialization
-        "public", // Public access modifier
-        "private", // Private access modifier
-        "this", // Class access
-        "none", // None value
-        "defined" // Defined keyword
-    }; 
-
-    std::vector<std::string> builtinTypes = {
-        "i1", "i8", "i16","i32", "i64", "string", "void", "array", "map", "float", "struct", "func"
-    };
-
-    std::vector<std::string> labels = {
-        "@strict",
-        "@pure",
-        "@entry",
-        "@public",
-        "@private",
-        "@test"
-    };
-
-    std::string trimmedValue = ParsingFunctions::trim(value);
-
-    if (std::find(keywords.begin(), keywords.end(), trimmedValue) != keywords.end())
-    {
-        return TokenType::Keyword;
-    }
+    currentTokenValue = currentLineText.substr(position, 1);
+}
 
-    if (std::find(labels.begin(), labels.end(), trimmedValue) != labels.end())
+void Lexer::extendToken(size_t position)
+{
+    // Токен всегда растёт подряд идущими символами, так что достаточно сдвинуть конец среза
+    if (currentTokenValue.empty())
     {
-        return TokenType::Label;
+        startToken(position);
+        return;
     }
+    currentTokenValue = std::string_view(currentTokenValue.data(), currentTokenValue.size() + 1);
+}
 
-    if (std::find(builtinTypes.begin(), builtinTypes.end(), trimmedValue) != builtinTypes.end())
-    {
-        return TokenType::Type; // Treat builtin types as keywords
-    }
+TokenType Lexer::IdentifyTokenType(const char &value) const
+{
+    return Classifier::charClass(value); // Таблица на 256 символов, см. Classifier.h
+}
 
-    return TokenType::Identifier; // Default case, can be changed as needed
+TokenType Lexer::IsKeyword(std::string_view value) const
+{
+    // Keyword / Label / Type по совершенному хешу, иначе Identifier
+    return Classifier::word(ParsingFunctions::trim(value));
 }
 
 std::optional<char> Lexer::peek(int offset) const
 {
     //IC(currentIndex, currentLine,offset);
-    if (currentIndex + offset < sourceCode[currentLine-1].length())
+    if (currentIndex + offset < currentLineText.length())
     {
-        return sourceCode[currentLine-1][currentIndex+offset];
+        return currentLineText[currentIndex+offset];
     }
     return NULL;
 }
@@ -379,18 +363,5 @@ std::optional<char> Lexer::peek(int offset) const
 void Lexer::resetValues()
 {
     currentTokenType = TokenType::None; // Reset the current token type for the next token
-    currentTokenValue = ""; // Reset the current token value for the next token
+    currentTokenValue = {}; // Reset the current token value for the next token
 }
-
-void Lexer::removeEmpty()
-{
-    this->allTokens.erase(
-        std::remove_if(
-            this->allTokens.begin(), this->allTokens.end(),
-            [](const std::vector<Token>& token) {return token.empty();}
-        ),
-        this->allTokens.end()
-    );
-    // Сделано так а не .erase(remove(.begin(), .end(), std::vector<Token>()))
-    // Для будущего а то вдруг, хуй знает
-}
\ No newline at end of file
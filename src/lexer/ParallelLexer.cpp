@@ -0,0 +1,124 @@
+#include "headers/ParallelLexer.h"
+#include "headers/Lexer.h"
+#include "../includes/ThreadPool.hpp"
+#include <algorithm>
+#include <exception>
+#include <vector>
+
+namespace
+{
+    constexpr size_t minChunkSize = 256 << 10;
+    constexpr size_t chunksPerThread = 4; // Запас, чтобы потоки не ждали самый медленный кусок
+
+    enum class CommentEdge { None, Opens, Closes };
+
+    struct Chunk {
+        std::string_view text;     // Без завершающего '\n' - его съедает граница
+        int firstLine = 1;
+        CommentEdge edge = CommentEdge::None;
+        bool startsInComment = false;
+        bool endsInComment = false;
+        TokenStream tokens;
+        std::exception_ptr error;
+    };
+
+    // Последний '*' или '/' куска определяет, открыт ли комментарий после него
+    CommentEdge lastCommentEdge(std::string_view text)
+    {
+        size_t stop = text.find_last_of("*/");
+        if (stop == std::string_view::npos)
+            return CommentEdge::None;
+        return text[stop] == '*' && stop > 0 && text[stop - 1] == '/' ? CommentEdge::Opens : CommentEdge::Closes;
+    }
+
+    void lexChunk(Chunk& chunk)
+    {
+        Lexer lexer(chunk.text, chunk.firstLine, chunk.startsInComment);
+        lexer.tokenize();
+        chunk.endsInComment = lexer.endsInComment();
+        chunk.tokens = lexer.takeTokens();
+    }
+
+    std::vector<Chunk> splitIntoChunks(std::string_view source, size_t count)
+    {
+        std::vector<Chunk> chunks;
+        size_t start = 0;
+        for (size_t i = 1; i < count; i++)
+        {
+            size_t target = source.size() / count * i;
+            if (target < start)
+                continue;
+            size_t newline = source.find('\n', target);
+            if (newline == std::string_view::npos)
+                break;
+            chunks.push_back({source.substr(start, newline - start)});
+            start = newline + 1;
+        }
+        chunks.push_back({source.substr(start)}); // Последний кусок идёт до конца, как и в Lexer::tokenize
+        return chunks;
+    }
+}
+
+namespace ParallelLexer
+{
+    TokenStream tokenize(std::string_view sourceCode, size_t maxThreads)
+    {
+        ThreadPool& pool = ThreadPool::getInstance();
+        size_t threads = maxThreads == 0 ? pool.size() : std::min(maxThreads, pool.size());
+
+        if (threads <= 1 || sourceCode.size() < minParallelSize)
+        {
+            Lexer lexer(sourceCode);
+            lexer.tokenize();
+            return lexer.takeTokens();
+        }
+
+        size_t chunkCount = std::min(threads * chunksPerThread, sourceCode.size() / minChunkSize);
+        std::vector<Chunk> chunks = splitIntoChunks(sourceCode, std::max<size_t>(chunkCount, 1));
+
+        // 1. Предскан: число строк и граница комментария в каждом куске
+        std::vector<int> newlines(chunks.size());
+        pool.parallelFor(chunks.size(), [&](size_t i) {
+            newlines[i] = static_cast<int>(std::count(chunks[i].text.begin(), chunks[i].text.end(), '\n'));
+            chunks[i].edge = lastCommentEdge(chunks[i].text);
+        }, threads);
+
+        for (size_t i = 1; i < chunks.size(); i++)
+        {
+            const Chunk& previous = chunks[i - 1];
+            chunks[i].firstLine = previous.firstLine + newlines[i - 1] + 1;
+            chunks[i].startsInComment = previous.edge == CommentEdge::None ? previous.startsInComment : previous.edge == CommentEdge::Opens;
+        }
+
+        // 2. Параллельный проход с предсказанным состоянием; ошибки придерживаем до проверки
+        pool.parallelFor(chunks.size(), [&](size_t i) {
+            try { lexChunk(chunks[i]); }
+            catch (...) { chunks[i].error = std::current_exception(); }
+        }, threads);
+
+        // 3. Проверка границ по порядку: первая настоящая ошибка - та же, что бросил бы Lexer
+        bool inComment = false;
+        size_t totalTokens = 0, totalLines = 0;
+        for (auto& chunk : chunks)
+        {
+            if (chunk.startsInComment != inComment)
+            {
+                chunk.startsInComment = inComment;
+                chunk.error = nullptr;
+                lexChunk(chunk);
+            }
+            else if (chunk.error)
+                std::rethrow_exception(chunk.error);
+
+            inComment = chunk.endsInComment;
+            totalTokens += chunk.tokens.size();
+            totalLines += chunk.tokens.lineCount();
+        }
+
+        TokenStream tokens = std::move(chunks[0].tokens);
+        tokens.reserve(totalTokens, totalLines);
+        for (size_t i = 1; i < chunks.size(); i++)
+            tokens.append(chunks[i].tokens);
+        return tokens;
+    }
+}
@@ -25,4 +25,15 @@ namespace ParsingFunctions
         size_t last = str.find_last_not_of(whitespace);
         return str.substr(first, (last - first + 1));
     }
+
+    std::string_view trim(std::string_view str)
+    {
+        const std::string_view whitespace = " \t\n\r\v\f";
+
+        size_t first = str.find_first_not_of(whitespace);
+        if (first == std::string_view::npos) return {}; // No content
+
+        size_t last = str.find_last_not_of(whitespace);
+        return str.substr(first, (last - first + 1));
+    }
 }
\ No newline at end of file
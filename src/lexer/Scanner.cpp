@@ -0,0 +1,174 @@
+#include "headers/Scanner.h"
+#include <cstdlib>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define MS_SCANNER_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    // --- Предикаты: скалярная проверка и маски для SSE2/AVX2 ---
+    // Маска - 0xFF в байтах, которые продолжают серию.
+
+    struct WordChars {
+        static bool scalar(unsigned char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_'; }
+#ifdef MS_SCANNER_SIMD
+        // (c | 0x20) сводит A-Z к a-z; байты >= 0x80 отрицательны и в диапазон не попадают
+        static __m128i sse2(__m128i v) {
+            __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+            __m128i letter = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(lower, _mm_set1_epi8('z' + 1)));
+            return _mm_or_si128(letter, _mm_cmpeq_epi8(v, _mm_set1_epi8('_')));
+        }
+        __attribute__((target("avx2"))) static __m256i avx2(__m256i v) {
+            __m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+            __m256i letter = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), lower));
+            return _mm256_or_si256(letter, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_')));
+        }
+#endif
+    };
+
+    struct DigitChars {
+        static bool scalar(unsigned char c) { return c >= '0' && c <= '9'; }
+#ifdef MS_SCANNER_SIMD
+        static __m128i sse2(__m128i v) {
+            return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('9' + 1)));
+        }
+        __attribute__((target("avx2"))) static __m256i avx2(__m256i v) {
+            return _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), v));
+        }
+#endif
+    };
+
+    struct SpaceChars {
+        static bool scalar(unsigned char c) { return c == ' '; }
+#ifdef MS_SCANNER_SIMD
+        static __m128i sse2(__m128i v) { return _mm_cmpeq_epi8(v, _mm_set1_epi8(' ')); }
+        __attribute__((target("avx2"))) static __m256i avx2(__m256i v) { return _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')); }
+#endif
+    };
+
+    struct NotCommentStop {
+        static bool scalar(unsigned char c) { return c != '*' && c != '/'; }
+#ifdef MS_SCANNER_SIMD
+        static __m128i sse2(__m128i v) {
+            __m128i stop = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('*')), _mm_cmpeq_epi8(v, _mm_set1_epi8('/')));
+            return _mm_xor_si128(stop, _mm_set1_epi8(-1));
+        }
+        __attribute__((target("avx2"))) static __m256i avx2(__m256i v) {
+            __m256i stop = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('*')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('/')));
+            return _mm256_xor_si256(stop, _mm256_set1_epi8(-1));
+        }
+#endif
+    };
+
+    struct NotQuote {
+        static bool scalar(unsigned char c) { return c != '"'; }
+#ifdef MS_SCANNER_SIMD
+        static __m128i sse2(__m128i v) { return _mm_xor_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')), _mm_set1_epi8(-1)); }
+        __attribute__((target("avx2"))) static __m256i avx2(__m256i v) { return _mm256_xor_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')), _mm256_set1_epi8(-1)); }
+#endif
+    };
+
+    // --- Реализации серии: длина префикса, на котором Match выполняется ---
+
+    template <typename Match>
+    size_t scalarRun(const char* data, size_t size, size_t from = 0)
+    {
+        size_t i = from;
+        while (i < size && Match::scalar(static_cast<unsigned char>(data[i])))
+            i++;
+        return i;
+    }
+
+#ifdef MS_SCANNER_SIMD
+    template <typename Match>
+    size_t sse2Run(const char* data, size_t size)
+    {
+        size_t i = 0;
+        for (; i + 16 <= size; i += 16)
+        {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(Match::sse2(chunk)));
+            if (mask != 0xFFFFu)
+                return i + __builtin_ctz(~mask);
+        }
+        return scalarRun<Match>(data, size, i); // Хвост короче вектора
+    }
+
+    template <typename Match>
+    __attribute__((target("avx2"))) size_t avx2Run(const char* data, size_t size)
+    {
+        size_t i = 0;
+        for (; i + 32 <= size; i += 32)
+        {
+            __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(Match::avx2(chunk)));
+            if (mask != 0xFFFFFFFFu)
+                return i + __builtin_ctz(~mask);
+        }
+        // GCC не всегда ставит vzeroupper перед вызовом не-VEX кода, а без него
+        // SSE-хвост и весь вызывающий лексер платят за смену состояния AVX
+        _mm256_zeroupper();
+        return i + sse2Run<Match>(data + i, size - i); // Хвост короче вектора
+    }
+#endif
+
+    using RunFunction = size_t (*)(const char*, size_t);
+
+    struct Backend {
+        const char* name;
+        RunFunction identifierRun;
+        RunFunction digitRun;
+        RunFunction spaceRun;
+        RunFunction findCommentStop;
+        RunFunction findQuote;
+    };
+
+    template <template <typename> class Run>
+    constexpr Backend makeBackend(const char* name)
+    {
+        return {name, Run<WordChars>::call, Run<DigitChars>::call, Run<SpaceChars>::call,
+                Run<NotCommentStop>::call, Run<NotQuote>::call};
+    }
+
+    template <typename Match> struct ScalarRun { static size_t call(const char* d, size_t s) { return scalarRun<Match>(d, s); } };
+#ifdef MS_SCANNER_SIMD
+    template <typename Match> struct Sse2Run { static size_t call(const char* d, size_t s) { return sse2Run<Match>(d, s); } };
+    template <typename Match> struct Avx2Run { static size_t call(const char* d, size_t s) { return avx2Run<Match>(d, s); } };
+#endif
+
+    Backend selectBackend()
+    {
+        const char* forced = std::getenv("MS_SCANNER");
+        if (forced && std::strcmp(forced, "scalar") == 0)
+            return makeBackend<ScalarRun>("scalar");
+#ifdef MS_SCANNER_SIMD
+        __builtin_cpu_init();
+        bool forceSse2 = forced && std::strcmp(forced, "sse2") == 0;
+        if (!forceSse2 && __builtin_cpu_supports("avx2"))
+            return makeBackend<Avx2Run>("avx2");
+        return makeBackend<Sse2Run>("sse2");
+#else
+        return makeBackend<ScalarRun>("scalar");
+#endif
+    }
+
+    const Backend& backend()
+    {
+        static const Backend selected = selectBackend(); // Выбирается один раз
+        return selected;
+    }
+}
+
+namespace Scanner
+{
+    size_t identifierRun(const char* data, size_t size) { return backend().identifierRun(data, size); }
+    size_t digitRun(const char* data, size_t size) { return backend().digitRun(data, size); }
+    size_t spaceRun(const char* data, size_t size) { return backend().spaceRun(data, size); }
+    size_t findCommentStop(const char* data, size_t size) { return backend().findCommentStop(data, size); }
+    size_t findQuote(const char* data, size_t size) { return backend().findQuote(data, size); }
+
+    const char* backendName() { return backend().name; }
+}
@@ -0,0 +1,62 @@
+#include "headers/TokenStream.h"
+
+void TokenStream::appendLine(const std::vector<Token>& lineTokens)
+{
+    if (lineTokens.empty())
+        return;
+
+    for (const auto& token : lineTokens)
+    {
+        types.push_back(token.type);
+        spans.push_back(token.value);
+        lines.push_back(token.line);
+        columns.push_back(token.column);
+        symbols.push_back(token.symbol);
+    }
+    lineStarts.push_back(static_cast<uint32_t>(types.size()));
+}
+
+void TokenStream::append(const TokenStream& next)
+{
+    uint32_t offset = static_cast<uint32_t>(types.size());
+
+    types.insert(types.end(), next.types.begin(), next.types.end());
+    spans.insert(spans.end(), next.spans.begin(), next.spans.end());
+    lines.insert(lines.end(), next.lines.begin(), next.lines.end());
+    columns.insert(columns.end(), next.columns.begin(), next.columns.end());
+    symbols.insert(symbols.end(), next.symbols.begin(), next.symbols.end());
+
+    for (size_t line = 1; line < next.lineStarts.size(); line++)
+        lineStarts.push_back(next.lineStarts[line] + offset);
+}
+
+void TokenStream::reserve(size_t tokenCount, size_t lineCount)
+{
+    types.reserve(tokenCount);
+    spans.reserve(tokenCount);
+    lines.reserve(tokenCount);
+    columns.reserve(tokenCount);
+    symbols.reserve(tokenCount);
+    lineStarts.reserve(lineCount + 1);
+}
+
+void TokenStream::clear()
+{
+    types.clear();
+    spans.clear();
+    lines.clear();
+    columns.clear();
+    symbols.clear();
+    lineStarts.assign(1, 0);
+}
+
+std::string TokenStream::lineText(size_t line) const
+{
+    std::string text;
+    for (uint32_t i = lineStarts[line]; i < lineStarts[line + 1]; i++)
+    {
+        text += spans[i];
+        text += ' ';
+    }
+    return text;
+}
@@ -0,0 +1,137 @@
+#ifndef CLASSIFIER_H
+#define CLASSIFIER_H
+
+#include <array>
+#include <string_view>
+#include "Token.h"
+
+// Таблицы классификации лексера. Всё считается на этапе компиляции:
+// во время токенизации ни аллокаций, ни линейного поиска.
+namespace Classifier
+{
+    // --- Классы символов ---
+
+    constexpr std::array<TokenType, 256> buildCharClassTable()
+    {
+        std::array<TokenType, 256> table{};
+        for (auto& entry : table)
+            entry = TokenType::Identifier; // Всё неизвестное (в т.ч. '@', '\t', '\r', UTF-8) идёт в идентификатор
+
+        for (unsigned char c = '0'; c <= '9'; c++)
+            table[c] = TokenType::Number;
+
+        table['.'] = TokenType::Dot;
+        table['"'] = TokenType::String;
+        for (unsigned char c : std::string_view("+-*%/^=!<>?"))
+            table[c] = TokenType::Operator;
+
+        table['('] = TokenType::LeftParen;
+        table[')'] = TokenType::RightParen;
+        table['['] = TokenType::LeftBracket;
+        table[']'] = TokenType::RightBracket;
+        table['{'] = TokenType::LeftBrace;
+        table['}'] = TokenType::RightBrace;
+        table[','] = TokenType::Comma;
+        table[';'] = TokenType::Semicolon;
+        table[':'] = TokenType::Colon;
+        table['|'] = TokenType::Pipe;
+        return table;
+    }
+
+    inline constexpr std::array<TokenType, 256> charClassTable = buildCharClassTable();
+
+    constexpr TokenType charClass(char value)
+    {
+        return charClassTable[static_cast<unsigned char>(value)];
+    }
+
+    // --- Ключевые слова, встроенные типы и метки ---
+
+    struct WordEntry {
+        std::string_view word;
+        TokenType type;
+    };
+
+    inline constexpr WordEntry words[] = {
+        {"if", TokenType::Keyword},  // If statement
+        {"and", TokenType::Keyword}, // Logical AND
+        {"or", TokenType::Keyword}, // Logical OR
+        {"else", TokenType::Keyword},  // Else statement
+        {"while", TokenType::Keyword},  // While loop
+        {"for", TokenType::Keyword},  // For loop
+        {"return", TokenType::Keyword}, // Return statement
+        {"break", TokenType::Keyword}, // Break statement
+        {"continue", TokenType::Keyword}, // Continue statement
+        {"true", TokenType::Keyword}, // Boolean true
+        {"false", TokenType::Keyword}, // Boolean false
+        {"null", TokenType::Keyword}, // Null value
+        {"use", TokenType::Keyword}, // Import module
+        {"const", TokenType::Keyword}, // Constant declaration
+        {"in", TokenType::Keyword}, // In operator for iteration
+        {"is", TokenType::Keyword}, // Type check operator
+        {"final", TokenType::Keyword}, // Final keyword for initialization
+        {"public", TokenType::Keyword}, // Public access modifier
+        {"private", TokenType::Keyword}, // Private access modifier
+        {"this", TokenType::Keyword}, // Class access
+        {"none", TokenType::Keyword}, // None value
+        {"defined", TokenType::Keyword}, // Defined keyword
+
+        {"i1", TokenType::Type}, {"i8", TokenType::Type}, {"i16", TokenType::Type}, {"i32", TokenType::Type},
+        {"i64", TokenType::Type}, {"string", TokenType::Type}, {"void", TokenType::Type}, {"array", TokenType::Type},
+        {"map", TokenType::Type}, {"float", TokenType::Type}, {"struct", TokenType::Type}, {"func", TokenType::Type},
+
+        {"@strict", TokenType::Label},
+        {"@pure", TokenType::Label},
+        {"@entry", TokenType::Label},
+        {"@public", TokenType::Label},
+        {"@private", TokenType::Label},
+        {"@test", TokenType::Label},
+    };
+
+    inline constexpr size_t wordTableSize = 128;
+    inline constexpr size_t minWordLength = 2;
+    inline constexpr size_t maxWordLength = 8;
+
+    // Совершенный хеш по длине, второму и последнему символу.
+    // Коэффициенты подобраны под таблицу выше; если добавить слово и получить коллизию,
+    // buildWordTable() не соберётся в constexpr и компиляция упадёт.
+    constexpr size_t wordHash(std::string_view word)
+    {
+        return (word.size() * 4
+              + static_cast<unsigned char>(word[1]) * 3
+              + static_cast<unsigned char>(word[word.size() - 1]) * 21) % wordTableSize;
+    }
+
+    constexpr std::array<WordEntry, wordTableSize> buildWordTable()
+    {
+        std::array<WordEntry, wordTableSize> table{};
+        for (auto& entry : table)
+            entry = {std::string_view(), TokenType::Identifier};
+
+        for (const auto& entry : words)
+        {
+            if (entry.word.size() < minWordLength || entry.word.size() > maxWordLength)
+                throw "Classifier: word length is out of range";
+
+            auto& slot = table[wordHash(entry.word)];
+            if (!slot.word.empty())
+                throw "Classifier: perfect hash collision, pick new wordHash coefficients";
+            slot = entry;
+        }
+        return table;
+    }
+
+    inline constexpr std::array<WordEntry, wordTableSize> wordTable = buildWordTable();
+
+    // Keyword / Type / Label, иначе Identifier
+    constexpr TokenType word(std::string_view value)
+    {
+        if (value.size() < minWordLength || value.size() > maxWordLength)
+            return TokenType::Identifier;
+
+        const auto& slot = wordTable[wordHash(value)];
+        return slot.word == value ? slot.type : TokenType::Identifier;
+    }
+}
+
+#endif // CLASSIFIER_H
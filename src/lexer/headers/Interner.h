@@ -0,0 +1,108 @@
+#ifndef INTERNER_H
+#define INTERNER_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/*
+Глобальный интернер имён.
+Каждое имя (идентификатор, имя функции, тип) хранится в одном экземпляре
+и получает плотный 32-битный id. Id 0 зарезервирован под пустую строку.
+
+    Symbol a = "main";      // интернирует "main"
+    Symbol b = token.value; // тот же id, что и у a
+    a == b;                 // сравнение id, без сравнения строк
+
+Строки не удаляются до конца работы компилятора, поэтому ссылки из str() стабильны.
+intern() потокобезопасен: таблица разбита на шарды со своими мьютексами, чтобы
+параллельный лексер не упирался в одну блокировку. Чтение по id блокировок не берёт.
+*/
+class Interner
+{
+public:
+    Interner(const Interner&) = delete;
+    Interner& operator=(const Interner&) = delete;
+
+    static Interner& getInstance() {
+        static Interner instance;
+        return instance;
+    }
+
+    uint32_t intern(std::string_view text);
+    const std::string& lookup(uint32_t id) const;
+    size_t size() const { return count.load(std::memory_order_relaxed); }
+
+private:
+    Interner();
+
+    // Строки живут в страницах фиксированного размера: страницы не переезжают,
+    // поэтому lookup() может читать их без блокировки, пока intern() дописывает новые.
+    static constexpr uint32_t pageBits = 12;
+    static constexpr uint32_t pageSize = 1u << pageBits;
+    static constexpr uint32_t maxPages = 1u << 16;
+    static constexpr size_t shardCount = 64;
+
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_map<std::string_view, uint32_t> ids; // Вьюхи смотрят в строки страниц
+    };
+
+    std::unique_ptr<std::atomic<std::string*>[]> pages;
+    std::unique_ptr<Shard[]> shards;
+    std::atomic<uint32_t> count;
+    std::mutex pagesMutex; // Только для выделения новой страницы
+};
+
+// Интернированное имя: 4 байта вместо std::string, сравнение и хеш - по id
+class Symbol
+{
+public:
+    Symbol() : id(0) {}
+    Symbol(std::string_view text) : id(Interner::getInstance().intern(text)) {}
+    Symbol(const std::string& text) : Symbol(std::string_view(text)) {}
+    Symbol(const char* text) : Symbol(std::string_view(text)) {}
+
+    static Symbol fromId(uint32_t id) { Symbol symbol; symbol.id = id; return symbol; }
+
+    uint32_t getId() const { return id; }
+    const std::string& str() const { return Interner::getInstance().lookup(id); }
+    operator const std::string&() const { return str(); }
+
+    bool empty() const { return id == 0; }
+    size_t size() const { return str().size(); }
+    size_t length() const { return str().size(); }
+    const char* c_str() const { return str().c_str(); }
+
+    friend bool operator==(Symbol left, Symbol right) { return left.id == right.id; }
+    friend bool operator!=(Symbol left, Symbol right) { return left.id != right.id; }
+    friend bool operator==(Symbol left, std::string_view right) { return left.str() == right; }
+    friend bool operator!=(Symbol left, std::string_view right) { return left.str() != right; }
+    friend bool operator==(Symbol left, const std::string& right) { return left.str() == right; }
+    friend bool operator!=(Symbol left, const std::string& right) { return left.str() != right; }
+    friend bool operator==(Symbol left, const char* right) { return left.str() == right; }
+    friend bool operator!=(Symbol left, const char* right) { return left.str() != right; }
+    friend bool operator<(Symbol left, Symbol right) { return left.str() < right.str(); }
+
+    friend std::string operator+(const std::string& left, Symbol right) { return left + right.str(); }
+    friend std::string operator+(const char* left, Symbol right) { return left + right.str(); }
+    friend std::string operator+(Symbol left, const std::string& right) { return left.str() + right; }
+    friend std::string operator+(Symbol left, const char* right) { return left.str() + right; }
+    friend std::ostream& operator<<(std::ostream& stream, Symbol symbol) { return stream << symbol.str(); }
+
+private:
+    uint32_t id;
+};
+
+template <>
+struct std::hash<Symbol> {
+    size_t operator()(Symbol symbol) const noexcept { return std::hash<uint32_t>()(symbol.getId()); }
+};
+
+#endif // INTERNER_H
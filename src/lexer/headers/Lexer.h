@@ -3,21 +3,30 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <cctype>
 #include <algorithm>
 #include <optional>
 #include "Token.h"
+#include "TokenStream.h"
+#include "Classifier.h"
+#include "Scanner.h"
 #include "ParsingFunctions.h"
 #include "../../includes/icecream.hpp"
 
 class Lexer
 {
 public:
-    Lexer(const std::string& sourceCode);
+    // Лексер не копирует исходник: буфер должен жить дольше лексера и его токенов.
+    // firstLine и startsInComment нужны, когда sourceCode - кусок файла (см. ParallelLexer.h)
+    Lexer(std::string_view sourceCode, int firstLine = 1, bool startsInComment = false);
     void tokenize();
     void printTokens();
-    const std::vector<std::vector<Token>>& getTokens() const; // Returns a vector of vectors of tokens
+    static void printTokens(const TokenStream& tokens);
+    bool endsInComment() const { return isInMultilineComment; } // Единственное состояние, переходящее между строками
+    const TokenStream& getTokens() const; // Returns the flat token stream, one entry per non-empty line
+    TokenStream takeTokens(); // Moves the stream out; spans still point into the source buffer
     /* Token Vector:
     "i ^= 4"
     → 
@@ -40,30 +49,34 @@ public:
         {RightParen, ")"}
     ]
 
-    And then the lexer will return a vector of these vectors, where each vector represents a line of code.
-    For example, if the input code has 3 lines, the lexer will return a vector of 3 vectors of tokens.
+    And then the lexer will store these lines one after another in a flat TokenStream,
+    remembering where each line starts. For example, if the input code has 3 lines,
+    the stream will have 3 lines of tokens.
     Then all this will be passed to the parser, which will parse each line separately.
     */
     
 private:
-    std::vector<std::string> sourceCode;
-    std::vector<Token> currentTokens;
-    std::vector<std::vector<Token>> allTokens; // Vector of vectors to store tokens for each line
-    std::vector<char> firstLettersInBuiltTypes;
+    std::string_view sourceCode;
+    std::string_view currentLineText; // Текущая строка - срез sourceCode без '\n'
+    std::vector<Token> currentTokens; // Токены текущей строки, переиспользуется между строками
+    TokenStream tokens; // Все токены модуля
     int currentLine;
     int currentIndex;
     TokenType currentTokenType;
-    std::string currentTokenValue;
+    std::string_view currentTokenValue; // Срез currentLineText, растёт вместе с токеном
     bool isStringnotFinished = false;
     bool isInMultilineComment = false;
     bool isInMultilineExpression = false;
 
-    void addToken(TokenType type, const std::string& value);
+    void tokenizeLine();
+    size_t bulkRun(size_t position) const;
+    void addToken(TokenType type, std::string_view value);
+    void startToken(size_t position);
+    void extendToken(size_t position);
     TokenType IdentifyTokenType(const char& value) const;
-    TokenType IsKeyword(const std::string& value) const;
+    TokenType IsKeyword(std::string_view value) const;
     std::optional<char> peek(int offset) const;
     void resetValues();
-    void removeEmpty();
 };
 
 #endif // LEXER_H
\ No newline at end of file
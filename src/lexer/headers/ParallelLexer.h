@@ -0,0 +1,32 @@
+#ifndef PARALLELLEXER_H
+#define PARALLELLEXER_H
+
+#include <cstddef>
+#include <string_view>
+#include "TokenStream.h"
+
+/*
+Параллельная токенизация больших файлов.
+Лексер работает построчно, и между строками переходит только isInMultilineComment
+(незакрытая строка - это ошибка в пределах строки). Поэтому файл режется по '\n' на куски,
+куски лексятся на пуле потоков, а состояние на границах восстанавливается так:
+
+    1. Предскан: в каждом куске ищется последний '*' или '/' - он решает, открыт ли
+       комментарий в конце куска (открывающая скобка комментария - открыт, любой другой - закрыт, нет - как в начале).
+    2. Куски лексятся параллельно с состоянием, которое предсказал предскан.
+    3. Проверка по порядку: если настоящее состояние на границе (из лексера предыдущего
+       куска) не совпало с предсказанным, кусок перелексируется. Предскан не видит строк и
+       "//", так что это возможно, но редко.
+
+Результат совпадает с Lexer::tokenize() токен в токен, включая номера строк и ошибки.
+*/
+namespace ParallelLexer
+{
+    // Файлы меньше этого размера лексятся последовательно: потоки не окупятся
+    constexpr size_t minParallelSize = 1 << 20;
+
+    // maxThreads = 0 - весь пул (см. ThreadPool.hpp)
+    TokenStream tokenize(std::string_view sourceCode, size_t maxThreads = 0);
+}
+
+#endif // PARALLELLEXER_H
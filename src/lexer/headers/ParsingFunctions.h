@@ -1,6 +1,7 @@
 #ifndef PARSINGFUNCTIONS_H
 #define PARSINGFUNCTIONS_H
 #include <string>
+#include <string_view>
 #include <vector>
 #include <regex>
 
@@ -8,6 +9,7 @@ namespace ParsingFunctions
 {
     std::vector<std::string> split(const std::string str, const std::string regex_str);
     std::string trim(const std::string& str);
+    std::string_view trim(std::string_view str);
 }
 
 #endif // PARSINGFUNCTIONS_H
\ No newline at end of file
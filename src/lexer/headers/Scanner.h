@@ -0,0 +1,27 @@
+#ifndef SCANNER_H
+#define SCANNER_H
+
+#include <cstddef>
+
+// Поиск серий однотипных символов для лексера.
+// На x86 используется AVX2 или SSE2 (выбирается один раз во время выполнения),
+// на остальных платформах - скалярная версия. Переменная окружения
+// MS_SCANNER=scalar|sse2|avx2 принудительно выбирает реализацию (для отладки).
+namespace Scanner
+{
+    // Длина префикса из [A-Za-z_]
+    size_t identifierRun(const char* data, size_t size);
+    // Длина префикса из [0-9]
+    size_t digitRun(const char* data, size_t size);
+    // Длина префикса из пробелов
+    size_t spaceRun(const char* data, size_t size);
+    // Индекс первого '*' или '/' (возможный конец блочного комментария), иначе size
+    size_t findCommentStop(const char* data, size_t size);
+    // Индекс первой '"' (возможный конец строки), иначе size
+    size_t findQuote(const char* data, size_t size);
+
+    // Имя выбранной реализации: "avx2", "sse2" или "scalar"
+    const char* backendName();
+}
+
+#endif // SCANNER_H
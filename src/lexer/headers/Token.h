@@ -2,6 +2,8 @@
 #define TOKEN_H
 
 #include <string>
+#include <string_view>
+#include "Interner.h"
 enum class TokenType { 
     None,                   // none - это не токен, а просто значение по умолчанию
     Identifier,             // identifier - имя переменной или функции
@@ -26,10 +28,16 @@ enum class TokenType {
     Label
 };
 
+// Число типов токенов - для таблиц, индексируемых TokenType
+constexpr size_t tokenTypeCount = static_cast<size_t>(TokenType::Label) + 1;
+
+// Невладеющий токен: value смотрит прямо в буфер исходника (или в статический литерал),
+// строка на каждый токен не выделяется. Буфер должен жить дольше токенов.
 struct Token {
     TokenType type;
-    std::string value;
+    std::string_view value;
     int line, column;
+    Symbol symbol = {}; // Интернированное имя для Identifier и Type, иначе пустой символ
 };
 
 inline std::string TokenTypeToString(TokenType type)
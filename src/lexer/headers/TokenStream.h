@@ -0,0 +1,59 @@
+#ifndef TOKENSTREAM_H
+#define TOKENSTREAM_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Token.h"
+
+/*
+Плоский поток токенов одного модуля (struct-of-arrays).
+Вместо std::vector<std::vector<Token>> все токены лежат подряд в параллельных массивах,
+а lineStarts хранит индекс первого токена каждой непустой строки:
+
+    "i32 x = 1"          types:      [Type, Identifier, Operator, Number, Pipe, Keyword, Identifier]
+    "| return x"   →     spans:      ["i32", "x", "=", "1", "|", "return", "x"]
+                         lineStarts: [0, 4, 7]
+
+Спаны смотрят в буфер исходника, поэтому буфер должен жить дольше потока.
+Лексер заполняет поток, а парсер, линкер и ErrorEngine читают его по ссылке.
+*/
+class TokenStream
+{
+public:
+    TokenStream() : lineStarts{0} {}
+
+    // Добавляет строку токенов (пустые строки пропускаются, как и раньше в Lexer::removeEmpty)
+    void appendLine(const std::vector<Token>& lineTokens);
+    // Дописывает поток следующего куска того же файла (номера строк в нём уже сквозные)
+    void append(const TokenStream& next);
+    void reserve(size_t tokenCount, size_t lineCount);
+    void clear();
+
+    size_t lineCount() const { return lineStarts.size() - 1; }
+    size_t lineSize(size_t line) const { return lineStarts[line + 1] - lineStarts[line]; }
+    size_t size() const { return types.size(); }
+
+    // Доступ по (строка, индекс в строке) - без аллокаций, Token это пара указатель+длина и пара int
+    Token at(size_t line, size_t index) const
+    {
+        size_t i = lineStarts[line] + index;
+        return Token{types[i], spans[i], lines[i], columns[i], symbols[i]};
+    }
+    TokenType typeAt(size_t line, size_t index) const { return types[lineStarts[line] + index]; }
+    std::string_view valueAt(size_t line, size_t index) const { return spans[lineStarts[line] + index]; }
+    Symbol symbolAt(size_t line, size_t index) const { return symbols[lineStarts[line] + index]; }
+
+    // Строка, восстановленная из токенов ("a = 1 "), для диагностики
+    std::string lineText(size_t line) const;
+
+    std::vector<TokenType>      types;      // Тип токена
+    std::vector<std::string_view> spans;    // Текст токена в буфере исходника
+    std::vector<int>            lines;      // Номер строки в исходнике (с 1)
+    std::vector<int>            columns;    // Колонка, как её считает лексер
+    std::vector<Symbol>         symbols;    // Интернированное имя (Identifier, Type), иначе пустой символ
+    std::vector<uint32_t>       lineStarts; // Индекс первого токена каждой строки + замыкающий size()
+};
+
+#endif // TOKENSTREAM_H
@@ -1,22 +1,50 @@
 #include "headers/Linker.h"
-#include "../parser/headers/Parser.h" 
+#include "../parser/headers/ASTCache.h"
+#include "../parser/headers/Parser.h"
+#include "../lexer/headers/ParallelLexer.h"
 #include "../includes/ASTDebugger.hpp"
+#include "../includes/ThreadPool.hpp"
+#include "../loader/headers/ModuleResolver.h"
+#include "headers/ModuleSummaries.h"
+#include <algorithm>
+#include <cstdio>
 #include <fstream>
 #include <filesystem>
+#include <functional>
 #include <iostream>
+#include <unordered_set>
 
-Linker::Linker(const std::string& stdLibPath) : stdLibPath(stdLibPath) {}
+Linker::Linker(const std::string& stdLibPath, size_t maxThreads) : stdLibPath(stdLibPath), maxThreads(maxThreads) {}
 
-bool Linker::addModule(const std::string& name, const std::string& path, std::shared_ptr<ProgramNode> ast) {
-    if (modules.find(name) != modules.end()) {
-        std::cerr << "Error: Module with name " << name << " already exists" << std::endl;
-        return false;
+bool Linker::addModule(const std::string& name, const std::string& path, NodePtr<ProgramNode> ast, std::shared_ptr<const TokenStream> tokens, std::string_view source) {
+    uint64_t contentHash = source.empty() ? 0 : ASTCache::hash(source);
+
+    // Тот же файл при повторной линковке: неизменённый остаётся как есть, изменённый заменяется
+    uint64_t interfaceHash = 0;
+    std::vector<SymbolId> exports;
+    if (auto existing = modules.find(name); existing != modules.end()) {
+        if (existing->second.path != path) {
+            std::cerr << "Error: Module with name " << name << " already exists" << std::endl;
+            return false;
+        }
+        if (contentHash != 0 && existing->second.contentHash == contentHash && !existing->second.summary && !changedOnDisk()) {
+            existing->second.root = true;
+            return true;
+        }
+        // Для сравнения после нового сбора символов и чистки индекса
+        interfaceHash = existing->second.interfaceHash;
+        exports = std::move(existing->second.exports);
     }
     
     ModuleContext module;
     module.name = name;
     module.path = path;
     module.ast = ast;
+    module.tokens = tokens;
+    module.contentHash = contentHash;
+    module.interfaceHash = interfaceHash;
+    module.exports = std::move(exports);
+    module.root = true;
     
     modules[name] = module;
     return true;
@@ -24,20 +52,29 @@ bool Linker::addModule(const std::string& name, const std::string& path, std::sh
 
 void Linker::collectModuleInfo(ModuleContext& module) {
     if (module.processed) return;
+    module.functions.clear();
+    module.globals.clear();
+    module.structs.clear();
     
     // Проходимся по AST модуля и собираем информацию
     for (auto& node : module.ast->body) {
+        if (!node) continue;
+
+        switch (node->kind) {
         // Глобальные переменные
-        if (auto varNode = std::dynamic_pointer_cast<VariableAssignNode>(node)) {
+        case NodeKind::VariableAssign: {
+            auto varNode = cast<VariableAssignNode>(node);
             VariableInfo info;
             info.node = varNode;
             info.type = varNode->type->toString();
             info.isConst = varNode->isConst;
             info.defined = true;
             module.globals[varNode->name] = info;
+            break;
         }
         // Функции
-        else if (auto funcNode = std::dynamic_pointer_cast<FunctionNode>(node)) {
+        case NodeKind::Function: {
+            auto funcNode = cast<FunctionNode>(node);
             FunctionInfo info;
             info.node = funcNode;
             info.returnType = funcNode->returnType->toString();
@@ -48,24 +85,83 @@ void Linker::collectModuleInfo(ModuleContext& module) {
             
             info.defined = true;
             module.functions[funcNode->name] = info;
+            break;
         }
         // Структуры
-        else if (auto structNode = std::dynamic_pointer_cast<StructNode>(node)) {
+        case NodeKind::Struct: {
+            auto structNode = cast<StructNode>(node);
             StructInfo info;
             info.node = structNode;
             info.defined = true;
             module.structs[structNode->name] = info;
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    // Символы - в индекс; те, что пропали из модуля при повторном сборе, - из индекса
+    std::vector<SymbolId> previous = std::move(module.exports);
+    module.exports.clear();
+    for (const auto& [name, info] : module.functions) {
+        module.exports.push_back(registerSymbol(SymbolInfo::Type::FUNCTION, module.name, name));
+    }
+    for (const auto& [name, info] : module.globals) {
+        module.exports.push_back(registerSymbol(SymbolInfo::Type::VARIABLE, module.name, name));
+    }
+    for (const auto& [name, info] : module.structs) {
+        module.exports.push_back(registerSymbol(SymbolInfo::Type::STRUCT, module.name, name));
+    }
+    std::sort(module.exports.begin(), module.exports.end());
+    for (SymbolId id : previous) {
+        if (!std::binary_search(module.exports.begin(), module.exports.end(), id)) {
+            symbolIndex.erase(symbolKey(symbols[id].moduleName, symbols[id].name));
+        }
+    }
+
+    // Интерфейс - то, что видят импортирующие модули; порядок строк не должен зависеть от хеш-таблиц
+    std::vector<std::string> exported;
+    for (const auto& [name, info] : module.functions) {
+        std::string line = "f " + name + " " + info.returnType;
+        for (const auto& [type, param] : info.params) {
+            line += " " + type + ":" + param;
         }
+        exported.push_back(line);
+    }
+    for (const auto& [name, info] : module.globals) {
+        exported.push_back("v " + name + " " + info.type + (info.isConst ? " const" : ""));
+    }
+    for (const auto& [name, info] : module.structs) {
+        std::string line = "s " + name;
+        if (auto body = dyn_cast<BlockNode>(info.node->body)) {
+            for (const auto& field : body->statements) {
+                if (auto variable = dyn_cast<VariableAssignNode>(field)) {
+                    line += " " + variable->type->toString() + ":" + variable->name;
+                }
+            }
+        }
+        exported.push_back(line);
+    }
+    std::sort(exported.begin(), exported.end());
+
+    std::string interface;
+    for (const auto& line : exported) {
+        interface += line + "\n";
     }
+    module.interfaceHash = ASTCache::hash(interface);
     
     module.processed = true;
 }
 
 bool Linker::processImports(ModuleContext& module) {
+    // Повторная проверка собирает импорты заново, а не дописывает к прошлым
+    module.imports.clear();
+    module.importedModules.clear();
     
     // Проходимся по AST и обрабатываем импорты
     for (auto& node : module.ast->body) {
-        if (auto importNode = std::dynamic_pointer_cast<ImportNode>(node)) {
+        if (auto importNode = dyn_cast<ImportNode>(node)) {
             for (const auto& [path, alias] : importNode->paths) {
                 if (path.empty()) continue;
                 
@@ -73,9 +169,8 @@ bool Linker::processImports(ModuleContext& module) {
 
                 // Проверяем существует ли модуль ваще
                 if (modules.find(moduleName) == modules.end()) {
-                    // Пытаемся загрузить модуль, если он ещё не загружен
-                    if (!loadModule(moduleName)) {
-                        std::cerr << "Ошибка: Не удалось найти модуль " << moduleName << std::endl;
+                    // Обычно модуль уже загружен в loadImports; сюда попадают только импорты без него
+                    if (!loadModules({moduleName})) {
                         return false;
                     }
                 }
@@ -86,153 +181,247 @@ bool Linker::processImports(ModuleContext& module) {
                     std::string symbolName = path[1];
                     
                     // Проверяем, существует ли символ в модуле
-                    if (!symbolExists(moduleName, symbolName)) {
+                    auto symbol = findSymbol(moduleName, symbolName);
+                    if (!symbol) {
                         std::cerr << "Ошибка: Символ " << symbolName << " не найден в модуле " << moduleName << std::endl;
                         return false;
                     }
                     
-                    // Добавляем импортированный символ
-                    SymbolInfo symbol;
-                    symbol.name = symbolName;
-                    symbol.moduleName = moduleName;
-                    symbol.type = getSymbolType(moduleName, symbolName);
-                    
-                    module.imports.push_back(symbol);
+                    module.imports.push_back(*symbol);
                 }
-                // Иначе импортируется весь модуль
+                // Иначе импортируется весь модуль: его символы - в exports, копировать их не нужно
                 else {
+                    module.importedModules.push_back(moduleName);
+                }
+            }
+        }
+    }
 
-                    // Добавляем все функции
-                    for (const auto& [funcName, funcInfo] : modules[moduleName].functions) {
-                        SymbolInfo symbol;
-                        symbol.name = funcName;
-                        symbol.moduleName = moduleName;
-                        symbol.type = SymbolInfo::Type::FUNCTION;
-                        
-                        module.imports.push_back(symbol);
-                    }
-                    
-                    // Добавляем все глобальные переменные
-                    for (const auto& [varName, varInfo] : modules[moduleName].globals) {
-                        SymbolInfo symbol;
-                        symbol.name = varName;
-                        symbol.moduleName = moduleName;
-                        symbol.type = SymbolInfo::Type::VARIABLE;
-                        
-                        module.imports.push_back(symbol);
-                    }
-                    
-                    // Добавляем все структуры
-                    for (const auto& [structName, structInfo] : modules[moduleName].structs) {
-                        SymbolInfo symbol;
-                        symbol.name = structName;
-                        symbol.moduleName = moduleName;
-                        symbol.type = SymbolInfo::Type::STRUCT;
-                        
-                        module.imports.push_back(symbol);
+    // Без повторов: один модуль могут импортировать несколько use, символ - и по имени, и с модулем
+    std::sort(module.importedModules.begin(), module.importedModules.end());
+    module.importedModules.erase(std::unique(module.importedModules.begin(), module.importedModules.end()), module.importedModules.end());
+    std::sort(module.imports.begin(), module.imports.end());
+    module.imports.erase(std::unique(module.imports.begin(), module.imports.end()), module.imports.end());
+    std::erase_if(module.imports, [&](SymbolId id) {
+        return std::binary_search(module.importedModules.begin(), module.importedModules.end(), symbols[id].moduleName);
+    });
+    
+    return true;
+}
+
+bool Linker::loadImports() {
+    std::vector<std::string> frontier;
+    for (const auto& [name, module] : modules) {
+        frontier.push_back(name);
+    }
+
+    while (!frontier.empty()) {
+        // Имена модулей из use фронта, которых ещё нет; сортировка - для детерминированного порядка
+        std::vector<std::string> missing;
+        for (const auto& name : frontier) {
+            const ModuleContext& module = modules.at(name);
+            if (!module.ast) continue;
+
+            for (const auto& node : module.ast->body) {
+                auto importNode = dyn_cast<ImportNode>(node);
+                if (!importNode) continue;
+
+                for (const auto& [path, alias] : importNode->paths) {
+                    if (!path.empty() && modules.find(path[0]) == modules.end()) {
+                        missing.push_back(path[0]);
                     }
                 }
             }
         }
+        std::sort(missing.begin(), missing.end());
+        missing.erase(std::unique(missing.begin(), missing.end()), missing.end());
+
+        if (!loadModules(missing)) {
+            return false;
+        }
+        frontier = std::move(missing);
     }
-    
     return true;
 }
 
-bool Linker::loadModule(const std::string& moduleName) {
-    std::string filePath;
-    std::string moduleContent;
-    
-    // Проверяем стандартную библиотеку
-    std::string stdPath = stdLibPath + "/" + moduleName + ".ms";
-    if (std::filesystem::exists(stdPath)) {
-        filePath = stdPath;
-    } else {
-        // Проверяем относительные пути
-        for (const auto& [name, module] : modules) {
-            if (module.path.empty()) continue;
-            
-            std::string dirPath = std::filesystem::path(module.path).parent_path().string();
-            std::string relativePath = dirPath + "/" + moduleName + ".ms";
-            
-            if (std::filesystem::exists(relativePath)) {
-                filePath = relativePath;
-                break;
+bool Linker::loadModules(const std::vector<std::string>& moduleNames) {
+    // Пути ищутся до параллельной части: поиск смотрит на modules
+    std::vector<std::string> filePaths;
+    for (const auto& moduleName : moduleNames) {
+        std::string filePath = findModuleFile(moduleName);
+        if (filePath.empty()) {
+            std::cerr << "Ошибка: Не удалось найти модуль " << moduleName << std::endl;
+            return false;
+        }
+        filePaths.push_back(filePath);
+    }
+
+    // Каждая загрузка пишет только в свой слот; ошибки печатаются после волны по порядку имён
+    std::vector<ModuleContext> loaded(moduleNames.size());
+    std::vector<std::string> errors(moduleNames.size());
+    ThreadPool::getInstance().parallelFor(moduleNames.size(), [&](size_t i) {
+        const std::string& moduleName = moduleNames[i];
+
+        // Файл модуля отображается в память один раз за компиляцию;
+        // open() сверяет stat() с кэшем и перечитывает файл, если его изменили снаружи
+        auto source = SourceManager::getInstance().open(filePaths[i]);
+        if (!source) {
+            errors[i] = "Ошибка: не удалось открыть файл модуля " + filePaths[i];
+            return;
+        }
+
+        try {
+            ModuleContext& module = loaded[i];
+            module.name = moduleName;
+            module.path = filePaths[i];
+            module.contentHash = ASTCache::hash(source->text());
+            module.stamp = source->getStamp();
+
+            // Свежая сводка заменяет разбор: тела понадобятся, только если до них дойдут
+            if (useSummaries) {
+                if (auto summary = ModuleSummaries::getInstance().load(filePaths[i], module.contentHash)) {
+                    module.ast = summary;
+                    module.summary = true;
+                    return;
+                }
+            }
+
+            // Лексический анализ и парсинг в AST (или AST из кэша, тогда tokens остаётся пустым)
+            std::shared_ptr<const TokenStream> tokens;
+            auto moduleAST = parseModule(source, moduleName, tokens);
+
+            if (!moduleAST) {
+                errors[i] = "Error: failed to parse module " + moduleName;
+                return;
             }
+
+            module.ast = moduleAST;
+            module.tokens = tokens;
+            module.source = source; // Буфер живёт вместе с ModuleContext: в него смотрят спаны токенов
+            if (useSummaries) {
+                ModuleSummaries::getInstance().schedule(filePaths[i], module.contentHash, moduleAST);
+            }
+        } catch (const std::exception& e) {
+            errors[i] = "Error loading module " + moduleName + ": " + e.what();
+        }
+    }, maxThreads);
+
+    for (size_t i = 0; i < moduleNames.size(); i++) {
+        if (!errors[i].empty()) {
+            std::cerr << errors[i] << std::endl;
+            return false;
         }
+        modules[moduleNames[i]] = std::move(loaded[i]);
     }
-    
-    // Если файл не найден
-    if (filePath.empty()) {
-        return false;
+    return true;
+}
+
+NodePtr<ProgramNode> Linker::parseModule(const std::shared_ptr<const SourceBuffer>& source, const std::string& moduleName, std::shared_ptr<const TokenStream>& tokens) const {
+    if (!lazyBodies) {
+        return ASTCache::getInstance().parse(source->text(), moduleName, tokens);
     }
-    
-    // Чтение файла модуля
-    std::ifstream file(filePath);
-    if (!file) {
-        std::cerr << "Ошибка: не удалось открыть файл модуля " << filePath << std::endl;
+
+    // Готовый AST из кэша дешевле разбора. Свой AST без тел в кэш не пишется: запись
+    // откладывается до ASTCache::flush(), который разберёт модуль целиком
+    if (auto cached = ASTCache::getInstance().load(source->text(), moduleName)) {
+        return cached;
+    }
+    tokens = std::make_shared<const TokenStream>(ParallelLexer::tokenize(source->text()));
+    Parser parser(*tokens, moduleName);
+    parser.deferBodies(tokens);
+    auto program = parser.parse();
+    ASTCache::getInstance().schedule(source, moduleName, tokens);
+    return program;
+}
+
+bool Linker::materialize(const std::string& moduleName) {
+    ModuleContext& module = modules.at(moduleName);
+    if (!module.summary) {
+        return true;
+    }
+
+    auto source = SourceManager::getInstance().open(module.path);
+    if (!source) {
+        std::cerr << "Ошибка: не удалось открыть файл модуля " << module.path << std::endl;
         return false;
     }
-    
-    // Чтение содержимого
-    std::string line;
-    while (std::getline(file, line)) {
-        moduleContent += line + "\n";
+    // Сводка описывает содержимое на момент загрузки: другое тело с ней не сшить
+    if (ASTCache::hash(source->text()) != module.contentHash) {
+        std::cerr << "Ошибка: файл модуля " << module.path << " изменён во время компиляции" << std::endl;
+        return false;
     }
-    
-    try {
-        // Лексический анализ
-        Lexer lexer(moduleContent);
-        lexer.tokenize();
-        const auto tokens = lexer.getTokens();
 
-        for (const auto& tokenVec : tokens) {
-            this->Tokens.push_back(tokenVec);
-        }
-        
-        // Парсинг в AST
-        Parser parser(tokens, moduleName);
-        auto moduleAST = parser.parse();
-        
+    try {
+        std::shared_ptr<const TokenStream> tokens;
+        auto moduleAST = parseModule(source, moduleName, tokens);
         if (!moduleAST) {
             std::cerr << "Error: failed to parse module " << moduleName << std::endl;
             return false;
         }
-        
-        return addModule(moduleName, filePath, moduleAST);
-        
+        module.ast = moduleAST;
+        module.tokens = tokens;
+        module.source = source;
+        module.summary = false;
     } catch (const std::exception& e) {
         std::cerr << "Error loading module " << moduleName << ": " << e.what() << std::endl;
         return false;
     }
+
+    // FunctionInfo и остальные смотрели в узлы сводки; интерфейс и номера символов те же
+    module.processed = false;
+    collectModuleInfo(module);
+    return true;
 }
 
-bool Linker::symbolExists(const std::string& moduleName, const std::string& symbolName) {
-    if (modules.find(moduleName) == modules.end()) return false;
-    
-    const auto& module = modules[moduleName];
-    
-    return module.functions.find(symbolName) != module.functions.end() ||
-           module.globals.find(symbolName) != module.globals.end() ||
-           module.structs.find(symbolName) != module.structs.end();
+std::string Linker::findModuleFile(const std::string& moduleName) const {
+    // Стандартная библиотека, каталоги поиска (--modulePath, MS_MODULE_PATH), затем каталоги
+    // уже загруженных модулей - по имени модуля, чтобы порядок не зависел от хеш-таблицы
+    std::vector<std::string> directories{stdLibPath};
+    for (auto& directory : ModuleResolver::getInstance().getSearchPaths()) {
+        directories.push_back(std::move(directory));
+    }
+
+    std::vector<const ModuleContext*> loaded;
+    for (const auto& [name, module] : modules) {
+        if (!module.path.empty()) loaded.push_back(&module);
+    }
+    std::sort(loaded.begin(), loaded.end(), [](const ModuleContext* left, const ModuleContext* right) { return left->name < right->name; });
+    for (const ModuleContext* module : loaded) {
+        std::string directory = std::filesystem::path(module->path).parent_path().string();
+        if (std::find(directories.begin(), directories.end(), directory) == directories.end()) {
+            directories.push_back(std::move(directory));
+        }
+    }
+
+    return ModuleResolver::getInstance().resolve(moduleName, directories);
 }
 
-SymbolInfo::Type Linker::getSymbolType(const std::string& moduleName, const std::string& symbolName) {
-    if (modules.find(moduleName) == modules.end()) 
-        return SymbolInfo::Type::FUNCTION; // По умолчанию
-    
-    const auto& module = modules[moduleName];
-    
-    if (module.functions.find(symbolName) != module.functions.end())
-        return SymbolInfo::Type::FUNCTION;
-    
-    if (module.globals.find(symbolName) != module.globals.end())
-        return SymbolInfo::Type::VARIABLE;
-    
-    if (module.structs.find(symbolName) != module.structs.end())
-        return SymbolInfo::Type::STRUCT;
-    
-    return SymbolInfo::Type::FUNCTION; // По умолчанию
+uint64_t Linker::symbolKey(const std::string& moduleName, const std::string& symbolName) {
+    return (static_cast<uint64_t>(Symbol(moduleName).getId()) << 32) | Symbol(symbolName).getId();
+}
+
+SymbolId Linker::registerSymbol(SymbolInfo::Type type, const std::string& moduleName, const std::string& symbolName) {
+    auto [it, inserted] = symbolIndex.try_emplace(symbolKey(moduleName, symbolName), static_cast<SymbolId>(symbols.size()));
+    if (inserted) {
+        symbols.push_back(SymbolInfo{type, symbolName, moduleName});
+    } else {
+        symbols[it->second].type = type;
+    }
+    return it->second;
+}
+
+void Linker::forgetSymbols(const ModuleContext& module) {
+    for (SymbolId id : module.exports) {
+        symbolIndex.erase(symbolKey(symbols[id].moduleName, symbols[id].name));
+    }
+}
+
+std::optional<SymbolId> Linker::findSymbol(const std::string& moduleName, const std::string& symbolName) const {
+    auto it = symbolIndex.find(symbolKey(moduleName, symbolName));
+    if (it == symbolIndex.end()) {
+        return std::nullopt;
+    }
+    return it->second;
 }
 
 bool Linker::validateImports() {
@@ -265,8 +454,12 @@ void Linker::debugModules() const {
             std::cout << "    " << info.type << " " << varName << (info.isConst ? " (const)" : "") << "\n";
         }
         
-        std::cout << "  Импорты (" << module.imports.size() << "):\n";
-        for (const auto& import : module.imports) {
+        std::cout << "  Импорты (" << module.imports.size() << ", модулей целиком " << module.importedModules.size() << "):\n";
+        for (const auto& importedModule : module.importedModules) {
+            std::cout << "    * из " << importedModule << "\n";
+        }
+        for (SymbolId id : module.imports) {
+            const SymbolInfo& import = symbols[id];
             std::cout << "    " << import.name << " из " << import.moduleName << " (";
             switch(import.type) {
                 case SymbolInfo::Type::FUNCTION: std::cout << "функция"; break;
@@ -280,23 +473,193 @@ void Linker::debugModules() const {
 #endif
 }
 
-bool Linker::linkModules() {
-    // Собираем информацию о всех модулях
+bool Linker::changedOnDisk() const {
+    for (const auto& [name, module] : modules) {
+        if (module.root || module.path.empty()) continue;
+
+        FileStamp stamp;
+        if (!SourceManager::statFile(module.path, stamp) || stamp != module.stamp) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Linker::refreshModules() {
+    std::vector<std::string> stale;
     for (auto& [name, module] : modules) {
-        collectModuleInfo(module);
-        processImports(module);
+        if (module.root || module.path.empty()) continue;
+
+        FileStamp stamp;
+        if (SourceManager::statFile(module.path, stamp) && stamp == module.stamp) continue;
+
+        // Время изменения сдвинулось, а содержимое то же (touch, сохранение без правок) - модуль остаётся
+        auto source = SourceManager::getInstance().open(module.path);
+        if (source && ASTCache::hash(source->text()) == module.contentHash) {
+            module.stamp = source->getStamp();
+            continue;
+        }
+        stale.push_back(name);
     }
 
-    // Обрабатываем импорты
-    if (!validateImports()) {
+    for (const auto& name : stale) {
+        ModuleContext& module = modules.at(name);
+        SourceManager::getInstance().invalidate(module.path);
+        forgetSymbols(module);
+        modules.erase(name);
+    }
+}
+
+bool Linker::linkModules() {
+    // Модули из use, изменённые на диске, перечитываются, а не берутся из прошлой линковки
+    refreshModules();
+
+    // Сначала загружаем всё, что достижимо по use: дальше modules не растёт
+    if (!loadImports()) {
         return false;
     }
+    buildGraph();
+
+    // Символы собираются только у новых и изменённых модулей
+    std::unordered_set<std::string> changedInterfaces;
+    for (const auto& name : order) {
+        ModuleContext& module = modules.at(name);
+        if (module.processed) continue;
+
+        uint64_t previous = module.interfaceHash;
+        collectModuleInfo(module);
+        module.validated = false;
+        if (module.interfaceHash != previous) {
+            changedInterfaces.insert(name);
+        }
+    }
+
+    // Импорты - у изменённых модулей и у тех, чья зависимость поменяла интерфейс
+    for (const auto& name : order) {
+        ModuleContext& module = modules.at(name);
+        bool stale = !module.validated || std::any_of(module.dependencies.begin(), module.dependencies.end(),
+            [&](const std::string& dependency) { return changedInterfaces.count(dependency) > 0; });
+        if (!stale) continue;
+
+        if (!processImports(module)) {
+            return false;
+        }
+        module.validated = true;
+    }
     
     return true;
 }
 
-std::vector<std::shared_ptr<ProgramNode>> Linker::getLinkedASTs() {
-    std::vector<std::shared_ptr<ProgramNode>> result;
+void Linker::buildGraph() {
+    for (auto& [name, module] : modules) {
+        module.dependencies.clear();
+        if (!module.ast) continue;
+
+        for (const auto& node : module.ast->body) {
+            if (auto importNode = dyn_cast<ImportNode>(node)) {
+                for (const auto& [path, alias] : importNode->paths) {
+                    if (!path.empty()) {
+                        module.dependencies.push_back(path[0]);
+                    }
+                }
+            }
+        }
+        std::sort(module.dependencies.begin(), module.dependencies.end());
+        module.dependencies.erase(std::unique(module.dependencies.begin(), module.dependencies.end()), module.dependencies.end());
+    }
+
+    std::vector<std::string> names;
+    for (const auto& [name, module] : modules) {
+        names.push_back(name);
+    }
+    std::sort(names.begin(), names.end());
+
+    // Модули, которые больше никто не импортирует (use убрали), выпадают из линковки
+    std::unordered_set<std::string> reachable;
+    std::vector<std::string> pending;
+    for (const auto& name : names) {
+        if (modules.at(name).root) {
+            pending.push_back(name);
+        }
+    }
+    while (!pending.empty()) {
+        std::string name = std::move(pending.back());
+        pending.pop_back();
+        if (!reachable.insert(name).second) continue;
+
+        for (const auto& dependency : modules.at(name).dependencies) {
+            if (modules.count(dependency)) {
+                pending.push_back(dependency);
+            }
+        }
+    }
+    std::erase_if(names, [&](const std::string& name) {
+        if (reachable.count(name)) return false;
+        forgetSymbols(modules.at(name));
+        modules.erase(name);
+        return true;
+    });
+
+    // Обход в глубину: модуль попадает в order после своих зависимостей.
+    // Ребро в модуль, который ещё на пути обхода, - цикл
+    order.clear();
+    cycles.clear();
+    std::unordered_map<std::string, int> state; // 0 - не посещён, 1 - на пути, 2 - готов
+    std::vector<std::string> path;
+    std::function<void(const std::string&)> visit = [&](const std::string& name) {
+        state[name] = 1;
+        path.push_back(name);
+        for (const auto& dependency : modules.at(name).dependencies) {
+            if (!modules.count(dependency)) continue;
+
+            if (state[dependency] == 1) {
+                std::vector<std::string> cycle(std::find(path.begin(), path.end(), dependency), path.end());
+                cycle.push_back(dependency);
+                cycles.push_back(std::move(cycle));
+            } else if (state[dependency] == 0) {
+                visit(dependency);
+            }
+        }
+        path.pop_back();
+        state[name] = 2;
+        order.push_back(name);
+    };
+    // Обход начинается с модулей из addModule: в цикле разрывается ребро, ведущее обратно в них,
+    // и главный модуль остаётся после всего, что он импортирует
+    std::stable_partition(names.begin(), names.end(), [&](const std::string& name) { return modules.at(name).root; });
+    for (const auto& name : names) {
+        if (state[name] == 0) {
+            visit(name);
+        }
+    }
+}
+
+void Linker::dumpGraph(std::ostream& out) const {
+    out << "\n--- Граф модулей ---\n";
+    for (const auto& name : order) {
+        const ModuleContext& module = modules.at(name);
+        char hash[17];
+        std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(module.contentHash));
+        out << name << " (" << module.path << ") " << hash << "\n";
+        for (const auto& dependency : module.dependencies) {
+            out << "  -> " << dependency << "\n";
+        }
+    }
+    if (!cycles.empty()) {
+        out << "Циклы:\n";
+        for (const auto& cycle : cycles) {
+            out << " ";
+            for (size_t i = 0; i < cycle.size(); i++) {
+                out << (i ? " -> " : " ") << cycle[i];
+            }
+            out << "\n";
+        }
+    }
+    out << "--- Конец графа модулей ---\n";
+}
+
+std::vector<NodePtr<ProgramNode>> Linker::getLinkedASTs() {
+    std::vector<NodePtr<ProgramNode>> result;
     for (auto& [name, module] : modules) {
         result.push_back(module.ast);
     }
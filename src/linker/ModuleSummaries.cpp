@@ -0,0 +1,163 @@
+#include "headers/ModuleSummaries.h"
+#include "../parser/headers/ASTCache.h"
+#include "../loader/headers/SourceManager.h"
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+namespace
+{
+    constexpr char magic[4] = {'M', 'S', 'I', 'F'};
+    constexpr uint32_t formatVersion = 2; // Менять при изменении того, что попадает в сводку
+    constexpr size_t headerSize = sizeof(magic) + sizeof(uint32_t) + 3 * sizeof(uint64_t);
+
+    // Та же версия компилятора, что в ключе ASTCache: пересобранный компилятор
+    // с той же MS_VERSION может иначе раскладывать поля узлов
+    // Разбирает отложенные тела модуля; false - какое-то не разбирается
+    bool requireBodies(ProgramNode& program)
+    {
+        for (const auto& node : program.body)
+        {
+            auto function = dyn_cast<FunctionNode>(node);
+            if (!function)
+                continue;
+            try
+            {
+                if (!function->requireBody())
+                    return false; // Тело уже не разобралось раньше: requireBody второй раз не бросает
+            }
+            catch (const std::runtime_error&)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    uint64_t compilerHash()
+    {
+        static const uint64_t value = ASTCache::hash(ASTCache::getInstance().getCompilerStamp());
+        return value;
+    }
+}
+
+std::string ModuleSummaries::summaryPath(const std::string& modulePath)
+{
+    return std::filesystem::path(modulePath).replace_extension(".msi").string();
+}
+
+NodePtr<ProgramNode> ModuleSummaries::summarize(const ProgramNode& program)
+{
+    auto summary = makeNode<ProgramNode>();
+    summary->moduleName = program.moduleName;
+
+    for (const auto& node : program.body)
+    {
+        NodePtr<ASTNode> entry = node;
+        if (auto function = dyn_cast<FunctionNode>(node))
+            entry = makeNode<FunctionNode>(function->name, function->associated, function->returnType, function->parameters, function->labels, nullptr);
+        else if (auto variable = dyn_cast<VariableAssignNode>(node))
+            entry = makeNode<VariableAssignNode>(variable->name, variable->isConst, variable->type, nullptr);
+
+        if (entry != node)
+        {
+            entry->line = node->line;
+            entry->column = node->column;
+        }
+        summary->body.push_back(entry);
+    }
+    return summary;
+}
+
+NodePtr<ProgramNode> ModuleSummaries::load(const std::string& modulePath, uint64_t sourceHash) const
+{
+    if (!enabled)
+        return nullptr;
+
+    auto file = SourceManager::getInstance().open(summaryPath(modulePath));
+    if (!file)
+        return nullptr;
+    std::string_view data = file->text();
+
+    uint32_t version;
+    uint64_t compiler, source, checksum;
+    if (data.size() < headerSize || std::memcmp(data.data(), magic, sizeof(magic)) != 0)
+        return nullptr;
+    std::memcpy(&version, data.data() + sizeof(magic), sizeof(version));
+    std::memcpy(&compiler, data.data() + sizeof(magic) + sizeof(version), sizeof(compiler));
+    std::memcpy(&source, data.data() + sizeof(magic) + sizeof(version) + sizeof(compiler), sizeof(source));
+    std::memcpy(&checksum, data.data() + sizeof(magic) + sizeof(version) + sizeof(compiler) + sizeof(source), sizeof(checksum));
+    std::string_view payload = data.substr(headerSize);
+    if (version != formatVersion || compiler != compilerHash() || source != sourceHash || checksum != ASTCache::hash(payload))
+        return nullptr;
+
+    try
+    {
+        return ASTCache::deserialize(payload);
+    }
+    catch (const std::runtime_error&)
+    {
+        return nullptr; // Битая сводка - модуль разбирается из исходника, flush() её перепишет
+    }
+}
+
+void ModuleSummaries::schedule(const std::string& modulePath, uint64_t sourceHash, NodePtr<ProgramNode> program)
+{
+    if (!enabled)
+        return;
+
+    std::string payload = ASTCache::serialize(*summarize(*program));
+    std::string data(magic, sizeof(magic));
+    uint64_t compiler = compilerHash();
+    uint64_t checksum = ASTCache::hash(payload);
+    data.append(reinterpret_cast<const char*>(&formatVersion), sizeof(formatVersion));
+    data.append(reinterpret_cast<const char*>(&compiler), sizeof(compiler));
+    data.append(reinterpret_cast<const char*>(&sourceHash), sizeof(sourceHash));
+    data.append(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+    data += payload;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    pending.push_back({summaryPath(modulePath), std::move(data), std::move(program)});
+}
+
+void ModuleSummaries::flush()
+{
+    std::vector<Pending> entries;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.swap(pending);
+    }
+
+    // Как в ASTCache::store: временный файл и переименование, читатель не видит половину сводки
+    static std::atomic<uint64_t> counter{0};
+    for (const auto& entry : entries)
+    {
+        if (!requireBodies(*entry.program))
+            continue;
+
+        std::error_code error;
+        std::filesystem::path temporary = entry.path;
+#if defined(__unix__) || defined(__APPLE__)
+        temporary += ".tmp" + std::to_string(::getpid()) + "." + std::to_string(counter++);
+#else
+        temporary += ".tmp" + std::to_string(counter++);
+#endif
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            if (!file.write(entry.data.data(), static_cast<std::streamsize>(entry.data.size())))
+            {
+                file.close();
+                std::filesystem::remove(temporary, error);
+                continue;
+            }
+        }
+        std::filesystem::rename(temporary, entry.path, error);
+        if (error)
+            std::filesystem::remove(temporary, error);
+    }
+}
@@ -0,0 +1,221 @@
+#include "headers/TreeShaker.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+    // Имя, под которым объявление верхнего уровня видно из других модулей (пусто - не объявление)
+    std::string declarationName(ASTNode& node)
+    {
+        switch (node.kind)
+        {
+            case NodeKind::Function:
+                return static_cast<FunctionNode&>(node).name.str();
+            case NodeKind::VariableAssign:
+                return static_cast<VariableAssignNode&>(node).name.str();
+            case NodeKind::Struct:
+                return static_cast<StructNode&>(node).name;
+            default:
+                return {};
+        }
+    }
+
+    bool isEntry(ASTNode& node)
+    {
+        auto* function = dyn_cast<FunctionNode>(&node);
+        return function && (function->name == "main"
+            || std::find(function->labels.begin(), function->labels.end(), "@entry") != function->labels.end());
+    }
+}
+
+TreeShaker::TreeShaker(Linker& linker) : linker(linker)
+{
+    for (const auto& name : linker.getOrder())
+    {
+        const ModuleContext& module = linker.getModules().at(name);
+        if (!module.ast)
+            continue;
+
+        for (size_t position = 0; position < module.ast->body.size(); position++)
+        {
+            NodePtr<ASTNode> node = module.ast->body[position];
+            if (isa<ImportNode>(node))
+                continue;
+
+            std::string declared = declarationName(*node);
+            if (module.root || declared.empty() || isEntry(*node))
+                markReachable({name, position});
+            else
+                declarations[declared].push_back({name, position});
+        }
+    }
+
+    while (!worklist.empty())
+    {
+        NodePtr<ASTNode> node = worklist.back();
+        worklist.pop_back();
+        collectReferences(node);
+    }
+
+    for (const auto& [name, entries] : declarations)
+        for (const auto& declaration : entries)
+            if (!isReachable(linker.getModules().at(declaration.module).ast->body[declaration.position]))
+                dropped++;
+}
+
+void TreeShaker::markReachable(const Declaration& declaration)
+{
+    if (!linker.materialize(declaration.module))
+        throw std::runtime_error("Ошибка при линковке модулей");
+
+    const ModuleContext& module = linker.getModules().at(declaration.module);
+    if (declaration.position >= module.ast->body.size())
+        return;
+
+    NodePtr<ASTNode> node = module.ast->body[declaration.position];
+    if (reachable.insert(node.getIndex()).second)
+        worklist.push_back(node);
+}
+
+void TreeShaker::reference(const std::string& name)
+{
+    auto it = declarations.find(name);
+    if (it == declarations.end())
+        return;
+    for (const auto& declaration : it->second)
+        markReachable(declaration);
+}
+
+// Обходит все дочерние узлы (тот же набор полей, что пишет ASTCache)
+void TreeShaker::collectReferences(const NodePtr<ASTNode>& node)
+{
+    if (!node)
+        return;
+
+    auto collectAll = [this](const auto& nodes) {
+        for (const auto& child : nodes)
+            collectReferences(child);
+    };
+
+    switch (node->kind)
+    {
+        case NodeKind::SimpleType:
+            reference(cast<SimpleTypeNode>(node)->name);
+            break;
+        case NodeKind::GenericType: {
+            auto type = cast<GenericTypeNode>(node);
+            reference(type->baseName);
+            collectAll(type->typeParameters);
+            break;
+        }
+        case NodeKind::Program:
+            collectAll(cast<ProgramNode>(node)->body);
+            break;
+        case NodeKind::Function: {
+            auto function = cast<FunctionNode>(node);
+            reference(function->associated);
+            collectReferences(function->returnType);
+            for (const auto& [type, name] : function->parameters)
+                collectReferences(type);
+            collectReferences(function->requireBody()); // Отложенное тело разбирается, только когда до функции дошли
+            break;
+        }
+        case NodeKind::Lambda: {
+            auto lambda = cast<LambdaNode>(node);
+            collectReferences(lambda->returnType);
+            for (const auto& [type, name] : lambda->parameters)
+                collectReferences(type);
+            collectReferences(lambda->body);
+            break;
+        }
+        case NodeKind::Struct:
+            collectReferences(cast<StructNode>(node)->body);
+            break;
+        case NodeKind::Block:
+            collectAll(cast<BlockNode>(node)->statements);
+            break;
+        case NodeKind::VariableAssign: {
+            auto assign = cast<VariableAssignNode>(node);
+            collectReferences(assign->type);
+            collectReferences(assign->expression);
+            break;
+        }
+        case NodeKind::ReassignMember: {
+            auto reassign = cast<ReassignMemberNode>(node);
+            collectReferences(reassign->accessExpression);
+            collectReferences(reassign->expression);
+            break;
+        }
+        case NodeKind::VariableReassign: {
+            auto reassign = cast<VariableReassignNode>(node);
+            reference(reassign->name.str());
+            collectReferences(reassign->expression);
+            break;
+        }
+        case NodeKind::If: {
+            auto ifNode = cast<IfNode>(node);
+            collectReferences(ifNode->condition);
+            collectReferences(ifNode->thenBlock);
+            collectReferences(ifNode->elseBlock);
+            break;
+        }
+        case NodeKind::For: {
+            auto forNode = cast<ForNode>(node);
+            collectReferences(forNode->varType);
+            collectReferences(forNode->iterable);
+            collectReferences(forNode->body);
+            break;
+        }
+        case NodeKind::While: {
+            auto whileNode = cast<WhileNode>(node);
+            collectReferences(whileNode->condition);
+            collectReferences(whileNode->body);
+            break;
+        }
+        case NodeKind::Return:
+            collectReferences(cast<ReturnNode>(node)->expression);
+            break;
+        case NodeKind::Call: {
+            auto call = cast<CallNode>(node);
+            reference(call->callee.str());
+            collectAll(call->arguments);
+            break;
+        }
+        case NodeKind::BinaryOp: {
+            auto binary = cast<BinaryOpNode>(node);
+            collectReferences(binary->left);
+            collectReferences(binary->right);
+            break;
+        }
+        case NodeKind::UnaryOp:
+            collectReferences(cast<UnaryOpNode>(node)->operand);
+            break;
+        case NodeKind::Identifier:
+            reference(cast<IdentifierNode>(node)->name.str());
+            break;
+        case NodeKind::Number:
+            collectReferences(cast<NumberNode>(node)->type);
+            break;
+        case NodeKind::KeyValue: {
+            auto keyValue = cast<KeyValueNode>(node);
+            collectReferences(keyValue->key);
+            collectReferences(keyValue->value);
+            break;
+        }
+        case NodeKind::AccessExpression: {
+            auto access = cast<AccessExpression>(node);
+            collectReferences(access->expression);
+            collectReferences(access->nextAccess);
+            break;
+        }
+        case NodeKind::ModuleMark:
+        case NodeKind::Import:
+        case NodeKind::FloatNumber:
+        case NodeKind::String:
+        case NodeKind::Null:
+        case NodeKind::None:
+        case NodeKind::Break:
+        case NodeKind::Continue:
+            break;
+    }
+}
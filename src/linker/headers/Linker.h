@@ -4,10 +4,13 @@
 #include "../../lexer/headers/Lexer.h"
 #include "../../includes/icecream.hpp"
 #include "../../visitors/headers/TypeSymbolVisitor.h"
+#include "../../loader/headers/SourceManager.h"
 
 #include <string>
 #include <vector>
 #include <optional>
+#include <ostream>
+#include <string_view>
 // Forward declarations для типов из Parser.h
 class Parser;
 class ProgramNode;
@@ -17,7 +20,7 @@ class ASTNode;
 
 // Информация о функции
 struct FunctionInfo {
-    std::shared_ptr<FunctionNode>                                                                       node;
+    NodePtr<FunctionNode>                                                                       node;
     std::string                                                                                         returnType;
     std::vector<std::pair<std::string, std::string>>                                                    params; // {тип, имя}
     bool                                                                                                defined = false;
@@ -25,7 +28,7 @@ struct FunctionInfo {
 
 // Информация о глобальной переменной/константе
 struct VariableInfo {
-    std::shared_ptr<ASTNode>                                                                            node;
+    NodePtr<ASTNode>                                                                            node;
     std::string                                                                                         type;
     bool                                                                                                isConst;
     bool                                                                                                defined = false;
@@ -33,10 +36,13 @@ struct VariableInfo {
 
 // Информация о структуре
 struct StructInfo {
-    std::shared_ptr<StructNode>                                                                         node;
+    NodePtr<StructNode>                                                                         node;
     bool                                                                                                defined = false;
 };
 
+// Номер символа в индексе Linker: импорты хранят его, а не копию SymbolInfo
+using SymbolId = uint32_t;
+
 // Информация о символе (для импорта)
 struct SymbolInfo {
     enum class Type {
@@ -59,33 +65,69 @@ struct SymbolInfo {
 struct ModuleContext {
     std::string                                                                                         name;
     std::string                                                                                         path;
-    std::shared_ptr<ProgramNode>                                                                        ast;
+    NodePtr<ProgramNode>                                                                        ast;
+    std::shared_ptr<const TokenStream>                                                                  tokens; // общий поток токенов модуля (nullptr, если AST взят из кэша)
+    std::shared_ptr<const SourceBuffer>                                                                 source; // буфер, в который смотрят спаны tokens (пуст, если им владеет вызывающий)
 
     // Символы, определённые в этом модуле
     std::unordered_map<std::string, FunctionInfo>                                                       functions;
     std::unordered_map<std::string, VariableInfo>                                                       globals;
     std::unordered_map<std::string, StructInfo>                                                         structs;
     
-    // Импортированные символы
-    std::vector<SymbolInfo>                                                                             imports;
-    bool                                                                                                processed = false;
+    // Свои символы в индексе Linker
+    std::vector<SymbolId>                                                                               exports;
+
+    // Импортированные символы: модули целиком (их exports не копируются) и отдельные имена,
+    // без повторов и без тех, что уже входят в модули целиком
+    std::vector<std::string>                                                                            importedModules;
+    std::vector<SymbolId>                                                                               imports;
+    bool                                                                                                processed = false; // Символы собраны (collectModuleInfo)
+
+    // Узел графа модулей
+    std::vector<std::string>                                                                            dependencies; // Модули из use, по имени без повторов
+    uint64_t                                                                                            contentHash = 0; // ASTCache::hash исходника; 0 - неизвестен
+    uint64_t                                                                                            interfaceHash = 0; // Хеш functions/globals/structs: меняется - перепроверяются зависимые
+    bool                                                                                                root = false; // Добавлен через addModule (остальные - загружены по use)
+    bool                                                                                                summary = false; // ast - сводка из .msi без тел (ModuleSummaries), полный AST - Linker::materialize
+    bool                                                                                                validated = false; // imports собраны для текущих зависимостей
+    FileStamp                                                                                           stamp; // Файл модуля из use на момент чтения
 };
 
+/*
+Модули из use загружаются волнами: фронт - модули, импорты которых ещё не разобраны.
+Пути новых модулей ищутся последовательно, а чтение, лексер и парсер каждого файла
+идут параллельно на ThreadPool - каждая загрузка собирает свой ModuleContext отдельно.
+Результаты волны вливаются в modules по имени модуля, поэтому порядок не зависит от
+того, какой поток закончил первым. Следующий фронт - модули, загруженные в этой волне.
+
+После загрузки строится граф модулей (рёбра - use) и топологический порядок: зависимости
+раньше зависимых. Циклы не ошибка - объединённый AST их допускает, - но запоминаются для
+--deps; обход идёт от модулей из addModule, поэтому они остаются после своих импортов.
+
+Линкер можно звать повторно (языковой сервер): addModule с тем же путём заменяет модуль,
+если изменился хеш исходника. Символы заново собираются только у изменённых модулей,
+импорты проверяются у изменённых и у тех, чья зависимость поменяла интерфейс. Модули,
+до которых больше не дойти по use, удаляются. Модули из use, файл которых изменили
+на диске, выбрасываются и загружаются заново (см. changedOnDisk).
+*/
 class Linker {
 public:
-                                                                                                        Linker(const std::string& stdLibPath);
+    // maxThreads = 0 - весь пул (см. ThreadPool.hpp), 1 - модули загружаются по одному
+                                                                                                        Linker(const std::string& stdLibPath, size_t maxThreads = 0);
     
     // Добавление модуля
     bool                                                                                                addModule(
                                                                                                             const std::string& name, 
                                                                                                             const std::string& path, 
-                                                                                                            std::shared_ptr<ProgramNode> ast);
+                                                                                                            NodePtr<ProgramNode> ast,
+                                                                                                            std::shared_ptr<const TokenStream> tokens = nullptr,
+                                                                                                            std::string_view source = {});
     
     // Линковка модулей
     bool                                                                                                linkModules();
     
     // Получение всех AST после линковки
-    std::vector<std::shared_ptr<ProgramNode>>                                                           getLinkedASTs();
+    std::vector<NodePtr<ProgramNode>>                                                           getLinkedASTs();
     
     // Проверка корректности импортов
     bool                                                                                                validateImports();
@@ -94,14 +136,52 @@ public:
                                                                                                             return modules; 
                                                                                                         }
 
-    const std::vector<std::vector<Token>>&                                                              getTokens() const { 
-                                                                                                            return Tokens; 
+    // Имена модулей в топологическом порядке: зависимости раньше зависимых
+    const std::vector<std::string>&                                                                     getOrder() const {
+                                                                                                            return order;
+                                                                                                        }
+
+    // Символ из индекса: (модуль, имя) -> номер за одно обращение к хеш-таблице
+    std::optional<SymbolId>                                                                             findSymbol(const std::string& moduleName, const std::string& symbolName) const;
+    const SymbolInfo&                                                                                   getSymbol(SymbolId id) const {
+                                                                                                            return symbols[id];
+                                                                                                        }
+
+    // Файл какого-то модуля из use изменён или удалён после загрузки (только stat)
+    bool                                                                                                changedOnDisk() const;
+
+    // Граф модулей для --deps
+    void                                                                                                dumpGraph(std::ostream& out) const;
+
+    // Модули из use читаются из сводок .msi, если они свежие; разобранные из исходника
+    // отдаются ModuleSummaries на запись. Тела нужны тому, кто обходит AST, - см. materialize
+    void                                                                                                setUseSummaries(bool value) {
+                                                                                                            useSummaries = value;
                                                                                                         }
+
+    // Модули из use разбираются без тел функций (Parser::deferBodies): тело разбирается,
+    // когда его впервые запросят (FunctionNode::requireBody). Такие AST идут в ASTCache
+    // только через ASTCache::flush() - после запуска без ошибок и разбора целиком
+    void                                                                                                setLazyBodies(bool value) {
+                                                                                                            lazyBodies = value;
+                                                                                                        }
+
+    // Заменяет сводку модуля полным AST из исходника (у модулей без сводки ничего не делает)
+    bool                                                                                                materialize(const std::string& moduleName);
     
 private:
     std::string                                                                                         stdLibPath;
+    size_t                                                                                              maxThreads;
+    bool                                                                                                useSummaries = false;
+    bool                                                                                                lazyBodies = false;
     std::unordered_map<std::string, ModuleContext>                                                      modules;
-    std::vector<std::vector<Token>>                                                                     Tokens;
+    std::vector<std::string>                                                                            order;
+    std::vector<std::vector<std::string>>                                                               cycles; // Каждый цикл - путь по use, первый модуль повторён в конце
+
+    // Индекс символов всей программы. Номер символа не меняется, пока символ есть в модуле:
+    // при повторном сборе он находится по ключу; удалённые символы остаются в symbols без ключа
+    std::vector<SymbolInfo>                                                                             symbols;
+    std::unordered_map<uint64_t, SymbolId>                                                              symbolIndex; // ключ - symbolKey
     
     // Первый проход: сбор информации о модулях
     void                                                                                                collectModuleInfo(ModuleContext& module);
@@ -111,15 +191,32 @@ private:
     // Обработка импортов модуля
     bool                                                                                                processImports(ModuleContext& module);
     
-    // Загрузка модуля по пути
-    bool                                                                                                loadModule(const std::string& modulePath);
+    // Рёбра, удаление недостижимых модулей, порядок и циклы
+    void                                                                                                buildGraph();
+
+    // Выбрасывает модули из use, содержимое файла которых изменилось: loadImports загрузит их заново
+    void                                                                                                refreshModules();
+
+    // Загрузка всех модулей, достижимых по use из уже добавленных
+    bool                                                                                                loadImports();
+
+    // Загрузка модулей по именам: пути - последовательно, разбор - параллельно
+    bool                                                                                                loadModules(const std::vector<std::string>& moduleNames);
+
+    // AST модуля из use: из ASTCache или разбором (с отложенными телами при lazyBodies)
+    NodePtr<ProgramNode>                                                                                parseModule(const std::shared_ptr<const SourceBuffer>& source, const std::string& moduleName, std::shared_ptr<const TokenStream>& tokens) const;
+
+    // Путь к файлу модуля (пусто, если не найден); каталоги индексирует ModuleResolver
+    std::string                                                                                         findModuleFile(const std::string& moduleName) const;
     
-    // Вспомогательная хуйня
-    bool                                                                                                symbolExists(const std::string& moduleName, 
-                                                                                                            const std::string& symbolName);
+    // Ключ индекса: id имён модуля и символа в Interner
+    static uint64_t                                                                                     symbolKey(const std::string& moduleName, const std::string& symbolName);
+
+    // Номер символа: прежний, если (модуль, имя) уже в индексе, иначе новый
+    SymbolId                                                                                            registerSymbol(SymbolInfo::Type type, const std::string& moduleName, const std::string& symbolName);
 
-    SymbolInfo::Type                                                                                    getSymbolType(const std::string& moduleName, 
-                                                                                                            const std::string& symbolName);
+    // Убирает символы модуля из индекса (модуль удалён из линковки)
+    void                                                                                                forgetSymbols(const ModuleContext& module);
 };
 
 #endif // LINKER_H
\ No newline at end of file
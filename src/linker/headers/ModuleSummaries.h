@@ -0,0 +1,68 @@
+#ifndef MODULESUMMARIES_H
+#define MODULESUMMARIES_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../../parser/headers/AST.h"
+
+/*
+Сводки интерфейса модулей (.msi) - рядом с исходником: lib/math.ms -> lib/math.msi.
+Сводка - это AST модуля без тел: use, сигнатуры и метки функций, глобальные переменные
+с типом (без выражения), структуры целиком (их поля и есть раскладка). Порядок узлов
+верхнего уровня тот же, что в исходнике, поэтому узел сводки и узел полного AST
+находятся по одному номеру (Linker::materialize).
+
+Формат - заголовок (магия, версия формата, хеш версии компилятора - той же, что в ключе
+ASTCache, - ASTCache::hash исходника и дерева) и дерево в формате ASTCache::serialize.
+Файл читается через SourceManager, то есть отображается в память. Сводка с другим
+хешем исходника, версией, контрольной суммой или битым деревом считается отсутствующей -
+модуль разбирается из исходника.
+
+Запись откладывается: schedule() запоминает сводки разобранных из исходника модулей,
+flush() пишет их после проверки типов без ошибок. Отложенные тела (Linker::setLazyBodies),
+до которых проверка не дошла, flush() разбирает: сводка модуля с неразбираемым телом
+не пишется. Такие тела только разобраны, не проверены - их проверит запуск, который
+до них дойдёт. Ошибки записи (каталог только для чтения) не фатальны. --offCache выключает и чтение, и запись. Потокобезопасен.
+*/
+class ModuleSummaries
+{
+public:
+    ModuleSummaries(const ModuleSummaries&) = delete;
+    ModuleSummaries& operator=(const ModuleSummaries&) = delete;
+
+    static ModuleSummaries& getInstance() {
+        static ModuleSummaries instance;
+        return instance;
+    }
+
+    void setEnabled(bool value) { enabled = value; }
+    bool isEnabled() const { return enabled; }
+
+    // Сводка модуля с исходником modulePath, если она есть и совпадает по хешу; иначе nullptr
+    NodePtr<ProgramNode> load(const std::string& modulePath, uint64_t sourceHash) const;
+
+    // Запомнить сводку полного AST модуля для записи в flush(); program нужен flush() для тел
+    void schedule(const std::string& modulePath, uint64_t sourceHash, NodePtr<ProgramNode> program);
+    void flush();
+
+    static std::string summaryPath(const std::string& modulePath);
+    // AST без тел функций и выражений глобальных переменных (узлы новые, исходный AST не меняется)
+    static NodePtr<ProgramNode> summarize(const ProgramNode& program);
+
+private:
+    ModuleSummaries() = default;
+
+    struct Pending {
+        std::string path; // путь .msi
+        std::string data; // заголовок и дерево
+        NodePtr<ProgramNode> program; // все тела должны разобраться до записи
+    };
+    std::vector<Pending> pending;
+    std::mutex mutex;
+    bool enabled = true;
+};
+
+#endif // MODULESUMMARIES_H
@@ -0,0 +1,55 @@
+#ifndef TREESHAKER_H
+#define TREESHAKER_H
+
+#include "Linker.h"
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/*
+Отсечение недостижимых объявлений модулей из use до проверки типов.
+Корни - всё, что объявлено в модулях из addModule (их ошибки должны показываться,
+даже если функция нигде не вызвана), и функции @entry/main любого модуля. От них
+по вызовам, идентификаторам и именам типов помечаются функции, глобальные переменные
+и структуры остальных модулей; пространства имён у модулей нет, поэтому имя
+связывается со всеми объявлениями с таким именем (перегрузки, одноимённые локальные
+переменные - с запасом, лишнее просто остаётся в AST).
+Узлы верхнего уровня других видов из модулей use не отсекаются.
+
+Модуль, прочитанный из сводки .msi, разбирается целиком (Linker::materialize), только
+когда до него дошли; модули, из которых ничего не нужно, остаются сводками.
+Если исходник такого модуля не разобрать, конструктор бросает std::runtime_error.
+*/
+class TreeShaker {
+public:
+    explicit TreeShaker(Linker& linker);
+
+    // Попадает ли узел верхнего уровня модуля в объединённый AST
+    bool isReachable(const NodePtr<ASTNode>& node) const {
+        return reachable.count(node.getIndex()) != 0;
+    }
+
+    // Сколько объявлений модулей из use отброшено
+    size_t droppedCount() const { return dropped; }
+
+private:
+    // Объявление - номер узла в body модуля: у сводки и полного AST номера совпадают
+    struct Declaration {
+        std::string module;
+        size_t position;
+    };
+
+    void markReachable(const Declaration& declaration);
+    void collectReferences(const NodePtr<ASTNode>& node);
+    void reference(const std::string& name);
+
+    Linker& linker;
+    std::unordered_map<std::string, std::vector<Declaration>> declarations; // имя -> объявления в модулях use
+    std::unordered_set<uint32_t> reachable; // индексы узлов в арене
+    std::vector<NodePtr<ASTNode>> worklist;
+    size_t dropped = 0;
+};
+
+#endif // TREESHAKER_H
@@ -0,0 +1,89 @@
+#include "headers/ModuleResolver.h"
+#include <cstdlib>
+#include <filesystem>
+
+ModuleResolver::ModuleResolver()
+{
+    // MS_MODULE_PATH=/opt/ms/rules:/home/user/shared - как PATH
+    if (const char* paths = std::getenv("MS_MODULE_PATH"); paths && *paths)
+    {
+        std::string list = paths;
+        size_t start = 0;
+        while (start <= list.size())
+        {
+            size_t end = list.find(':', start);
+            if (end == std::string::npos)
+                end = list.size();
+            if (end > start)
+                searchPaths.push_back(list.substr(start, end - start));
+            start = end + 1;
+        }
+    }
+}
+
+void ModuleResolver::addSearchPaths(const std::vector<std::string>& paths)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    searchPaths.insert(searchPaths.begin(), paths.begin(), paths.end());
+    resolved.clear();
+}
+
+std::vector<std::string> ModuleResolver::getSearchPaths() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return searchPaths;
+}
+
+std::string ModuleResolver::resolve(const std::string& moduleName, const std::vector<std::string>& directoryList)
+{
+    std::string key = moduleName;
+    for (const auto& directory : directoryList)
+        key += '\n' + directory;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (auto it = resolved.find(key); it != resolved.end())
+        return it->second;
+
+    auto find = [&]() -> std::string {
+        for (const auto& directory : directoryList)
+        {
+            const auto& index = directoryIndex(directory);
+            if (auto it = index.find(moduleName); it != index.end())
+                return it->second;
+        }
+        return {};
+    };
+
+    std::string path = find();
+    if (path.empty())
+    {
+        // Файл могли создать после чтения каталогов (языковой сервер живёт долго):
+        // каталоги перечитываются по одному разу, промах не запоминается
+        for (const auto& directory : directoryList)
+            directories.erase(directory);
+        path = find();
+        if (path.empty())
+            return path;
+    }
+    resolved.emplace(std::move(key), path);
+    return path;
+}
+
+const std::unordered_map<std::string, std::string>& ModuleResolver::directoryIndex(const std::string& directory)
+{
+    auto [it, inserted] = directories.try_emplace(directory);
+    if (!inserted || directory.empty())
+        return it->second;
+
+    // Путь собирается так же, как раньше в Linker: каталог + "/" + имя файла
+    std::error_code error;
+    for (std::filesystem::directory_iterator entry(directory, error), end; !error && entry != end; entry.increment(error))
+    {
+        const std::filesystem::path& file = entry->path();
+        std::error_code fileError;
+        if (file.extension() != ".ms" || !entry->is_regular_file(fileError))
+            continue;
+        it->second.emplace(file.stem().string(), directory + "/" + file.filename().string());
+    }
+    return it->second;
+}
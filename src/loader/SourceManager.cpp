@@ -0,0 +1,182 @@
+#include "headers/SourceManager.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #define MS_SOURCE_MMAP 1
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+SourceBuffer::SourceBuffer(std::string path, std::string contents)
+    : path(std::move(path)), owned(std::move(contents)), data(nullptr), size(0), mapped(false)
+{
+    data = owned.data();
+    size = owned.size();
+}
+
+SourceBuffer::SourceBuffer(std::string path, const char* mappedData, size_t mappedSize)
+    : path(std::move(path)), data(mappedData), size(mappedSize), mapped(true)
+{
+}
+
+SourceBuffer::~SourceBuffer()
+{
+#ifdef MS_SOURCE_MMAP
+    if (mapped)
+        munmap(const_cast<char*>(data), size);
+#endif
+}
+
+namespace
+{
+    std::string canonicalKey(const std::string& path)
+    {
+        std::error_code error;
+        auto canonical = std::filesystem::weakly_canonical(path, error);
+        return error ? path : canonical.string();
+    }
+
+#ifdef MS_SOURCE_MMAP
+    FileStamp stampOf(const struct stat& info)
+    {
+        FileStamp stamp;
+        stamp.device = static_cast<uint64_t>(info.st_dev);
+        stamp.inode = static_cast<uint64_t>(info.st_ino);
+        stamp.size = static_cast<uint64_t>(info.st_size);
+#if defined(__APPLE__)
+        stamp.modified = static_cast<int64_t>(info.st_mtimespec.tv_sec) * 1000000000 + info.st_mtimespec.tv_nsec;
+#else
+        stamp.modified = static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+#endif
+        return stamp;
+    }
+#endif
+}
+
+bool SourceManager::statFile(const std::string& path, FileStamp& stamp)
+{
+#ifdef MS_SOURCE_MMAP
+    struct stat info;
+    if (::stat(path.c_str(), &info) != 0)
+        return false;
+    stamp = stampOf(info);
+    return true;
+#else
+    std::error_code error;
+    auto size = std::filesystem::file_size(path, error);
+    if (error)
+        return false;
+    auto modified = std::filesystem::last_write_time(path, error);
+    if (error)
+        return false;
+    stamp = {};
+    stamp.size = static_cast<uint64_t>(size);
+    stamp.modified = static_cast<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(modified.time_since_epoch()).count());
+    return true;
+#endif
+}
+
+std::shared_ptr<SourceBuffer> SourceManager::readFile(const std::string& path)
+{
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(path, error))
+        return nullptr;
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return nullptr;
+
+    // Одно выделение под весь файл вместо сборки по строкам
+    FileStamp stamp;
+    statFile(path, stamp);
+    file.seekg(0, std::ios::end);
+    std::string contents(static_cast<size_t>(file.tellg()), '\0');
+    file.seekg(0, std::ios::beg);
+    file.read(contents.data(), static_cast<std::streamsize>(contents.size()));
+    contents.resize(static_cast<size_t>(file.gcount())); // Файл могли обрезать между seekg и read
+
+    std::shared_ptr<SourceBuffer> buffer(new SourceBuffer(path, std::move(contents)));
+    buffer->stamp = stamp;
+    return buffer;
+}
+
+void SourceManager::invalidate(const std::string& path)
+{
+    std::string key = canonicalKey(path);
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    buffers.erase(key);
+}
+
+std::shared_ptr<const SourceBuffer> SourceManager::open(const std::string& path)
+{
+    if (!mapping)
+        return readFile(path);
+
+    std::string key = canonicalKey(path);
+
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    if (auto it = buffers.find(key); it != buffers.end())
+    {
+        FileStamp stamp;
+        if (statFile(path, stamp) && stamp == it->second->getStamp())
+            return it->second;
+        buffers.erase(it); // Файл изменён или удалён снаружи
+    }
+
+    std::shared_ptr<SourceBuffer> buffer;
+
+#ifdef MS_SOURCE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return nullptr;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode))
+    {
+        ::close(fd);
+        return nullptr;
+    }
+
+    size_t fileSize = static_cast<size_t>(info.st_size);
+    if (fileSize > 0)
+    {
+        void* mapping = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED)
+        {
+            madvise(mapping, fileSize, MADV_SEQUENTIAL); // Лексер читает файл один раз подряд
+            buffer.reset(new SourceBuffer(path, static_cast<const char*>(mapping), fileSize));
+        }
+    }
+    ::close(fd); // Отображение не зависит от дескриптора
+
+    if (!buffer && fileSize > 0)
+    {
+        std::cerr << "Ошибка: не удалось отобразить файл " << path << std::endl;
+        return nullptr;
+    }
+    if (!buffer)
+        buffer.reset(new SourceBuffer(path, std::string()));
+    buffer->stamp = stampOf(info);
+#else
+    buffer = readFile(path);
+    if (!buffer)
+        return nullptr;
+#endif
+
+    buffers.emplace(key, buffer);
+    return buffer;
+}
+
+std::shared_ptr<const SourceBuffer> SourceManager::readStdin()
+{
+    std::string contents;
+    char chunk[1 << 16];
+    while (std::cin.read(chunk, sizeof(chunk)) || std::cin.gcount() > 0)
+        contents.append(chunk, static_cast<size_t>(std::cin.gcount()));
+
+    return std::shared_ptr<const SourceBuffer>(new SourceBuffer("<stdin>", std::move(contents)));
+}
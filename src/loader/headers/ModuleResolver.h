@@ -0,0 +1,52 @@
+#ifndef MODULERESOLVER_H
+#define MODULERESOLVER_H
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+Поиск файлов модулей для use.
+Каждый каталог поиска читается один раз за запуск: его .ms файлы попадают в индекс
+имя модуля -> путь, и дальше поиск - это обращение к хеш-таблице, а не stat на каждый
+импорт. Найденные пути для одного и того же списка каталогов запоминаются.
+
+Пользовательские каталоги: --modulePath DIR (можно несколько раз), затем MS_MODULE_PATH
+(каталоги через ':'). Они проверяются после каталога стандартной библиотеки и до
+каталогов уже загруженных модулей (см. Linker::findModuleFile).
+Промах не запоминается: каталоги списка перечитываются, и файл, созданный после
+первого чтения каталога, находится без перезапуска языкового сервера.
+Потокобезопасен.
+*/
+class ModuleResolver
+{
+public:
+    ModuleResolver(const ModuleResolver&) = delete;
+    ModuleResolver& operator=(const ModuleResolver&) = delete;
+
+    static ModuleResolver& getInstance() {
+        static ModuleResolver instance;
+        return instance;
+    }
+
+    // Каталоги из --modulePath; встают перед каталогами из MS_MODULE_PATH
+    void addSearchPaths(const std::vector<std::string>& directories);
+    std::vector<std::string> getSearchPaths() const;
+
+    // Путь к name.ms в первом каталоге списка, где он есть (пусто, если нигде)
+    std::string resolve(const std::string& moduleName, const std::vector<std::string>& directories);
+
+private:
+    ModuleResolver();
+
+    // Индекс каталога: имя модуля -> путь; каталог читается при первом обращении
+    const std::unordered_map<std::string, std::string>& directoryIndex(const std::string& directory);
+
+    std::vector<std::string> searchPaths;
+    std::unordered_map<std::string, std::unordered_map<std::string, std::string>> directories; // ключ - каталог как передан
+    std::unordered_map<std::string, std::string> resolved; // ключ - имя модуля и список каталогов
+    mutable std::mutex mutex;
+};
+
+#endif // MODULERESOLVER_H
@@ -0,0 +1,101 @@
+#ifndef SOURCEMANAGER_H
+#define SOURCEMANAGER_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Что видно из stat() о файле: другой файл, другой размер или время изменения - другое содержимое
+struct FileStamp {
+    uint64_t device = 0;
+    uint64_t inode = 0;
+    uint64_t size = 0;
+    int64_t  modified = 0; // наносекунды
+
+    bool operator==(const FileStamp& other) const {
+        return device == other.device && inode == other.inode && size == other.size && modified == other.modified;
+    }
+    bool operator!=(const FileStamp& other) const { return !(*this == other); }
+};
+
+/*
+Исходник одного файла.
+Файл отображается в память только для чтения (mmap), поэтому текст не копируется
+и не собирается построчно. Если отобразить нельзя (stdin, пустой файл, платформа без mmap),
+текст лежит в обычной строке. Буфер неизменяем и живёт, пока на него есть ссылки,
+так что спаны токенов и диагностика могут смотреть в него напрямую.
+*/
+class SourceBuffer
+{
+public:
+    SourceBuffer(const SourceBuffer&) = delete;
+    SourceBuffer& operator=(const SourceBuffer&) = delete;
+    ~SourceBuffer();
+
+    const std::string& getPath() const { return path; }
+    std::string_view text() const { return std::string_view(data, size); }
+    bool isMapped() const { return mapped; }
+    const FileStamp& getStamp() const { return stamp; }
+
+private:
+    friend class SourceManager;
+    SourceBuffer(std::string path, std::string contents);
+    SourceBuffer(std::string path, const char* mappedData, size_t mappedSize);
+
+    std::string path;
+    FileStamp   stamp;    // Файл в момент чтения
+    std::string owned;    // Текст, если файл не отображён
+    const char* data;
+    size_t      size;
+    bool        mapped;
+};
+
+/*
+Менеджер исходников: каждый файл отображается один раз за компиляцию,
+повторные open() (например, модуль, который импортируют несколько файлов)
+возвращают тот же буфер, пока файл не изменился: open() сверяет FileStamp
+с текущим stat() и при расхождении читает файл заново. Старый буфер живёт,
+пока на него есть ссылки. Потокобезопасен.
+
+Языковой сервер живёт долго, а файлы модулей правят и обрезают снаружи: отображение
+обрезанного файла падает с SIGBUS на первом чтении. Поэтому там setMapping(false) -
+файлы читаются в свою память при каждом open() и не кэшируются.
+*/
+class SourceManager
+{
+public:
+    SourceManager(const SourceManager&) = delete;
+    SourceManager& operator=(const SourceManager&) = delete;
+
+    static SourceManager& getInstance() {
+        static SourceManager instance;
+        return instance;
+    }
+
+    // Буфер файла или nullptr, если файл нельзя открыть
+    std::shared_ptr<const SourceBuffer> open(const std::string& path);
+    // Забыть буфер файла: следующий open() прочитает файл заново
+    void invalidate(const std::string& path);
+    // false - читать файлы в память без кэша вместо отображения (ms lsp); до первого open()
+    void setMapping(bool enabled) { mapping = enabled; }
+    // FileStamp файла сейчас; false - файла нет
+    static bool statFile(const std::string& path, FileStamp& stamp);
+    // Весь stdin одним буфером (отобразить поток нельзя, поэтому читаем блоками)
+    std::shared_ptr<const SourceBuffer> readStdin();
+
+private:
+    SourceManager() = default;
+
+    // Файл целиком в собственной памяти
+    static std::shared_ptr<SourceBuffer> readFile(const std::string& path);
+
+    bool mapping = true;
+
+    std::unordered_map<std::string, std::shared_ptr<const SourceBuffer>> buffers; // ключ - канонический путь
+    std::mutex buffersMutex;
+};
+
+#endif // SOURCEMANAGER_H
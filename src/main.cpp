@@ -3,7 +3,13 @@
 #include "CLI/headers/runner.h"
 #include "CLI/headers/symantic.h"
 #include "CLI/headers/compile.h"
+#include "CLI/headers/bench.h"
+#include "CLI/headers/stream.h"
 #include "errors/headers/ErrorEngine.h"
+#include "parser/headers/ASTCache.h"
+#include "loader/headers/ModuleResolver.h"
+#include "linker/headers/ModuleSummaries.h"
+#include "server/headers/LanguageServer.h"
 #include <iostream>
 #include <chrono>
 #include <filesystem>
@@ -13,17 +19,52 @@ int main(int argc, char* argv[]) {
         // Парсинг аргументов
         CLIOptions options = parseArgs(argc, argv);
         
+        ASTCache::getInstance().setEnabled(!options.offCache);
+        ModuleSummaries::getInstance().setEnabled(!options.offCache);
+        ModuleResolver::getInstance().addSearchPaths(options.modulePaths);
+
+        // Языковой сервер: документы приходят от редактора, а не из файла
+        if (options.languageServer) {
+            LanguageServer server;
+            return server.run(std::cin, std::cout);
+        }
+
         // Чтение кода
-        std::string sourceCode = readSourceCode(options.inputFile);
-        
-        // Токенизация
-        auto tokens = tokenizeSource(sourceCode, options.showTokens);
+        auto source = readSourceCode(options.inputFile);
+
+        // Бенчмарк стадий вместо обычного запуска
+        if (options.runBenchmark) {
+            runBenchmarks(source->text(), options.inputFile);
+            return 0;
+        }
+
+        // Потоковая компиляция: разбор, проверка и выпуск по одной функции
+        if (options.streaming && (options.runJIT || options.compileExecutable)) {
+            int result = streamProgram(source->text(), options);
+            if (options.compileExecutable && result == 0) {
+                std::string outputFile = options.ExecutableFile.empty() ? "output" : options.ExecutableFile;
+                std::cout << "Компиляция завершена. Исполняемый файл: " << outputFile << std::endl;
+            }
+            return options.runJIT ? 0 : result;
+        }
+
+        // Токенизация: без --tokens лексер запускается только при промахе кэша AST
+        std::shared_ptr<const TokenStream> tokens;
+        if (options.showTokens) {
+            tokens = tokenizeSource(source->text(), options.showTokens);
+        }
 
         // Парсинг и линковка
-        auto combinedAST = parseAndLinkModules(tokens, options.inputFile, options.showAST);
+        auto combinedAST = parseAndLinkModules(source->text(), tokens, options.inputFile, options.showAST, options.showDeps);
 
         // Семантический анализ
         combinedAST = symanticParseModule(combinedAST, options.showSymantic);
+
+        // Сводки и записи кэша AST модулей из use, разобранных из исходника, - только после проверки без ошибок
+        if (ErrorEngine::getInstance().getErrorCount() == 0) {
+            ASTCache::getInstance().flush();
+            ModuleSummaries::getInstance().flush();
+        }
         
         // Выполнение только если указан флаг --run или run
         if (options.runJIT) {
@@ -0,0 +1,167 @@
+#include "headers/AST.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <stdexcept>
+
+namespace
+{
+    // Текущий блок потока: узлы одного потока выделяются подряд без блокировок
+    struct ThreadBlock {
+        char* cursor = nullptr;
+        char* end = nullptr;
+        uint64_t generation = 0;
+    };
+    thread_local ThreadBlock threadBlock;
+
+    // В порядке BinaryOpcode / UnaryOpcode
+    constexpr const char* binaryOpcodeNames[] = {
+        "+", "-", "*", "/", "%", "**",
+        "==", "!=", "<", ">", "<=", ">=",
+        "and", "or", "|>",
+
+        "add", "fadd", "sub", "fsub", "mul", "fmul", "sdiv", "fdiv", "srem", "frem",
+        "icmp_eq", "icmp_ne", "icmp_slt", "icmp_sgt", "icmp_sle", "icmp_sge",
+        "fcmp_eq", "fcmp_ne", "fcmp_slt", "fcmp_sgt", "fcmp_sle", "fcmp_sge",
+        "strcmp_eq", "strcmp_ne", "strcmp_slt", "strcmp_sgt", "strcmp_sle", "strcmp_sge",
+        "scat",
+    };
+    static_assert(std::size(binaryOpcodeNames) == static_cast<size_t>(BinaryOpcode::Count), "binaryOpcodeNames out of sync with BinaryOpcode");
+
+    constexpr const char* unaryOpcodeNames[] = {
+        "-", "!", "?",
+        "neg", "not", "nullcheck",
+    };
+    static_assert(std::size(unaryOpcodeNames) == static_cast<size_t>(UnaryOpcode::Count), "unaryOpcodeNames out of sync with UnaryOpcode");
+}
+
+std::string opcodeName(BinaryOpcode op)
+{
+    return binaryOpcodeNames[static_cast<size_t>(op)];
+}
+
+std::string opcodeName(UnaryOpcode op)
+{
+    return unaryOpcodeNames[static_cast<size_t>(op)];
+}
+
+void* ASTArena::allocate(size_t size, size_t alignment)
+{
+    uint64_t current = generation.load(std::memory_order_relaxed);
+    if (threadBlock.generation == current && threadBlock.cursor)
+    {
+        uintptr_t aligned = (reinterpret_cast<uintptr_t>(threadBlock.cursor) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+        if (aligned + size <= reinterpret_cast<uintptr_t>(threadBlock.end))
+        {
+            threadBlock.cursor = reinterpret_cast<char*>(aligned + size);
+            usedBytes.fetch_add(size, std::memory_order_relaxed);
+            return reinterpret_cast<void*>(aligned);
+        }
+    }
+
+    // Новый блок; узел крупнее блока получает свой собственный
+    size_t bytes = std::max(blockSize, size + alignment);
+    char* block = static_cast<char*>(std::malloc(bytes));
+    if (!block)
+        throw std::bad_alloc();
+    {
+        std::lock_guard<std::mutex> lock(blocksMutex);
+        blocks.push_back(block);
+    }
+
+    uintptr_t aligned = (reinterpret_cast<uintptr_t>(block) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    threadBlock = {reinterpret_cast<char*>(aligned + size), block + bytes, current};
+    usedBytes.fetch_add(size, std::memory_order_relaxed);
+    return reinterpret_cast<void*>(aligned);
+}
+
+uint32_t ASTArena::registerNode(ASTNode* node)
+{
+    uint32_t index = count.fetch_add(1, std::memory_order_relaxed);
+    uint32_t page = index >> pageBits;
+    if (page >= maxPages)
+        throw std::runtime_error("AST Error: too many nodes");
+
+    ASTNode** storage = pages[page].load(std::memory_order_acquire);
+    if (!storage)
+    {
+        std::lock_guard<std::mutex> lock(blocksMutex);
+        storage = pages[page].load(std::memory_order_relaxed);
+        if (!storage)
+        {
+            storage = new ASTNode*[pageSize]();
+            pages[page].store(storage, std::memory_order_release);
+        }
+    }
+    storage[index & (pageSize - 1)] = node;
+    return index;
+}
+
+void ASTArena::reset()
+{
+    // Вызывается, когда AST больше никто не использует: без блокировок на узлах
+    uint32_t total = count.load(std::memory_order_relaxed);
+    for (uint32_t index = 1; index < total; index++)
+        if (ASTNode* current = node(index))
+            current->~ASTNode();
+
+    std::lock_guard<std::mutex> lock(blocksMutex);
+    for (char* block : blocks)
+        std::free(block);
+    blocks.clear();
+
+    for (uint32_t page = 0; page <= (total - 1) >> pageBits; page++)
+        if (ASTNode** storage = pages[page].load(std::memory_order_relaxed))
+            std::fill(storage, storage + pageSize, nullptr);
+
+    count.store(1, std::memory_order_relaxed);
+    usedBytes.store(0, std::memory_order_relaxed);
+    generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+ASTArena::Mark ASTArena::mark() const
+{
+    Mark result;
+    result.count = count.load(std::memory_order_relaxed);
+    result.usedBytes = usedBytes.load(std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(blocksMutex);
+        result.blocks = blocks.size();
+    }
+    if (threadBlock.generation == generation.load(std::memory_order_relaxed)) {
+        result.cursor = threadBlock.cursor;
+        result.end = threadBlock.end;
+    }
+    return result;
+}
+
+void ASTArena::rewind(const Mark& mark)
+{
+    // Узлы разрушаются в обратном порядке, как при выходе из области видимости
+    uint32_t total = count.load(std::memory_order_relaxed);
+    for (uint32_t index = total; index-- > mark.count;)
+        if (ASTNode* current = node(index)) {
+            current->~ASTNode();
+            pages[index >> pageBits].load(std::memory_order_relaxed)[index & (pageSize - 1)] = nullptr;
+        }
+
+    {
+        std::lock_guard<std::mutex> lock(blocksMutex);
+        for (size_t i = mark.blocks; i < blocks.size(); i++)
+            std::free(blocks[i]);
+        blocks.resize(std::min(mark.blocks, blocks.size()));
+    }
+
+    count.store(mark.count, std::memory_order_relaxed);
+    usedBytes.store(mark.usedBytes, std::memory_order_relaxed);
+    // Блоки других потоков могли освободиться - пусть возьмут новые; этот поток продолжает с места отметки
+    uint64_t current = generation.fetch_add(1, std::memory_order_relaxed) + 1;
+    threadBlock = {mark.cursor, mark.end, mark.cursor ? current : 0};
+}
+
+size_t ASTArena::bytesReserved() const
+{
+    size_t tablePages = ((count.load(std::memory_order_relaxed) - 1) >> pageBits) + 1;
+    std::lock_guard<std::mutex> lock(blocksMutex);
+    return blocks.size() * blockSize + tablePages * pageSize * sizeof(ASTNode*);
+}
@@ -0,0 +1,863 @@
+#include "headers/ASTCache.h"
+#include "headers/ParallelParser.h"
+#include "../lexer/headers/ParallelLexer.h"
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+#ifndef MS_VERSION
+#define MS_VERSION "dev"
+#endif
+
+namespace
+{
+    constexpr char magic[4] = {'M', 'S', 'A', 'C'};
+    constexpr uint32_t formatVersion = 2; // Менять при любом изменении формата или полей узлов
+    constexpr size_t headerSize = sizeof(magic) + sizeof(uint32_t) + 3 * sizeof(uint64_t);
+
+    // Хеш по 8 байт за шаг: исходники крупные, а ключ считается на каждом запуске
+    uint64_t mix(uint64_t value)
+    {
+        value ^= value >> 33;
+        value *= 0xff51afd7ed558ccdULL;
+        value ^= value >> 33;
+        value *= 0xc4ceb9fe1a85ec53ULL;
+        value ^= value >> 33;
+        return value;
+    }
+
+    uint64_t hashBytes(std::string_view data, uint64_t seed)
+    {
+        constexpr uint64_t multiplier = 0x9e3779b97f4a7c15ULL;
+        uint64_t hash = seed ^ (data.size() * multiplier);
+        size_t i = 0;
+        for (; i + 8 <= data.size(); i += 8)
+        {
+            uint64_t word;
+            std::memcpy(&word, data.data() + i, sizeof(word));
+            hash = (hash ^ mix(word)) * multiplier;
+        }
+        uint64_t tail = 0;
+        std::memcpy(&tail, data.data() + i, data.size() - i);
+        hash = (hash ^ mix(tail)) * multiplier;
+        return mix(hash);
+    }
+
+    void appendRaw(std::string& out, const void* data, size_t size)
+    {
+        out.append(static_cast<const char*>(data), size);
+    }
+
+    class Writer
+    {
+    public:
+        std::string take() { return std::move(out); }
+
+        void writeVarint(uint64_t value)
+        {
+            while (value >= 0x80)
+            {
+                out.push_back(static_cast<char>(value | 0x80));
+                value >>= 7;
+            }
+            out.push_back(static_cast<char>(value));
+        }
+
+        void writeSigned(int64_t value)
+        {
+            writeVarint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+        }
+
+        void writeString(std::string_view text)
+        {
+            auto [it, inserted] = strings.try_emplace(std::string(text), static_cast<uint32_t>(strings.size()));
+            if (!inserted)
+            {
+                writeVarint(it->second + 1);
+                return;
+            }
+            writeVarint(0);
+            writeVarint(text.size());
+            out.append(text);
+        }
+
+        template <typename T>
+        void writeNodes(const std::vector<NodePtr<T>>& nodes)
+        {
+            writeVarint(nodes.size());
+            for (const auto& node : nodes)
+                writeNode(node);
+        }
+
+        template <typename T>
+        void writeNode(const NodePtr<T>& node)
+        {
+            if (!node)
+            {
+                writeVarint(0);
+                return;
+            }
+            auto [it, inserted] = ids.try_emplace(node.getIndex(), static_cast<uint32_t>(ids.size()));
+            if (!inserted)
+            {
+                writeVarint(it->second + 2);
+                return;
+            }
+            writeVarint(1);
+            writeBody(*node);
+        }
+
+    private:
+        void writeBody(ASTNode& node)
+        {
+            out.push_back(static_cast<char>(node.kind));
+            writeSigned(node.line);
+            writeSigned(node.column);
+            writeNode(node.inferredType);
+            writeNode(node.implicitCastTo);
+
+            switch (node.kind)
+            {
+                case NodeKind::ModuleMark:
+                    writeString(static_cast<ModuleMark&>(node).moduleName);
+                    break;
+                case NodeKind::SimpleType:
+                    writeString(static_cast<SimpleTypeNode&>(node).name);
+                    break;
+                case NodeKind::GenericType: {
+                    auto& type = static_cast<GenericTypeNode&>(node);
+                    writeString(type.baseName);
+                    writeNodes(type.typeParameters);
+                    break;
+                }
+                case NodeKind::Program: {
+                    auto& program = static_cast<ProgramNode&>(node);
+                    writeNodes(program.body);
+                    writeString(program.moduleName);
+                    break;
+                }
+                case NodeKind::Function: {
+                    // lambdas парсер не заполняет
+                    auto& function = static_cast<FunctionNode&>(node);
+                    writeString(function.name.str());
+                    writeString(function.associated);
+                    writeNode(function.returnType);
+                    writeVarint(function.parameters.size());
+                    for (const auto& [type, name] : function.parameters)
+                    {
+                        writeNode(type);
+                        writeString(name.str());
+                    }
+                    writeVarint(function.labels.size());
+                    for (const auto& label : function.labels)
+                        writeString(label);
+                    writeNode(function.requireBody()); // Отложенное тело в записи должно быть разобрано
+                    break;
+                }
+                case NodeKind::Lambda: {
+                    auto& lambda = static_cast<LambdaNode&>(node);
+                    writeNode(lambda.returnType);
+                    writeVarint(lambda.parameters.size());
+                    for (const auto& [type, name] : lambda.parameters)
+                    {
+                        writeNode(type);
+                        writeString(name);
+                    }
+                    writeNode(lambda.body);
+                    break;
+                }
+                case NodeKind::Struct: {
+                    auto& structNode = static_cast<StructNode&>(node);
+                    writeString(structNode.name);
+                    writeNode(structNode.body);
+                    break;
+                }
+                case NodeKind::Block:
+                    writeNodes(static_cast<BlockNode&>(node).statements);
+                    break;
+                case NodeKind::VariableAssign: {
+                    auto& assign = static_cast<VariableAssignNode&>(node);
+                    writeString(assign.name.str());
+                    writeNode(assign.type);
+                    writeVarint(assign.isConst ? 1 : 0);
+                    writeNode(assign.expression);
+                    break;
+                }
+                case NodeKind::ReassignMember: {
+                    auto& reassign = static_cast<ReassignMemberNode&>(node);
+                    writeNode(reassign.accessExpression);
+                    writeNode(reassign.expression);
+                    break;
+                }
+                case NodeKind::VariableReassign: {
+                    auto& reassign = static_cast<VariableReassignNode&>(node);
+                    writeString(reassign.name.str());
+                    writeNode(reassign.expression);
+                    break;
+                }
+                case NodeKind::If: {
+                    auto& ifNode = static_cast<IfNode&>(node);
+                    writeNode(ifNode.condition);
+                    writeNode(ifNode.thenBlock);
+                    writeNode(ifNode.elseBlock);
+                    break;
+                }
+                case NodeKind::For: {
+                    auto& forNode = static_cast<ForNode&>(node);
+                    writeString(forNode.varName.str());
+                    writeNode(forNode.varType);
+                    writeNode(forNode.iterable);
+                    writeNode(forNode.body);
+                    break;
+                }
+                case NodeKind::While: {
+                    auto& whileNode = static_cast<WhileNode&>(node);
+                    writeNode(whileNode.condition);
+                    writeNode(whileNode.body);
+                    break;
+                }
+                case NodeKind::Return:
+                    writeNode(static_cast<ReturnNode&>(node).expression);
+                    break;
+                case NodeKind::Call: {
+                    auto& call = static_cast<CallNode&>(node);
+                    writeString(call.callee.str());
+                    writeNodes(call.arguments);
+                    break;
+                }
+                case NodeKind::BinaryOp: {
+                    auto& binary = static_cast<BinaryOpNode&>(node);
+                    writeVarint(static_cast<uint64_t>(binary.op));
+                    writeNode(binary.left);
+                    writeNode(binary.right);
+                    break;
+                }
+                case NodeKind::UnaryOp: {
+                    auto& unary = static_cast<UnaryOpNode&>(node);
+                    writeVarint(static_cast<uint64_t>(unary.op));
+                    writeNode(unary.operand);
+                    break;
+                }
+                case NodeKind::Identifier:
+                    writeString(static_cast<IdentifierNode&>(node).name.str());
+                    break;
+                case NodeKind::Number: {
+                    auto& number = static_cast<NumberNode&>(node);
+                    writeSigned(number.value);
+                    writeNode(number.type);
+                    break;
+                }
+                case NodeKind::FloatNumber: {
+                    uint32_t bits;
+                    std::memcpy(&bits, &static_cast<FloatNumberNode&>(node).value, sizeof(bits));
+                    for (size_t i = 0; i < sizeof(bits); i++)
+                        out.push_back(static_cast<char>(bits >> (8 * i)));
+                    break;
+                }
+                case NodeKind::String:
+                    writeString(static_cast<StringNode&>(node).value);
+                    break;
+                case NodeKind::KeyValue: {
+                    auto& keyValue = static_cast<KeyValueNode&>(node);
+                    writeNode(keyValue.key);
+                    writeNode(keyValue.value);
+                    writeString(keyValue.keyName);
+                    break;
+                }
+                case NodeKind::AccessExpression: {
+                    auto& access = static_cast<AccessExpression&>(node);
+                    writeString(access.memberName);
+                    writeString(access.notation);
+                    writeNode(access.expression);
+                    writeNode(access.nextAccess);
+                    break;
+                }
+                case NodeKind::Import: {
+                    auto& import = static_cast<ImportNode&>(node);
+                    writeVarint(import.paths.size());
+                    for (const auto& [path, alias] : import.paths)
+                    {
+                        writeVarint(path.size());
+                        for (const auto& part : path)
+                            writeString(part);
+                        writeString(alias);
+                    }
+                    break;
+                }
+                case NodeKind::Null:
+                case NodeKind::None:
+                case NodeKind::Break:
+                case NodeKind::Continue:
+                    break;
+            }
+        }
+
+        std::string out;
+        std::unordered_map<uint32_t, uint32_t> ids;        // индекс в арене -> номер в записи
+        std::unordered_map<std::string, uint32_t> strings; // строка -> номер в таблице
+    };
+
+    class Reader
+    {
+    public:
+        explicit Reader(std::string_view data) : data(data) {}
+
+        bool atEnd() const { return position == data.size(); }
+
+        uint64_t readVarint()
+        {
+            uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7)
+            {
+                uint8_t byte = readByte();
+                value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                if (!(byte & 0x80))
+                    return value;
+            }
+            corrupt();
+        }
+
+        int64_t readSigned()
+        {
+            uint64_t value = readVarint();
+            return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+        }
+
+        int readInt()
+        {
+            return static_cast<int>(readSigned());
+        }
+
+        size_t readCount()
+        {
+            uint64_t count = readVarint();
+            if (count > data.size() - position) // Каждый элемент занимает хотя бы байт
+                corrupt();
+            return static_cast<size_t>(count);
+        }
+
+        const std::string& readString()
+        {
+            uint64_t ref = readVarint();
+            if (ref != 0)
+            {
+                if (ref - 1 >= strings.size())
+                    corrupt();
+                return strings[ref - 1];
+            }
+            size_t size = readCount();
+            strings.emplace_back(data.substr(position, size));
+            symbols.push_back(0);
+            position += size;
+            return strings.back();
+        }
+
+        Symbol readSymbol()
+        {
+            const std::string& text = readString();
+            size_t index = &text - strings.data();
+            if (!symbols[index])
+                symbols[index] = Symbol(text).getId() + 1;
+            return Symbol::fromId(symbols[index] - 1);
+        }
+
+        template <typename T>
+        NodePtr<T> readNode()
+        {
+            NodePtr<ASTNode> node = readAnyNode();
+            if constexpr (!std::is_same_v<T, ASTNode>)
+                if (node && !isa<T>(node))
+                    corrupt();
+            return staticNodeCast<T>(node);
+        }
+
+        template <typename T>
+        void readNodes(std::vector<NodePtr<T>>& nodes)
+        {
+            size_t count = readCount();
+            nodes.reserve(count);
+            for (size_t i = 0; i < count; i++)
+                nodes.push_back(readNode<T>());
+        }
+
+    private:
+        [[noreturn]] void corrupt() const
+        {
+            throw std::runtime_error("AST cache: corrupt entry");
+        }
+
+        uint8_t readByte()
+        {
+            if (position >= data.size())
+                corrupt();
+            return static_cast<uint8_t>(data[position++]);
+        }
+
+        NodePtr<ASTNode> readAnyNode()
+        {
+            uint64_t ref = readVarint();
+            if (ref == 0)
+                return nullptr;
+            if (ref >= 2)
+            {
+                // Ссылка только на уже дочитанный узел: циклов в AST нет
+                if (ref - 2 >= nodes.size() || !nodes[ref - 2])
+                    corrupt();
+                return nodes[ref - 2];
+            }
+            if (ref != 1)
+                corrupt();
+
+            size_t slot = nodes.size();
+            nodes.emplace_back();
+            NodePtr<ASTNode> node = readBody();
+            nodes[slot] = node;
+            return node;
+        }
+
+        NodePtr<ASTNode> readBody()
+        {
+            uint8_t kind = readByte();
+            if (kind > static_cast<uint8_t>(NodeKind::Import))
+                corrupt();
+            int line = readInt();
+            int column = readInt();
+            auto inferredType = readNode<TypeNode>();
+            auto implicitCastTo = readNode<TypeNode>();
+
+            NodePtr<ASTNode> result;
+            switch (static_cast<NodeKind>(kind))
+            {
+                case NodeKind::ModuleMark:
+                    result = makeNode<ModuleMark>(readString());
+                    break;
+                case NodeKind::SimpleType:
+                    result = makeNode<SimpleTypeNode>(readString());
+                    break;
+                case NodeKind::GenericType: {
+                    auto type = makeNode<GenericTypeNode>(readString());
+                    readNodes(type->typeParameters);
+                    result = type;
+                    break;
+                }
+                case NodeKind::Program: {
+                    auto program = makeNode<ProgramNode>();
+                    readNodes(program->body);
+                    program->moduleName = readString();
+                    result = program;
+                    break;
+                }
+                case NodeKind::Function: {
+                    auto function = makeNode<FunctionNode>();
+                    function->name = readSymbol();
+                    function->associated = readString();
+                    function->returnType = readNode<TypeNode>();
+                    size_t parameters = readCount();
+                    for (size_t i = 0; i < parameters; i++)
+                    {
+                        auto type = readNode<TypeNode>();
+                        function->parameters.push_back({type, readSymbol()});
+                    }
+                    size_t labels = readCount();
+                    for (size_t i = 0; i < labels; i++)
+                        function->labels.push_back(readString());
+                    function->body = readNode<ASTNode>();
+                    result = function;
+                    break;
+                }
+                case NodeKind::Lambda: {
+                    auto returnType = readNode<TypeNode>();
+                    std::vector<std::pair<NodePtr<TypeNode>, std::string>> parameters;
+                    size_t count = readCount();
+                    for (size_t i = 0; i < count; i++)
+                    {
+                        auto type = readNode<TypeNode>();
+                        parameters.push_back({type, readString()});
+                    }
+                    result = makeNode<LambdaNode>(returnType, parameters, readNode<ASTNode>());
+                    break;
+                }
+                case NodeKind::Struct: {
+                    auto structNode = makeNode<StructNode>();
+                    structNode->name = readString();
+                    structNode->body = readNode<ASTNode>();
+                    result = structNode;
+                    break;
+                }
+                case NodeKind::Block: {
+                    auto block = makeNode<BlockNode>();
+                    readNodes(block->statements);
+                    result = block;
+                    break;
+                }
+                case NodeKind::VariableAssign: {
+                    auto assign = makeNode<VariableAssignNode>();
+                    assign->name = readSymbol();
+                    assign->type = readNode<TypeNode>();
+                    assign->isConst = readVarint() != 0;
+                    assign->expression = readNode<ASTNode>();
+                    result = assign;
+                    break;
+                }
+                case NodeKind::ReassignMember: {
+                    auto reassign = makeNode<ReassignMemberNode>();
+                    reassign->accessExpression = readNode<ASTNode>();
+                    reassign->expression = readNode<ASTNode>();
+                    result = reassign;
+                    break;
+                }
+                case NodeKind::VariableReassign: {
+                    auto reassign = makeNode<VariableReassignNode>();
+                    reassign->name = readSymbol();
+                    reassign->expression = readNode<ASTNode>();
+                    result = reassign;
+                    break;
+                }
+                case NodeKind::If: {
+                    auto ifNode = makeNode<IfNode>();
+                    ifNode->condition = readNode<ASTNode>();
+                    ifNode->thenBlock = readNode<BlockNode>();
+                    ifNode->elseBlock = readNode<ASTNode>();
+                    result = ifNode;
+                    break;
+                }
+                case NodeKind::For: {
+                    auto forNode = makeNode<ForNode>();
+                    forNode->varName = readSymbol();
+                    forNode->varType = readNode<TypeNode>();
+                    forNode->iterable = readNode<ASTNode>();
+                    forNode->body = readNode<BlockNode>();
+                    result = forNode;
+                    break;
+                }
+                case NodeKind::While: {
+                    auto whileNode = makeNode<WhileNode>();
+                    whileNode->condition = readNode<ASTNode>();
+                    whileNode->body = readNode<BlockNode>();
+                    result = whileNode;
+                    break;
+                }
+                case NodeKind::Return: {
+                    auto returnNode = makeNode<ReturnNode>();
+                    returnNode->expression = readNode<ASTNode>();
+                    result = returnNode;
+                    break;
+                }
+                case NodeKind::Call: {
+                    auto call = makeNode<CallNode>();
+                    call->callee = readSymbol();
+                    readNodes(call->arguments);
+                    result = call;
+                    break;
+                }
+                case NodeKind::BinaryOp: {
+                    auto binary = makeNode<BinaryOpNode>();
+                    uint64_t op = readVarint();
+                    if (op >= static_cast<uint64_t>(BinaryOpcode::Count))
+                        corrupt();
+                    binary->op = static_cast<BinaryOpcode>(op);
+                    binary->left = readNode<ASTNode>();
+                    binary->right = readNode<ASTNode>();
+                    result = binary;
+                    break;
+                }
+                case NodeKind::UnaryOp: {
+                    auto unary = makeNode<UnaryOpNode>();
+                    uint64_t op = readVarint();
+                    if (op >= static_cast<uint64_t>(UnaryOpcode::Count))
+                        corrupt();
+                    unary->op = static_cast<UnaryOpcode>(op);
+                    unary->operand = readNode<ASTNode>();
+                    result = unary;
+                    break;
+                }
+                case NodeKind::Identifier:
+                    result = makeNode<IdentifierNode>(readSymbol());
+                    break;
+                case NodeKind::Number: {
+                    auto number = makeNode<NumberNode>();
+                    number->value = readSigned();
+                    number->type = readNode<TypeNode>();
+                    result = number;
+                    break;
+                }
+                case NodeKind::FloatNumber: {
+                    uint32_t bits = 0;
+                    for (size_t i = 0; i < sizeof(bits); i++)
+                        bits |= static_cast<uint32_t>(readByte()) << (8 * i);
+                    float value;
+                    std::memcpy(&value, &bits, sizeof(value));
+                    result = makeNode<FloatNumberNode>(value);
+                    break;
+                }
+                case NodeKind::String:
+                    result = makeNode<StringNode>(readString());
+                    break;
+                case NodeKind::KeyValue: {
+                    auto keyValue = makeNode<KeyValueNode>();
+                    keyValue->key = readNode<ASTNode>();
+                    keyValue->value = readNode<ASTNode>();
+                    keyValue->keyName = readString();
+                    result = keyValue;
+                    break;
+                }
+                case NodeKind::AccessExpression: {
+                    auto access = makeNode<AccessExpression>();
+                    access->memberName = readString();
+                    access->notation = readString();
+                    access->expression = readNode<ASTNode>();
+                    access->nextAccess = readNode<ASTNode>();
+                    result = access;
+                    break;
+                }
+                case NodeKind::Import: {
+                    auto import = makeNode<ImportNode>();
+                    size_t count = readCount();
+                    for (size_t i = 0; i < count; i++)
+                    {
+                        std::vector<std::string> path(readCount());
+                        for (auto& part : path)
+                            part = readString();
+                        import->paths.emplace(std::move(path), readString());
+                    }
+                    result = import;
+                    break;
+                }
+                case NodeKind::Null:
+                    result = makeNode<NullNode>();
+                    break;
+                case NodeKind::None:
+                    result = makeNode<NoneNode>();
+                    break;
+                case NodeKind::Break:
+                    result = makeNode<BreakNode>();
+                    break;
+                case NodeKind::Continue:
+                    result = makeNode<ContinueNode>();
+                    break;
+            }
+
+            result->line = line;
+            result->column = column;
+            result->inferredType = inferredType;
+            result->implicitCastTo = implicitCastTo;
+            return result;
+        }
+
+        std::string_view data;
+        size_t position = 0;
+        std::vector<NodePtr<ASTNode>> nodes;
+        std::vector<std::string> strings;
+        std::vector<uint32_t> symbols; // id + 1 для strings[i], 0 - ещё не интернирована
+    };
+
+    std::filesystem::path defaultDirectory()
+    {
+        if (const char* forced = std::getenv("MS_CACHE_DIR"); forced && *forced)
+            return forced;
+        if (const char* xdg = std::getenv("XDG_CACHE_HOME"); xdg && *xdg)
+            return std::filesystem::path(xdg) / "monoscript" / "ast";
+        if (const char* home = std::getenv("HOME"); home && *home)
+            return std::filesystem::path(home) / ".cache" / "monoscript" / "ast";
+        return {};
+    }
+
+    // Пересобранный компилятор может разбирать иначе при той же MS_VERSION,
+    // поэтому в ключ идёт и отметка исполняемого файла
+    std::string executableStamp()
+    {
+#if defined(__linux__)
+        std::error_code error;
+        std::filesystem::path executable = std::filesystem::read_symlink("/proc/self/exe", error);
+        if (error)
+            return {};
+        auto size = std::filesystem::file_size(executable, error);
+        if (error)
+            return {};
+        auto time = std::filesystem::last_write_time(executable, error);
+        if (error)
+            return {};
+        return std::to_string(size) + ":" + std::to_string(time.time_since_epoch().count());
+#else
+        return {};
+#endif
+    }
+}
+
+ASTCache::ASTCache() : directory(defaultDirectory()),
+    compilerStamp(std::string(MS_VERSION) + "/" + std::to_string(formatVersion) + "/" + executableStamp())
+{
+}
+
+ASTCache::Key ASTCache::makeKey(std::string_view source, const std::string& moduleName) const
+{
+    uint64_t prefix = hashBytes(compilerStamp, 0) ^ mix(hashBytes(moduleName, 1));
+    return {hashBytes(source, prefix), hashBytes(source, ~prefix)};
+}
+
+std::filesystem::path ASTCache::entryPath(const Key& key) const
+{
+    static constexpr char digits[] = "0123456789abcdef";
+    std::string name(32, '0');
+    for (int i = 0; i < 16; i++)
+    {
+        name[15 - i] = digits[(key.high >> (4 * i)) & 0xf];
+        name[31 - i] = digits[(key.low >> (4 * i)) & 0xf];
+    }
+    return directory / name.substr(0, 2) / (name + ".msast");
+}
+
+uint64_t ASTCache::hash(std::string_view data)
+{
+    return hashBytes(data, 0);
+}
+
+std::string ASTCache::serialize(const ProgramNode& program)
+{
+    Writer writer;
+    writer.writeNode(program.self());
+    return writer.take();
+}
+
+NodePtr<ProgramNode> ASTCache::deserialize(std::string_view data)
+{
+    Reader reader(data);
+    auto program = reader.readNode<ProgramNode>();
+    if (!program || !reader.atEnd())
+        throw std::runtime_error("AST cache: corrupt entry");
+    return program;
+}
+
+NodePtr<ProgramNode> ASTCache::load(std::string_view source, const std::string& moduleName) const
+{
+    if (!isEnabled())
+        return nullptr;
+
+    Key key = makeKey(source, moduleName);
+    std::ifstream file(entryPath(key), std::ios::binary);
+    if (!file)
+        return nullptr;
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    // Заголовок: магия, версия формата, полный ключ (имя файла - тот же ключ, но проверяем)
+    // и контрольная сумма дерева: Reader проверяет только структуру, а испорченное
+    // поле узла с правильной структурой уронило бы следующие проходы
+    uint32_t version;
+    uint64_t low, high, checksum;
+    if (data.size() < headerSize || std::memcmp(data.data(), magic, sizeof(magic)) != 0)
+        return nullptr;
+    std::memcpy(&version, data.data() + sizeof(magic), sizeof(version));
+    std::memcpy(&low, data.data() + sizeof(magic) + sizeof(version), sizeof(low));
+    std::memcpy(&high, data.data() + sizeof(magic) + sizeof(version) + sizeof(low), sizeof(high));
+    std::memcpy(&checksum, data.data() + sizeof(magic) + sizeof(version) + sizeof(low) + sizeof(high), sizeof(checksum));
+    std::string_view payload = std::string_view(data).substr(headerSize);
+    if (version != formatVersion || low != key.low || high != key.high || checksum != hashBytes(payload, 0))
+        return nullptr;
+
+    try
+    {
+        return deserialize(payload);
+    }
+    catch (const std::runtime_error&)
+    {
+        return nullptr; // Битая запись - разбираем заново, store() её перезапишет
+    }
+}
+
+void ASTCache::store(std::string_view source, const std::string& moduleName, const ProgramNode& program) const
+{
+    if (!isEnabled())
+        return;
+
+    Key key = makeKey(source, moduleName);
+    std::filesystem::path path = entryPath(key);
+    std::error_code error;
+    std::filesystem::create_directories(path.parent_path(), error);
+    if (error)
+        return;
+
+    std::string payload = serialize(program);
+    uint64_t checksum = hashBytes(payload, 0);
+    std::string data;
+    appendRaw(data, magic, sizeof(magic));
+    appendRaw(data, &formatVersion, sizeof(formatVersion));
+    appendRaw(data, &key.low, sizeof(key.low));
+    appendRaw(data, &key.high, sizeof(key.high));
+    appendRaw(data, &checksum, sizeof(checksum));
+    data += payload;
+
+    // Пишем во временный файл и переименовываем: читатель видит либо старую запись, либо полную новую
+    static std::atomic<uint64_t> counter{0};
+    std::filesystem::path temporary = path;
+#if defined(__unix__) || defined(__APPLE__)
+    temporary += ".tmp" + std::to_string(::getpid()) + "." + std::to_string(counter++);
+#else
+    temporary += ".tmp" + std::to_string(counter++);
+#endif
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file.write(data.data(), static_cast<std::streamsize>(data.size())))
+        {
+            file.close();
+            std::filesystem::remove(temporary, error);
+            return;
+        }
+    }
+    std::filesystem::rename(temporary, path, error);
+    if (error)
+        std::filesystem::remove(temporary, error);
+}
+
+void ASTCache::schedule(std::shared_ptr<const SourceBuffer> source, const std::string& moduleName, std::shared_ptr<const TokenStream> tokens)
+{
+    if (!isEnabled())
+        return;
+
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    pending.push_back({std::move(source), moduleName, std::move(tokens)});
+}
+
+void ASTCache::flush()
+{
+    std::vector<Pending> entries;
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        entries.swap(pending);
+    }
+
+    // Разбор заново, а не запись AST модуля: тот уже прошёл проверку типов и несёт её пометки
+    for (const auto& entry : entries)
+    {
+        try
+        {
+            auto program = ParallelParser::parse(*entry.tokens, entry.moduleName);
+            store(entry.source->text(), entry.moduleName, *program);
+        }
+        catch (const std::runtime_error&)
+        {
+            // Тело, до которого запуск не дошёл, не разбирается - модуль остаётся без записи
+        }
+    }
+}
+
+NodePtr<ProgramNode> ASTCache::parse(std::string_view source, const std::string& moduleName, std::shared_ptr<const TokenStream>& tokens)
+{
+    if (auto cached = load(source, moduleName))
+        return cached;
+
+    if (!tokens)
+        tokens = std::make_shared<const TokenStream>(ParallelLexer::tokenize(source));
+    auto program = ParallelParser::parse(*tokens, moduleName);
+    store(source, moduleName, *program);
+    return program;
+}
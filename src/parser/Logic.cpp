@@ -1,4 +1,5 @@
 #include "headers/Parser.h"
+#include <array>
 /*
 Тут все логические и вспомогательные функции
 По типу getIndentLevel, getLastTokenInCurrentLine и т.д.
@@ -11,7 +12,7 @@
 Token Parser::current()
 {
     if (!isEndOfFile() && !isEndOfLine()) {
-        return lines[lineIndex][tokenIndex];
+        return tokens.at(lineIndex, tokenIndex);
     }
     return Token{TokenType::None, "", -1, -1};
 }
@@ -23,7 +24,7 @@ Token Parser::advance()
 {
     if (!isEndOfFile() && !isEndOfLine())
     {
-        return lines[lineIndex][tokenIndex++];
+        return tokens.at(lineIndex, tokenIndex++);
     }
     return Token{TokenType::None, "", -1, -1};
 }
@@ -50,7 +51,7 @@ bool Parser::check(TokenType type)
     if (isEndOfFile()) return false;
     if (isEndOfLine()) return false;
 
-    return lines[lineIndex][tokenIndex].type == type;
+    return tokens.typeAt(lineIndex, tokenIndex) == type;
 }
 
 /// @brief Возвращает следующий токен без перехода к нему
@@ -58,13 +59,37 @@ bool Parser::check(TokenType type)
 /// @return Следующий токен, если индекс токена меньше размера токенов, иначе возвращает токен с типом None и пустым значением
 Token Parser::peek()
 {
-    if (!isEndOfFile() && tokenIndex + 1 < lines[lineIndex].size())
+    if (!isEndOfFile() && tokenIndex + 1 < tokens.lineSize(lineIndex))
     {
-        return lines[lineIndex][tokenIndex+1];
+        return tokens.at(lineIndex, tokenIndex+1);
     }
     return Token{TokenType::None, "", -1, -1};
 }
 
+/// @brief Возвращает тип текущего токена
+/// @return Тип текущего токена или TokenType::None в конце строки/файла
+TokenType Parser::currentType() const
+{
+    if (isEndOfFile() || isEndOfLine()) return TokenType::None;
+    return tokens.typeAt(lineIndex, tokenIndex);
+}
+
+/// @brief Возвращает тип следующего токена без перехода к нему
+/// @return Тип следующего токена или TokenType::None в конце строки/файла
+TokenType Parser::peekType() const
+{
+    if (isEndOfFile() || tokenIndex + 1 >= tokens.lineSize(lineIndex)) return TokenType::None;
+    return tokens.typeAt(lineIndex, tokenIndex + 1);
+}
+
+/// @brief Возвращает текст текущего токена
+/// @return Текст текущего токена или пустая строка в конце строки/файла
+std::string_view Parser::currentValue() const
+{
+    if (isEndOfFile() || isEndOfLine()) return {};
+    return tokens.valueAt(lineIndex, tokenIndex);
+}
+
 /// @brief Переходит к следующей строке токенов
 /// @details Если достигнут конец файла, возвращает false. Иначе увеличивает индекс строки на 1 и сбрасывает индекс токена на 0
 /// @return true, если удалось перейти к следующей строке, иначе возвращает false
@@ -79,13 +104,9 @@ bool Parser::nextLine()
 void Parser::throwError(const std::string &errMsg)
 {
     std::string sourceFragment = "";
-    if (lineIndex < lines.size()) 
+    if (lineIndex < tokens.lineCount()) 
     {
-        std::string lineStr = "";
-        for (const auto& token : lines[lineIndex]) 
-        {
-            lineStr += token.value + " ";
-        }
+        std::string lineStr = tokens.lineText(lineIndex);
         
         sourceFragment = "\n|>  " + lineStr + " <|\n";
         sourceFragment = std::string(sourceFragment.size()-2, '-') + sourceFragment + std::string(sourceFragment.size()-2, '-');
@@ -93,7 +114,7 @@ void Parser::throwError(const std::string &errMsg)
     
     throw std::runtime_error(
         "Parser Error [line " + std::to_string(lineIndex+1) + 
-        (tokenIndex < lines[lineIndex].size() ? ", column " + std::to_string(lines[lineIndex][tokenIndex].column) : "") +
+        (lineIndex < tokens.lineCount() && tokenIndex < tokens.lineSize(lineIndex) ? ", column " + std::to_string(tokens.at(lineIndex, tokenIndex).column) : "") +
         "]: " + errMsg + "\n\nSOURCE(FILENAME) - placeholders\n" + sourceFragment
     );
 }
@@ -111,37 +132,31 @@ void Parser::consume(TokenType Token, const std::string &errMsg)
 }
 
 /// @brief  Проверяет, достигнут ли конец файла
-/// @details Если индекс строки больше или равен размеру токенов, возвращает true
+/// @details Если индекс строки дошёл до конца разбираемого диапазона (по умолчанию - всего потока), возвращает true
 /// @return  true, если достигнут конец файла, иначе false
 bool Parser::isEndOfFile() const
 {
-    return lineIndex >= lines.size();
+    return lineIndex >= lineEnd;
 }
 
 /// @brief Проверяет, достигнут ли конец строки токенов
 /// @return true, если достигнут конец строки токенов, иначе false
 bool Parser::isEndOfLine() const
 {
-    return tokenIndex >= lines[lineIndex].size();
+    return tokenIndex >= tokens.lineSize(lineIndex);
 }
 
 /// @brief Получает уровень отступа для данной строки токенов
 /// @details Уровень отступа определяется количеством токенов типа Pipe в начале строки
-/// @param line Строка токенов, для которой нужно получить уровень отступа 
+/// @param line Индекс строки токенов, для которой нужно получить уровень отступа 
 /// @return Уровень отступа для данной строки токенов
-int Parser::getIndentLevel(const std::vector<Token>& line)
+int Parser::getIndentLevel(int line) const
 {
     int indentLevel = 0;
-    for (const auto& token : line)
+    int lineSize = static_cast<int>(tokens.lineSize(line));
+    while (indentLevel < lineSize && tokens.typeAt(line, indentLevel) == TokenType::Pipe) // если токен - отступ
     {
-        if (token.type == TokenType::Pipe) // если токен - отступ
-        {
-            indentLevel++;
-        }
-        else
-        {
-            break; // выходим из цикла, если встретили не отступ
-        }
+        indentLevel++;
     }
     return indentLevel;
 }
@@ -150,12 +165,12 @@ int Parser::getIndentLevel(const std::vector<Token>& line)
 /// @return Последний токен в текущей строке, если индекс строки меньше размера токенов, иначе возвращает токен с типом None и пустым значением
 Token Parser::getLastTokenInCurrentLine() const
 {
-    if (lineIndex < lines.size())
+    if (lineIndex < tokens.lineCount())
     {
-        const std::vector<Token>& currentLine = lines[lineIndex];
-        if (!currentLine.empty())
+        size_t lineSize = tokens.lineSize(lineIndex);
+        if (lineSize > 0)
         {
-            return currentLine.back(); // возвращаем последний токен в текущей строке
+            return tokens.at(lineIndex, lineSize - 1); // возвращаем последний токен в текущей строке
         }
     }
     return Token{TokenType::None, "", -1, -1};
@@ -164,21 +179,21 @@ Token Parser::getLastTokenInCurrentLine() const
 /// @brief Возвращает полный тип токена
 /// @details Может быть случий когда пользователь использует array<i32> или array<string> и т.д. и такие случии обрабатываются в Lexer как {Type, "array"} {Operator, "<"} {Type, "i32"} {Operator, ">"}
 /// @return Полный тип токена, если он существует, иначе возвращает пустую строку
-std::shared_ptr<TypeNode> Parser::getFullType()
+NodePtr<TypeNode> Parser::getFullType()
 {
     Token currentToken = current();
     if (currentToken.type != TokenType::Type && currentToken.type != TokenType::Identifier) {
         throwError("Expected type identifier");
     }
     
-    std::string baseName = current().value;
+    std::string baseName(current().value);
     advance();
     
     // Проверяем, является ли это параметризованным типом (generic)
     if (check(TokenType::Operator) && current().value == "<") {
         advance(); // Пропускаем <
         
-        auto genericType = std::make_shared<GenericTypeNode>(baseName);
+        auto genericType = makeNode<GenericTypeNode>(baseName);
         genericType->line = lineIndex;
         genericType->column = tokenIndex;
         
@@ -202,413 +217,498 @@ std::shared_ptr<TypeNode> Parser::getFullType()
         return genericType;
     } else {
         // Простой тип
-        auto node = std::make_shared<SimpleTypeNode>(baseName);
+        auto node = makeNode<SimpleTypeNode>(baseName);
         node->line = lineIndex; node->column = tokenIndex;
         return node;
     }
 }
 
-/// @brief Получает приоритет токена
-/// @param token Токен, для которого нужно получить приоритет
-/// @return Все возможные приоритеты токенов: or - 1, and - 2, == - 3, + и - - 4, * и / - 5. Если токен не является оператором или ключевым словом, возвращает -1
-int Parser::getPrecedence(const Token &token) const
+namespace
 {
-    if (token.type != TokenType::Operator && token.type != TokenType::Keyword && token.type != TokenType::PipeArrow) return -1;
-    if (token.value == "or") return 1; // keyword
-    if (token.value == "and") return 2; // keyword
-    if (token.value == "|>") return 3; // keyword
-    if (token.value == "==" || token.value == "<" || token.value == ">" || token.value == "!=" || token.value == "<=" || token.value == ">=") return 4; // operator
-    if (token.value == "+" || token.value == "-") return 5; // operator
-    if (token.value == "*" || token.value == "/" || token.value == "%" || token.value == "**") return 6; // operator
+    // Токены, которые могут стоять между операндами: +, ==, and, |> и т.д.
+    constexpr auto infixTokenTypes = [] {
+        std::array<bool, tokenTypeCount> table{};
+        table[static_cast<size_t>(TokenType::Operator)] = true;
+        table[static_cast<size_t>(TokenType::Keyword)] = true;
+        table[static_cast<size_t>(TokenType::PipeArrow)] = true;
+        return table;
+    }();
+
+    // Сила связывания по оператору: or - 1, and - 2, |> - 3, сравнения - 4, + и - - 5, * / % ** - 6.
+    // -1 - не инфиксный оператор (IR-операции и BinaryOpcode::Count)
+    constexpr auto bindingPowers = [] {
+        std::array<int8_t, static_cast<size_t>(BinaryOpcode::Count) + 1> table{};
+        table.fill(-1);
+        auto set = [&](BinaryOpcode op, int8_t power) { table[static_cast<size_t>(op)] = power; };
+        set(BinaryOpcode::Or, 1);
+        set(BinaryOpcode::And, 2);
+        set(BinaryOpcode::Pipe, 3);
+        for (auto op : {BinaryOpcode::Equal, BinaryOpcode::NotEqual, BinaryOpcode::Less,
+                        BinaryOpcode::Greater, BinaryOpcode::LessEqual, BinaryOpcode::GreaterEqual})
+            set(op, 4);
+        set(BinaryOpcode::Plus, 5);
+        set(BinaryOpcode::Minus, 5);
+        for (auto op : {BinaryOpcode::Star, BinaryOpcode::Slash, BinaryOpcode::Percent, BinaryOpcode::Power})
+            set(op, 6);
+        return table;
+    }();
+
+    int bindingPower(BinaryOpcode op)
+    {
+        return bindingPowers[static_cast<size_t>(op)];
+    }
+
+    // Бинарный оператор по тексту токена, BinaryOpcode::Count - если это не он
+    BinaryOpcode infixOpcode(std::string_view text)
+    {
+        if (text.size() == 1)
+        {
+            switch (text[0])
+            {
+                case '+': return BinaryOpcode::Plus;
+                case '-': return BinaryOpcode::Minus;
+                case '*': return BinaryOpcode::Star;
+                case '/': return BinaryOpcode::Slash;
+                case '%': return BinaryOpcode::Percent;
+                case '<': return BinaryOpcode::Less;
+                case '>': return BinaryOpcode::Greater;
+                default: return BinaryOpcode::Count;
+            }
+        }
+        if (text == "==") return BinaryOpcode::Equal;
+        if (text == "!=") return BinaryOpcode::NotEqual;
+        if (text == "<=") return BinaryOpcode::LessEqual;
+        if (text == ">=") return BinaryOpcode::GreaterEqual;
+        if (text == "**") return BinaryOpcode::Power;
+        if (text == "and") return BinaryOpcode::And;
+        if (text == "or") return BinaryOpcode::Or;
+        if (text == "|>") return BinaryOpcode::Pipe;
+        return BinaryOpcode::Count;
+    }
+
+    // Унарный оператор по тексту токена: -x, !x, ?x
+    bool prefixOpcode(std::string_view text, UnaryOpcode& op)
+    {
+        if (text.size() != 1) return false;
+        switch (text[0])
+        {
+            case '-': op = UnaryOpcode::Minus; return true;
+            case '!': op = UnaryOpcode::Exclaim; return true;
+            case '?': op = UnaryOpcode::Question; return true;
+            default: return false;
+        }
+    }
+}
 
-    return -1; // Для компилятора, чтобы не ругался на -Wreturn-type
+/// @brief Возвращает инфиксный оператор под курсором
+/// @return Оператор, если текущий токен - бинарный оператор, иначе BinaryOpcode::Count
+BinaryOpcode Parser::currentInfix() const
+{
+    TokenType type = currentType();
+    if (!infixTokenTypes[static_cast<size_t>(type)]) return BinaryOpcode::Count;
+    return infixOpcode(currentValue());
 }
 
-std::shared_ptr<ASTNode> Parser::parseBinary(int precedence) 
+/// @brief Разбирает выражение с операторами не слабее precedence (Pratt)
+/// @details Операторы одного приоритета группируются вправо: a - b - c это a - (b - c)
+NodePtr<ASTNode> Parser::parseBinary(int precedence) 
 {
-    auto left = parseUnary(); // 2
-    int initialLine = lineIndex;  // Запоминаем начальную строку
-    int movedLine = 0; // Флаг для проверки, был ли сделан переход на следующую строку
+    auto left = parsePrefix();
 
     while (true)
     {
-        Token currentToken = current(); // + текущий токен, == текущий токен
-        int currentPrecedence = getPrecedence(currentToken); // Получаем приоритет текущего токена
         // Если дошли до конца строки — пробуем перейти на следующую строку с pipe
-        if (currentToken.type == TokenType::None)
+        if (currentType() == TokenType::None)
         {
             // Проверяем, что следующая строка существует
-            if (!isEndOfFile() && lineIndex + 1 < lines.size())
-            {
-                // Получаем уровень отступа следующей строки
-                int nextIndent = getIndentLevel(lines[lineIndex + 1]);
-
-                if (nextIndent < lines[lineIndex + 1].size() &&
-                    lines[lineIndex + 1][nextIndent].type == TokenType::PipeArrow)
-                {
-                    nextLine();
-                    movedLine++;
-
-                    tokenIndex = getIndentLevel(lines[lineIndex]); // Перепрыгиваем через пайпы/отступы
-
-                    isPipe = true;
-                    currentToken = current();
-                    currentPrecedence = getPrecedence(currentToken);
-                }
-                else
-                {
-                    break; // Нет pipe — выходим из цикла, не переходим на строку
-                }
-            }
-            else
-            {
+            if (isEndOfFile() || lineIndex + 1 >= lineEnd)
                 break; // Конец файла — выходим из цикла
-            }
+
+            // Получаем уровень отступа следующей строки
+            int nextIndent = getIndentLevel(lineIndex + 1);
+            if (nextIndent >= tokens.lineSize(lineIndex + 1) ||
+                tokens.typeAt(lineIndex + 1, nextIndent) != TokenType::PipeArrow)
+                break; // Нет pipe — выходим из цикла, не переходим на строку
+
+            nextLine();
+            tokenIndex = getIndentLevel(lineIndex); // Перепрыгиваем через пайпы/отступы
+            isPipe = true;
         }
-        if (currentPrecedence < precedence) break; // Если текущий приоритет меньше, чем заданный, выходим из цикла
+
+        BinaryOpcode op = currentInfix();
+        int power = bindingPower(op);
+        if (power < precedence) break; // Не оператор или связывает слабее - выражение кончилось
 
         advance(); // Переходим к следующему токену
-        auto right = parseBinary(currentPrecedence);
+        auto right = parseBinary(power);
 
-        left = std::make_shared<BinaryOpNode>(left, currentToken.value, right); // Создаём новый узел бинарной операции
+        left = makeNode<BinaryOpNode>(left, op, right); // Создаём новый узел бинарной операции
         left->line = lineIndex; left->column = tokenIndex; // Устанавливаем строку и колонку для узла
     }
 
     return left; // Возвращаем разобранное выражение
 }
 
-std::shared_ptr<ASTNode> Parser::parseUnary()
+/// @brief Разбирает операнд: выбирает разборщик по типу текущего токена
+NodePtr<ASTNode> Parser::parsePrefix()
 {
-    Token currentToken = current();
-    if (currentToken.type == TokenType::Operator && (currentToken.value == "!" || currentToken.value == "-" || currentToken.value == "?"))
-    {
-        advance(); // Переходим к следующему токену
-        auto right = parseUnary(); // Рекурсивно разбираем правую часть выражения
-        auto node = std::make_shared<UnaryOpNode>(currentToken.value, right); // Создаём новый узел унарной операции
-        node->line = lineIndex; node->column = tokenIndex; // Устанавливаем строку и колонку для узла
-        return node; // Возвращаем узел унарной операции
-    }
-    return parsePrimary(); // Если нет унарной операции, разбираем первичное выражение
+    using PrefixParselet = NodePtr<ASTNode> (Parser::*)();
+    static constexpr auto parselets = [] {
+        std::array<PrefixParselet, tokenTypeCount> table{};
+        table[static_cast<size_t>(TokenType::Number)] = &Parser::parseNumberLiteral;
+        table[static_cast<size_t>(TokenType::String)] = &Parser::parseStringLiteral;
+        table[static_cast<size_t>(TokenType::Identifier)] = &Parser::parseIdentifierExpression;
+        table[static_cast<size_t>(TokenType::LeftBracket)] = &Parser::parseBracketExpression;
+        table[static_cast<size_t>(TokenType::LeftBrace)] = &Parser::parseMapLiteral;
+        table[static_cast<size_t>(TokenType::LeftParen)] = &Parser::parseGrouping;
+        table[static_cast<size_t>(TokenType::Keyword)] = &Parser::parseKeywordExpression;
+        table[static_cast<size_t>(TokenType::Operator)] = &Parser::parsePrefixOperator;
+        return table;
+    }();
+
+    PrefixParselet parselet = parselets[static_cast<size_t>(currentType())];
+    if (!parselet) throwUnknownPrimary();
+    return (this->*parselet)();
 }
 
-std::shared_ptr<ASTNode> Parser::parsePrimary()
+void Parser::throwUnknownPrimary()
 {
     Token currentToken = current();
-    if (currentToken.type == TokenType::Number) // Если токен - число
+    throw std::runtime_error("Parser Error: Unknown primary expression at line " + std::to_string(currentToken.line) +
+        ", column " + std::to_string(currentToken.column) +
+        ": " + std::string(currentToken.value));
+}
+
+NodePtr<ASTNode> Parser::parsePrefixOperator()
+{
+    UnaryOpcode op;
+    if (!prefixOpcode(currentValue(), op)) throwUnknownPrimary();
+
+    advance(); // Переходим к следующему токену
+    auto right = parsePrefix(); // Рекурсивно разбираем правую часть выражения
+    auto node = makeNode<UnaryOpNode>(op, right); // Создаём новый узел унарной операции
+    node->line = lineIndex; node->column = tokenIndex; // Устанавливаем строку и колонку для узла
+    return node; // Возвращаем узел унарной операции
+}
+
+NodePtr<ASTNode> Parser::parseNumberLiteral()
+{
+    std::string_view text = currentValue();
+    int numberLine = lineIndex, numberIndex = tokenIndex; // Для сообщения об ошибке
+    advance(); // Переходим к следующему токену
+    std::optional<int64_t> intValue; // Переменная для хранения значения числа
+    std::optional<float> floatValue; // Переменная для хранения значения числа с плавающей точкой
+    try
     {
-        advance(); // Переходим к следующему токену
-        std::optional<int64_t> intValue; // Переменная для хранения значения числа
-        std::optional<float> floatValue; // Переменная для хранения значения числа с плавающей точкой
-        try
+        if (text.find('.') != std::string_view::npos) // Если число с плавающей точкой
         {
-            if(std::find(currentToken.value.begin(), currentToken.value.end(), '.') != currentToken.value.end()) // Если число с плавающей точкой
-            {
-                floatValue = std::stof(currentToken.value); // Преобразуем строку в число с плавающей точкой
-            }
-            else
-            {
-                intValue = std::stoll(currentToken.value); // Преобразуем строку в число
-            }
+            floatValue = std::stof(std::string(text)); // Преобразуем строку в число с плавающей точкой
         }
-        catch (const std::invalid_argument& e) // Если преобразование не удалось, выбрасываем исключение
+        else
         {
-            throw std::runtime_error("Parser Error: Invalid number format at line " + std::to_string(currentToken.line) +
-                ", column " + std::to_string(currentToken.column) +
-                ": " + currentToken.value);
+            intValue = std::stoll(std::string(text)); // Преобразуем строку в число
         }
+    }
+    catch (const std::invalid_argument& e) // Если преобразование не удалось, выбрасываем исключение
+    {
+        Token numberToken = tokens.at(numberLine, numberIndex);
+        throw std::runtime_error("Parser Error: Invalid number format at line " + std::to_string(numberToken.line) +
+            ", column " + std::to_string(numberToken.column) +
+            ": " + std::string(numberToken.value));
+    }
 
-        if (intValue.has_value()) // Если число целое
-        {
-            std::shared_ptr<SimpleTypeNode> type;
-            if (intValue.value() == 0 || intValue.value() == 1) {
-                type = std::make_shared<SimpleTypeNode>("i1");
-            }
-            else if (intValue.value() >= -128 && intValue.value() <= 127) {
-                type = std::make_shared<SimpleTypeNode>("i8");
-            }
-            else if (intValue.value() >= -32768 && intValue.value() <= 32767) {
-                type = std::make_shared<SimpleTypeNode>("i16");
-            }
-            else if (intValue.value() >= -2147483648 && intValue.value() <= 2147483647) {
-                type = std::make_shared<SimpleTypeNode>("i32");
-            }
-            else {
-                type = std::make_shared<SimpleTypeNode>("i64");
-            }
-            type->line = lineIndex; type->column = tokenIndex;
+    if (intValue.has_value()) // Если число целое
+    {
+        NodePtr<SimpleTypeNode> type;
+        if (intValue.value() == 0 || intValue.value() == 1) {
+            type = makeNode<SimpleTypeNode>("i1");
+        }
+        else if (intValue.value() >= -128 && intValue.value() <= 127) {
+            type = makeNode<SimpleTypeNode>("i8");
+        }
+        else if (intValue.value() >= -32768 && intValue.value() <= 32767) {
+            type = makeNode<SimpleTypeNode>("i16");
+        }
+        else if (intValue.value() >= -2147483648 && intValue.value() <= 2147483647) {
+            type = makeNode<SimpleTypeNode>("i32");
+        }
+        else {
+            type = makeNode<SimpleTypeNode>("i64");
+        }
+        type->line = lineIndex; type->column = tokenIndex;
 
-            auto ASTnode = std::make_shared<NumberNode>(intValue.value(), type); // Создаём узел числа
+        auto ASTnode = makeNode<NumberNode>(intValue.value(), type); // Создаём узел числа
 
-            ASTnode->line = lineIndex; ASTnode->column = tokenIndex; // Устанавливаем строку и колонку для узла
-            if(check(TokenType::Arrow)) return parseCast(ASTnode); // Если есть каст, то кастим
-            return ASTnode; // Возвращаем узел числа
-        }
-        else
-        {
-            auto ASTnode = std::make_shared<FloatNumberNode>(floatValue.value()); // Создаём узел числа с плавающей точкой
-            
-            ASTnode->line = lineIndex; ASTnode->column = tokenIndex; // Устанавливаем строку и колонку для узла
+        ASTnode->line = lineIndex; ASTnode->column = tokenIndex; // Устанавливаем строку и колонку для узла
+        if(check(TokenType::Arrow)) return parseCast(ASTnode); // Если есть каст, то кастим
+        return ASTnode; // Возвращаем узел числа
+    }
+
+    auto ASTnode = makeNode<FloatNumberNode>(floatValue.value()); // Создаём узел числа с плавающей точкой
+
+    ASTnode->line = lineIndex; ASTnode->column = tokenIndex; // Устанавливаем строку и колонку для узла
 
-            if(check(TokenType::Arrow)) return parseCast(ASTnode); // Если есть каст, то кастим
-            return ASTnode; // Возвращаем узел числа с плавающей точкой
+    if(check(TokenType::Arrow)) return parseCast(ASTnode); // Если есть каст, то кастим
+    return ASTnode; // Возвращаем узел числа с плавающей точкой
+}
+
+NodePtr<ASTNode> Parser::parseStringLiteral()
+{
+    std::string_view strValue = currentValue();
+    strValue = strValue.substr(1, strValue.length()-2); // Обрезаем кавычки
+    advance(); // Переходим к следующему токену
+
+    // Обрабатываем экранированные последовательности
+    std::string processedValue;
+    processedValue.reserve(strValue.length()); // Резервируем память для оптимизации
+    
+    for (size_t i = 0; i < strValue.length(); ++i) {
+        if (strValue[i] == '\\' && i + 1 < strValue.length()) {
+            // Обработка экранированных последовательностей
+            switch (strValue[i + 1]) {
+                case 'n': processedValue.push_back('\n'); break;
+                case 't': processedValue.push_back('\t'); break;
+                case 'r': processedValue.push_back('\r'); break;
+                case 'f': processedValue.push_back('\f'); break;
+                case 'b': processedValue.push_back('\b'); break;
+                case '0': processedValue.push_back('\0'); break;
+                case '\'': processedValue.push_back('\''); break;
+                case '"': processedValue.push_back('"'); break;
+                case '\\': processedValue.push_back('\\'); break;
+                default: 
+                    // Неизвестная экранированная последовательность - сохраняем как есть
+                    processedValue.push_back('\\');
+                    processedValue.push_back(strValue[i + 1]);
+                    break;
+            }
+            ++i;
+        } else {
+            processedValue.push_back(strValue[i]);
         }
     }
-    else if (currentToken.type == TokenType::String) // Если токен - строка
+    
+    auto stringNode = makeNode<StringNode>(processedValue); // Используем обработанное значение
+    stringNode->line = lineIndex; stringNode->column = tokenIndex; // Устанавливаем строку и колонку для узла
+    
+    return stringNode; // Возвращаем узел строки
+}
+
+/// @brief Идентификатор, вызов функции name(...) или доступ к члену name.x / name[i]
+NodePtr<ASTNode> Parser::parseIdentifierExpression()
+{
+    TokenType next = peekType();
+    if (next == TokenType::LeftBracket || next == TokenType::Dot)
+    {
+        return parseMemberExpression();
+    }
+
+    Symbol name = tokens.symbolAt(lineIndex, tokenIndex); // Имя уже интернировано лексером
+    advance(); // Переходим к следующему токену
+
+    if (next == TokenType::LeftParen)
     {
         advance(); // Переходим к следующему токену
         
-        std::string strValue = currentToken.value.substr(1, currentToken.value.length()-2); // Получаем значение строки обрезая кавычки
+        std::vector<NodePtr<ASTNode>> arguments; // Вектор аргументов функции
+        if (!check(TokenType::RightParen))
+        {
+            do
+            { 
+                arguments.push_back(parseExpression()); // Если аргумент разобран, добавляем его в вектор
+            } while (match(TokenType::Comma));
+        }
 
-        // Обрабатываем экранированные последовательности
-        std::string processedValue;
-        processedValue.reserve(strValue.length()); // Резервируем память для оптимизации
+        consume(TokenType::RightParen, "Expected ')' after function arguments"); // Проверяем наличие правой скобки
         
-        for (size_t i = 0; i < strValue.length(); ++i) {
-            if (strValue[i] == '\\' && i + 1 < strValue.length()) {
-                // Обработка экранированных последовательностей
-                switch (strValue[i + 1]) {
-                    case 'n': processedValue.push_back('\n'); break;
-                    case 't': processedValue.push_back('\t'); break;
-                    case 'r': processedValue.push_back('\r'); break;
-                    case 'f': processedValue.push_back('\f'); break;
-                    case 'b': processedValue.push_back('\b'); break;
-                    case '0': processedValue.push_back('\0'); break;
-                    case '\'': processedValue.push_back('\''); break;
-                    case '"': processedValue.push_back('"'); break;
-                    case '\\': processedValue.push_back('\\'); break;
-                    default: 
-                        // Неизвестная экранированная последовательность - сохраняем как есть
-                        processedValue.push_back('\\');
-                        processedValue.push_back(strValue[i + 1]);
-                        break;
-                }
-                ++i;
-            } else {
-                processedValue.push_back(strValue[i]);
-            }
-        }
+        auto ASTnode = makeNode<CallNode>(name, arguments); // Создаём узел вызова функции
+        ASTnode->line = lineIndex; ASTnode->column = tokenIndex; // Устанавливаем строку и колонку для узла
         
-        auto stringNode = std::make_shared<StringNode>(processedValue); // Используем обработанное значение // Создаём узел строки обризаяя кавычки
-        stringNode->line = lineIndex; stringNode->column = tokenIndex; // Устанавливаем строку и колонку для узла
+        if(check(TokenType::Arrow)) return parseCast(ASTnode); // Если есть каст, то кастим
         
-        return stringNode; // Возвращаем узел строки
+        return ASTnode; // Возвращаем узел вызова функции
     }
-    else if (currentToken.type == TokenType::Identifier && peek().type == TokenType::LeftParen) // Если токен - идентификатор
-    {
-        advance(); // Переходим к следующему токену
-        if (check(TokenType::LeftParen))
-        {
-            advance(); // Переходим к следующему токену
-            
-            std::vector<std::shared_ptr<ASTNode>> arguments; // Вектор аргументов функции
-            if (!check(TokenType::RightParen))
-            {
-                do
-                { 
-                    arguments.push_back(parseExpression()); // Если аргумент разобран, добавляем его в вектор
-                } while (match(TokenType::Comma));
-            }
 
-            consume(TokenType::RightParen, "Expected ')' after function arguments"); // Проверяем наличие правой скобки
-            
-            auto ASTnode = std::make_shared<CallNode>(currentToken.value, arguments); // Создаём узел вызова функции
-            ASTnode->line = lineIndex; ASTnode->column = tokenIndex; // Устанавливаем строку и колонку для узла
-            
-            if(check(TokenType::Arrow)) return parseCast(ASTnode); // Если есть каст, то кастим
-            
-            return ASTnode; // Возвращаем узел вызова функции
-        }
-    }
-    else if (currentToken.type == TokenType::Identifier && peek().type == TokenType::LeftBracket)
-    {
-        return parseMemberExpression();
-    }
-    else if (currentToken.type == TokenType::Identifier && peek().type == TokenType::Dot)
+    auto ASTnode = makeNode<IdentifierNode>(name);
+    ASTnode->line = lineIndex; ASTnode->column = tokenIndex; // Устанавливаем строку и колонку для узла
+    if(check(TokenType::Arrow)) return parseCast(ASTnode); // Если есть каст, то кастим
+    return ASTnode; // Возвращаем узел идентификатора
+}
+
+/// @brief Лямбда [Type](...) или массив [a, b, ...]
+NodePtr<ASTNode> Parser::parseBracketExpression()
+{
+    if (peekType() == TokenType::Type)
     {
-        return parseMemberExpression();
+        return parseLambdaLiteral();
     }
-    else if (currentToken.type == TokenType::LeftBracket && peek().type == TokenType::Type)
-    {
-        // [i8]func(i8: a) -> a*a
-        advance(); // [
 
-        std::shared_ptr<TypeNode> returnType = getFullType();
+    NodePtr<BlockNode> body = makeNode<BlockNode>();
+    body->line = lineIndex; body->column = tokenIndex; // Устанавливаем строку и колонку для узла
+    if(peekType() == TokenType::RightBracket) {
+        auto none = makeNode<NoneNode>(); 
+        none->line = lineIndex; none->column = tokenIndex; // Устанавливаем строку и колонку для узла
+        return none; // Возвращаем узел none
+    }// если нихуя нету в скобках скипай
 
-        consume(TokenType::RightBracket, "Expected ']' after type in lambda/function literal");
-        consume(TokenType::LeftParen, "Expected '(' after function name"); // Проверяем наличие правой скобки
+    do 
+    {
+        advance();
 
-        // Парсим параметры
-        std::vector<std::pair<std::shared_ptr<TypeNode>, std::string>> params;
-        do
-        {
-            std::shared_ptr<TypeNode> paramType = getFullType(); // Получаем полный тип параметра функции
-            consume(TokenType::Colon, "Expected ':' after parameter type"); // Проверяем наличие двоеточия после типа параметра функции
+        auto value = parseExpression(); 
 
-            std::string paramName = current().value; // Сохраняем имя параметра функции
-            consume(TokenType::Identifier, "Expected identifier"); // Проверяем наличие идентификатора параметра функции
+        body->statements.push_back(value);
+    } while(currentType() == TokenType::Comma);
 
-            params.push_back({paramType, paramName}); // Добавляем параметр в вектор параметров функции
-        } while (match(TokenType::Comma)); // Пока следующий токен - это запятая, продолжаем добавлять параметры функции
-    
-        consume(TokenType::RightParen, "Expected ')' after parameters in lambda/function literal");
+    consume(TokenType::RightBracket, "Expected ']' after array arguments");
+    return body;
+}
 
-        // Парсим тело
-        if(check(TokenType::Arrow))
-        {
-            advance(); // Переходим к следующему токену
-            auto body = parseExpression();
-            auto lambda = std::make_shared<LambdaNode>(returnType, params, body);
-            lambda->line = lineIndex; lambda->column = tokenIndex; // Устанавливаем строку и колонку для узла
-            return lambda; // Возвращаем узел лямбда-функции
-        }
-        else if(check(TokenType::Colon))
-        {
-            int expectedIndent = getIndentLevel(lines[lineIndex]) + 1; // Уровень отступа для блока if
-            nextLine(); // Переходим к следующему токену
-            
-            auto body = parseBlock(expectedIndent);
-            
-            lineIndex--; // Без этого он скипает 2 линии а не одну
-            tokenIndex = getIndentLevel(lines[lineIndex]); // Перепрыгиваем через пайпы/отступы
-            auto lamda = std::make_shared<LambdaNode>(returnType, params, body);
-            lamda->line = lineIndex; lamda->column = tokenIndex; // Устанавливаем строку и колонку для узла
-            return lamda; // Возвращаем узел лямбда-функции
-        }
-        else
-        {
-            throwError("Expected '->' or ':' after parameters in lambda/function literal");
-        }
+NodePtr<ASTNode> Parser::parseLambdaLiteral()
+{
+    // [i8]func(i8: a) -> a*a
+    advance(); // [
 
-        // Вернуть FunctionLiteralNode или аналогичный узел
+    NodePtr<TypeNode> returnType = getFullType();
 
-        /*
-        FunctionNode(const std::string& name, const std::string& associated, std::shared_ptr<TypeNode> returnType, const std::vector<std::pair<std::shared_ptr<TypeNode>, std::string>> parameters, std::shared_ptr<ASTNode> body) 
-            : name(name), associated(associated), returnType(returnType), parameters(parameters), body(body) {}
-        */
-    }
-    else if (currentToken.type == TokenType::LeftBracket)
+    consume(TokenType::RightBracket, "Expected ']' after type in lambda/function literal");
+    consume(TokenType::LeftParen, "Expected '(' after function name"); // Проверяем наличие правой скобки
+
+    // Парсим параметры
+    std::vector<std::pair<NodePtr<TypeNode>, std::string>> params;
+    do
     {
-        std::shared_ptr<BlockNode> body = std::make_shared<BlockNode>();
-        body->line = lineIndex; body->column = tokenIndex; // Устанавливаем строку и колонку для узла
-        if(peek().type == TokenType::RightBracket) {
-            auto none = std::make_shared<NoneNode>(); 
-            none->line = lineIndex; none->column = tokenIndex; // Устанавливаем строку и колонку для узла
-            return none; // Возвращаем узел none
-        }// если нихуя нету в скобках скипай
+        NodePtr<TypeNode> paramType = getFullType(); // Получаем полный тип параметра функции
+        consume(TokenType::Colon, "Expected ':' after parameter type"); // Проверяем наличие двоеточия после типа параметра функции
 
-        do 
-        {
-            advance();
+        std::string paramName(currentValue()); // Сохраняем имя параметра функции
+        consume(TokenType::Identifier, "Expected identifier"); // Проверяем наличие идентификатора параметра функции
 
-            auto value = parseExpression(); 
+        params.push_back({paramType, paramName}); // Добавляем параметр в вектор параметров функции
+    } while (match(TokenType::Comma)); // Пока следующий токен - это запятая, продолжаем добавлять параметры функции
 
-            body->statements.push_back(value);
-        } while(current().type == TokenType::Comma);
+    consume(TokenType::RightParen, "Expected ')' after parameters in lambda/function literal");
 
-        consume(TokenType::RightBracket, "Expected ']' after array arguments");
-        return body;
+    // Парсим тело
+    if(check(TokenType::Arrow))
+    {
+        advance(); // Переходим к следующему токену
+        auto body = parseExpression();
+        auto lambda = makeNode<LambdaNode>(returnType, params, body);
+        lambda->line = lineIndex; lambda->column = tokenIndex; // Устанавливаем строку и колонку для узла
+        return lambda; // Возвращаем узел лямбда-функции
     }
-    else if (currentToken.type == TokenType::LeftBrace)
+    else if(check(TokenType::Colon))
     {
-        if(peek().type == TokenType::RightBrace)  return std::make_shared<NoneNode>(); 
-
-        std::shared_ptr<BlockNode> body = std::make_shared<BlockNode>();
-        body->line = lineIndex; body->column = tokenIndex; // Устанавливаем строку и колонку для узла
+        int expectedIndent = getIndentLevel(lineIndex) + 1; // Уровень отступа для блока if
+        nextLine(); // Переходим к следующему токену
         
-        do 
-        {
-            std::shared_ptr<KeyValueNode> key_value = std::make_shared<KeyValueNode>();
-            key_value->line = lineIndex; key_value->column = tokenIndex; // Устанавливаем строку и колонку для узла
+        auto body = parseBlock(expectedIndent);
+        
+        lineIndex--; // Без этого он скипает 2 линии а не одну
+        tokenIndex = getIndentLevel(lineIndex); // Перепрыгиваем через пайпы/отступы
+        auto lamda = makeNode<LambdaNode>(returnType, params, body);
+        lamda->line = lineIndex; lamda->column = tokenIndex; // Устанавливаем строку и колонку для узла
+        return lamda; // Возвращаем узел лямбда-функции
+    }
+
+    throwError("Expected '->' or ':' after parameters in lambda/function literal");
+    return nullptr; // Для компилятора: throwError не возвращается
+}
+
+NodePtr<ASTNode> Parser::parseMapLiteral()
+{
+    if(peekType() == TokenType::RightBrace)  return makeNode<NoneNode>(); 
+
+    NodePtr<BlockNode> body = makeNode<BlockNode>();
+    body->line = lineIndex; body->column = tokenIndex; // Устанавливаем строку и колонку для узла
+    
+    do 
+    {
+        NodePtr<KeyValueNode> key_value = makeNode<KeyValueNode>();
+        key_value->line = lineIndex; key_value->column = tokenIndex; // Устанавливаем строку и колонку для узла
+
+        advance();
+
+        key_value->keyName = currentValue(); // {[here] : value}
+
+        auto key = parseExpression(); // {[here] : value}
+        key_value->key = key; 
 
-            advance();
+        consume(TokenType::Colon, "Expected : after key"); // Ну сжираем нахуй : между ними
 
-            key_value->keyName = current().value; // {[here] : value}
+        auto value = parseExpression(); // {key : [here]}
+        key_value->value = value;
 
-            auto key = parseExpression(); // {[here] : value}
-            key_value->key = key; 
+        body->statements.push_back(key_value);
+    } while(currentType() == TokenType::Comma);
 
-            consume(TokenType::Colon, "Expected : after key"); // Ну сжираем нахуй : между ними
+    consume(TokenType::RightBrace, "Expected '}' after map arguments");
+    return body;
+}
 
-            auto value = parseExpression(); // {key : [here]}
-            key_value->value = value;
+NodePtr<ASTNode> Parser::parseGrouping()
+{
+    advance(); // Переходим к следующему токену
+    auto expression = parseExpression(); // Разбираем выражение внутри скобок
 
-            body->statements.push_back(key_value);
-        } while(current().type == TokenType::Comma);
+    consume(TokenType::RightParen, "Expected ')' after expression"); // Проверяем наличие правой скобки
 
-        consume(TokenType::RightBrace, "Expected '}' after map arguments");
-        return body;
+    /*
+    TODO: Каст выражений с помощью CastNode.
+    Пример: (1+2)->i32
+    if (check(TokenType::Arrow)) // Если есть каст, то кастим
+    {
+        auto cast = makeNode<CastNode>(expression);
+        cast->line = lineIndex; cast->column = tokenIndex; // Устанавливаем строку и колонку для узла
+        return parseCast(cast);
     }
-    else if (currentToken.type == TokenType::LeftParen) // Если токен - левая скобка
+    */
+    return expression; // Возвращаем разобранное выражение
+}
+
+/// @brief Литералы-ключевые слова: true, false, null, none и defined(expr)
+NodePtr<ASTNode> Parser::parseKeywordExpression()
+{
+    std::string_view keyword = currentValue();
+    if (keyword == "true" || keyword == "false") // Если токен - булевый литерал
     {
         advance(); // Переходим к следующему токену
-        auto expression = parseExpression(); // Разбираем выражение внутри скобок
-
-        consume(TokenType::RightParen, "Expected ')' after expression"); // Проверяем наличие правой скобки
-
-        /*
-        TODO: Каст выражений с помощью CastNode.
-        Пример: (1+2)->i32
-        if (check(TokenType::Arrow)) // Если есть каст, то кастим
-        {
-            auto cast = std::make_shared<CastNode>(expression);
-            cast->line = lineIndex; cast->column = tokenIndex; // Устанавливаем строку и колонку для узла
-            return parseCast(cast);
-        }
-        */
-        return expression; // Возвращаем разобранное выражение
+        auto type = makeNode<SimpleTypeNode>("i1"); // Создаём тип bool
+        
+        type->line = lineIndex; type->column = tokenIndex; // Устанавливаем строку и колонку для узла
+        
+        auto numberNode = makeNode<NumberNode>(keyword == "true", type); // Создаём узел булевого значения
+        
+        numberNode->line = lineIndex; numberNode->column = tokenIndex; // Устанавливаем строку и колонку для узла
+        return numberNode; // Создаём узел булевого значения
     }
-    else if (currentToken.type == TokenType::Keyword)
+    else if (keyword == "null") // Если токен - null
     {
-        if (currentToken.value == "true" || currentToken.value == "false") // Если токен - булевый литерал
-        {
-            advance(); // Переходим к следующему токену
-            auto type = std::make_shared<SimpleTypeNode>("i1"); // Создаём тип bool
-            
-            type->line = lineIndex; type->column = tokenIndex; // Устанавливаем строку и колонку для узла
-            
-            auto numberNode = std::make_shared<NumberNode>(currentToken.value == "true", type); // Создаём узел булевого значения
-            
-            numberNode->line = lineIndex; numberNode->column = tokenIndex; // Устанавливаем строку и колонку для узла
-            return numberNode; // Создаём узел булевого значения
-        }
-        else if (currentToken.value == "null") // Если токен - null
-        {
-            advance(); // Переходим к следующему токену
-            auto nullNode = std::make_shared<NullNode>(); // Создаём узел null
-            nullNode->line = lineIndex; nullNode->column = tokenIndex; // Устанавливаем строку и колонку для узла
-            return nullNode; // Возвращаем узел null
-        }
-        else if (currentToken.value == "none")
-        {
-            advance(); // Переходим к следующему токену
-            auto noneNode = std::make_shared<NoneNode>(); // Создаём узел none
-            noneNode->line = lineIndex; noneNode->column = tokenIndex; // Устанавливаем строку и колонку для узла
-            return noneNode; // Возвращаем узел none
-        }
-        else if (currentToken.value == "defined")
-        {
-            advance();
-            auto call = std::make_shared<CallNode>();
-            call->line = lineIndex; call->column = tokenIndex; // Устанавливаем строку и колонку для узла
-            call->callee = "defined";
-            call->arguments.push_back(parseExpression());
-            return call;
-        }
+        advance(); // Переходим к следующему токену
+        auto nullNode = makeNode<NullNode>(); // Создаём узел null
+        nullNode->line = lineIndex; nullNode->column = tokenIndex; // Устанавливаем строку и колонку для узла
+        return nullNode; // Возвращаем узел null
     }
-    else if (currentToken.type == TokenType::Identifier && (peek().value != "." || peek().value != "["))
+    else if (keyword == "none")
+    {
+        advance(); // Переходим к следующему токену
+        auto noneNode = makeNode<NoneNode>(); // Создаём узел none
+        noneNode->line = lineIndex; noneNode->column = tokenIndex; // Устанавливаем строку и колонку для узла
+        return noneNode; // Возвращаем узел none
+    }
+    else if (keyword == "defined")
     {
         advance();
-        auto ASTnode = std::make_shared<IdentifierNode>(currentToken.value);
-        ASTnode->line = lineIndex; ASTnode->column = tokenIndex; // Устанавливаем строку и колонку для узла
-        if(check(TokenType::Arrow)) return parseCast(ASTnode); // Если есть каст, то кастим
-        else return ASTnode; // Возвращаем узел идентификатора
+        auto call = makeNode<CallNode>();
+        call->line = lineIndex; call->column = tokenIndex; // Устанавливаем строку и колонку для узла
+        call->callee = "defined";
+        call->arguments.push_back(parseExpression());
+        return call;
     }
-    throw std::runtime_error("Parser Error: Unknown primary expression at line " + std::to_string(currentToken.line) +
-        ", column " + std::to_string(currentToken.column) +
-        ": " + currentToken.value);
+    throwUnknownPrimary();
 }
 
-void Parser::parseDotNotation(std::shared_ptr<AccessExpression> next)
+void Parser::parseDotNotation(NodePtr<AccessExpression> next)
 {
     // Точечная нотация
     advance(); // пропускаем .
@@ -630,7 +730,7 @@ void Parser::parseDotNotation(std::shared_ptr<AccessExpression> next)
     next->notation = ".";
 }
 
-void Parser::parseArrayNotation(std::shared_ptr<AccessExpression> next)
+void Parser::parseArrayNotation(NodePtr<AccessExpression> next)
 {
     // Индексная нотация
     advance(); // пропускаем [
@@ -646,9 +746,9 @@ void Parser::parseArrayNotation(std::shared_ptr<AccessExpression> next)
     consume(TokenType::RightBracket, "Expected ']' after array notation");
 }
 
-std::shared_ptr<ASTNode> Parser::parseMemberExpression()
+NodePtr<ASTNode> Parser::parseMemberExpression()
 {
-    std::shared_ptr<AccessExpression> root = std::make_shared<AccessExpression>();
+    NodePtr<AccessExpression> root = makeNode<AccessExpression>();
     root->line = lineIndex; root->column = tokenIndex; // Устанавливаем строку и колонку для узла
     auto currentNode = root;
     
@@ -663,7 +763,7 @@ std::shared_ptr<ASTNode> Parser::parseMemberExpression()
     while (check(TokenType::Dot) || check(TokenType::LeftBracket) || 
            (check(TokenType::LeftParen) && currentNode->memberName.size() > 0))
     {
-        auto next = std::make_shared<AccessExpression>();
+        auto next = makeNode<AccessExpression>();
         next->line = lineIndex; next->column = tokenIndex; // Устанавливаем строку и колонку для узла
         next->memberName = currentNode->memberName;
         
@@ -687,7 +787,7 @@ std::shared_ptr<ASTNode> Parser::parseMemberExpression()
     
     if (root->nextAccess == nullptr && !root->expression)
     {
-        auto IdentifierASTNode = std::make_shared<IdentifierNode>(root->memberName);
+        auto IdentifierASTNode = makeNode<IdentifierNode>(root->memberName);
         IdentifierASTNode->line = lineIndex; IdentifierASTNode->column = tokenIndex; // Устанавливаем строку и колонку для узла
         return IdentifierASTNode; // Возвращаем узел идентификатора
     }
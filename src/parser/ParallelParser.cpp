@@ -0,0 +1,94 @@
+#include "headers/ParallelParser.h"
+#include "headers/Parser.h"
+#include "../includes/ThreadPool.hpp"
+#include <algorithm>
+#include <exception>
+#include <vector>
+
+namespace
+{
+    constexpr size_t batchesPerThread = 4; // Запас, чтобы потоки не ждали самую тяжёлую пачку
+
+    struct Batch {
+        int firstLine = 0;
+        int endLine = 0;
+        NodePtr<ProgramNode> program;
+        std::exception_ptr error;
+    };
+
+    // Режет строки на пачки примерно по tokensPerBatch токенов, только по границам объявлений
+    std::vector<Batch> splitIntoBatches(const TokenStream& tokens, size_t count)
+    {
+        std::vector<Batch> batches;
+        size_t tokensPerBatch = std::max<size_t>(tokens.size() / count, 1);
+        size_t lineCount = tokens.lineCount();
+        size_t start = 0;
+        for (size_t line = 1; line < lineCount; line++)
+        {
+            if (tokens.lineStarts[line] - tokens.lineStarts[start] < tokensPerBatch || !ParallelParser::startsDeclaration(tokens, line))
+                continue;
+            batches.push_back({static_cast<int>(start), static_cast<int>(line)});
+            start = line;
+        }
+        batches.push_back({static_cast<int>(start), static_cast<int>(lineCount)});
+        return batches;
+    }
+}
+
+namespace ParallelParser
+{
+    bool startsDeclaration(const TokenStream& tokens, size_t line)
+    {
+        switch (tokens.typeAt(line, 0))
+        {
+            case TokenType::Pipe:
+            case TokenType::PipeArrow:
+                return false;
+            case TokenType::Keyword:
+                return tokens.valueAt(line, 0) != "else";
+            default:
+                return true;
+        }
+    }
+
+    NodePtr<ProgramNode> parse(const TokenStream& tokens, const std::string& moduleName, size_t maxThreads)
+    {
+        ThreadPool& pool = ThreadPool::getInstance();
+        size_t threads = maxThreads == 0 ? pool.size() : std::min(maxThreads, pool.size());
+
+        if (threads <= 1 || tokens.size() < minParallelTokens)
+        {
+            Parser parser(tokens, moduleName);
+            return parser.parse();
+        }
+
+        std::vector<Batch> batches = splitIntoBatches(tokens, threads * batchesPerThread);
+        pool.parallelFor(batches.size(), [&](size_t i) {
+            try
+            {
+                Parser parser(tokens, moduleName, batches[i].firstLine, batches[i].endLine);
+                batches[i].program = parser.parse();
+            }
+            catch (...) { batches[i].error = std::current_exception(); }
+        }, threads);
+
+        for (const auto& batch : batches)
+            if (batch.error)
+            {
+                // Узлы неудачного прохода остаются в арене до reset() - это путь ошибки
+                Parser parser(tokens, moduleName);
+                return parser.parse();
+            }
+
+        auto program = makeNode<ProgramNode>();
+        program->line = 0; program->column = 0;
+        program->moduleName = moduleName;
+        size_t statements = 0;
+        for (const auto& batch : batches)
+            statements += batch.program->body.size();
+        program->body.reserve(statements);
+        for (const auto& batch : batches)
+            program->body.insert(program->body.end(), batch.program->body.begin(), batch.program->body.end());
+        return program;
+    }
+}
@@ -7,9 +7,9 @@
 /// @brief Парсит программу
 /// @details Создает узел программы и добавляет в него все узлы, которые были распознаны в процессе парсинга
 /// @return Указатель на узел программы, содержащий все узлы, которые были распознаны в процессе парсинга
-std::shared_ptr<ProgramNode> Parser::parse()
+NodePtr<ProgramNode> Parser::parse()
 {
-    auto program = std::make_shared<ProgramNode>();
+    auto program = makeNode<ProgramNode>();
     program->line = lineIndex; program->column = tokenIndex;
     program->moduleName = moduleName;
     
@@ -22,10 +22,10 @@ std::shared_ptr<ProgramNode> Parser::parse()
         {
             std::runtime_error("Parser Error: Expected statement at line " + std::to_string(current().line) +
                 ", column " + std::to_string(current().column) +
-                ": " + current().value);
+                ": " + std::string(current().value));
         }
         if (statement) program->body.push_back(statement);
-        if (!isEndOfLine() && (currentLine == lineIndex)) throwError("Character(" + current().value + ") not parsed at the end of");
+        if (!isEndOfLine() && (currentLine == lineIndex)) throwError("Character(" + std::string(current().value) + ") not parsed at the end of");
         if (!nextLine()) break; // если не удалось перейти к следующей строке, выходим из цикла
     }
     return program;
@@ -34,7 +34,7 @@ std::shared_ptr<ProgramNode> Parser::parse()
 /// @brief Парсит оператор
 /// @details Разбирает оператор в зависимости от его типа. Если оператор не распознан, выбрасывает исключение.
 /// @return Указатель на узел AST, представляющий разобранный оператор.
-std::shared_ptr<ASTNode> Parser::parseStatement()
+NodePtr<ASTNode> Parser::parseStatement()
 {
     Token currentToken = current();
     // Function declaration
@@ -97,7 +97,7 @@ std::shared_ptr<ASTNode> Parser::parseStatement()
         // ↑ if we have keyword break, we have break statement
     else if (currentToken.type == TokenType::Keyword && currentToken.value == "break")
     {
-        auto breakNode = std::make_shared<BreakNode>(); // А тут и в continue нехуй заморачиваться, правильно? правильно
+        auto breakNode = makeNode<BreakNode>(); // А тут и в continue нехуй заморачиваться, правильно? правильно
         breakNode->line = lineIndex; breakNode->column = tokenIndex;
         return breakNode;
     }
@@ -106,7 +106,7 @@ std::shared_ptr<ASTNode> Parser::parseStatement()
         // ↑ if we have keyword continue, we have continue statement
     else if (currentToken.type == TokenType::Keyword && currentToken.value == "continue")
     {
-        auto continueNode = std::make_shared<ContinueNode>();
+        auto continueNode = makeNode<ContinueNode>();
         continueNode->line = lineIndex; continueNode->column = tokenIndex;
         return continueNode;
     }
@@ -119,7 +119,7 @@ std::shared_ptr<ASTNode> Parser::parseStatement()
             if(current().value == "=")
             {
                 advance();
-                auto reassignNode = std::make_shared<ReassignMemberNode>();
+                auto reassignNode = makeNode<ReassignMemberNode>();
                 reassignNode->line = lineIndex; reassignNode->column = tokenIndex;
                 reassignNode->accessExpression = memberExpression;
                 reassignNode->expression = parseExpression();
@@ -3,7 +3,61 @@
 Ну а тут уже парсеры для всех действий в языке
 */
 
-std::shared_ptr<FunctionNode> Parser::parseFunction()
+NodePtr<FunctionNode> Parser::parseFunction()
+{
+    auto func = parseFunctionSignature(); // Заголовок: тип, имя, параметры и метки
+
+    int expectedIndent = getIndentLevel(lineIndex) + 1; // Уровень отступа для блока if
+    nextLine(); // Переходим к следующему токену
+
+    NodePtr<BlockNode> body = nullptr; // Создаём указатель на тело функции
+
+    if (getIndentLevel(lineIndex) == expectedIndent-1)
+    {
+        body = makeNode<BlockNode>(); // Создаём тело функции
+        body->line = lineIndex; body->column = tokenIndex; // Устанавливаем строку и колонку для узла
+    }
+    else if (getIndentLevel(lineIndex) == expectedIndent)
+    {
+        if (deferredTokens && expectedIndent == 1)
+            deferBody(func, expectedIndent); // Модуль из use: тело разберётся, когда понадобится
+        else
+            body = parseBlock(expectedIndent); // Парсим тело функции
+    }
+    else
+    {
+        throwError("Expected indentation after function declaration");
+    }
+
+    lineIndex--; // Без этого он скипает 2 линии а не одну
+
+    func->body = body;
+    return func; // Возвращаем узел функции
+}
+
+void Parser::deferBody(NodePtr<FunctionNode> function, int expectedIndent)
+{
+    // Тело - строки с отступом не меньше expectedIndent, те же, что прочитал бы parseBlock
+    int firstLine = lineIndex;
+    while (!isEndOfFile() && getIndentLevel(lineIndex) >= expectedIndent)
+        nextLine();
+    int endLine = lineIndex;
+
+    function->deferredBody = [tokens = deferredTokens, module = moduleName, firstLine, endLine, expectedIndent]() -> NodePtr<ASTNode> {
+        Parser parser(*tokens, module, firstLine, endLine);
+        try
+        {
+            return parser.parseBlock(expectedIndent);
+        }
+        catch (const std::runtime_error& error)
+        {
+            // Ошибка всплывает не при загрузке модуля, поэтому сообщение называет его, как Linker
+            throw std::runtime_error("Error loading module " + module + ": " + error.what());
+        }
+    };
+}
+
+NodePtr<FunctionNode> Parser::parseFunctionSignature()
 {
     /*
     Function declaration:
@@ -15,31 +69,31 @@ std::shared_ptr<FunctionNode> Parser::parseFunction()
 
     std::string association = "";
 
-    std::shared_ptr<TypeNode> returnType = getFullType(); // Получаем полный тип функции
+    NodePtr<TypeNode> returnType = getFullType(); // Получаем полный тип функции
     consume(TokenType::RightBracket, "Expected ']' before function declaration"); 
-    std::string functionName = current().value; // Сохраняем имя функции
+    Symbol functionName = current().symbol; // Сохраняем имя функции
     consume(TokenType::Identifier, "Expected identifier"); // Проверяем наличие идентификатора
 
     if (check(TokenType::Colon))
     {
         consume(TokenType::Colon, "Expected '::' when associating function to class");
         consume(TokenType::Colon, "Expected '::' when associating function to class");
-        association = current().value;
-        std::swap(functionName, association);
+        association = functionName.str(); // То, что стояло до '::', - имя класса
+        functionName = current().symbol;
         consume(TokenType::Identifier, "Class identifier expected after association");
     }
     
     if (check(TokenType::LeftParen)) // Если следующий токен - это левая скобка, то это функция с параметрами
     {
         advance(); // Переходим к следующему токену
-        std::vector<std::pair<std::shared_ptr<TypeNode>, std::string>> parameters; // Вектор параметров функции
+        std::vector<std::pair<NodePtr<TypeNode>, Symbol>> parameters; // Вектор параметров функции
         int lambdaCounter = 0; // Счётчик лямбд
 
         if (!check(TokenType::RightParen)) // Если следующий токен - это не правая скобка, то это функция с параметрами
         {
             do
             {
-                std::shared_ptr<TypeNode> paramType = getFullType(); // Получаем полный тип параметра функции
+                NodePtr<TypeNode> paramType = getFullType(); // Получаем полный тип параметра функции
                 consume(TokenType::Colon, "Expected ':' after parameter type"); // Проверяем наличие двоеточия после типа параметра функции
                 if (paramType->toString() == "func") // Если тип параметра не определён, выбрасываем исключение
                 {
@@ -58,12 +112,12 @@ std::shared_ptr<FunctionNode> Parser::parseFunction()
                         paramName = "@" + std::to_string(lambdaCounter++);
 
                     consume(TokenType::LeftParen, "Expected '(' after function type"); // Проверяем наличие левой скобки после типа параметра функции
-                    std::vector<std::pair<std::shared_ptr<TypeNode>, std::string>> params;
+                    std::vector<std::pair<NodePtr<TypeNode>, std::string>> params;
                     do
                     {
-                        std::shared_ptr<TypeNode> paramType = getFullType(); // Получаем полный тип параметра функции
+                        NodePtr<TypeNode> paramType = getFullType(); // Получаем полный тип параметра функции
                         consume(TokenType::Colon, "Expected ':' after parameter type"); // Проверяем наличие двоеточия после типа параметра функции
-                        std::string paramName = current().value; // Сохраняем имя параметра функции
+                        std::string paramName(current().value); // Сохраняем имя параметра функции
                         consume(TokenType::Identifier, "Expected identifier"); // Проверяем наличие идентификатора параметра функции
 
                         params.push_back({paramType, paramName}); // Добавляем параметр в вектор параметров функции
@@ -72,7 +126,7 @@ std::shared_ptr<FunctionNode> Parser::parseFunction()
                     consume(TokenType::Arrow, "Expected '->' after parameters in lambda/function literal"); // Проверяем наличие стрелки после параметров функции
                     auto returnType = getFullType(); // Получаем полный тип возвращаемого значения функции
 
-                    std::shared_ptr<GenericTypeNode> genericType = std::make_shared<GenericTypeNode>("func"); // Создаём указатель на тип функции
+                    NodePtr<GenericTypeNode> genericType = makeNode<GenericTypeNode>("func"); // Создаём указатель на тип функции
                     genericType->line = lineIndex; genericType->column = tokenIndex; // Устанавливаем строку и колонку для узла
                     for (const auto& param : params) // Для каждого параметра функции
                     {
@@ -84,7 +138,7 @@ std::shared_ptr<FunctionNode> Parser::parseFunction()
                 }
                 else
                 {
-                    std::string paramName = current().value; // Сохраняем имя параметра функции
+                    std::string paramName(current().value); // Сохраняем имя параметра функции
                     consume(TokenType::Identifier, "Expected identifier"); // Проверяем наличие идентификатора параметра функции
 
                     parameters.push_back({paramType, paramName}); // Добавляем параметр в вектор параметров функции
@@ -97,34 +151,13 @@ std::shared_ptr<FunctionNode> Parser::parseFunction()
         std::vector<std::string> labels; // Вектор меток функции
         while (check(TokenType::Label))
         {
-            std::string label = current().value;
+            std::string label(current().value);
             consume(TokenType::Label, "Expected label"); // Проверяем наличие метки функции
 
             labels.push_back(label);
         }
-        
-        int expectedIndent = getIndentLevel(lines[lineIndex]) + 1; // Уровень отступа для блока if
-        nextLine(); // Переходим к следующему токену
-
-        std::shared_ptr<BlockNode> body = nullptr; // Создаём указатель на тело функции
-
-        if (getIndentLevel(lines[lineIndex]) == expectedIndent-1)
-        {
-            body = std::make_shared<BlockNode>(); // Создаём тело функции
-            body->line = lineIndex; body->column = tokenIndex; // Устанавливаем строку и колонку для узла
-        }
-        else if (getIndentLevel(lines[lineIndex]) == expectedIndent)
-        {
-            body = parseBlock(expectedIndent); // Парсим тело функции
-        }
-        else
-        {
-            throwError("Expected indentation after function declaration");
-        }
-
-        lineIndex--; // Без этого он скипает 2 линии а не одну
 
-        auto func = std::make_shared<FunctionNode>(functionName, association, returnType, parameters, labels, body); // Создаём узел функции
+        auto func = makeNode<FunctionNode>(functionName, association, returnType, parameters, labels, nullptr); // Создаём узел функции без тела
         func->line = line; func->column = token; // Устанавливаем строку и колонку для узла
         return func; // Возвращаем узел функции
     }
@@ -136,12 +169,12 @@ std::shared_ptr<FunctionNode> Parser::parseFunction()
     return nullptr; // Если ничего не найдено, возвращаем nullptr
 }
 
-std::shared_ptr<ASTNode> Parser::parseCast(std::shared_ptr<ASTNode> expression)
+NodePtr<ASTNode> Parser::parseCast(NodePtr<ASTNode> expression)
 {
     consume(TokenType::Arrow, "Expected '->' after expression"); // Проверяем наличие стрелки после выражения
     if(check(TokenType::Type))
     {
-        std::string typeName = current().value; // Сохраняем имя типа
+        std::string typeName(current().value); // Сохраняем имя типа
         if(typeName != "array" && typeName != "func" && typeName != "string" && typeName != "struct" && typeName != "map" && typeName != "void")
         {
             advance(); // Переходим к следующему токену
@@ -150,7 +183,7 @@ std::shared_ptr<ASTNode> Parser::parseCast(std::shared_ptr<ASTNode> expression)
         {
             throwError("Expected primitive type after '->'");
         }
-        expression->implicitCastTo = std::make_shared<SimpleTypeNode>(typeName); // Создаём указатель на тип
+        expression->implicitCastTo = makeNode<SimpleTypeNode>(typeName); // Создаём указатель на тип
         expression->implicitCastTo->line = lineIndex; expression->implicitCastTo->column = tokenIndex; // Устанавливаем строку и колонку для узла
         return expression; // Возвращаем выражение
     }
@@ -161,7 +194,7 @@ std::shared_ptr<ASTNode> Parser::parseCast(std::shared_ptr<ASTNode> expression)
     return nullptr; // Если ничего не найдено, возвращаем nullptr
 }
 
-std::shared_ptr<ASTNode> Parser::parseIf()
+NodePtr<ASTNode> Parser::parseIf()
 {
     int line = lineIndex; int token = tokenIndex; // Запоминаем строку и токен
 
@@ -174,11 +207,11 @@ std::shared_ptr<ASTNode> Parser::parseIf()
     // Поэтому мы просто сразу посылаем его в parseExpression который разберёт его
 
     auto condition = parseExpression();
-    int expectedIndent = getIndentLevel(lines[lineIndex]) + 1; // Уровень отступа для блока if
+    int expectedIndent = getIndentLevel(lineIndex) + 1; // Уровень отступа для блока if
     nextLine(); // Переходим к следующей строке токенов 
 
     auto thenBlock = parseBlock(expectedIndent);
-    std::shared_ptr<ASTNode> elseBlock = nullptr;
+    NodePtr<ASTNode> elseBlock = nullptr;
     tokenIndex = expectedIndent-1;
     //if (tokenIndex!=(expectedIndent-1)) 
 
@@ -199,13 +232,13 @@ std::shared_ptr<ASTNode> Parser::parseIf()
 
     lineIndex--; // Без этого он скипает 2 линии а не одну
 
-    auto ifNode = std::make_shared<IfNode>(condition, thenBlock, elseBlock);
+    auto ifNode = makeNode<IfNode>(condition, thenBlock, elseBlock);
     ifNode->line = line; ifNode->column = token; // Устанавливаем строку и колонку для узла
     
     return ifNode; // Возвращаем узел if
 }
 
-std::shared_ptr<ASTNode> Parser::parseFor()
+NodePtr<ASTNode> Parser::parseFor()
 {
     /*
     For statement:
@@ -216,7 +249,7 @@ std::shared_ptr<ASTNode> Parser::parseFor()
 
     consume(TokenType::Keyword, "Expected 'for' keyword"); // Проверяем наличие ключевого слова for
 
-    std::string iterationVariable = current().value; // Сохраняем имя переменной итерации
+    std::string iterationVariable(current().value); // Сохраняем имя переменной итерации
     consume(TokenType::Identifier, "Expected identifier"); // Проверяем наличие идентификатора
 
     if(current().type != TokenType::Keyword && current().value != "in")
@@ -230,20 +263,20 @@ std::shared_ptr<ASTNode> Parser::parseFor()
     if (currentLine < lineIndex) // Если мы не перешли на следующую линию, то это не for
         lineIndex--;
 
-    int expectedIndent = getIndentLevel(lines[lineIndex]) + 1; // Уровень отступа для блока for
+    int expectedIndent = getIndentLevel(lineIndex) + 1; // Уровень отступа для блока for
     nextLine(); // Переходим к следующему токену 
 
     auto body = parseBlock(expectedIndent); // Парсим тело цикла for
 
     lineIndex--; // Без этого он скипает 2 линии а не одну
 
-    auto forNode = std::make_shared<ForNode>(iterationVariable, iterable, body); // Создаём узел цикла for
+    auto forNode = makeNode<ForNode>(iterationVariable, iterable, body); // Создаём узел цикла for
     forNode->line = line; forNode->column = token; // Устанавливаем строку и колонку для узла
     
     return forNode; // Возвращаем узел цикла for
 }
 
-std::shared_ptr<ASTNode> Parser::parseWhile()
+NodePtr<ASTNode> Parser::parseWhile()
 {
     /*
     While statement: 
@@ -255,7 +288,7 @@ std::shared_ptr<ASTNode> Parser::parseWhile()
     consume(TokenType::Keyword, "Expected 'while' keyword"); // Проверяем наличие ключевого слова while
     auto condition = parseExpression();
 
-    int expectedIndent = getIndentLevel(lines[lineIndex]) + 1;
+    int expectedIndent = getIndentLevel(lineIndex) + 1;
     nextLine();
 
     auto body = parseBlock(expectedIndent);
@@ -263,12 +296,12 @@ std::shared_ptr<ASTNode> Parser::parseWhile()
     lineIndex--; // Без этого он скипает 2 линии а не одну
 
 
-    auto whileNode = std::make_shared<WhileNode>(condition, body);
+    auto whileNode = makeNode<WhileNode>(condition, body);
     whileNode->line = line; whileNode->column = token; // Устанавливаем строку и колонку для узла
     return whileNode; // Возвращаем узел цикла while
 }
 
-std::shared_ptr<BlockNode> Parser::parseBlock(int expectedIndent)
+NodePtr<BlockNode> Parser::parseBlock(int expectedIndent)
 {
     /*
     Как выглядят блоки в коде:
@@ -276,10 +309,10 @@ std::shared_ptr<BlockNode> Parser::parseBlock(int expectedIndent)
     |   *code*
     |
     */
-    auto block = std::make_shared<BlockNode>();
+    auto block = makeNode<BlockNode>();
     block->line = lineIndex; block->column = tokenIndex; // Устанавливаем строку и колонку для узла
     while (!isEndOfFile()) {
-        int actualIndent = getIndentLevel(lines[lineIndex]);
+        int actualIndent = getIndentLevel(lineIndex);
 
         if (actualIndent < expectedIndent) break;
         
@@ -306,7 +339,7 @@ else
 |   echo("Below threshold")
 */
 
-std::shared_ptr<ASTNode> Parser::parseReturn()
+NodePtr<ASTNode> Parser::parseReturn()
 {
     /*
     Return statement:
@@ -316,23 +349,23 @@ std::shared_ptr<ASTNode> Parser::parseReturn()
     int line = lineIndex; int token = tokenIndex; // Запоминаем строку и токен
 
     consume(TokenType::Keyword, "Expected 'return' keyword"); // Проверяем наличие ключевого слова return
-    std::shared_ptr<ASTNode> expression;
+    NodePtr<ASTNode> expression;
     if(current().column != -1)
         expression = parseExpression(); 
     else
-        expression = std::make_shared<NullNode>();
+        expression = makeNode<NullNode>();
 
-    auto returnNode = std::make_shared<ReturnNode>(expression); // Создаём узел возврата
+    auto returnNode = makeNode<ReturnNode>(expression); // Создаём узел возврата
     returnNode->line = line; returnNode->column = token; // Устанавливаем строку и колонку для узла
     return returnNode; // Возвращаем узел возврата
 }
 
-std::shared_ptr<ASTNode> Parser::parseExpression()
+NodePtr<ASTNode> Parser::parseExpression()
 {
     return parseBinary();
 }
 
-std::shared_ptr<ASTNode> Parser::parseAssignment(bool isConst)
+NodePtr<ASTNode> Parser::parseAssignment(bool isConst)
 {
     /*
     Variable declaration or assignment:
@@ -342,13 +375,13 @@ std::shared_ptr<ASTNode> Parser::parseAssignment(bool isConst)
     const i32 i = 0 -- константа с статической инициализацией
     final i ^= 0  -- константа с динамической инициализацией
     */                           
-    std::shared_ptr<TypeNode> type;                                           // Переменная для хранения типа
+    NodePtr<TypeNode> type;                                           // Переменная для хранения типа
     std::string variableName;                                   // Переменная для хранения имени переменной
     bool finalFlag = false;                                     // Флаг для проверки наличия ключевого слова final
 
     if(isConst)
     {                                     
-        std::string keyWord = current().value;                  // Сохраняем текущее значение токена
+        std::string keyWord(current().value);                  // Сохраняем текущее значение токена
         if (keyWord != "const" && keyWord != "final")           // Проверяем наличие ключевого слова const или final
         {
             throwError("Expected 'const' or 'final'");
@@ -359,7 +392,7 @@ std::shared_ptr<ASTNode> Parser::parseAssignment(bool isConst)
 
     if(current().type == TokenType::Type && (current().value != "array" && current().value != "map"))                       // Проверяем наличие типа
     {
-        type = std::make_shared<SimpleTypeNode>(current().value); // Сохраняем тип переменной   
+        type = makeNode<SimpleTypeNode>(std::string(current().value)); // Сохраняем тип переменной   
         type->line = lineIndex; type->column = tokenIndex; // Устанавливаем строку и колонку для узла
         
         consume(TokenType::Type, "Expected type");              // Проверяем наличие типа
@@ -367,13 +400,13 @@ std::shared_ptr<ASTNode> Parser::parseAssignment(bool isConst)
         consume(TokenType::Identifier, "Expected identifier");  // Проверяем наличие идентификатора
         if(!check(TokenType::Operator) || current().value != "=") // Проверяем наличие оператора присваивания
         {   
-            std::shared_ptr<NoneNode> none = std::make_shared<NoneNode>();
-            return std::make_shared<VariableAssignNode>(variableName, isConst, type, none);
+            NodePtr<NoneNode> none = makeNode<NoneNode>();
+            return makeNode<VariableAssignNode>(variableName, isConst, type, none);
         }
     }
     else if(current().type == TokenType::Identifier && peek().value == "^=") // Проверяем наличие идентификатора
     {
-        type = std::make_shared<SimpleTypeNode>("auto"); // Сохраняем тип переменной
+        type = makeNode<SimpleTypeNode>("auto"); // Сохраняем тип переменной
         type->line = lineIndex; type->column = tokenIndex; // Устанавливаем строку и колонку для узла
 
         variableName = current().value;                         // Сохраняем имя переменной
@@ -390,7 +423,7 @@ std::shared_ptr<ASTNode> Parser::parseAssignment(bool isConst)
         consume(TokenType::Identifier, "Expected identifier");  // Проверяем наличие идентификатора
         consume(TokenType::Operator, "Expected = operator");
         auto expression = parseExpression();
-        auto varReassign = std::make_shared<VariableReassignNode>(variableName, expression);
+        auto varReassign = makeNode<VariableReassignNode>(variableName, expression);
         varReassign->line = lineIndex; varReassign->column = tokenIndex; // Устанавливаем строку и колонку для узла
         return varReassign; // Возвращаем узел присваивания переменной
     }
@@ -414,10 +447,10 @@ std::shared_ptr<ASTNode> Parser::parseAssignment(bool isConst)
         consume(TokenType::Identifier, "Expected identifier");  // Проверяем наличие идентификатора
         if(!check(TokenType::Operator) || current().value != "=") // Проверяем наличие оператора присваивания
         {
-            std::shared_ptr<NoneNode> none = std::make_shared<NoneNode>();
+            NodePtr<NoneNode> none = makeNode<NoneNode>();
             none->line = lineIndex; none->column = tokenIndex; // Устанавливаем строку и колонку для узла
 
-            auto varAssign = std::make_shared<VariableAssignNode>(variableName, isConst, type, none);
+            auto varAssign = makeNode<VariableAssignNode>(variableName, isConst, type, none);
             varAssign->line = lineIndex; varAssign->column = tokenIndex; // Устанавливаем строку и колонку для узла
             return varAssign; // Возвращаем узел присваивания переменной
         }
@@ -425,32 +458,32 @@ std::shared_ptr<ASTNode> Parser::parseAssignment(bool isConst)
     // Здесь мы уже у оператора присваивания, который идёт после имени переменной
     advance(); // Переходим к следующему токену
     //std::cout << "[parseAssignment] Current token: " << current().value << std::endl; // Выводим текущий токен в консоль
-    std::shared_ptr<ASTNode> expression = parseExpression(); // Разбираем выражение справа от оператора присваивания
+    NodePtr<ASTNode> expression = parseExpression(); // Разбираем выражение справа от оператора присваивания
     
     if (!expression) // Если выражение не разобрано, выбрасываем исключение
     {
         throwError("Expected expression after assignment operator");
     }
 
-    auto varAssign = std::make_shared<VariableAssignNode>(variableName, isConst, type ,expression); // Создаём узел присваивания переменной
+    auto varAssign = makeNode<VariableAssignNode>(variableName, isConst, type ,expression); // Создаём узел присваивания переменной
     varAssign->line = lineIndex; varAssign->column = tokenIndex; // Устанавливаем строку и колонку для узла
     return varAssign; // Возвращаем узел присваивания переменной
 }
 
-std::shared_ptr<ASTNode> Parser::parseCall()
+NodePtr<ASTNode> Parser::parseCall()
 {
     /*
     Function call:
     [functionName]([expression], [expression], ...)
     bubbleSort(arr, 0, 10)
     */
-    std::shared_ptr<CallNode> callNode = std::make_shared<CallNode>();
+    NodePtr<CallNode> callNode = makeNode<CallNode>();
     callNode->line = lineIndex; callNode->column = tokenIndex; // Устанавливаем строку и колонку для узла
     callNode->callee = current().value;
     consume(TokenType::Identifier, "Expected function name"); // Проверяем наличие идентификатора функции
     consume(TokenType::LeftParen, "Expected '(' after function name");
     
-    std::vector<std::shared_ptr<ASTNode>> arguments; // Вектор аргументов функции
+    std::vector<NodePtr<ASTNode>> arguments; // Вектор аргументов функции
 
     if (!check(TokenType::RightParen)) // Если после ( там нету сразу ) значит есть аргументы ёпта
     {
@@ -466,7 +499,7 @@ std::shared_ptr<ASTNode> Parser::parseCall()
     return callNode; // Создаём узел идентификатора
 }
 
-std::shared_ptr<ASTNode> Parser::parseStruct()
+NodePtr<ASTNode> Parser::parseStruct()
 {
     /*
 |   // Struct definition
@@ -480,21 +513,21 @@ std::shared_ptr<ASTNode> Parser::parseStruct()
     consume(TokenType::Type, "Expected 'struct' keyword"); // Проверяем наличие ключевого слова struct
     consume(TokenType::RightBracket, "Expected ']' before struct declaration"); // Проверяем наличие левой скобки
 
-    std::string name = current().value; // Сохраняем имя структуры
+    std::string name(current().value); // Сохраняем имя структуры
     consume(TokenType::Identifier, "Expected identifier"); // Проверяем наличие идентификатора структуры
     
-    int expectedIndent = getIndentLevel(lines[lineIndex]) + 1; // Уровень отступа для блока структуры
+    int expectedIndent = getIndentLevel(lineIndex) + 1; // Уровень отступа для блока структуры
     nextLine(); // Переходим к следующему токену
     auto body = parseBlock(expectedIndent); // Парсим тело структуры
     
     lineIndex--; // Без этого он скипает 2 линии а не одну    
     
-    auto structNode = std::make_shared<StructNode>(name, body); // Создаём узел структуры
+    auto structNode = makeNode<StructNode>(name, body); // Создаём узел структуры
     structNode->line = line; structNode->column = token; // Устанавливаем строку и колонку для узла
     return structNode; // Возвращаем узел структуры
 }
 
-std::shared_ptr<ASTNode> Parser::parseUse()
+NodePtr<ASTNode> Parser::parseUse()
 {
     std::map<std::vector<std::string>, std::string> paths;
     std::string alias;
@@ -509,7 +542,7 @@ std::shared_ptr<ASTNode> Parser::parseUse()
         consume(TokenType::PipeArrow, "Expected '|>' at start of import entry");
     
         do {
-            path.push_back(current().value);
+            path.emplace_back(current().value);
             consume(TokenType::Identifier, "Expected identifier in import path");
             if (!current().value.empty() && !(check(TokenType::Arrow) || check(TokenType::Colon)))
                 throwError("Import path must be a single word without spaces");
@@ -532,7 +565,7 @@ std::shared_ptr<ASTNode> Parser::parseUse()
     }
 
     lineIndex--; // Без этого он скипает 2 линии а не одну
-    auto importNode = std::make_shared<ImportNode>(paths);
+    auto importNode = makeNode<ImportNode>(paths);
     importNode->line = line; importNode->column = token; // Устанавливаем строку и колонку для узла
     return importNode; // Возвращаем узел импорта
 }
\ No newline at end of file
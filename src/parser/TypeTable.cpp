@@ -0,0 +1,107 @@
+#include "headers/TypeTable.h"
+
+TypeTable::TypeTable()
+{
+    entries.emplace_back(); // id 0 - нет типа
+    for (const char* name : {"i1", "i8", "i16", "i32", "i64", "float", "string", "void", "null", "none", "auto"})
+        intern(name, false, {});
+}
+
+TypeId TypeTable::intern(Symbol name, bool generic, const std::vector<TypeId>& parameters)
+{
+    std::u32string key;
+    key.reserve(parameters.size() + 2);
+    key.push_back(generic ? 1 : 0);
+    key.push_back(name.getId());
+    for (TypeId parameter : parameters)
+        key.push_back(parameter);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto [it, inserted] = ids.try_emplace(std::move(key), static_cast<TypeId>(entries.size()));
+    if (inserted)
+        entries.push_back({name, generic, parameters, nullptr});
+    return it->second;
+}
+
+TypeId TypeTable::simple(Symbol name)
+{
+    return intern(name, false, {});
+}
+
+TypeId TypeTable::generic(Symbol baseName, const std::vector<TypeId>& parameters)
+{
+    return intern(baseName, true, parameters);
+}
+
+NodePtr<TypeNode> TypeTable::node(TypeId id)
+{
+    Entry entry;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (id == Invalid || id >= entries.size())
+            return nullptr;
+
+        // Индекс мог достаться другому узлу после reset()/rewind() - тогда id не совпадёт
+        NodePtr<TypeNode> cached = entries[id].canonical;
+        if (cached && ASTArena::node(cached.getIndex()) && isa<TypeNode>(cached) && cached->typeId == id)
+            return cached;
+        entry = entries[id];
+    }
+
+    NodePtr<TypeNode> created;
+    if (entry.generic)
+    {
+        auto type = makeNode<GenericTypeNode>(entry.name.str());
+        for (TypeId parameter : entry.parameters)
+            type->typeParameters.push_back(node(parameter));
+        created = type;
+    }
+    else
+        created = makeNode<SimpleTypeNode>(entry.name.str());
+    created->typeId = id;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    entries[id].canonical = created;
+    return created;
+}
+
+std::string TypeTable::toString(TypeId id) const
+{
+    Entry entry;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (id == Invalid || id >= entries.size())
+            return "";
+        entry = entries[id];
+    }
+    if (!entry.generic)
+        return entry.name.str();
+
+    std::string result = entry.name.str() + "<";
+    for (size_t i = 0; i < entry.parameters.size(); ++i)
+    {
+        if (i > 0) result += ", ";
+        result += toString(entry.parameters[i]);
+    }
+    return result + ">";
+}
+
+TypeId SimpleTypeNode::id() const
+{
+    if (!typeId)
+        typeId = TypeTable::getInstance().simple(name);
+    return typeId;
+}
+
+TypeId GenericTypeNode::id() const
+{
+    if (!typeId)
+    {
+        std::vector<TypeId> parameters;
+        parameters.reserve(typeParameters.size());
+        for (const auto& parameter : typeParameters)
+            parameters.push_back(parameter ? parameter->id() : TypeTable::Invalid);
+        typeId = TypeTable::getInstance().generic(baseName, parameters);
+    }
+    return typeId;
+}
@@ -1,10 +1,128 @@
 #ifndef AST_H
 #define AST_H
+#include <atomic>
+#include <cassert>
 #include <memory>
+#include <mutex>
+#include <new>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #include <cstdint>
+#include <functional>
 #include <map>
+#include "../../lexer/headers/Interner.h"
+
+class ASTNode;
+
+/*
+Арена AST.
+Все узлы живут в больших блоках памяти и адресуются 32-битным индексом (NodePtr),
+вместо отдельной make_shared-аллокации и атомарного счётчика ссылок на каждый узел.
+Узлы не удаляются по одному: reset() разрушает их все разом в конце компиляции
+(или перед повторным разбором), блоки освобождаются целиком.
+
+    auto call = makeNode<CallNode>(name, args); // NodePtr<CallNode>
+    NodePtr<ASTNode> node = call;               // "upcast" - тот же индекс
+    auto same = dyn_cast<CallNode>(node);       // см. NodeKind
+
+Индекс 0 - пустой указатель. Выделение потокобезопасно: у каждого потока свой текущий блок.
+*/
+class ASTArena
+{
+public:
+    ASTArena(const ASTArena&) = delete;
+    ASTArena& operator=(const ASTArena&) = delete;
+
+    static ASTArena& getInstance() {
+        static ASTArena instance;
+        return instance;
+    }
+
+    template <typename T, typename... Args>
+    T* create(Args&&... args);
+
+    // Узел по индексу - два чтения без блокировок
+    static ASTNode* node(uint32_t index) {
+        return pages[index >> pageBits].load(std::memory_order_acquire)[index & (pageSize - 1)];
+    }
+
+    // Разрушает все узлы; NodePtr, выданные до вызова, становятся недействительными
+    void reset();
+
+    // Точка отката: всё, что создано после mark(), можно разрушить через rewind()
+    struct Mark {
+        uint32_t count = 1;
+        size_t blocks = 0;
+        size_t usedBytes = 0;
+        char* cursor = nullptr;
+        char* end = nullptr;
+    };
+
+    // Только пока узлы создаёт один поток - тот, что вызывает mark() и rewind()
+    // (потоковая компиляция освобождает AST каждой функции после её кодогенерации)
+    Mark mark() const;
+    void rewind(const Mark& mark);
+
+    size_t nodeCount() const { return count.load(std::memory_order_relaxed) - 1; }
+    size_t bytesUsed() const { return usedBytes.load(std::memory_order_relaxed); }      // Под сами узлы
+    size_t bytesReserved() const;                                                        // Блоки + таблица индексов
+
+private:
+    ASTArena() = default;
+    ~ASTArena() { reset(); }
+
+    void* allocate(size_t size, size_t alignment);
+    uint32_t registerNode(ASTNode* node);
+
+    static constexpr uint32_t pageBits = 16;
+    static constexpr uint32_t pageSize = 1u << pageBits;
+    static constexpr uint32_t maxPages = 1u << 16;
+    static constexpr size_t blockSize = 256 << 10;
+
+    static inline std::atomic<ASTNode**> pages[maxPages] = {}; // В .bss: страницы выделяются по мере роста
+
+    std::atomic<uint32_t> count{1};
+    std::atomic<size_t> usedBytes{0};
+    std::atomic<uint64_t> generation{1}; // Меняется в reset(), чтобы потоки бросили старые блоки
+    std::vector<char*> blocks;
+    mutable std::mutex blocksMutex;
+};
+
+// 32-битная ссылка на узел арены. Тривиально копируется, интерфейс как у shared_ptr
+template <typename T>
+class NodePtr
+{
+public:
+    NodePtr() = default;
+    NodePtr(std::nullptr_t) {}
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    NodePtr(const NodePtr<U>& other) : index(other.getIndex()) {}
+
+    static NodePtr fromIndex(uint32_t index) { NodePtr result; result.index = index; return result; }
+
+    uint32_t getIndex() const { return index; }
+    T* get() const { return index ? static_cast<T*>(ASTArena::node(index)) : nullptr; }
+    T* operator->() const { return get(); }
+    T& operator*() const { return *get(); }
+    explicit operator bool() const { return index != 0; }
+
+    template <typename U>
+    bool operator==(const NodePtr<U>& other) const { return index == other.getIndex(); }
+    bool operator==(std::nullptr_t) const { return index == 0; }
+    template <typename U>
+    bool operator<(const NodePtr<U>& other) const { return index < other.getIndex(); }
+
+private:
+    uint32_t index = 0;
+};
+
+template <typename T>
+struct std::hash<NodePtr<T>> {
+    size_t operator()(const NodePtr<T>& node) const noexcept { return std::hash<uint32_t>()(node.getIndex()); }
+};
 
 class ASTNodeVisitor {
     public:
@@ -42,52 +160,205 @@ class ASTNodeVisitor {
 
 class TypeNode;
 
-class ASTNode : public std::enable_shared_from_this<ASTNode> {
+/*
+Вид узла. Проверка вида - сравнение одного байта вместо dynamic_cast с обходом RTTI:
+
+    if (auto func = dyn_cast<FunctionNode>(node)) ... // NodePtr<FunctionNode> или пустой
+    if (isa<BlockNode>(stmt)) ...
+    auto block = cast<BlockNode>(func->body);          // вид уже проверен
+
+а там, где разбирается много видов подряд, - switch (node->kind).
+Каждый класс узла передаёт свой вид в конструктор ASTNode и объявляет static classof().
+*/
+enum class NodeKind : uint8_t {
+    ModuleMark,
+    // Типы - непрерывный диапазон, его проверяет TypeNode::classof
+    SimpleType,
+    GenericType,
+    Program,
+    Function,
+    Lambda,
+    Struct,
+    Block,
+    VariableAssign,
+    ReassignMember,
+    VariableReassign,
+    If,
+    For,
+    While,
+    Return,
+    Call,
+    BinaryOp,
+    UnaryOp,
+    Identifier,
+    Number,
+    FloatNumber,
+    String,
+    Null,
+    None,
+    KeyValue,
+    Break,
+    Continue,
+    AccessExpression,
+    Import,
+
+    FirstType = SimpleType,
+    LastType = GenericType
+};
+
+class ASTNode {
     public:
-        int line; // номер строки в исходном коде
-        int column; // номер столбца в исходном коде
+        explicit ASTNode(NodeKind kind) : kind(kind) {}
 
-        std::shared_ptr<TypeNode> inferredType; // Выводимый тип узла (для IR)
+        int line = 0; // номер строки в исходном коде
+        int column = 0; // номер столбца в исходном коде
 
-        std::shared_ptr<TypeNode> implicitCastTo; // Неявное приведение к типу (для IR)
+        NodePtr<TypeNode> inferredType; // Выводимый тип узла (для IR)
 
-        
+        NodePtr<TypeNode> implicitCastTo; // Неявное приведение к типу (для IR)
+
+        uint32_t arenaIndex = 0; // Индекс в ASTArena, 0 - узел создан не через makeNode
+
+        NodeKind kind; // Вид узла, задаётся конструктором класса (после полей по 4 байта - без выравнивания)
 
         virtual ~ASTNode() = default;
 
         virtual void accept(ASTNodeVisitor& visitor) = 0; // Метод для обхода узла
 
-        std::shared_ptr<ASTNode> shared_from_this() {
-            return std::enable_shared_from_this<ASTNode>::shared_from_this();
+        NodePtr<ASTNode> self() const {
+            return NodePtr<ASTNode>::fromIndex(arenaIndex);
         }
 };
 
+template <typename T, typename... Args>
+T* ASTArena::create(Args&&... args)
+{
+    T* node = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    node->arenaIndex = registerNode(node);
+    return node;
+}
+
+template <typename T, typename... Args>
+NodePtr<T> makeNode(Args&&... args)
+{
+    return NodePtr<T>::fromIndex(ASTArena::getInstance().create<T>(std::forward<Args>(args)...)->arenaIndex);
+}
+
+template <typename T, typename U>
+NodePtr<T> staticNodeCast(const NodePtr<U>& node)
+{
+    return NodePtr<T>::fromIndex(node.getIndex());
+}
+
+template <typename T>
+bool isa(const ASTNode* node)
+{
+    return node && T::classof(node);
+}
+
+template <typename T, typename U>
+bool isa(const NodePtr<U>& node)
+{
+    return isa<T>(static_cast<const ASTNode*>(node.get()));
+}
+
+template <typename T>
+T* dyn_cast(ASTNode* node)
+{
+    return isa<T>(node) ? static_cast<T*>(node) : nullptr;
+}
+
+template <typename T, typename U>
+NodePtr<T> dyn_cast(const NodePtr<U>& node)
+{
+    return isa<T>(node) ? NodePtr<T>::fromIndex(node.getIndex()) : NodePtr<T>();
+}
+
+// Вид должен быть уже известен: проверяется только в отладочной сборке
+template <typename T, typename U>
+NodePtr<T> cast(const NodePtr<U>& node)
+{
+    assert(!node || isa<T>(node));
+    return staticNodeCast<T>(node);
+}
+
+/*
+Операции бинарных и унарных узлов.
+Парсер ставит оператор исходника (Plus, Less, ...), семантика заменяет его IR-операцией
+(Add/FAdd, ICmpSLT, StrCmpEQ, Scat, ...), по которой кодогенерация берёт инструкцию из таблицы.
+and/or остаются как есть. Имена (opcodeName) совпадают с прежними строками op - их видно в --ast.
+*/
+enum class BinaryOpcode : uint8_t {
+    // Операторы исходника
+    Plus, Minus, Star, Slash, Percent, Power,
+    Equal, NotEqual, Less, Greater, LessEqual, GreaterEqual,
+    And, Or, Pipe,
+
+    // IR-операции
+    Add, FAdd, Sub, FSub, Mul, FMul, SDiv, FDiv, SRem, FRem,
+    ICmpEQ, ICmpNE, ICmpSLT, ICmpSGT, ICmpSLE, ICmpSGE,
+    FCmpEQ, FCmpNE, FCmpSLT, FCmpSGT, FCmpSLE, FCmpSGE,
+    StrCmpEQ, StrCmpNE, StrCmpSLT, StrCmpSGT, StrCmpSLE, StrCmpSGE,
+    Scat,
+
+    Count
+};
+
+enum class UnaryOpcode : uint8_t {
+    // Операторы исходника: -x, !x, ?x
+    Minus, Exclaim, Question,
+
+    // IR-операции
+    Neg, Not, NullCheck,
+
+    Count
+};
+
+std::string opcodeName(BinaryOpcode op);
+std::string opcodeName(UnaryOpcode op);
+
+// Сравнения идут подряд в порядке EQ, NE, SLT, SGT, SLE, SGE - семейства отличаются сдвигом
+inline bool isSourceComparison(BinaryOpcode op) { return op >= BinaryOpcode::Equal && op <= BinaryOpcode::GreaterEqual; }
+inline bool isICmp(BinaryOpcode op) { return op >= BinaryOpcode::ICmpEQ && op <= BinaryOpcode::ICmpSGE; }
+inline bool isFCmp(BinaryOpcode op) { return op >= BinaryOpcode::FCmpEQ && op <= BinaryOpcode::FCmpSGE; }
+
 class ModuleMark : public ASTNode {
     public:
-        ModuleMark() = default;
-        ModuleMark(const std::string& moduleName) : moduleName(moduleName) {}
+        ModuleMark() : ASTNode(NodeKind::ModuleMark) {}
+        ModuleMark(const std::string& moduleName) : ASTNode(NodeKind::ModuleMark), moduleName(moduleName) {}
         std::string moduleName;
 
+        static bool classof(const ASTNode* node) { return node->kind == NodeKind::ModuleMark; }
+
         void accept(ASTNodeVisitor& visitor) override {
             visitor.visit(*this);
         }
 };
 
+using TypeId = uint32_t; // Id типа в TypeTable, 0 - нет типа
+
 class TypeNode : public ASTNode {
     public:
-        TypeNode() = default;
+        explicit TypeNode(NodeKind kind) : ASTNode(kind) {}
+        static bool classof(const ASTNode* node) { return node->kind >= NodeKind::FirstType && node->kind <= NodeKind::LastType; }
         virtual ~TypeNode() = default;
         virtual std::string toString() const = 0; // Printing type
+        virtual TypeId id() const = 0; // Id в TypeTable (считается один раз): равные типы - равные id
+
+        mutable TypeId typeId = 0; // Кэш id()
 };
 
 class SimpleTypeNode : public TypeNode {
     public:
-        SimpleTypeNode(const std::string& name) : name(name) {}
+        SimpleTypeNode(const std::string& name) : TypeNode(NodeKind::SimpleType), name(name) {}
         std::string name;
 
         std::string toString() const override {
             return name;
         }
+        TypeId id() const override;
+
+        static bool classof(const ASTNode* node) { return node->kind == NodeKind::SimpleType; }
 
         void accept(ASTNodeVisitor& visitor) override {
             visitor.visit(*this);
@@ -96,10 +367,10 @@ class SimpleTypeNode : public TypeNode {
 
 class GenericTypeNode : public TypeNode {
     public:
-        GenericTypeNode(const std::string& baseName) : baseName(baseName) {}
+        GenericTypeNode(const std::string& baseName) : TypeNode(NodeKind::GenericType), baseName(baseName) {}
 
         std::string baseName;
-        std::vector<std::shared_ptr<TypeNode>> typeParameters;
+        std::vector<NodePtr<TypeNode>> typeParameters;
 
         std::string toString() const override {
             std::string result = baseName + "<";
@@ -111,22 +382,32 @@ class GenericTypeNode : public TypeNode {
             result += ">";
             return result;
         }
+        TypeId id() const override;
+
+        static bool classof(const ASTNode* node) { return node->kind == NodeKind::GenericType; }
 
         void accept(ASTNodeVisitor& visitor) override {
             visitor.visit(*this);
         }
 };
 
+// Равенство типов - сравнение id (см. TypeTable)
+inline bool sameType(const NodePtr<TypeNode>& left, const NodePtr<TypeNode>& right) {
+    return left == right || (left && right && left->id() == right->id());
+}
+
 class ProgramNode : public ASTNode {
     public:
-        ProgramNode() = default;
+        ProgramNode() : ASTNode(NodeKind::Program) {}
         ProgramNode(
-            const std::vector<std::shared_ptr<ASTNode>>& body,
+            const std::vector<NodePtr<ASTNode>>& body,
             std::string moduleName) 
-            : body(body), moduleName(moduleName) {}
-        std::vector<std::shared_ptr<ASTNode>> body;
+            : ASTNode(NodeKind::Program), body(body), moduleName(moduleName) {}
+        std::vector<NodePtr<ASTNode>> body;
         std::string moduleName;
 
+        static bool classof(const ASTNode* node) { return node->kind == NodeKind::Program; }
+
         void accept(ASTNodeVisitor& visitor) override {
             visitor.visit(*this);
         }
@@ -134,18 +415,33 @@ class ProgramNode : public ASTNode {
     
 class FunctionNode : public ASTNode {
     public:
-        FunctionNode() = default;
-        FunctionNode(const std::string& name, const std::string& associated, std::shared_ptr<TypeNode> returnType, const std::vector<std::pair<std::shared_ptr<TypeNode>, std::string>> parameters, const std::vector<std::string> labels, std::shared_ptr<ASTNode> body) 
-            : name(name), associated(associated), returnType(returnType), parameters(parameters), labels(labels), body(body) {}
-        std::string name;
+        FunctionNode() : ASTNode(NodeKind::Function) {}
+        FunctionNode(Symbol name, const std::string& associated, NodePtr<TypeNode> returnType, const std::vector<std::pair<NodePtr<TypeNode>, Symbol>> parameters, const std::vector<std::string> labels, NodePtr<ASTNode> body) 
+            : ASTNode(NodeKind::Function), name(name), associated(associated), returnType(returnType), parameters(parameters), labels(labels), body(body) {}
+        Symbol name;
         std::string associated;
-        std::shared_ptr<TypeNode> returnType;
-        std::vector<std::pair<std::shared_ptr<TypeNode>, std::string>> parameters; // {type, name}
+        NodePtr<TypeNode> returnType;
+        std::vector<std::pair<NodePtr<TypeNode>, Symbol>> parameters; // {type, name}
         std::vector<std::pair<std::string, LambdaNode>> lambdas; // {type, name}
 
         std::vector<std::string> labels; // @strict, @pure, @entry, @public, @private, @test
-        std::shared_ptr<ASTNode> body; // BlockNode
+        NodePtr<ASTNode> body; // BlockNode
+
+        // Тело, которое парсер отложил (Parser::deferBodies): пока оно не разобрано, body пуст
+        std::function<NodePtr<ASTNode>()> deferredBody;
+
+        // body, при необходимости разобранный сейчас; ошибка разбора - std::runtime_error
+        NodePtr<ASTNode> requireBody() {
+            if (deferredBody) {
+                auto parseBody = std::move(deferredBody);
+                deferredBody = nullptr;
+                body = parseBody();
+            }
+            return body;
+        }
         
+        static bool classof(const ASTNode* node) { return node->kind == NodeKind::Function; }
+
         void accept(ASTNodeVisitor& visitor) override {
             visitor.visit(*this);
         }
@@ -153,24 +449,28 @@ class FunctionNode : public ASTNode {
 
 class LambdaNode : public ASTNode {
     public:
-        std::shared_ptr<TypeNode> returnType;
-        std::vector<std::pair<std::shared_ptr<TypeNode>, std::string>> parameters; // {type, name}
-        std::shared_ptr<ASTNode> body;
+        NodePtr<TypeNode> returnType;
+        std::vector<std::pair<NodePtr<TypeNode>, std::string>> parameters; // {type, name}
+        NodePtr<ASTNode> body;
     
-        LambdaNode(std::shared_ptr<TypeNode> returnType,
-                            const std::vector<std::pair<std::shared_ptr<TypeNode>, std::string>> parameters,
-                            std::shared_ptr<ASTNode> body)
-            : returnType(returnType), parameters(parameters), body(body) {}
+        LambdaNode(NodePtr<TypeNode> returnType,
+                            const std::vector<std::pair<NodePtr<TypeNode>, std::string>> parameters,
+                            NodePtr<ASTNode> body)
+            : ASTNode(NodeKind::Lambda), returnType(returnType), parameters(parameters), body(body) {}
     
+        static bool classof(const ASTNode* node) { return node->kind == NodeKind::Lambda; }
+
         void accept(ASTNodeVisitor& visitor) override { visitor.visit(*this); }
 };
 
 class StructNode : public ASTNode {
     public:
-        StructNode() = default;
-        StructNode(const std::string& name, std::shared_ptr<ASTNode> body) : name(name), body(body) {}
+        StructNode() : ASTNode(NodeKind::Struct) {}
+        StructNode(const std::string& name, NodePtr<ASTNode> body) : ASTNode(NodeKind::Struct), name(name), body(body) {}
         std::string name;
-        std::shared_ptr<ASTNode> body;
+        NodePtr<ASTNode> body;
+
+        static bool classof(const ASTNode* node) { return node->kind == NodeKind::Struct; }
 
         void accept(ASTNodeVisitor& visitor) override {
             visitor.visit(*this);
@@ -179,9 +479,11 @@ class StructNode : public ASTNode {
 
 class BlockNode : public ASTNode {
     public:
-        BlockNode() = default;
-        BlockNode(const std::vector<std::shared_ptr<ASTNode>>& statements) : statements(statements) {}
-        std::vector<std::shared_ptr<ASTNode>> statements;
+        BlockNode() : ASTNode(NodeKind::Block) {}
+        BlockNode(const std::vector<NodePtr<ASTNode>>& statements) : ASTNode(NodeKind::Block), statements(statements) {}
+        std::vector<NodePtr<ASTNode>> statements;
+
+        static bool classof(const ASTNode* node) { return node->kind == NodeKind::Block; }
 
         void accept(ASTNodeVisitor& visitor) override {
             visitor.visit(*this);
@@ -190,13 +492,15 @@ class BlockNode : public ASTNode {
 
 class VariableAssignNode : public ASTNode {
     public:
-        VariableAssignNode() = default;
-        VariableAssignNode(const std::string& name, bool isConst, std::shared_ptr<TypeNode> type, std::shared_ptr<ASTNode> expression) 
-            : name(name), isConst(isConst), type(type), expression(expression) {}
-        std::string name;
-        std::shared_ptr<TypeNode> type;
+        VariableAssignNode() : ASTNode(NodeKind::VariableAssign) {}
+        VariableAssignNode(Symbol name, bool isConst, NodePtr<TypeNode> type, NodePtr<ASTNode> expression) 
+            : ASTNode(NodeKind::VariableAssign), name(name), isConst(isConst), type(type), expression(expression) {}
+        Symbol name;
+        NodePtr<TypeNode> type;
         bool isConst;
-        std::shared_ptr<ASTNode> expression;
+        NodePtr<ASTNode> expression;
+
+        static bool classof(const ASTNode* node) { return node->kind == NodeKind::VariableAssign; }
 
         void accept(ASTNodeVisitor& visitor) override {
             visitor.visit(*this);
@@ -205,11 +509,13 @@ class VariableAssignNode : public ASTNode {
 
 class ReassignMemberNode : public ASTNode {
     public:
-        ReassignMemberNode() = default;
-        ReassignMemberNode(std::shared_ptr<ASTNode> accessExpression, std::shared_ptr<ASTNode> expression) 
-            : accessExpression(accessExpression), expression(expression) {}
-        std::shared_ptr<ASTNode> accessExpression;
-        std::shared_ptr<ASTNode> expression;
+        ReassignMemberNode() : ASTNode(NodeKind::ReassignMember) {}
+        ReassignMemberNode(NodePtr<ASTNode> accessExpression, NodePtr<ASTNode> expression) 
+            : ASTNode(NodeKind::ReassignMember), accessExpression(accessExpression), expression(expression) {}
+        NodePtr<ASTNode> accessExpression;
+        NodePtr<ASTNode> expression;
+
+        static bool classof(const ASTNode* node) { return node->kind == NodeKind::ReassignMember; }
 
         void accept(ASTNodeVisitor& visitor) override {
             visitor.visit(*this);
@@ -218,11 +524,13 @@ class ReassignMemberNode : public ASTNode {
 
 class VariableReassignNode : public ASTNode {
     public:
-        VariableReassignNode() = default;
-        VariableReassignNode(const std::string& name, std::shared_ptr<ASTNode> expression) 
-            : name(name), expression(expression) {}
-        std::string name;
-        std::shared_ptr<ASTNode> expression;
+        VariableReassignNode() : ASTNode(NodeKind::VariableReassign) {}
+        VariableReassignNode(Symbol name, NodePtr<ASTNode> expression) 
+            : ASTNode(NodeKind::VariableReassign), name(name), expression(expression) {}
+        Symbol name;
+        NodePtr<ASTNode> expression;
+
+        static bool classof(const ASTNode* node) { return node->kind == NodeKind::VariableReassign; }
 
         void accept(ASTNodeVisitor& visitor) override {
             visitor.visit(*this);
@@ -231,12 +539,14 @@ class VariableReassignNode : public ASTNode {
     
 class IfNode : public ASTNode {
     public:
-        IfNode() = default;
-        IfNode(std::shared_ptr<ASTNode> condition, std::shared_ptr<BlockNode> thenBlock, std::shared_ptr<ASTNode> elseBlock = nullptr) 
-            : condition(condition), thenBlock(thenBlock), elseBlock(elseBlock) {}
-        std::shared_ptr<ASTNode> condition;
-        std::shared_ptr<BlockNode> thenBlock;
-        std::shared_ptr<ASTNode> elseBlock; // может быть и if
+        IfNode() : ASTNode(NodeKind::If) {}
+        IfNode(NodePtr<ASTNode> condition, NodePtr<BlockNode> thenBlock, NodePtr<ASTNode> elseBlock = nullptr) 
+            : ASTNode(NodeKind::If), condition(condition), thenBlock(thenBlock), elseBlock(elseBlock) {}
+        NodePtr<ASTNode> condition;
+        NodePtr<BlockNode> thenBlock;
+        NodePtr<ASTNode> elseBlock; // может быть и if
+
+        static bool classof(const ASTNode* node) { return node->kind == NodeKind::If; }
 
         void accept(ASTNodeVisitor& visitor) override {
             visitor.visit(*this);
@@ -245,13 +555,15 @@ class IfNode : public ASTNode {
     
 class ForNode : public ASTNode {
     public:
-        ForNode() = default;
-        ForNode(const std::string& varName, std::shared_ptr<ASTNode> iterable, std::shared_ptr<BlockNode> body) 
-            : varName(varName), iterable(iterable), body(body) {}
-        std::string varName;
-        std::shared_ptr<TypeNode> varType; // TODO: <-- чек хуету
-        std::shared_ptr<ASTNode> iterable;
-        std::shared_ptr<BlockNode> body;
+        ForNode() : ASTNode(NodeKind::For) {}
+        ForNode(Symbol varName, NodePtr<ASTNode> iterable, NodePtr<BlockNode> body) 
+            : ASTNode(NodeKind::For), varName(varName), iterable(iterable), body(body) {}
+        Symbol varName;
+        NodePtr<TypeNode> varType; // TODO: <-- чек хуету
+        NodePtr<ASTNode> iterable;
+        NodePtr<BlockNode> body;
+
+        static bool classof(const ASTNode* node) { return node->kind == NodeKind::For; }
 
         void accept(ASTNodeVisitor& visitor) override {
             visitor.visit(*this);
@@ -260,11 +572,13 @@ class ForNode : public ASTNode {
 
 class WhileNode : public ASTNode {
     public:
-        WhileNode() = default;
-        WhileNode(std::shared_ptr<ASTNode> condition, std::shared_ptr<BlockNode> body)
-            : condition(condition), body(body) {}
-        std::shared_ptr<ASTNode> condition;
-        std::shared_ptr<BlockNode> body;
+        WhileNode() : ASTNode(NodeKind::While) {}
+        WhileNode(NodePtr<ASTNode> condition, NodePtr<BlockNode> body)
+            : ASTNode(NodeKind::While), condition(condition), body(body) {}
+        NodePtr<ASTNode> condition;
+        NodePtr<BlockNode> body;
+
+        static bool classof(const ASTNode* node) { return node->kind == NodeKind::While; }
 
         void accept(ASTNodeVisitor& visitor) override {
             visitor.visit(*this);
@@ -273,9 +587,11 @@ class WhileNode : public ASTNode {
     
 class ReturnNode : public ASTNode {
     public:
-        ReturnNode() = default;
-        ReturnNode(std::shared_ptr<ASTNode> expression) : expression(expression) {}
-        std::shared_ptr<ASTNode> expression;
+        ReturnNode() : ASTNode(NodeKind::Return) {}
+        ReturnNode(NodePtr<ASTNode> expression) : ASTNode(NodeKind::Return), expression(expression) {}
+        NodePtr<ASTNode> expression;
+
+        static bool classof(const ASTNode* node) { return node->kind == NodeKind::Return; }
 
         void accept(ASTNodeVisitor& visitor) override {
             visitor.visit(*this);
@@ -284,11 +600,18 @@ class ReturnNode : public ASTNode {
     
 class CallNode : public ASTNode {
     public:
-        CallNode() = default;
-        CallNode(const std::string& callee, const std::vector<std::shared_ptr<ASTNode>>& arguments) 
-            : callee(callee), arguments(arguments) {}
-        std::string callee;
-        std::vector<std::shared_ptr<ASTNode>> arguments;
+        CallNode() : ASTNode(NodeKind::Call) {}
+        CallNode(Symbol callee, const std::vector<NodePtr<ASTNode>>& arguments) 
+            : ASTNode(NodeKind::Call), callee(callee), arguments(arguments) {}
+        Symbol callee;
+        std::vector<NodePtr<ASTNode>> arguments;
+
+        // Кэш разрешения встроенной функции (семантика): действителен для той же сигнатуры аргументов и того же реестра
+        NodePtr<FunctionNode> resolvedFunction;
+        TypeId resolvedSignature = 0;
+        uint32_t resolvedRegistry = 0;
+
+        static bool classof(const ASTNode* node) { return node->kind == NodeKind::Call; }
 
         void accept(ASTNodeVisitor& visitor) override {
             visitor.visit(*this);
@@ -297,12 +620,14 @@ class CallNode : public ASTNode {
     
 class BinaryOpNode : public ASTNode {
     public:
-        BinaryOpNode() = default;
-        BinaryOpNode(std::shared_ptr<ASTNode> left, const std::string& op, std::shared_ptr<ASTNode> right) 
-            : left(left), op(op), right(right) {}
-        std::string op;
-        std::shared_ptr<ASTNode> left;
-        std::shared_ptr<ASTNode> right;
+        BinaryOpNode() : ASTNode(NodeKind::BinaryOp) {}
+        BinaryOpNode(NodePtr<ASTNode> left, BinaryOpcode op, NodePtr<ASTNode> right) 
+            : ASTNode(NodeKind::BinaryOp), left(left), op(op), right(right) {}
+        BinaryOpcode op = BinaryOpcode::Plus;
+        NodePtr<ASTNode> left;
+        NodePtr<ASTNode> right;
+
+        static bool classof(const ASTNode* node) { return node->kind == NodeKind::BinaryOp; }
 
         void accept(ASTNodeVisitor& visitor) override {
             visitor.visit(*this);
@@ -311,11 +636,13 @@ class BinaryOpNode : public ASTNode {
     
 class UnaryOpNode : public ASTNode {
     public:
-        UnaryOpNode() = default;
-        UnaryOpNode(const std::string& op, std::shared_ptr<ASTNode> operand) 
-            : op(op), operand(operand) {}
-        std::string op;
-        std::shared_ptr<ASTNode> operand;
+        UnaryOpNode() : ASTNode(NodeKind::UnaryOp) {}
+        UnaryOpNode(UnaryOpcode op, NodePtr<ASTNode> operand) 
+            : ASTNode(NodeKind::UnaryOp), op(op), operand(operand) {}
+        UnaryOpcode op = UnaryOpcode::Minus;
+        NodePtr<ASTNode> operand;
+
+        static bool classof(const ASTNode* node) { return node->kind == NodeKind::UnaryOp; }
 
         void accept(ASTNodeVisitor& visitor) override {
             visitor.visit(*this);
@@ -324,9 +651,11 @@ class UnaryOpNode : public ASTNode {
     
 class IdentifierNode : public ASTNode {
     public:
-        IdentifierNode() = default;
-        IdentifierNode(const std::string& name) : name(name) {}
-        std::string name;
+        IdentifierNode() : ASTNode(NodeKind::Identifier) {}
+        IdentifierNode(Symbol name) : ASTNode(NodeKind::Identifier), name(name) {}
+        Symbol name; // интернированное имя, см. Interner.h
+
+        static bool classof(const ASTNode* node) { return node->kind == NodeKind::Identifier; }
 
         void accept(ASTNodeVisitor& visitor) override {
             visitor.visit(*this);
@@ -335,11 +664,13 @@ class IdentifierNode : public ASTNode {
 
 class NumberNode : public ASTNode {
     public:
-        NumberNode() = default;
-        NumberNode(int64_t value, std::shared_ptr<TypeNode> type) : value(value), type(type) {}
+        NumberNode() : ASTNode(NodeKind::Number) {}
+        NumberNode(int64_t value, NodePtr<TypeNode> type) : ASTNode(NodeKind::Number), value(value), type(type) {}
         int64_t value;
-        std::shared_ptr<TypeNode> type; // тип числа (i32, i64, i8, i1)
+        NodePtr<TypeNode> type; // тип числа (i32, i64, i8, i1)
+
 
+        static bool classof(const ASTNode* node) { return node->kind == NodeKind::Number; }
 
         void accept(ASTNodeVisitor& visitor) override {
             visitor.visit(*this);
@@ -348,10 +679,12 @@ class NumberNode : public ASTNode {
 
 class FloatNumberNode : public ASTNode {
     public:
-        FloatNumberNode() = default;
-        FloatNumberNode(float value) : value(value) {}
+        FloatNumberNode() : ASTNode(NodeKind::FloatNumber) {}
+        FloatNumberNode(float value) : ASTNode(NodeKind::FloatNumber), value(value) {}
         float value;
 
+        static bool classof(const ASTNode* node) { return node->kind == NodeKind::FloatNumber; }
+
         void accept(ASTNodeVisitor& visitor) override {
             visitor.visit(*this);
         }
@@ -359,10 +692,12 @@ class FloatNumberNode : public ASTNode {
 
 class StringNode : public ASTNode {
     public:
-        StringNode() = default;
-        StringNode(const std::string& value) : value(value) {}
+        StringNode() : ASTNode(NodeKind::String) {}
+        StringNode(const std::string& value) : ASTNode(NodeKind::String), value(value) {}
         std::string value;
 
+        static bool classof(const ASTNode* node) { return node->kind == NodeKind::String; }
+
         void accept(ASTNodeVisitor& visitor) override {
             visitor.visit(*this);
         }
@@ -370,7 +705,9 @@ class StringNode : public ASTNode {
 
 class NullNode : public ASTNode {
     public:
-        NullNode() = default;
+        NullNode() : ASTNode(NodeKind::Null) {}
+
+        static bool classof(const ASTNode* node) { return node->kind == NodeKind::Null; }
 
         void accept(ASTNodeVisitor& visitor) override {
             visitor.visit(*this);
@@ -379,7 +716,9 @@ class NullNode : public ASTNode {
 
 class NoneNode : public ASTNode {
     public:
-        NoneNode() = default;
+        NoneNode() : ASTNode(NodeKind::None) {}
+
+        static bool classof(const ASTNode* node) { return node->kind == NodeKind::None; }
 
         void accept(ASTNodeVisitor& visitor) override {
             visitor.visit(*this);
@@ -388,13 +727,15 @@ class NoneNode : public ASTNode {
 
 class KeyValueNode : public ASTNode {
     public:
-        KeyValueNode() = default;
+        KeyValueNode() : ASTNode(NodeKind::KeyValue) {}
 
-        std::shared_ptr<ASTNode> key;
-        std::shared_ptr<ASTNode> value;
+        NodePtr<ASTNode> key;
+        NodePtr<ASTNode> value;
 
         std::string keyName;
 
+        static bool classof(const ASTNode* node) { return node->kind == NodeKind::KeyValue; }
+
         void accept(ASTNodeVisitor& visitor) override {
             visitor.visit(*this);
         }
@@ -402,7 +743,9 @@ class KeyValueNode : public ASTNode {
 
 class BreakNode : public ASTNode {
     public:
-        BreakNode() = default;
+        BreakNode() : ASTNode(NodeKind::Break) {}
+
+        static bool classof(const ASTNode* node) { return node->kind == NodeKind::Break; }
 
         void accept(ASTNodeVisitor& visitor) override {
             visitor.visit(*this);
@@ -411,7 +754,9 @@ class BreakNode : public ASTNode {
     
 class ContinueNode : public ASTNode {
     public:
-        ContinueNode() = default;
+        ContinueNode() : ASTNode(NodeKind::Continue) {}
+
+        static bool classof(const ASTNode* node) { return node->kind == NodeKind::Continue; }
 
         void accept(ASTNodeVisitor& visitor) override {
             visitor.visit(*this);
@@ -422,13 +767,15 @@ class ContinueNode : public ASTNode {
 // Я рот ебал их разделять
 class AccessExpression : public ASTNode {
     public: 
-        AccessExpression() = default;
-        AccessExpression(std::string memberName, std::shared_ptr<ASTNode> expression)
-            :   memberName(memberName), expression(expression) {};
+        AccessExpression() : ASTNode(NodeKind::AccessExpression) {}
+        AccessExpression(std::string memberName, NodePtr<ASTNode> expression)
+            : ASTNode(NodeKind::AccessExpression), memberName(memberName), expression(expression) {};
         std::string memberName;
         std::string notation;
-        std::shared_ptr<ASTNode> expression;
-        std::shared_ptr<ASTNode> nextAccess;
+        NodePtr<ASTNode> expression;
+        NodePtr<ASTNode> nextAccess;
+
+        static bool classof(const ASTNode* node) { return node->kind == NodeKind::AccessExpression; }
 
         void accept(ASTNodeVisitor& visitor) override {
             visitor.visit(*this);
@@ -437,14 +784,16 @@ class AccessExpression : public ASTNode {
 
 class ImportNode : public ASTNode {
     public:
-        ImportNode() = default;
+        ImportNode() : ASTNode(NodeKind::Import) {}
         ImportNode(const std::map<std::vector<std::string>, std::string>& paths)
-        : paths(paths){}
+        : ASTNode(NodeKind::Import), paths(paths){}
         
         // Путь импорта: module -> struct -> function ...
         std::map<std::vector<std::string>, std::string> paths;
     
 
+        static bool classof(const ASTNode* node) { return node->kind == NodeKind::Import; }
+
         void accept(ASTNodeVisitor& visitor) override {
             visitor.visit(*this);
         }
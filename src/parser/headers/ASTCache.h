@@ -0,0 +1,97 @@
+#ifndef ASTCACHE_H
+#define ASTCACHE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "AST.h"
+#include "../../lexer/headers/TokenStream.h"
+#include "../../loader/headers/SourceManager.h"
+
+/*
+Кэш разобранных модулей на диске.
+Ключ - 128-битный хеш текста исходника, имени модуля и версии компилятора
+(MS_VERSION + размер и время изменения исполняемого файла, чтобы пересобранный
+компилятор не читал чужие записи). При попадании лексер и парсер не запускаются:
+
+    std::shared_ptr<const TokenStream> tokens;
+    auto program = ASTCache::getInstance().parse(source->text(), moduleName, tokens);
+    // tokens == nullptr, если AST взят из кэша
+
+Формат записи - заголовок (магия, версия формата, ключ, hash() дерева) и дерево в префиксном порядке:
+у узла вид, строка, колонка, inferredType, implicitCastTo и поля его класса.
+Ссылка на узел - varint: 0 - пусто, 1 - новый узел следом, k + 2 - уже записанный узел k
+(общие поддеревья остаются общими). Строки и имена (Symbol) идут через таблицу:
+0 - новая строка следом, k + 1 - строка k. Целые - varint/zigzag.
+
+Модуль, разобранный с отложенными телами (Linker::setLazyBodies), сразу не пишется:
+schedule() запоминает его исходник и токены, flush() после запуска без ошибок разбирает
+модуль целиком и записывает. Модуль с неразбираемым телом в кэш не попадает.
+
+Каталог: MS_CACHE_DIR, иначе $XDG_CACHE_HOME/monoscript/ast или ~/.cache/monoscript/ast.
+Ошибки кэша (нет каталога, битая запись или контрольная сумма, чужой формат) не фатальны - модуль просто
+разбирается заново. Все методы потокобезопасны.
+*/
+class ASTCache
+{
+public:
+    ASTCache(const ASTCache&) = delete;
+    ASTCache& operator=(const ASTCache&) = delete;
+
+    static ASTCache& getInstance() {
+        static ASTCache instance;
+        return instance;
+    }
+
+    // --offCache выключает и чтение, и запись
+    void setEnabled(bool value) { enabled = value; }
+    bool isEnabled() const { return enabled && !directory.empty(); }
+
+    // AST модуля: из кэша, иначе лексер + парсер и запись в кэш.
+    // tokens - уже построенный поток (--tokens) или nullptr; при промахе заполняется
+    NodePtr<ProgramNode> parse(std::string_view source, const std::string& moduleName, std::shared_ptr<const TokenStream>& tokens);
+
+    NodePtr<ProgramNode> load(std::string_view source, const std::string& moduleName) const; // nullptr - промах
+    void store(std::string_view source, const std::string& moduleName, const ProgramNode& program) const;
+
+    // Отложенная запись модуля: tokens - поток, из которого он разобран без тел
+    void schedule(std::shared_ptr<const SourceBuffer> source, const std::string& moduleName, std::shared_ptr<const TokenStream> tokens);
+    void flush();
+
+    // Версия компилятора из ключа: MS_VERSION, версия формата и отметка исполняемого файла
+    const std::string& getCompilerStamp() const { return compilerStamp; }
+
+    // Хеш содержимого - тот же, что в ключе кэша (линкер сравнивает им версии модулей)
+    static uint64_t hash(std::string_view data);
+
+    // Сериализация без диска (бенчмарк); deserialize бросает std::runtime_error на битых данных
+    static std::string serialize(const ProgramNode& program);
+    static NodePtr<ProgramNode> deserialize(std::string_view data);
+
+private:
+    ASTCache();
+
+    struct Key {
+        uint64_t low = 0, high = 0;
+    };
+    Key makeKey(std::string_view source, const std::string& moduleName) const;
+    std::filesystem::path entryPath(const Key& key) const;
+
+    struct Pending {
+        std::shared_ptr<const SourceBuffer> source;
+        std::string moduleName;
+        std::shared_ptr<const TokenStream> tokens;
+    };
+    std::vector<Pending> pending;
+    std::mutex pendingMutex;
+
+    std::filesystem::path directory; // Пусто - кэш недоступен
+    std::string compilerStamp;       // Версия компилятора в ключе
+    bool enabled = true;
+};
+
+#endif // ASTCACHE_H
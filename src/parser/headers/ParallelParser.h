@@ -0,0 +1,42 @@
+#ifndef PARALLELPARSER_H
+#define PARALLELPARSER_H
+
+#include <cstddef>
+#include <string>
+#include "AST.h"
+#include "../../lexer/headers/TokenStream.h"
+
+/*
+Параллельный разбор модуля по объявлениям верхнего уровня.
+Объявление верхнего уровня начинается строкой без отступа, и функции, структуры и use
+не переходят через такие строки. Продолжениями считаются строки, которые начинаются с '|'
+(тело), с "|>" (use, поля структуры, pipe-выражения) и с "else" (ветки if верхнего уровня):
+
+    [i32]add(i32: a, i32: b)   ← граница
+    |   return a + b
+    use                        ← граница
+    |> std -> io
+    if x > 0                   ← граница
+    |   echo("+")
+    else
+    |   echo("-")
+
+Строки режутся на пачки по границам, каждую пачку на пуле потоков разбирает свой Parser
+с диапазоном строк, а тела склеиваются в один ProgramNode в порядке исходника.
+Номера строк в узлах сквозные, как у последовательного разбора. Если какая-то пачка
+не разобралась, модуль разбирается заново последовательно - ошибка будет та же,
+что и без параллельности.
+*/
+namespace ParallelParser
+{
+    // Модули меньше этого числа токенов разбираются последовательно: потоки не окупятся
+    constexpr size_t minParallelTokens = 1 << 16;
+
+    // Может ли строка потока начинать новое объявление верхнего уровня (строка непустая)
+    bool startsDeclaration(const TokenStream& tokens, size_t line);
+
+    // maxThreads = 0 - весь пул (см. ThreadPool.hpp)
+    NodePtr<ProgramNode> parse(const TokenStream& tokens, const std::string& moduleName, size_t maxThreads = 0);
+}
+
+#endif // PARALLELPARSER_H
@@ -1,4 +1,5 @@
 #include "../../lexer/headers/Token.h"
+#include "../../lexer/headers/TokenStream.h"
 #include "../../includes/icecream.hpp"
 #include "AST.h"
 #include <memory>
@@ -10,48 +11,74 @@
 
 class Parser {
 public:
-    Parser(const std::vector<std::vector<Token>>& tokens, std::string module) : 
-    moduleName(module), lines(tokens), lineIndex(0), tokenIndex(0)
+    Parser(const TokenStream& tokens, std::string module) : 
+    Parser(tokens, std::move(module), 0, static_cast<int>(tokens.lineCount()))
+    {
+    };
+
+    // Разбирает только строки [firstLine, endLine) - для параллельного разбора по
+    // объявлениям верхнего уровня (см. ParallelParser.h). Конец диапазона - как конец файла.
+    Parser(const TokenStream& tokens, std::string module, int firstLine, int endLine) : 
+    tokens(tokens), moduleName(std::move(module)), lineIndex(firstLine), tokenIndex(0), lineEnd(endLine)
     {
         this->currentNode = nullptr;
     };
 
-    std::shared_ptr<ProgramNode> parse();
+    NodePtr<ProgramNode> parse();
+
+    // Только заголовок функции на текущей строке, тело не читается (body = nullptr)
+    NodePtr<FunctionNode> parseFunctionSignature();
+
+    // Режим для модулей из use: тела функций верхнего уровня пропускаются по отступу и
+    // разбираются при первом FunctionNode::requireBody. owner - тот же поток, что tokens:
+    // отложенные тела держат его, пока не разобраны. Такой AST нельзя класть в ASTCache
+    void deferBodies(std::shared_ptr<const TokenStream> owner) { deferredTokens = std::move(owner); }
+
+    // Где остановился разбор; после исключения из parse() - место ошибки (для ms lsp)
+    int getLineIndex() const { return lineIndex; }
+    int getTokenIndex() const { return tokenIndex; }
 
 private:
-    std::vector<std::vector<Token>> lines; // вектор токенов
+    const TokenStream& tokens; // поток токенов модуля, не копируется
     std::string moduleName; // имя модуля
     int lineIndex; // индекс текущей строки токенов
     int tokenIndex; // индекс текущего токена в строке
+    int lineEnd; // строка за последней разбираемой (lineCount() для всего файла)
     int currentIndent; // текущий уровень отступа
     bool isPipe;
-    std::shared_ptr<ASTNode> currentNode; // указатель на текущий узел AST
+    NodePtr<ASTNode> currentNode; // указатель на текущий узел AST
+    std::shared_ptr<const TokenStream> deferredTokens; // не пусто - тела функций верхнего уровня откладываются
 
     // указатель на текущий токен
     Token current(); // возвращает текущий токен
     Token advance(); // переходит к следующему токену
     Token peek(); // возвращает следующий токен без перехода к нему
+    // то же без сборки Token - для горячих путей разбора выражений
+    TokenType currentType() const; // тип текущего токена, None в конце строки
+    TokenType peekType() const; // тип следующего токена, None в конце строки
+    std::string_view currentValue() const; // текст текущего токена, пустой в конце строки
     bool nextLine(); // переходит к следующей строке токенов
     bool match(TokenType type); // проверяет, совпадает ли текущий токен с заданным типом
                                 // и если да, переходит к следующему токену
     bool check(TokenType type); // проверяет, является ли текущий токен заданного типа
                                 // и если да, возвращает true, без перехода к следующему токену
     // парсеры
-    std::shared_ptr<ASTNode> parseStatement();
-    std::shared_ptr<ASTNode> parseExpression();
-    std::shared_ptr<FunctionNode> parseFunction();
-    std::shared_ptr<BlockNode> parseBlock(int);
-    std::shared_ptr<ASTNode> parseAssignment(bool);
-    std::shared_ptr<ASTNode> parseIf();
-    std::shared_ptr<ASTNode> parseFor();
-    std::shared_ptr<ASTNode> parseWhile();
-    std::shared_ptr<ASTNode> parseReturn();
-    std::shared_ptr<ASTNode> parseCall();
-    std::shared_ptr<ASTNode> parseStruct();
-
-    std::shared_ptr<ASTNode> parseUse();
-
-    std::shared_ptr<ASTNode> parseCast(std::shared_ptr<ASTNode> expression);
+    NodePtr<ASTNode> parseStatement();
+    NodePtr<ASTNode> parseExpression();
+    NodePtr<FunctionNode> parseFunction();
+    NodePtr<BlockNode> parseBlock(int);
+    void deferBody(NodePtr<FunctionNode> function, int expectedIndent); // пропускает тело, его разбор - в function->deferredBody
+    NodePtr<ASTNode> parseAssignment(bool);
+    NodePtr<ASTNode> parseIf();
+    NodePtr<ASTNode> parseFor();
+    NodePtr<ASTNode> parseWhile();
+    NodePtr<ASTNode> parseReturn();
+    NodePtr<ASTNode> parseCall();
+    NodePtr<ASTNode> parseStruct();
+
+    NodePtr<ASTNode> parseUse();
+
+    NodePtr<ASTNode> parseCast(NodePtr<ASTNode> expression);
 
 /*
 все возможные случаи это
@@ -87,24 +114,34 @@ functionName([expression], [expression], ...)
 return [expression]
 
 */
-    // выражения
-    std::shared_ptr<ASTNode> parseBinary(int precedence = 0);
-    std::shared_ptr<ASTNode> parseUnary();
-    std::shared_ptr<ASTNode> parsePrimary();
-    std::shared_ptr<ASTNode> parseMemberExpression();
+    // выражения (Pratt): префиксные разборщики выбираются по типу токена,
+    // инфиксные операторы - по силе связывания
+    NodePtr<ASTNode> parseBinary(int precedence = 0);
+    NodePtr<ASTNode> parsePrefix();
+    NodePtr<ASTNode> parseNumberLiteral();
+    NodePtr<ASTNode> parseStringLiteral();
+    NodePtr<ASTNode> parseIdentifierExpression();
+    NodePtr<ASTNode> parseBracketExpression();
+    NodePtr<ASTNode> parseLambdaLiteral();
+    NodePtr<ASTNode> parseMapLiteral();
+    NodePtr<ASTNode> parseGrouping();
+    NodePtr<ASTNode> parseKeywordExpression();
+    NodePtr<ASTNode> parsePrefixOperator();
+    NodePtr<ASTNode> parseMemberExpression();
     
-    void parseDotNotation(std::shared_ptr<AccessExpression>);
-    void parseArrayNotation(std::shared_ptr<AccessExpression>);
+    void parseDotNotation(NodePtr<AccessExpression>);
+    void parseArrayNotation(NodePtr<AccessExpression>);
 
     // вспомогательное
     void consume(TokenType, const std::string& errMsg);
     bool isEndOfFile() const; 
     bool isEndOfLine() const; // проверяет, достигнут ли конец строки
-    int getIndentLevel(const std::vector<Token>& line);
+    int getIndentLevel(int line) const;
     Token getLastTokenInCurrentLine() const;
-    int getPrecedence(const Token& token) const;
+    BinaryOpcode currentInfix() const; // инфиксный оператор под курсором или BinaryOpcode::Count
     void throwError(const std::string& errMsg);
+    [[noreturn]] void throwUnknownPrimary();
 
-    std::shared_ptr<TypeNode> getFullType();
+    NodePtr<TypeNode> getFullType();
 };
     
\ No newline at end of file
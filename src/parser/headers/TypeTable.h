@@ -0,0 +1,78 @@
+#ifndef TYPETABLE_H
+#define TYPETABLE_H
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "AST.h"
+
+/*
+Глобальная таблица типов (hash-consing).
+Каждый различный тип - имя и, для обобщённых, id параметров - получает плотный
+32-битный id, как имя в Interner. Узел типа считает свой id один раз (TypeNode::id())
+и дальше сравнивается с другими по id, без toString():
+
+    a->id() == b->id();              // map<string, array<i32>> == map<string, array<i32>>
+    sameType(a, b);                  // то же, с проверкой на пустые узлы
+    type->id() == TypeTable::Float;  // встроенные типы - константы
+
+node(id) - канонический узел типа в арене: один на id, а не новый makeNode на каждый
+вывод типа. После ASTArena::reset()/rewind() узел пересоздаётся, id не меняются.
+Узел типа не меняется после первого id() (параметры добавляются до использования).
+Id 0 - нет типа. Потокобезопасна.
+*/
+class TypeTable
+{
+public:
+    // Встроенные типы регистрируются первыми в этом порядке: у i1..float id совпадает
+    // с рангом числового типа (TypeSymbolVisitor::getTypeRank)
+    static constexpr TypeId Invalid = 0;
+    static constexpr TypeId I1 = 1;
+    static constexpr TypeId I8 = 2;
+    static constexpr TypeId I16 = 3;
+    static constexpr TypeId I32 = 4;
+    static constexpr TypeId I64 = 5;
+    static constexpr TypeId Float = 6;
+    static constexpr TypeId String = 7;
+    static constexpr TypeId Void = 8;
+    static constexpr TypeId Null = 9;
+    static constexpr TypeId None = 10;
+    static constexpr TypeId Auto = 11;
+
+    TypeTable(const TypeTable&) = delete;
+    TypeTable& operator=(const TypeTable&) = delete;
+
+    static TypeTable& getInstance() {
+        static TypeTable instance;
+        return instance;
+    }
+
+    TypeId simple(Symbol name);
+    TypeId generic(Symbol baseName, const std::vector<TypeId>& parameters);
+
+    // Канонический узел типа (SimpleTypeNode или GenericTypeNode)
+    NodePtr<TypeNode> node(TypeId id);
+    NodePtr<TypeNode> node(Symbol name) { return node(simple(name)); }
+
+    std::string toString(TypeId id) const;
+    static bool isInteger(TypeId id) { return id >= I1 && id <= I64; }
+
+private:
+    TypeTable();
+
+    struct Entry {
+        Symbol name;
+        bool generic = false;
+        std::vector<TypeId> parameters;
+        NodePtr<TypeNode> canonical; // Проверяется на каждом node(): арену могли сбросить
+    };
+
+    TypeId intern(Symbol name, bool generic, const std::vector<TypeId>& parameters);
+
+    std::vector<Entry> entries; // Индекс - id
+    std::unordered_map<std::u32string, TypeId> ids; // Ключ: вид, имя, id параметров
+    mutable std::mutex mutex;
+};
+
+#endif // TYPETABLE_H
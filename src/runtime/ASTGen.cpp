@@ -81,7 +81,7 @@ void ASTGen::visit(FunctionNode& node) {
     
     llvm::FunctionType* funcType = llvm::FunctionType::get(returnLLVMType, paramTypes, false);
     llvm::Function* func = llvm::Function::Create(
-        funcType, llvm::Function::ExternalLinkage, node.name, context.TheModule.get());
+        funcType, llvm::Function::ExternalLinkage, node.name.str(), context.TheModule.get());
 
     
     
@@ -90,19 +90,20 @@ void ASTGen::visit(FunctionNode& node) {
         context.TheContext, "entry", func);
     context.Builder.SetInsertPoint(entryBlock);
     
-    // Сохраняем старую таблицу символов и создаем новую
-    auto oldNamedValues = context.NamedValues;
+    // Область функции: параметры и локальные переменные откатываются при выходе
+    context.NamedValues.enterScope();
     
     // Обрабатываем параметры функции
     unsigned idx = 0;
     for (auto &arg : func->args()) {
-        arg.setName(node.parameters[idx++].second);
-        context.NamedValues[arg.getName().str()] = &arg;
+        Symbol paramName = node.parameters[idx++].second;
+        arg.setName(paramName.str());
+        context.NamedValues[paramName] = &arg;
     }
 
     // Генерируем тело функции, если оно есть
-    if (node.body) {
-        node.body->accept(*this);
+    if (auto body = node.requireBody()) {
+        body->accept(*this);
     }
 
     // Добавляем return, если его нет
@@ -134,7 +135,7 @@ void ASTGen::visit(FunctionNode& node) {
 
     
     // Восстанавливаем старую таблицу символов
-    context.NamedValues = oldNamedValues;
+    context.NamedValues.exitScope();
     
     result = func;
 
@@ -160,17 +161,20 @@ void ASTGen::visit(BlockNode& node) {
 
         stmt->accept(*this);
 
-        // Если это вложенная функция, то чтобы не терялась точка вставки
-        if (dynamic_cast<FunctionNode*>(stmt.get()) && prevBlock) {
-            context.Builder.SetInsertPoint(prevBlock);
-        }
-        if (dynamic_cast<IfNode*>(stmt.get()) && prevBlock) {
-            prevBlock = context.Builder.GetInsertBlock();
-            context.Builder.SetInsertPoint(prevBlock);
-        }
-        if (dynamic_cast<WhileNode*>(stmt.get()) && prevBlock) {
-            prevBlock = context.Builder.GetInsertBlock();
-            context.Builder.SetInsertPoint(prevBlock);
+        if (!prevBlock) continue;
+
+        switch (stmt->kind) {
+            // Если это вложенная функция, то чтобы не терялась точка вставки
+            case NodeKind::Function:
+                context.Builder.SetInsertPoint(prevBlock);
+                break;
+            case NodeKind::If:
+            case NodeKind::While:
+                prevBlock = context.Builder.GetInsertBlock();
+                context.Builder.SetInsertPoint(prevBlock);
+                break;
+            default:
+                break;
         }
     }
 
@@ -225,7 +229,7 @@ void ASTGen::visit(VariableAssignNode& node) {
     }
     
     // Проверяем является ли выражение структурой данных (array или map)
-    std::shared_ptr<BlockNode> blockExpr = std::dynamic_pointer_cast<BlockNode>(node.expression);
+    NodePtr<BlockNode> blockExpr = dyn_cast<BlockNode>(node.expression);
     if (blockExpr) {
 #if DEBUG
         std::cerr << "Обнаружено выражение блока для переменной " << node.name << std::endl;
@@ -371,7 +375,14 @@ void ASTGen::visit(ReturnNode& node) {
 void ASTGen::visit(CallNode& node) {
     LogWarning("visit не реализован для CallNode: " + node.callee);
     // Сначала в модуле ищем хуйню
-    llvm::Function* calleeFunc = context.TheModule->getFunction(node.callee);
+    llvm::Function* calleeFunc = context.TheModule->getFunction(node.callee.str());
+
+    // Потоковая компиляция: функция сгенерирована в другом модуле - хватит объявления
+    if (!calleeFunc) {
+        auto prototype = context.externalFunctions.find(node.callee);
+        if (prototype != context.externalFunctions.end())
+            calleeFunc = context.getOrDeclareFunction(node.callee.str(), prototype->second);
+    }
 
     // Если не нашли пробуем объявить через TOML
     if (!calleeFunc) {
@@ -491,7 +502,7 @@ void ASTGen::visit(ModuleMark &node)
 }
 
 void ASTGen::visit(BinaryOpNode& node) {
-    LogWarning("Обработка BinaryOpNode: " + node.op);
+    LogWarning("Обработка BinaryOpNode: " + opcodeName(node.op));
 
     if (!node.left) {
         LogWarning("Ошибка: левый операнд равен nullptr");
@@ -525,7 +536,7 @@ void ASTGen::visit(BinaryOpNode& node) {
 }
 
 void ASTGen::visit(UnaryOpNode& node) {
-    LogWarning("Обработка UnaryOpNode: " + node.op);
+    LogWarning("Обработка UnaryOpNode: " + opcodeName(node.op));
 
     if (!node.operand) {
         LogWarning("Ошибка: операнд равен nullptr");
@@ -10,10 +10,10 @@ llvm::Function* CodeGenContext::getOrDeclareFunction(const std::string& name, ll
     return func;
 }
 
-llvm::Type* CodeGenContext::getLLVMType(std::shared_ptr<TypeNode> typeNode, llvm::LLVMContext& ctx) {
+llvm::Type* CodeGenContext::getLLVMType(NodePtr<TypeNode> typeNode, llvm::LLVMContext& ctx) {
     // TODO: Реализовать хуйню для сложных типов как array<array<array<i16>>>
 
-    if (auto simpleType = std::dynamic_pointer_cast<SimpleTypeNode>(typeNode)) {
+    if (auto simpleType = dyn_cast<SimpleTypeNode>(typeNode)) {
         if (simpleType->name == "i1") return llvm::Type::getInt1Ty(ctx);
         if (simpleType->name == "i8") return llvm::Type::getInt8Ty(ctx);
         if (simpleType->name == "i16") return llvm::Type::getInt16Ty(ctx);
@@ -25,7 +25,7 @@ llvm::Type* CodeGenContext::getLLVMType(std::shared_ptr<TypeNode> typeNode, llvm
         if (simpleType->name == "null") return llvm::PointerType::get(llvm::Type::getInt8Ty(ctx), 0); // null как указатель на i8
         if (simpleType->name == "auto") return llvm::PointerType::get(llvm::Type::getInt8Ty(ctx), 0); // auto как указатель на i8
     }
-    else if (auto genericType = std::dynamic_pointer_cast<GenericTypeNode>(typeNode)) {
+    else if (auto genericType = dyn_cast<GenericTypeNode>(typeNode)) {
         // Обработка параметризованных типов
         if (genericType->baseName == "array") {
             // Создаём структуру для представления массива с метаданными
@@ -77,21 +77,21 @@ llvm::Type* CodeGenContext::getLLVMType(std::shared_ptr<TypeNode> typeNode, llvm
     return llvm::PointerType::getUnqual(ctx);
 }
 
-std::shared_ptr<TypeNode> CodeGenContext::getTypeByASTNode(std::shared_ptr<ASTNode> node) {
-    if (auto typeNode = std::dynamic_pointer_cast<TypeNode>(node)) {
-        return typeNode;
-    }
-    else if (auto numberNode = std::dynamic_pointer_cast<NumberNode>(node)) {
-        return std::make_shared<SimpleTypeNode>(numberNode->type->toString());
-    }
-    else if (auto stringNode = std::dynamic_pointer_cast<StringNode>(node)) {
-        return std::make_shared<SimpleTypeNode>("string");
-    }
-    else if (auto floatNode = std::dynamic_pointer_cast<FloatNumberNode>(node)) {
-        return std::make_shared<SimpleTypeNode>("float");
-    }
-    else if (auto nullNode = std::dynamic_pointer_cast<NullNode>(node)) {
-        return std::make_shared<SimpleTypeNode>("null");
+NodePtr<TypeNode> CodeGenContext::getTypeByASTNode(NodePtr<ASTNode> node) {
+    switch (node->kind) {
+        case NodeKind::SimpleType:
+        case NodeKind::GenericType:
+            return cast<TypeNode>(node);
+        case NodeKind::Number:
+            return TypeTable::getInstance().node(cast<NumberNode>(node)->type->id());
+        case NodeKind::String:
+            return TypeTable::getInstance().node(TypeTable::String);
+        case NodeKind::FloatNumber:
+            return TypeTable::getInstance().node(TypeTable::Float);
+        case NodeKind::Null:
+            return TypeTable::getInstance().node(TypeTable::Null);
+        default:
+            break;
     }
     throw std::runtime_error("Unknown ASTNode type for type inference : " + std::to_string(node->line) + ":" + std::to_string(node->column));
 }
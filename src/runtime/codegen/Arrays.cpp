@@ -3,7 +3,7 @@
 
 namespace Arrays
 {
-    llvm::Value* handleArrayInitialization(CodeGenContext& context, VariableAssignNode& node, llvm::Type* varType, std::shared_ptr<BlockNode> blockExpr)
+    llvm::Value* handleArrayInitialization(CodeGenContext& context, VariableAssignNode& node, llvm::Type* varType, NodePtr<BlockNode> blockExpr)
     {
         ASTGen codeGen(context);
         // Генерируем код для выражения
@@ -12,7 +12,7 @@ namespace Arrays
         codeGen.LogWarning("Инициализация массива через блок для " + node.name);
     
         // Проверяем, является ли первый элемент KeyValueNode (для map)
-        if (!blockExpr->statements.empty() && std::dynamic_pointer_cast<KeyValueNode>(blockExpr->statements[0])) {
+        if (!blockExpr->statements.empty() && dyn_cast<KeyValueNode>(blockExpr->statements[0])) {
             codeGen.LogWarning("Инициализация map не реализована");
             return nullptr;
         }
@@ -21,7 +21,7 @@ namespace Arrays
         llvm::Type* elementType = nullptr;
         
         // Пытаемся получить тип элемента из объявления переменной
-        if (auto genType = std::dynamic_pointer_cast<GenericTypeNode>(node.type)) {
+        if (auto genType = dyn_cast<GenericTypeNode>(node.type)) {
             if (genType->baseName == "array" && !genType->typeParameters.empty()) {
                 elementType = context.getLLVMType(genType->typeParameters[0], context.TheContext);
             }
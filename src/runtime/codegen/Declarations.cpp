@@ -9,7 +9,7 @@ namespace Declarations
         node.expression->accept(codeGen);
         llvm::Value* value = codeGen.getResult();
 
-        std::shared_ptr<TypeNode> typeNode;
+        NodePtr<TypeNode> typeNode;
         if (node.expression->inferredType)
             typeNode = node.expression->inferredType;
         else 
@@ -32,7 +32,7 @@ namespace Declarations
         }
 
         // Создаем переменную в таблице символов
-        llvm::AllocaInst* alloca = context.Builder.CreateAlloca(varType, nullptr, node.name);
+        llvm::AllocaInst* alloca = context.Builder.CreateAlloca(varType, nullptr, node.name.str());
         context.NamedValues[node.name] = alloca;
         
         // Записываем значение в переменную
@@ -40,7 +40,7 @@ namespace Declarations
         return alloca;
     }
     
-    llvm::Value* handleGlobalStringVariable(CodeGenContext &context, VariableAssignNode &node, llvm::Type *varType, std::shared_ptr<StringNode> strNode)
+    llvm::Value* handleGlobalStringVariable(CodeGenContext &context, VariableAssignNode &node, llvm::Type *varType, NodePtr<StringNode> strNode)
     {
         // Создаем константный массив символов для строки
         llvm::Constant* strConstant = llvm::ConstantDataArray::getString(context.TheContext, strNode->value, true);
@@ -52,7 +52,7 @@ namespace Declarations
             node.isConst,            // isConstant
             llvm::GlobalValue::PrivateLinkage,
             strConstant,             // Инициализатор
-            node.name
+            node.name.str()
         );
 
         // Устанавливаем атрибуты для глобальной переменной
@@ -65,11 +65,11 @@ namespace Declarations
         return globalVar;
     }
 
-    llvm::Value* handleGlobalArrayVariable(CodeGenContext &context, VariableAssignNode &node, llvm::Type *varType, std::shared_ptr<BlockNode> blockExpr)
+    llvm::Value* handleGlobalArrayVariable(CodeGenContext &context, VariableAssignNode &node, llvm::Type *varType, NodePtr<BlockNode> blockExpr)
     {
         ASTGen codeGen(context);
         
-        if (!blockExpr->statements.empty() && std::dynamic_pointer_cast<KeyValueNode>(blockExpr->statements[0])) {
+        if (!blockExpr->statements.empty() && dyn_cast<KeyValueNode>(blockExpr->statements[0])) {
             codeGen.LogWarning("Инициализация map не реализована");
             return nullptr;
         }
@@ -78,7 +78,7 @@ namespace Declarations
     
         // 1. Определяем тип элементов
         llvm::Type* elementType = nullptr;
-        if (auto genType = std::dynamic_pointer_cast<GenericTypeNode>(node.type)) {
+        if (auto genType = dyn_cast<GenericTypeNode>(node.type)) {
             if (genType->baseName == "array" && !genType->typeParameters.empty()) {
                 elementType = context.getLLVMType(genType->typeParameters[0], context.TheContext);
             }
@@ -128,7 +128,7 @@ namespace Declarations
                 if (!stmt) continue;
                 
                 // Специальная обработка для строк и других типов...
-                if (auto stringNode = std::dynamic_pointer_cast<StringNode>(stmt)) {
+                if (auto stringNode = dyn_cast<StringNode>(stmt)) {
                     llvm::Constant* strConst = llvm::ConstantDataArray::getString(
                         context.TheContext, stringNode->value, true);
                     llvm::GlobalVariable* strGlobal = new llvm::GlobalVariable(
@@ -224,7 +224,7 @@ namespace Declarations
             node.isConst,
             llvm::GlobalValue::PrivateLinkage,
             structInitializer,
-            node.name
+            node.name.str()
         );
         
         // 5. Сохраняем переменную в таблицу символов и тип элементов в таблицу типов
@@ -246,12 +246,12 @@ namespace Declarations
     {
         ASTGen codeGen(context);
 
-        if (std::shared_ptr<StringNode> strNode = std::dynamic_pointer_cast<StringNode>(node.expression)) {
+        if (NodePtr<StringNode> strNode = dyn_cast<StringNode>(node.expression)) {
 
             return handleGlobalStringVariable(context, node, varType, strNode);
         }
 
-        if (std::shared_ptr<BlockNode> blockNode = std::dynamic_pointer_cast<BlockNode>(node.expression)) {
+        if (NodePtr<BlockNode> blockNode = dyn_cast<BlockNode>(node.expression)) {
             
             return handleGlobalArrayVariable(context, node, varType, blockNode);
         }
@@ -284,7 +284,7 @@ namespace Declarations
             node.isConst, // isConstant
             llvm::GlobalValue::PrivateLinkage,
             llvm::Constant::getNullValue(varType), // Инициализатор
-            node.name
+            node.name.str()
         );
         
         // Если инициализатор - константа, используем её
@@ -7,9 +7,96 @@
 #include <llvm/IR/BasicBlock.h>
 #include <llvm/IR/Type.h>
 #include <llvm/IR/DerivedTypes.h>
+#include <array>
 #include <string>
 #include <vector>
 
+namespace {
+    enum class LoweringKind : uint8_t { Unsupported, Arithmetic, IntCompare, Concat };
+
+    // Как опускать BinaryOpcode в IR. Целая или вещественная инструкция выбирается по типам операндов,
+    // поэтому add и fadd (и т.д.) опускаются одинаково
+    struct BinaryLowering {
+        LoweringKind kind = LoweringKind::Unsupported;
+        llvm::Instruction::BinaryOps intInstruction = llvm::Instruction::Add;
+        llvm::Instruction::BinaryOps floatInstruction = llvm::Instruction::FAdd;
+        const char* intName = "";
+        const char* floatName = "";
+        llvm::CmpInst::Predicate predicate = llvm::CmpInst::BAD_ICMP_PREDICATE;
+    };
+
+    constexpr std::array<BinaryLowering, static_cast<size_t>(BinaryOpcode::Count)> binaryLowering = [] {
+        std::array<BinaryLowering, static_cast<size_t>(BinaryOpcode::Count)> table{};
+        auto arithmetic = [&](BinaryOpcode intOp, BinaryOpcode floatOp, llvm::Instruction::BinaryOps intInstruction,
+                              llvm::Instruction::BinaryOps floatInstruction, const char* intName, const char* floatName) {
+            BinaryLowering lowering{LoweringKind::Arithmetic, intInstruction, floatInstruction, intName, floatName};
+            table[static_cast<size_t>(intOp)] = lowering;
+            table[static_cast<size_t>(floatOp)] = lowering;
+        };
+        arithmetic(BinaryOpcode::Add, BinaryOpcode::FAdd, llvm::Instruction::Add, llvm::Instruction::FAdd, "addtmp_int", "addtmp_float");
+        arithmetic(BinaryOpcode::Sub, BinaryOpcode::FSub, llvm::Instruction::Sub, llvm::Instruction::FSub, "subtmp_int", "subtmp_float");
+        arithmetic(BinaryOpcode::Mul, BinaryOpcode::FMul, llvm::Instruction::Mul, llvm::Instruction::FMul, "multmp_int", "multmp_float");
+        arithmetic(BinaryOpcode::SDiv, BinaryOpcode::FDiv, llvm::Instruction::SDiv, llvm::Instruction::FDiv, "divtmp_int", "divtmp_float");
+        arithmetic(BinaryOpcode::SRem, BinaryOpcode::FRem, llvm::Instruction::SRem, llvm::Instruction::FRem, "remtmp_int", "remtmp_float");
+
+        auto compare = [&](BinaryOpcode op, llvm::CmpInst::Predicate predicate) {
+            table[static_cast<size_t>(op)].kind = LoweringKind::IntCompare;
+            table[static_cast<size_t>(op)].predicate = predicate;
+        };
+        compare(BinaryOpcode::ICmpEQ, llvm::CmpInst::ICMP_EQ);   // ==
+        compare(BinaryOpcode::ICmpNE, llvm::CmpInst::ICMP_NE);   // !=
+        compare(BinaryOpcode::ICmpSLT, llvm::CmpInst::ICMP_SLT); // <
+        compare(BinaryOpcode::ICmpSGT, llvm::CmpInst::ICMP_SGT); // >
+        compare(BinaryOpcode::ICmpSLE, llvm::CmpInst::ICMP_SLE); // <=
+        compare(BinaryOpcode::ICmpSGE, llvm::CmpInst::ICMP_SGE); // >=
+
+        table[static_cast<size_t>(BinaryOpcode::Scat)].kind = LoweringKind::Concat;
+        return table;
+    }();
+
+    // Целочисленное деление с ловушкой на делитель 0
+    llvm::Value* createCheckedSDiv(CodeGenContext& context, llvm::Value* left, llvm::Value* right) {
+        llvm::Function* function = context.Builder.GetInsertBlock()->getParent();
+
+        llvm::BasicBlock* trapBlock = llvm::BasicBlock::Create(context.TheContext, "trap", function);
+        llvm::BasicBlock* divBlock = llvm::BasicBlock::Create(context.TheContext, "div", function);
+
+        // Проверка на делитель == 0
+        llvm::Value* isZero = context.Builder.CreateICmpEQ(
+            right, llvm::ConstantInt::get(right->getType(), 0), "is_zero_check"
+        );
+        context.Builder.CreateCondBr(isZero, trapBlock, divBlock);
+
+        // Код в trap-блоке
+        context.Builder.SetInsertPoint(trapBlock);
+        llvm::Function* trapFunc = llvm::Intrinsic::getOrInsertDeclaration(
+            context.TheModule.get(), llvm::Intrinsic::trap
+        );
+        context.Builder.CreateCall(trapFunc);
+        context.Builder.CreateUnreachable();
+
+        // Код в блоке деления
+        context.Builder.SetInsertPoint(divBlock);
+        auto div = context.Builder.CreateSDiv(left, right, "divtmp_int");
+        // Создаем переход к продолжению
+        llvm::BasicBlock* continueBlock = llvm::BasicBlock::Create(
+            context.TheContext, "div_continue", function
+        );
+        context.Builder.CreateBr(continueBlock);
+
+        // Устанавливаем точку вставки на блок продолжения
+        context.Builder.SetInsertPoint(continueBlock);
+
+        // Создаем PHI-узел для результата деления
+        llvm::PHINode* phi = context.Builder.CreatePHI(
+            div->getType(), 1, "div_result"
+        );
+        phi->addIncoming(div, divBlock);
+
+        return phi;
+    }
+}
+
 llvm::Value* Expressions::handleBinaryOperation(CodeGenContext& context, BinaryOpNode& node, llvm::Value* left, llvm::Value* right) {
     left = TypeConversions::loadValueIfPointer(context, left, "left");
     right = TypeConversions::loadValueIfPointer(context, right, "right");
@@ -19,7 +106,7 @@ llvm::Value* Expressions::handleBinaryOperation(CodeGenContext& context, BinaryO
     left->getType()->print(llvm::errs());
     std::cerr << "\nRight operand type: ";
     right->getType()->print(llvm::errs());
-    std::cerr << "\nOperation: " << node.op << "\n";
+    std::cerr << "\nOperation: " << opcodeName(node.op) << "\n";
 #endif
 
     // Приведение типов
@@ -52,207 +139,52 @@ llvm::Value* Expressions::handleBinaryOperation(CodeGenContext& context, BinaryO
         }
     }
 
-    if (node.op == "add" || node.op == "fadd") {
-        if (left->getType()->isFloatingPointTy() || right->getType()->isFloatingPointTy()) {
-            // Приводим оба операнда к типу float, если один из них float
-            if (left->getType()->isIntegerTy()) {
-                left = context.Builder.CreateSIToFP(left, llvm::Type::getFloatTy(context.TheContext), "int_to_float_left");
-            }
-            if (right->getType()->isIntegerTy()) {
-                right = context.Builder.CreateSIToFP(right, llvm::Type::getFloatTy(context.TheContext), "int_to_float_right");
-            }
-            return context.Builder.CreateFAdd(left, right, "addtmp_float");
-        } else {
-            return context.Builder.CreateAdd(left, right, "addtmp_int");
-        }
-    } 
-    else if (node.op == "sub" || node.op == "fsub") {
-        if (left->getType()->isFloatingPointTy() || right->getType()->isFloatingPointTy()) {
-            if (left->getType()->isIntegerTy()) {
-                left = context.Builder.CreateSIToFP(left, llvm::Type::getFloatTy(context.TheContext), "int_to_float_left");
-            }
-            if (right->getType()->isIntegerTy()) {
-                right = context.Builder.CreateSIToFP(right, llvm::Type::getFloatTy(context.TheContext), "int_to_float_right");
-            }
-            return context.Builder.CreateFSub(left, right, "subtmp_float");
-        } else {
-            return context.Builder.CreateSub(left, right, "subtmp_int");
-        }
-    } 
-    else if (node.op == "mul" || node.op == "fmul") {
-        if (left->getType()->isFloatingPointTy() || right->getType()->isFloatingPointTy()) {
-            if (left->getType()->isIntegerTy()) {
-                left = context.Builder.CreateSIToFP(left, llvm::Type::getFloatTy(context.TheContext), "int_to_float_left");
-            }
-            if (right->getType()->isIntegerTy()) {
-                right = context.Builder.CreateSIToFP(right, llvm::Type::getFloatTy(context.TheContext), "int_to_float_right");
-            }
-            return context.Builder.CreateFMul(left, right, "multmp_float");
-        } else {
-            return context.Builder.CreateMul(left, right, "multmp_int");
-        }
-    } 
-    else if (node.op == "sdiv" || node.op == "fdiv") {
-        if (left->getType()->isFloatingPointTy() || right->getType()->isFloatingPointTy()) {
-            // Обработка float деления...
-            if (left->getType()->isIntegerTy()) {
-                left = context.Builder.CreateSIToFP(left, llvm::Type::getFloatTy(context.TheContext), "int_to_float_left");
+    const BinaryLowering& lowering = binaryLowering[static_cast<size_t>(node.op)];
+    switch (lowering.kind) {
+        case LoweringKind::Arithmetic:
+            if (left->getType()->isFloatingPointTy() || right->getType()->isFloatingPointTy()) {
+                // Приводим оба операнда к типу float, если один из них float
+                if (left->getType()->isIntegerTy()) {
+                    left = context.Builder.CreateSIToFP(left, llvm::Type::getFloatTy(context.TheContext), "int_to_float_left");
+                }
+                if (right->getType()->isIntegerTy()) {
+                    right = context.Builder.CreateSIToFP(right, llvm::Type::getFloatTy(context.TheContext), "int_to_float_right");
+                }
+                return context.Builder.CreateBinOp(lowering.floatInstruction, left, right, lowering.floatName);
             }
-            if (right->getType()->isIntegerTy()) {
-                right = context.Builder.CreateSIToFP(right, llvm::Type::getFloatTy(context.TheContext), "int_to_float_right");
+            if (lowering.intInstruction == llvm::Instruction::SDiv) {
+                return createCheckedSDiv(context, left, right);
             }
-            return context.Builder.CreateFDiv(left, right, "divtmp_float");
-        } else {
-            // Упрощенный вариант для целочисленного деления:
-            llvm::Function* function = context.Builder.GetInsertBlock()->getParent();
-
-            llvm::BasicBlock* currentBlock = context.Builder.GetInsertBlock();
-
-            llvm::BasicBlock* trapBlock = llvm::BasicBlock::Create(context.TheContext, "trap", function);
-            llvm::BasicBlock* divBlock = llvm::BasicBlock::Create(context.TheContext, "div", function);
+            return context.Builder.CreateBinOp(lowering.intInstruction, left, right, lowering.intName);
 
-            // Проверка на делитель == 0
-            llvm::Value* isZero = context.Builder.CreateICmpEQ(
-                right, llvm::ConstantInt::get(right->getType(), 0), "is_zero_check"
-            );
-            context.Builder.CreateCondBr(isZero, trapBlock, divBlock);
-
-            // Код в trap-блоке
-            context.Builder.SetInsertPoint(trapBlock);
-            llvm::Function* trapFunc = llvm::Intrinsic::getOrInsertDeclaration(
-                context.TheModule.get(), llvm::Intrinsic::trap
-            );
-            context.Builder.CreateCall(trapFunc);
-            context.Builder.CreateUnreachable();
+        case LoweringKind::IntCompare:
+            return context.Builder.CreateICmp(lowering.predicate, left, right, "cmptmp");
 
-            // Код в блоке деления
-            context.Builder.SetInsertPoint(divBlock);
-            auto div = context.Builder.CreateSDiv(left, right, "divtmp_int");
-            // Создаем переход к продолжению
-            llvm::BasicBlock* continueBlock = llvm::BasicBlock::Create(
-                context.TheContext, "div_continue", function
-            );
-            context.Builder.CreateBr(continueBlock);
-
-            // Устанавливаем точку вставки на блок продолжения
-            context.Builder.SetInsertPoint(continueBlock);
-
-            // Создаем PHI-узел для результата деления
-            llvm::PHINode* phi = context.Builder.CreatePHI(
-                div->getType(), 1, "div_result"
-            );
-            phi->addIncoming(div, divBlock);
-
-            return phi;
-        }
-    }
-    else if (node.op == "srem" || node.op == "frem") {
-        if (left->getType()->isFloatingPointTy() || right->getType()->isFloatingPointTy()) {
-            if (left->getType()->isIntegerTy()) {
-                left = context.Builder.CreateSIToFP(left, llvm::Type::getFloatTy(context.TheContext), "int_to_float_left");
+        case LoweringKind::Concat: {
+            std::string TOML_path = loader::findTomlPath();
+            if (TOML_path.empty()) {
+                std::cerr << "Warning: Не удалось найти путь к TOML-файлу" << std::endl;
+                return nullptr;
             }
-            if (right->getType()->isIntegerTy()) {
-                right = context.Builder.CreateSIToFP(right, llvm::Type::getFloatTy(context.TheContext), "int_to_float_right");
+
+            // Конкатенация строк через вызов функции из стандартной библиотеки
+            llvm::Function* concatFunc = declareFunctionFromTOML("scat", context.TheModule.get(), 
+                                                             context.TheContext, TOML_path);
+            if (!concatFunc) {
+                std::cerr << "Warning: Функция scat не найдена в стандартной библиотеке" << std::endl;
+                return nullptr;
             }
-            return context.Builder.CreateFRem(left, right, "remtmp_float");
-        } else {
-            return context.Builder.CreateSRem(left, right, "remtmp_int");
-        }
-    } 
-    else if (node.op == "scat") {
-        std::string TOML_path = loader::findTomlPath();
-        if (TOML_path.empty()) {
-            std::cerr << "Warning: Не удалось найти путь к TOML-файлу" << std::endl;
-            return nullptr;
+            std::vector<llvm::Value*> args = {left, right};
+            return context.Builder.CreateCall(concatFunc, args, "concat_result");
         }
 
-        // Конкатенация строк через вызов функции из стандартной библиотеки
-        llvm::Function* concatFunc = declareFunctionFromTOML("scat", context.TheModule.get(), 
-                                                         context.TheContext, TOML_path);
-        if (!concatFunc) {
-            std::cerr << "Warning: Функция scat не найдена в стандартной библиотеке" << std::endl;
-            return nullptr;
-        }
-        std::vector<llvm::Value*> args = {left, right};
-        return context.Builder.CreateCall(concatFunc, args, "concat_result");
+        case LoweringKind::Unsupported:
+            // fcmp_*, strcmp_* и and/or этим опусканием не поддерживаются
+            break;
     }
-    else if (node.op.starts_with("icmp")) {
-        // Сравнение
-        llvm::CmpInst::Predicate predicate;
-        if (node.op == "icmp_eq") 
-        { // ==
-            predicate = llvm::CmpInst::ICMP_EQ;
-        } 
-        else if (node.op == "icmp_ne") 
-        { // !=
-            predicate = llvm::CmpInst::ICMP_NE;
-        } 
-        else if (node.op == "icmp_slt") 
-        { // <
-            predicate = llvm::CmpInst::ICMP_SLT;
-        } 
-        else if (node.op == "icmp_sgt") 
-        { // >
-            predicate = llvm::CmpInst::ICMP_SGT;
-        } 
-        else if (node.op == "icmp_sge") 
-        { // >=
-            predicate = llvm::CmpInst::ICMP_SGE;
-        } 
-        else if (node.op == "icmp_sle") 
-        { // <=
-            predicate = llvm::CmpInst::ICMP_SLE;
-        } 
-        else 
-        {
-#if DEBUG
-            std::cerr << "Warning: Неизвестная операция сравнения: " << node.op << std::endl;
-#endif
-            return nullptr;
-        }
-        
-        return context.Builder.CreateICmp(predicate, left, right, "cmptmp");
-    }
-    /*
-    TODO: Сделать поддержку float
-    else if (node.op.starts_with("fcmp")) {
-        // Сравнение с плавающей точкой
-        llvm::CmpInst::Predicate predicate;
-        if (node.op == "fcmp_oeq") 
-        { // ==
-            predicate = llvm::CmpInst::FCMP_OEQ;
-        } 
-        else if (node.op == "fcmp_one") 
-        { // !=
-            predicate = llvm::CmpInst::FCMP_ONE;
-        } 
-        else if (node.op == "fcmp_olt") 
-        { // <
-            predicate = llvm::CmpInst::FCMP_OLT;
-        } 
-        else if (node.op == "fcmp_ogt") 
-        { // >
-            predicate = llvm::CmpInst::FCMP_OGT;
-        } 
-        else if (node.op == "fcmp_oge") 
-        { // >=
-            predicate = llvm::CmpInst::FCMP_OGE;
-        } 
-        else if (node.op == "fcmp_ole") 
-        { // <=
-            predicate = llvm::CmpInst::FCMP_OLE;
-        } 
-        else 
-        {
-            std::cerr << "Warning: Неизвестная операция сравнения с плавающей точкой: " << node.op << std::endl;
-            return nullptr;
-        }
-        
-        return context.Builder.CreateFCmp(predicate, left, right, "cmptmp");
-    }
-    */
+
 #if DEBUG    
-    std::cerr << "Warning: Неизвестная бинарная операция: " << node.op << std::endl;
+    std::cerr << "Warning: Неизвестная бинарная операция: " << opcodeName(node.op) << std::endl;
 #endif
     return nullptr;
 }
@@ -264,7 +196,7 @@ llvm::Value* Expressions::handleUnaryOperation(CodeGenContext& context, UnaryOpN
         operand = TypeConversions::applyImplicitCast(context, operand, node.operand->implicitCastTo, "operand");
     }
     
-    if (node.op == "neg") {  // Унарный минус
+    if (node.op == UnaryOpcode::Neg) {  // Унарный минус
         if (operand->getType()->isFloatingPointTy()) {
             return context.Builder.CreateFNeg(operand, "negtmp");
         } else if (operand->getType()->isIntegerTy()) {
@@ -274,7 +206,7 @@ llvm::Value* Expressions::handleUnaryOperation(CodeGenContext& context, UnaryOpN
             return nullptr;
         }
     } 
-    else if (node.op == "not") {  // Логическое отрицание
+    else if (node.op == UnaryOpcode::Not) {  // Логическое отрицание
         if (operand->getType()->isIntegerTy(1)) {  // boolean
             return context.Builder.CreateNot(operand, "nottmp");
         } else if (operand->getType()->isIntegerTy()) {
@@ -292,7 +224,7 @@ llvm::Value* Expressions::handleUnaryOperation(CodeGenContext& context, UnaryOpN
     }
 
 #if DEBUG
-    std::cerr << "Warning: Неизвестная унарная операция: " << node.op << std::endl;
+    std::cerr << "Warning: Неизвестная унарная операция: " << opcodeName(node.op) << std::endl;
 #endif
 
     return nullptr;
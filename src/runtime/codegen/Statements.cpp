@@ -9,8 +9,8 @@ namespace Statements {
         llvm::Value* result = nullptr;
         
         if (node.expression) {
-            if (auto block = std::dynamic_pointer_cast<BlockNode>(node.expression)) {
-                if (auto keyValue = std::dynamic_pointer_cast<KeyValueNode>(block->statements[0])) {
+            if (auto block = dyn_cast<BlockNode>(node.expression)) {
+                if (auto keyValue = dyn_cast<KeyValueNode>(block->statements[0])) {
                     // Обработка map (словаря)
                     codeGen.LogWarning("visit для KeyValueNode: ");
                     codeGen.visit(*keyValue);
@@ -57,7 +57,7 @@ namespace Statements {
                             if (!elementNode) continue;
                             
                             // Обрабатываем вложенные массивы рекурсивно
-                            if (auto nestedBlock = std::dynamic_pointer_cast<BlockNode>(elementNode)) {
+                            if (auto nestedBlock = dyn_cast<BlockNode>(elementNode)) {
                                 // Создаем временный ReturnNode для обработки вложенного массива
                                 ReturnNode tempReturn(nestedBlock);
                                 // Рекурсивно обрабатываем вложенный массив
@@ -65,7 +65,7 @@ namespace Statements {
                                 elements.push_back(nestedArrayPtr);
                             }
                             // Обрабатываем вызовы функций
-                            else if (auto callNode = std::dynamic_pointer_cast<CallNode>(elementNode)) {
+                            else if (auto callNode = dyn_cast<CallNode>(elementNode)) {
                                 callNode->accept(codeGen);
                                 llvm::Value* value = codeGen.getResult();
                                 elements.push_back(value);
@@ -96,7 +96,7 @@ llvm::Value* TypeConversions::convertValueToType(CodeGenContext& context, llvm::
     return value;
 }
 
-llvm::Value* TypeConversions::applyImplicitCast(CodeGenContext& context, llvm::Value* value, std::shared_ptr<TypeNode> targetTypeNode, const std::string& name) {
+llvm::Value* TypeConversions::applyImplicitCast(CodeGenContext& context, llvm::Value* value, NodePtr<TypeNode> targetTypeNode, const std::string& name) {
     if (!targetTypeNode || !value) {
         return value;
     }
@@ -9,11 +9,57 @@
 #include <llvm/IR/Type.h>
 #include <llvm/IR/Verifier.h>
 #include <map>
+#include <unordered_map>
 #include <string>
 #include <vector>
 #include <memory> 
+#include <optional>
 
 #include "../../parser/headers/AST.h"
+#include "../../parser/headers/TypeTable.h"
+
+/*
+Таблица символов кодогенерации с областями. Вход в функцию не копирует таблицу:
+запись внутри области запоминает прежнее значение в журнале, а exitScope откатывает
+журнал до отметки входа. Цена функции - число её записей, а не размер таблицы
+(глобальные переменные). Вне областей записи не журналируются.
+*/
+class ScopedSymbolTable {
+public:
+    using Map = std::unordered_map<Symbol, llvm::Value*>;
+
+    Map::iterator       find(Symbol name) { return values.find(name); }
+    Map::iterator       end() { return values.end(); }
+
+    llvm::Value*& operator[](Symbol name) {
+        auto [it, inserted] = values.try_emplace(name, nullptr);
+        if (!marks.empty())
+            journal.push_back({name, inserted ? std::nullopt : std::optional<llvm::Value*>(it->second)});
+        return it->second;
+    }
+
+    void enterScope() { marks.push_back(journal.size()); }
+
+    void exitScope() {
+        if (marks.empty())
+            return;
+        size_t mark = marks.back();
+        marks.pop_back();
+        while (journal.size() > mark) { // В обратном порядке: первая запись области хранит исходное значение
+            auto& [name, previous] = journal.back();
+            if (previous)
+                values[name] = *previous;
+            else
+                values.erase(name);
+            journal.pop_back();
+        }
+    }
+
+private:
+    Map values;
+    std::vector<std::pair<Symbol, std::optional<llvm::Value*>>> journal; // имя и значение до записи (nullopt - имени не было)
+    std::vector<size_t> marks;
+};
 
 
 class CodeGenContext {
@@ -21,17 +67,18 @@ public:
     llvm::LLVMContext                   TheContext; // Контекст LLVM(он отвечает за управление памятью)
     llvm::IRBuilder<>                   Builder; // IRBuilder - это класс, который помогает создавать IR-код
     std::unique_ptr<llvm::Module>       TheModule; // Модуль - это контейнер для IR-кода
-    std::map<std::string, llvm::Value*> NamedValues; // Простая таблица символов для переменных/параметров
+    ScopedSymbolTable                   NamedValues; // Таблица символов для переменных/параметров (ключ - id имени)
     std::map<llvm::Value*, llvm::Type*> arrayElementTypes;
+    std::unordered_map<Symbol, llvm::FunctionType*> externalFunctions; // Функции из уже выпущенных модулей (--stream): объявляются при первом вызове
 
     std::vector<llvm::BasicBlock*> loopEndBlocks;    // Стек для блоков выхода из цикла (для break)
     std::vector<llvm::BasicBlock*> loopCondBlocks;   // Стек для блоков условия цикла (для continue)
 
     llvm::Function*                     getOrDeclareFunction(const std::string& name, llvm::FunctionType* type);
 
-    static llvm::Type*                  getLLVMType(std::shared_ptr<TypeNode> typeNode, llvm::LLVMContext& ctx);
+    static llvm::Type*                  getLLVMType(NodePtr<TypeNode> typeNode, llvm::LLVMContext& ctx);
 
-    std::shared_ptr<TypeNode>           getTypeByASTNode(std::shared_ptr<ASTNode> node);
+    NodePtr<TypeNode>           getTypeByASTNode(NodePtr<ASTNode> node);
 
     llvm::Constant*                     getNoneValue() 
     {
@@ -43,7 +90,7 @@ public:
         return llvm::ConstantPointerNull::get(llvm::PointerType::get(llvm::Type::getInt8Ty(TheContext), 0));
     }
 
-    static std::string                  getTypeString(std::shared_ptr<TypeNode> typeNode)
+    static std::string                  getTypeString(NodePtr<TypeNode> typeNode)
     {
         return typeNode->inferredType->toString();
     }
@@ -27,12 +27,12 @@ inline llvm::Function* declareFunctionFromTOML(
         const auto& retStr = toml::find<std::string>(func, "ret");
         const auto& argsArr = toml::find<std::vector<std::string>>(func, "args");
 
-        llvm::Type* retType = CodeGenContext::getLLVMType(std::make_shared<SimpleTypeNode>(retStr), ctx);
+        llvm::Type* retType = CodeGenContext::getLLVMType(TypeTable::getInstance().node(retStr), ctx);
         if (!retType) return nullptr;
 
         std::vector<llvm::Type*> argTypes;
         for (const auto& argStr : argsArr) {
-            llvm::Type* argType = CodeGenContext::getLLVMType(std::make_shared<SimpleTypeNode>(argStr), ctx);
+            llvm::Type* argType = CodeGenContext::getLLVMType(TypeTable::getInstance().node(argStr), ctx);
             if (!argType) return nullptr;
             argTypes.push_back(argType);
         }
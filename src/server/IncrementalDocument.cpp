@@ -0,0 +1,512 @@
+#include "headers/IncrementalDocument.h"
+#include "../lexer/headers/Lexer.h"
+#include "../parser/headers/Parser.h"
+#include "../parser/headers/ParallelParser.h"
+#include "../linker/headers/Linker.h"
+#include "../errors/headers/ErrorEngine.h"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+
+namespace
+{
+    // Одинаково ли определение для тех, кто на него ссылается. Функцию видно по сигнатуре,
+    // глобальную переменную - по типу; структуру проще считать изменившейся
+    bool sameDefinition(const NodePtr<ASTNode>& before, const NodePtr<ASTNode>& after)
+    {
+        if (before == after)
+            return true;
+        if (!before || !after || before->kind != after->kind)
+            return false;
+
+        switch (before->kind)
+        {
+            case NodeKind::VariableAssign: {
+                auto left = cast<VariableAssignNode>(before);
+                auto right = cast<VariableAssignNode>(after);
+                return left->isConst == right->isConst && sameType(left->type, right->type)
+                    && sameType(left->inferredType, right->inferredType);
+            }
+            case NodeKind::Function: {
+                auto left = cast<FunctionNode>(before);
+                auto right = cast<FunctionNode>(after);
+                if (left->name != right->name || left->associated != right->associated || left->labels != right->labels
+                    || !sameType(left->returnType, right->returnType) || left->parameters.size() != right->parameters.size())
+                    return false;
+                for (size_t i = 0; i < left->parameters.size(); i++)
+                    if (left->parameters[i].second != right->parameters[i].second || !sameType(left->parameters[i].first, right->parameters[i].first))
+                        return false;
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+
+    // Имена, чьи определения различаются в before и after
+    template <typename Map>
+    void collectChanges(const Map& before, const Map& after, std::unordered_set<Symbol>& changedNames)
+    {
+        for (const auto& [name, node] : before) {
+            auto it = after.find(name);
+            if (it == after.end() || !sameDefinition(node, it->second))
+                changedNames.insert(Symbol(name));
+        }
+        for (const auto& entry : after)
+            if (before.find(entry.first) == before.end())
+                changedNames.insert(Symbol(entry.first));
+    }
+
+    // То, что появилось или заменилось в after относительно seed
+    template <typename Map>
+    Map addedEntries(const Map& seed, const Map& after)
+    {
+        Map added;
+        for (const auto& [name, node] : after) {
+            auto it = seed.find(name);
+            if (it == seed.end() || !(it->second == node))
+                added.emplace(name, node);
+        }
+        return added;
+    }
+
+    // Удаляет из сообщения " at line N" и ", column M": позиция и так в диагностике,
+    // а номер строки внутри текста устаревает, когда объявление сдвигается без разбора
+    std::string removePosition(std::string message)
+    {
+        for (std::string_view marker : {" at line ", ", column "}) {
+            size_t start = message.find(marker);
+            if (start == std::string::npos)
+                continue;
+            size_t end = start + marker.size();
+            while (end < message.size() && std::isdigit(static_cast<unsigned char>(message[end])))
+                end++;
+            message.erase(start, end - start);
+        }
+        return message;
+    }
+
+    // Первая строка сообщения; "[line N, column M]" парсера считает строки внутри объявления - убираем.
+    // "[модуль]" семантики - имя последнего проверенного модуля, для открытого документа оно лишнее
+    std::string shortMessage(const std::string& message)
+    {
+        std::string line = message.substr(0, message.find('\n'));
+        if (line.starts_with("Parser Error [")) {
+            size_t close = line.find("]: ");
+            if (close != std::string::npos)
+                line = "Parser Error: " + line.substr(close + 3);
+        } else if (line.starts_with("[")) {
+            size_t close = line.find("]Semantic Error: ");
+            if (close != std::string::npos)
+                line = line.substr(close + 1);
+        }
+        return removePosition(line);
+    }
+}
+
+IncrementalDocument::IncrementalDocument(std::string path, std::string_view text)
+    : path(std::move(path)), moduleName(std::filesystem::path(this->path).stem().string())
+{
+    setText(text);
+}
+
+IncrementalDocument::~IncrementalDocument() = default;
+
+void IncrementalDocument::setText(std::string_view text)
+{
+    lines.clear();
+    size_t start = 0;
+    while (true) {
+        size_t end = text.find('\n', start);
+        auto line = std::make_unique<Line>();
+        line->text = std::string(text.substr(start, end == std::string_view::npos ? std::string_view::npos : end - start));
+        lines.push_back(std::move(line));
+        if (end == std::string_view::npos)
+            break;
+        start = end + 1;
+    }
+}
+
+void IncrementalDocument::edit(int startLine, int startColumn, int endLine, int endColumn, std::string_view text)
+{
+    // Позиции за пределами документа прижимаются к нему, как это делают редакторы.
+    // Строка за последней (в LSP так задают конец документа) - это конец последней строки
+    auto clampPosition = [&](int& line, int& column) {
+        int lastLine = static_cast<int>(lines.size()) - 1;
+        if (line > lastLine) {
+            line = lastLine;
+            column = static_cast<int>(lines[line]->text.size());
+            return;
+        }
+        line = std::max(line, 0);
+        column = std::clamp(column, 0, static_cast<int>(lines[line]->text.size()));
+    };
+    clampPosition(startLine, startColumn);
+    clampPosition(endLine, endColumn);
+    if (endLine < startLine || (endLine == startLine && endColumn < startColumn)) {
+        std::swap(startLine, endLine);
+        std::swap(startColumn, endColumn);
+    }
+
+    // Целые строки вставляются и удаляются, не трогая соседние: строка, с которой
+    // начинается объявление, остаётся тем же объектом, и объявление не разбирается заново
+    if (startColumn == 0 && endColumn == 0 && (text.empty() || text.back() == '\n')) {
+        lines.erase(lines.begin() + startLine, lines.begin() + endLine);
+        std::vector<std::unique_ptr<Line>> inserted;
+        for (size_t start = 0; start < text.size(); ) {
+            size_t end = text.find('\n', start);
+            auto line = std::make_unique<Line>();
+            line->text = std::string(text.substr(start, end - start));
+            inserted.push_back(std::move(line));
+            start = end + 1;
+        }
+        lines.insert(lines.begin() + startLine, std::make_move_iterator(inserted.begin()), std::make_move_iterator(inserted.end()));
+        return;
+    }
+
+    std::string joined = lines[startLine]->text.substr(0, startColumn);
+    joined += text;
+    joined += std::string_view(lines[endLine]->text).substr(endColumn);
+
+    std::vector<std::unique_ptr<Line>> inserted;
+    size_t start = joined.find('\n');
+    lines[startLine]->text = joined.substr(0, start);
+    lines[startLine]->changed = true;
+    while (start != std::string::npos) {
+        size_t end = joined.find('\n', start + 1);
+        auto line = std::make_unique<Line>();
+        line->text = joined.substr(start + 1, end == std::string::npos ? std::string::npos : end - start - 1);
+        inserted.push_back(std::move(line));
+        start = end;
+    }
+
+    lines.erase(lines.begin() + startLine + 1, lines.begin() + endLine + 1);
+    lines.insert(lines.begin() + startLine + 1, std::make_move_iterator(inserted.begin()), std::make_move_iterator(inserted.end()));
+}
+
+void IncrementalDocument::releaseAST()
+{
+    declarations.clear();
+    imported = {};
+    importErrors.clear();
+    importsText.clear();
+    linked = false;
+    linker.reset();
+    checker.reset();
+}
+
+const std::vector<Diagnostic>& IncrementalDocument::diagnostics()
+{
+    stats = {};
+    if (!checker)
+        checker = std::make_unique<TypeSymbolVisitor>();
+
+    std::unordered_set<Symbol> changedNames;
+    relex();
+    splitDeclarations(changedNames);
+    for (auto& declaration : declarations)
+        if (declaration.needsParse)
+            parse(declaration);
+    link(changedNames);
+
+    // Проверка по порядку: visible - глобальный контекст после предыдущих объявлений
+    Definitions visible = imported;
+    for (auto& declaration : declarations) {
+        bool recheck = declaration.needsParse || std::any_of(declaration.uses.begin(), declaration.uses.end(),
+            [&](Symbol name) { return changedNames.count(name) != 0; });
+        if (recheck) {
+            // Проверка меняет AST, поэтому объявление проверяется только свежеразобранным
+            if (!declaration.needsParse)
+                parse(declaration);
+            check(declaration, visible, changedNames);
+        }
+
+        for (const auto& [name, node] : declaration.definitions.variables)
+            visible.variables.insert_or_assign(name, node);
+        for (const auto& [name, node] : declaration.definitions.functions)
+            visible.functions.insert_or_assign(name, node);
+        for (const auto& [name, node] : declaration.definitions.structs)
+            visible.structs.insert_or_assign(name, node);
+        declaration.needsParse = false;
+    }
+
+    for (auto& line : lines)
+        line->changed = false;
+
+    result.clear();
+    bool importsReported = false;
+    for (const auto& declaration : declarations) {
+        if (declaration.imports && !importsReported) {
+            for (const auto& message : importErrors)
+                result.push_back({static_cast<int>(declaration.firstLine), 0, static_cast<int>(lines[declaration.firstLine]->text.size()), message});
+            importsReported = true;
+        }
+        for (Diagnostic diagnostic : declaration.diagnostics) {
+            diagnostic.line += static_cast<int>(declaration.firstLine);
+            result.push_back(std::move(diagnostic));
+        }
+    }
+    return result;
+}
+
+void IncrementalDocument::relex()
+{
+    bool inComment = false;
+    for (size_t index = 0; index < lines.size(); index++) {
+        Line& line = *lines[index];
+        if (line.changed || line.startsInComment != inComment) {
+            line.startsInComment = inComment;
+            line.lexError.clear();
+            try {
+                Lexer lexer(line.text, static_cast<int>(index) + 1, inComment);
+                lexer.tokenize();
+                line.tokens = lexer.takeTokens();
+                line.endsInComment = lexer.endsInComment();
+            } catch (const std::exception& e) {
+                line.tokens.clear();
+                line.lexError = shortMessage(e.what());
+                line.endsInComment = inComment;
+            }
+            line.changed = true;
+            stats.lexedLines++;
+        }
+        inComment = line.endsInComment;
+    }
+}
+
+void IncrementalDocument::splitDeclarations(std::unordered_set<Symbol>& changedNames)
+{
+    std::unordered_map<const Line*, size_t> previous;
+    previous.reserve(declarations.size());
+    for (size_t index = 0; index < declarations.size(); index++)
+        previous.emplace(declarations[index].head, index);
+    std::vector<bool> reused(declarations.size(), false);
+
+    std::vector<Declaration> next;
+    next.reserve(declarations.size() + 1);
+    auto close = [&](size_t firstLine, size_t endLine) {
+        Declaration declaration;
+        declaration.head = lines[firstLine].get();
+        declaration.firstLine = firstLine;
+        declaration.endLine = endLine;
+        declaration.needsParse = true;
+
+        auto it = previous.find(declaration.head);
+        if (it != previous.end() && !reused[it->second]) {
+            Declaration& old = declarations[it->second];
+            reused[it->second] = true;
+            bool changed = old.endLine - old.firstLine != endLine - firstLine;
+            for (size_t line = firstLine; line < endLine && !changed; line++)
+                changed = lines[line]->changed;
+
+            if (!changed) {
+                // Строки те же - объявление переезжает целиком, со своим AST и ошибками
+                old.firstLine = firstLine;
+                old.endLine = endLine;
+                next.push_back(std::move(old));
+                return;
+            }
+            // Прежние определения - чтобы потом сравнить с новыми
+            declaration.definitions = std::move(old.definitions);
+        }
+        next.push_back(std::move(declaration));
+    };
+
+    size_t firstLine = 0;
+    for (size_t line = 1; line < lines.size(); line++) {
+        const TokenStream& tokens = lines[line]->tokens;
+        if (tokens.lineCount() == 0 || !ParallelParser::startsDeclaration(tokens, 0))
+            continue;
+        close(firstLine, line);
+        firstLine = line;
+    }
+    close(firstLine, lines.size());
+
+    // Исчезнувшие объявления больше ничего не определяют
+    for (size_t index = 0; index < declarations.size(); index++) {
+        if (reused[index])
+            continue;
+        collectChanges(declarations[index].definitions.variables, decltype(Definitions::variables){}, changedNames);
+        collectChanges(declarations[index].definitions.functions, decltype(Definitions::functions){}, changedNames);
+        collectChanges(declarations[index].definitions.structs, decltype(Definitions::structs){}, changedNames);
+    }
+    declarations = std::move(next);
+}
+
+void IncrementalDocument::parse(Declaration& declaration)
+{
+    stats.parsedDeclarations++;
+
+    TokenStream& tokens = declaration.tokens;
+    tokens.clear();
+    declaration.diagnostics.clear();
+    declaration.program = nullptr;
+    declaration.imports = false;
+
+    for (size_t line = declaration.firstLine; line < declaration.endLine; line++) {
+        const Line& source = *lines[line];
+        if (!source.lexError.empty())
+            declaration.diagnostics.push_back({static_cast<int>(line - declaration.firstLine), 0, static_cast<int>(source.text.size()), source.lexError});
+        if (source.tokens.lineCount() == 0)
+            continue;
+        size_t from = tokens.size();
+        tokens.append(source.tokens);
+        std::fill(tokens.lines.begin() + from, tokens.lines.end(), static_cast<int>(line) + 1);
+    }
+
+    declaration.uses.clear();
+    for (Symbol symbol : tokens.symbols)
+        if (!symbol.empty())
+            declaration.uses.push_back(symbol);
+    std::sort(declaration.uses.begin(), declaration.uses.end(), [](Symbol left, Symbol right) { return left.getId() < right.getId(); });
+    declaration.uses.erase(std::unique(declaration.uses.begin(), declaration.uses.end()), declaration.uses.end());
+
+    if (tokens.size() == 0) {
+        declaration.program = makeNode<ProgramNode>();
+        return;
+    }
+
+    Parser parser(tokens, moduleName);
+    try {
+        declaration.program = parser.parse();
+    } catch (const std::exception& e) {
+        declaration.diagnostics.push_back(locate(declaration, parser.getLineIndex(), parser.getTokenIndex(), shortMessage(e.what())));
+        return;
+    }
+
+    for (const auto& node : declaration.program->body)
+        declaration.imports = declaration.imports || isa<ImportNode>(node);
+}
+
+void IncrementalDocument::link(std::unordered_set<Symbol>& changedNames)
+{
+    std::string text;
+    for (const auto& declaration : declarations) {
+        if (!declaration.imports)
+            continue;
+        for (size_t line = declaration.firstLine; line < declaration.endLine; line++)
+            text.append(lines[line]->text).push_back('\n');
+    }
+    // Модули из use правят и снаружи: тогда линковка повторяется и при тех же use.
+    // После неудачной линковки (linker сброшен) - на каждой правке: недостающий модуль могли создать
+    if (linked && text == importsText && (text.empty() || (linker && !linker->changedOnDisk())))
+        return;
+    linked = true;
+    importsText = std::move(text);
+
+    Definitions previous = std::move(imported);
+    imported = {};
+    importErrors.clear();
+
+    if (!importsText.empty()) {
+        auto program = makeNode<ProgramNode>();
+        program->moduleName = moduleName;
+        for (const auto& declaration : declarations)
+            if (declaration.imports)
+                for (const auto& node : declaration.program->body)
+                    if (isa<ImportNode>(node))
+                        program->body.push_back(node);
+
+        // Модули ищутся так же, как при компиляции (см. parseAndLinkModules)
+        if (!linker)
+            linker = std::make_unique<Linker>(std::filesystem::current_path().string());
+        if (!linker->addModule(moduleName, path, program, nullptr, importsText) || !linker->linkModules()) {
+            importErrors.push_back("Ошибка при линковке модулей");
+            linker.reset(); // После неудачи состояние графа не переиспользуется
+        } else {
+            Context globals;
+            for (const auto& name : linker->getOrder()) {
+                const ModuleContext& module = linker->getModules().at(name);
+                if (name == moduleName || !module.ast)
+                    continue;
+                for (const auto& node : module.ast->body) {
+                    if (isa<ImportNode>(node))
+                        continue;
+                    try {
+                        checker->checkDeclaration(makeNode<ModuleMark>(module.path), globals, imported.structs);
+                        checker->checkDeclaration(node, globals, imported.structs);
+                    } catch (const std::exception& e) {
+                        auto report = ErrorEngine::getInstance().takeLastReport();
+                        importErrors.push_back(name + ": " + (report ? report->message : shortMessage(e.what())));
+                    }
+                }
+            }
+            imported.variables = std::move(globals.variables);
+            imported.functions = std::move(globals.functions);
+        }
+    }
+
+    collectChanges(previous.variables, imported.variables, changedNames);
+    collectChanges(previous.functions, imported.functions, changedNames);
+    collectChanges(previous.structs, imported.structs, changedNames);
+}
+
+void IncrementalDocument::check(Declaration& declaration, const Definitions& visible, std::unordered_set<Symbol>& changedNames)
+{
+    Definitions previous = std::move(declaration.definitions);
+    declaration.definitions = {};
+
+    if (declaration.program) {
+        stats.checkedDeclarations++;
+
+        // Из глобального контекста берутся только имена, которые встречаются в объявлении
+        Context globals;
+        std::unordered_map<std::string, NodePtr<StructNode>> structs;
+        for (Symbol name : declaration.uses) {
+            if (auto it = visible.variables.find(name); it != visible.variables.end())
+                globals.variables.emplace(*it);
+            if (auto it = visible.functions.find(name); it != visible.functions.end())
+                globals.functions.emplace(*it);
+            if (auto it = visible.structs.find(name.str()); it != visible.structs.end())
+                structs.emplace(*it);
+        }
+        Context seed = globals;
+        auto seedStructs = structs;
+
+        ErrorEngine::getInstance().takeLastReport();
+        for (const auto& node : declaration.program->body) {
+            try {
+                checker->checkDeclaration(node, globals, structs);
+            } catch (const std::exception& e) {
+                auto report = ErrorEngine::getInstance().takeLastReport();
+                if (report)
+                    declaration.diagnostics.push_back(locate(declaration, report->line, report->column, report->message));
+                else
+                    declaration.diagnostics.push_back(locate(declaration, node->line, node->column, shortMessage(e.what())));
+                break;
+            }
+        }
+
+        declaration.definitions.variables = addedEntries(seed.variables, globals.variables);
+        declaration.definitions.functions = addedEntries(seed.functions, globals.functions);
+        declaration.definitions.structs = addedEntries(seedStructs, structs);
+    }
+
+    collectChanges(previous.variables, declaration.definitions.variables, changedNames);
+    collectChanges(previous.functions, declaration.definitions.functions, changedNames);
+    collectChanges(previous.structs, declaration.definitions.structs, changedNames);
+}
+
+Diagnostic IncrementalDocument::locate(const Declaration& declaration, int streamLine, int tokenIndex, const std::string& message) const
+{
+    const TokenStream& tokens = declaration.tokens;
+    Diagnostic diagnostic;
+    diagnostic.message = message;
+    diagnostic.endColumn = static_cast<int>(lines[declaration.firstLine]->text.size());
+    if (streamLine < 0 || streamLine >= static_cast<int>(tokens.lineCount()) || tokens.lineSize(streamLine) == 0)
+        return diagnostic; // Позиции нет - всё первое объявление строки
+
+    size_t index = tokens.lineStarts[streamLine] + std::clamp<size_t>(std::max(tokenIndex, 0), 0, tokens.lineSize(streamLine) - 1);
+    // Номера строк в токенах - с момента разбора; объявление могло с тех пор сдвинуться
+    size_t line = declaration.firstLine + static_cast<size_t>(tokens.lines[index] - tokens.lines[0]);
+    std::string_view text = lines[line]->text;
+    std::string_view span = tokens.spans[index];
+
+    diagnostic.line = static_cast<int>(line - declaration.firstLine);
+    diagnostic.endColumn = static_cast<int>(text.size());
+    if (span.data() >= text.data() && span.data() + span.size() <= text.data() + text.size()) {
+        diagnostic.column = static_cast<int>(span.data() - text.data());
+        diagnostic.endColumn = diagnostic.column + static_cast<int>(span.size());
+    }
+    return diagnostic;
+}
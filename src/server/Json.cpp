@@ -0,0 +1,357 @@
+#include "headers/Json.h"
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace
+{
+    const JsonValue nullValue;
+    const std::string emptyString;
+    const std::vector<JsonValue> emptyArray;
+
+    class Reader
+    {
+    public:
+        explicit Reader(std::string_view text) : text(text) {}
+
+        JsonValue readDocument()
+        {
+            JsonValue value = readValue(0);
+            skipSpaces();
+            if (position != text.size())
+                fail("unexpected data after value");
+            return value;
+        }
+
+    private:
+        static constexpr int maxDepth = 256;
+
+        std::string_view text;
+        size_t position = 0;
+
+        [[noreturn]] void fail(const std::string& message) const
+        {
+            throw std::runtime_error("JSON Error: " + message + " at offset " + std::to_string(position));
+        }
+
+        void skipSpaces()
+        {
+            while (position < text.size() && (text[position] == ' ' || text[position] == '\t' || text[position] == '\n' || text[position] == '\r'))
+                position++;
+        }
+
+        bool consume(std::string_view word)
+        {
+            if (text.substr(position, word.size()) != word)
+                return false;
+            position += word.size();
+            return true;
+        }
+
+        void expect(char symbol)
+        {
+            skipSpaces();
+            if (position >= text.size() || text[position] != symbol)
+                fail(std::string("expected '") + symbol + "'");
+            position++;
+        }
+
+        JsonValue readValue(int depth)
+        {
+            if (depth > maxDepth)
+                fail("nesting is too deep");
+            skipSpaces();
+            if (position >= text.size())
+                fail("unexpected end of input");
+
+            switch (text[position])
+            {
+                case '{': return readObject(depth);
+                case '[': return readArray(depth);
+                case '"': return JsonValue(readString());
+                case 't': if (consume("true")) return JsonValue(true); break;
+                case 'f': if (consume("false")) return JsonValue(false); break;
+                case 'n': if (consume("null")) return JsonValue(); break;
+                default: return readNumber();
+            }
+            fail("unknown literal");
+        }
+
+        JsonValue readObject(int depth)
+        {
+            JsonValue object = JsonValue::object();
+            position++; // '{'
+            skipSpaces();
+            if (position < text.size() && text[position] == '}') {
+                position++;
+                return object;
+            }
+            while (true) {
+                skipSpaces();
+                if (position >= text.size() || text[position] != '"')
+                    fail("expected field name");
+                std::string key = readString();
+                expect(':');
+                object.set(std::move(key), readValue(depth + 1));
+                skipSpaces();
+                if (position < text.size() && text[position] == ',') {
+                    position++;
+                    continue;
+                }
+                expect('}');
+                return object;
+            }
+        }
+
+        JsonValue readArray(int depth)
+        {
+            JsonValue array = JsonValue::array();
+            position++; // '['
+            skipSpaces();
+            if (position < text.size() && text[position] == ']') {
+                position++;
+                return array;
+            }
+            while (true) {
+                array.push(readValue(depth + 1));
+                skipSpaces();
+                if (position < text.size() && text[position] == ',') {
+                    position++;
+                    continue;
+                }
+                expect(']');
+                return array;
+            }
+        }
+
+        JsonValue readNumber()
+        {
+            size_t start = position;
+            if (position < text.size() && text[position] == '-')
+                position++;
+            while (position < text.size() && (std::isdigit(static_cast<unsigned char>(text[position])) || text[position] == '.'
+                   || text[position] == 'e' || text[position] == 'E' || text[position] == '+' || text[position] == '-'))
+                position++;
+            if (start == position)
+                fail("unexpected character");
+
+            std::string digits(text.substr(start, position - start));
+            char* end = nullptr;
+            double value = std::strtod(digits.c_str(), &end);
+            if (end != digits.c_str() + digits.size())
+                fail("invalid number");
+            return JsonValue(value);
+        }
+
+        uint32_t readHex4()
+        {
+            if (position + 4 > text.size())
+                fail("truncated \\u escape");
+            uint32_t code = 0;
+            for (int i = 0; i < 4; i++) {
+                char digit = text[position++];
+                code <<= 4;
+                if (digit >= '0' && digit <= '9') code |= digit - '0';
+                else if (digit >= 'a' && digit <= 'f') code |= digit - 'a' + 10;
+                else if (digit >= 'A' && digit <= 'F') code |= digit - 'A' + 10;
+                else fail("invalid \\u escape");
+            }
+            return code;
+        }
+
+        static void appendUtf8(std::string& out, uint32_t code)
+        {
+            if (code < 0x80) {
+                out += static_cast<char>(code);
+            } else if (code < 0x800) {
+                out += static_cast<char>(0xC0 | (code >> 6));
+                out += static_cast<char>(0x80 | (code & 0x3F));
+            } else if (code < 0x10000) {
+                out += static_cast<char>(0xE0 | (code >> 12));
+                out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (code & 0x3F));
+            } else {
+                out += static_cast<char>(0xF0 | (code >> 18));
+                out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+                out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (code & 0x3F));
+            }
+        }
+
+        std::string readString()
+        {
+            position++; // '"'
+            std::string out;
+            while (true) {
+                size_t plain = position;
+                while (plain < text.size() && text[plain] != '"' && text[plain] != '\\')
+                    plain++;
+                out.append(text.substr(position, plain - position));
+                position = plain;
+                if (position >= text.size())
+                    fail("unterminated string");
+                if (text[position++] == '"')
+                    return out;
+
+                if (position >= text.size())
+                    fail("unterminated escape");
+                char escape = text[position++];
+                switch (escape) {
+                    case '"': out += '"'; break;
+                    case '\\': out += '\\'; break;
+                    case '/': out += '/'; break;
+                    case 'b': out += '\b'; break;
+                    case 'f': out += '\f'; break;
+                    case 'n': out += '\n'; break;
+                    case 'r': out += '\r'; break;
+                    case 't': out += '\t'; break;
+                    case 'u': {
+                        uint32_t code = readHex4();
+                        // Суррогатная пара UTF-16 -> одна кодовая точка
+                        if (code >= 0xD800 && code < 0xDC00 && consume("\\u")) {
+                            uint32_t low = readHex4();
+                            if (low >= 0xDC00 && low < 0xE000) {
+                                code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                            } else {
+                                appendUtf8(out, code);
+                                code = low;
+                            }
+                        }
+                        appendUtf8(out, code);
+                        break;
+                    }
+                    default:
+                        fail("invalid escape");
+                }
+            }
+        }
+    };
+
+    void dumpString(std::string& out, const std::string& value)
+    {
+        out += '"';
+        for (char symbol : value) {
+            switch (symbol) {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(symbol) < 0x20) {
+                        char escaped[8];
+                        std::snprintf(escaped, sizeof(escaped), "\\u%04x", symbol);
+                        out += escaped;
+                    } else {
+                        out += symbol;
+                    }
+            }
+        }
+        out += '"';
+    }
+}
+
+JsonValue JsonValue::parse(std::string_view text)
+{
+    return Reader(text).readDocument();
+}
+
+const std::string& JsonValue::asString() const
+{
+    return type == Type::String ? string : emptyString;
+}
+
+const std::vector<JsonValue>& JsonValue::asArray() const
+{
+    return type == Type::Array ? items : emptyArray;
+}
+
+const JsonValue& JsonValue::operator[](std::string_view key) const
+{
+    for (const auto& [name, value] : fields)
+        if (name == key)
+            return value;
+    return nullValue;
+}
+
+bool JsonValue::contains(std::string_view key) const
+{
+    for (const auto& field : fields)
+        if (field.first == key)
+            return true;
+    return false;
+}
+
+JsonValue& JsonValue::set(std::string key, JsonValue value)
+{
+    type = Type::Object;
+    for (auto& field : fields) {
+        if (field.first == key) {
+            field.second = std::move(value);
+            return *this;
+        }
+    }
+    fields.emplace_back(std::move(key), std::move(value));
+    return *this;
+}
+
+JsonValue& JsonValue::push(JsonValue value)
+{
+    type = Type::Array;
+    items.push_back(std::move(value));
+    return *this;
+}
+
+std::string JsonValue::dump() const
+{
+    std::string out;
+    dump(out);
+    return out;
+}
+
+void JsonValue::dump(std::string& out) const
+{
+    switch (type) {
+        case Type::Null:
+            out += "null";
+            break;
+        case Type::Bool:
+            out += boolean ? "true" : "false";
+            break;
+        case Type::Number: {
+            // Целые (id запросов, позиции) - без дробной части
+            if (std::isfinite(number) && number == std::floor(number) && std::fabs(number) < 9007199254740992.0) {
+                out += std::to_string(static_cast<long long>(number));
+            } else {
+                char buffer[32];
+                std::snprintf(buffer, sizeof(buffer), "%.17g", std::isfinite(number) ? number : 0.0);
+                out += buffer;
+            }
+            break;
+        }
+        case Type::String:
+            dumpString(out, string);
+            break;
+        case Type::Array:
+            out += '[';
+            for (size_t i = 0; i < items.size(); i++) {
+                if (i) out += ',';
+                items[i].dump(out);
+            }
+            out += ']';
+            break;
+        case Type::Object:
+            out += '{';
+            for (size_t i = 0; i < fields.size(); i++) {
+                if (i) out += ',';
+                dumpString(out, fields[i].first);
+                out += ':';
+                fields[i].second.dump(out);
+            }
+            out += '}';
+            break;
+    }
+}
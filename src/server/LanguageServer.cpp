@@ -0,0 +1,302 @@
+#include "headers/LanguageServer.h"
+#include "../errors/headers/ErrorEngine.h"
+#include "../loader/headers/SourceManager.h"
+#include "../parser/headers/AST.h"
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+
+#ifndef MS_VERSION
+#define MS_VERSION "dev"
+#endif
+
+namespace
+{
+    // Коды ошибок JSON-RPC
+    constexpr int parseErrorCode = -32700;
+    constexpr int methodNotFoundCode = -32601;
+    constexpr int textDocumentSyncIncremental = 2;
+
+    size_t utf8Length(unsigned char lead)
+    {
+        return lead < 0xC0 ? 1 : lead < 0xE0 ? 2 : lead < 0xF0 ? 3 : 4;
+    }
+
+    // Колонка LSP (единицы UTF-16) -> байт в строке
+    int toByteColumn(std::string_view text, int character)
+    {
+        size_t byte = 0;
+        int units = 0;
+        while (byte < text.size() && units < character) {
+            size_t length = utf8Length(static_cast<unsigned char>(text[byte]));
+            units += length == 4 ? 2 : 1; // Вне BMP - суррогатная пара
+            byte = std::min(byte + length, text.size());
+        }
+        return static_cast<int>(byte);
+    }
+
+    // Байт в строке -> колонка LSP
+    int toUtf16Column(std::string_view text, int column)
+    {
+        size_t end = std::min(static_cast<size_t>(std::max(column, 0)), text.size());
+        size_t byte = 0;
+        int units = 0;
+        while (byte < end) {
+            size_t length = utf8Length(static_cast<unsigned char>(text[byte]));
+            units += length == 4 ? 2 : 1;
+            byte += length;
+        }
+        return units;
+    }
+
+    // file:///home/user/a%20b.ms -> /home/user/a b.ms
+    std::string uriToPath(const std::string& uri)
+    {
+        std::string_view rest = uri;
+        if (!rest.starts_with("file://"))
+            return uri;
+        rest.remove_prefix(7);
+
+        std::string path;
+        for (size_t i = 0; i < rest.size(); i++) {
+            if (rest[i] == '%' && i + 2 < rest.size() && std::isxdigit(static_cast<unsigned char>(rest[i + 1]))
+                && std::isxdigit(static_cast<unsigned char>(rest[i + 2]))) {
+                path += static_cast<char>(std::stoi(std::string(rest.substr(i + 1, 2)), nullptr, 16));
+                i += 2;
+            } else {
+                path += rest[i];
+            }
+        }
+        return path;
+    }
+
+    JsonValue position(int line, int character)
+    {
+        JsonValue value = JsonValue::object();
+        value.set("line", line);
+        value.set("character", character);
+        return value;
+    }
+}
+
+int LanguageServer::run(std::istream& input, std::ostream& outputStream)
+{
+    // Протокол пишется в исходный буфер stdout, а сам std::cout отключается
+    std::ostream protocol(outputStream.rdbuf());
+    output = &protocol;
+    std::streambuf* coutBuffer = std::cout.rdbuf(nullptr);
+
+    ErrorEngine::getInstance().initialize();
+    ErrorEngine::getInstance().setQuiet(true);
+    // Модули из use правят снаружи: без отображения и кэша буферов
+    SourceManager::getInstance().setMapping(false);
+
+    int exitCode = 1;
+    std::string body;
+    while (readMessage(input, body)) {
+        JsonValue message;
+        try {
+            message = JsonValue::parse(body);
+        } catch (const std::exception& e) {
+            respondError(JsonValue(), parseErrorCode, e.what());
+            continue;
+        }
+        if (!handle(message)) {
+            exitCode = shutdownRequested ? 0 : 1;
+            break;
+        }
+    }
+
+    std::cout.rdbuf(coutBuffer);
+    std::cout.clear();
+    ErrorEngine::getInstance().setQuiet(false);
+    SourceManager::getInstance().setMapping(true);
+    documents.clear();
+    return exitCode;
+}
+
+bool LanguageServer::readMessage(std::istream& input, std::string& body)
+{
+    // Заголовки до пустой строки; нужен только Content-Length
+    std::string line;
+    size_t length = 0;
+    bool hasLength = false;
+    while (std::getline(input, line)) {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (line.empty()) {
+            if (hasLength)
+                break;
+            continue;
+        }
+        size_t colon = line.find(':');
+        if (colon == std::string::npos)
+            continue;
+        std::string name = line.substr(0, colon);
+        std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::tolower(c); });
+        if (name == "content-length") {
+            try {
+                length = std::stoul(line.substr(colon + 1));
+                hasLength = true;
+            } catch (const std::exception&) {
+                hasLength = false;
+            }
+        }
+    }
+    if (!input || !hasLength)
+        return false;
+
+    body.resize(length);
+    input.read(body.data(), static_cast<std::streamsize>(length));
+    return static_cast<size_t>(input.gcount()) == length;
+}
+
+void LanguageServer::send(const JsonValue& message)
+{
+    std::string body = message.dump();
+    *output << "Content-Length: " << body.size() << "\r\n\r\n" << body;
+    output->flush();
+}
+
+void LanguageServer::respond(const JsonValue& id, JsonValue result)
+{
+    JsonValue message = JsonValue::object();
+    message.set("jsonrpc", "2.0");
+    message.set("id", id);
+    message.set("result", std::move(result));
+    send(message);
+}
+
+void LanguageServer::respondError(const JsonValue& id, int code, const std::string& text)
+{
+    JsonValue error = JsonValue::object();
+    error.set("code", code);
+    error.set("message", text);
+
+    JsonValue message = JsonValue::object();
+    message.set("jsonrpc", "2.0");
+    message.set("id", id);
+    message.set("error", std::move(error));
+    send(message);
+}
+
+bool LanguageServer::handle(const JsonValue& message)
+{
+    const std::string& method = message["method"].asString();
+    const JsonValue& params = message["params"];
+
+    if (method == "initialize") {
+        JsonValue sync = JsonValue::object();
+        sync.set("openClose", true);
+        sync.set("change", textDocumentSyncIncremental);
+        JsonValue capabilities = JsonValue::object();
+        capabilities.set("textDocumentSync", std::move(sync));
+        JsonValue serverInfo = JsonValue::object();
+        serverInfo.set("name", "ms");
+        serverInfo.set("version", MS_VERSION);
+
+        JsonValue result = JsonValue::object();
+        result.set("capabilities", std::move(capabilities));
+        result.set("serverInfo", std::move(serverInfo));
+        respond(message["id"], std::move(result));
+    } else if (method == "shutdown") {
+        shutdownRequested = true;
+        respond(message["id"], JsonValue());
+    } else if (method == "exit") {
+        return false;
+    } else if (method == "textDocument/didOpen") {
+        const JsonValue& textDocument = params["textDocument"];
+        const std::string& uri = textDocument["uri"].asString();
+        auto& document = documents[uri];
+        document = std::make_unique<IncrementalDocument>(uriToPath(uri), textDocument["text"].asString());
+        publishDiagnostics(uri, *document);
+    } else if (method == "textDocument/didChange") {
+        didChange(params);
+    } else if (method == "textDocument/didClose") {
+        const std::string& uri = params["textDocument"]["uri"].asString();
+        documents.erase(uri);
+        sendDiagnostics(uri, JsonValue::array()); // Закрытый документ не должен оставлять ошибок в редакторе
+    } else if (message.contains("id") && !method.empty()) {
+        respondError(message["id"], methodNotFoundCode, "Method not found: " + method);
+    }
+    // Остальные уведомления (initialized, $/cancelRequest, ...) не требуют ответа
+    return true;
+}
+
+void LanguageServer::didChange(const JsonValue& params)
+{
+    const std::string& uri = params["textDocument"]["uri"].asString();
+    auto it = documents.find(uri);
+    if (it == documents.end())
+        return;
+    IncrementalDocument& document = *it->second;
+
+    // Правки применяются по очереди: позиции каждой - в тексте после предыдущей
+    for (const JsonValue& change : params["contentChanges"].asArray()) {
+        if (!change.contains("range")) {
+            document.setText(change["text"].asString());
+            continue;
+        }
+        const JsonValue& start = change["range"]["start"];
+        const JsonValue& end = change["range"]["end"];
+        auto toColumn = [&](const JsonValue& position) {
+            int line = position["line"].asInt();
+            if (line < 0 || line >= static_cast<int>(document.lineCount()))
+                return position["character"].asInt();
+            return toByteColumn(document.lineText(line), position["character"].asInt());
+        };
+        document.edit(start["line"].asInt(), toColumn(start), end["line"].asInt(), toColumn(end), change["text"].asString());
+    }
+    publishDiagnostics(uri, document);
+}
+
+void LanguageServer::publishDiagnostics(const std::string& uri, IncrementalDocument& document)
+{
+    JsonValue list = JsonValue::array();
+    for (const Diagnostic& diagnostic : document.diagnostics()) {
+        std::string_view text = document.lineText(diagnostic.line);
+        JsonValue range = JsonValue::object();
+        range.set("start", position(diagnostic.line, toUtf16Column(text, diagnostic.column)));
+        range.set("end", position(diagnostic.line, toUtf16Column(text, diagnostic.endColumn)));
+
+        JsonValue item = JsonValue::object();
+        item.set("range", std::move(range));
+        item.set("severity", 1); // Error
+        item.set("source", "ms");
+        item.set("message", diagnostic.message);
+        list.push(std::move(item));
+    }
+
+    sendDiagnostics(uri, std::move(list));
+
+    compactArena();
+}
+
+void LanguageServer::sendDiagnostics(const std::string& uri, JsonValue list)
+{
+    JsonValue params = JsonValue::object();
+    params.set("uri", uri);
+    params.set("diagnostics", std::move(list));
+
+    JsonValue notification = JsonValue::object();
+    notification.set("jsonrpc", "2.0");
+    notification.set("method", "textDocument/publishDiagnostics");
+    notification.set("params", std::move(params));
+    send(notification);
+}
+
+void LanguageServer::compactArena()
+{
+    // Каждая правка оставляет в арене узлы старых разборов; когда их набирается много,
+    // арена сбрасывается, а документы разбираются заново из уже готовых токенов
+    ASTArena& arena = ASTArena::getInstance();
+    if (arena.bytesUsed() < std::max(minCompactBytes, liveBytes * 2))
+        return;
+
+    for (auto& [uri, document] : documents)
+        document->releaseAST();
+    arena.reset();
+    for (auto& [uri, document] : documents)
+        document->diagnostics();
+    liveBytes = arena.bytesUsed();
+}
@@ -0,0 +1,123 @@
+#ifndef INCREMENTALDOCUMENT_H
+#define INCREMENTALDOCUMENT_H
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "../../lexer/headers/TokenStream.h"
+#include "../../parser/headers/AST.h"
+#include "../../visitors/headers/TypeSymbolVisitor.h"
+#include "../../linker/headers/Linker.h"
+
+struct Diagnostic {
+    int line = 0;       // с 0
+    int column = 0;     // байт в строке, с 0
+    int endColumn = 0;  // байт за концом выделения
+    std::string message;
+};
+
+/*
+Документ, открытый в языковом сервере (ms lsp).
+Между правками в памяти остаются строки с их токенами, объявления верхнего уровня
+с AST и то, что каждое объявление добавило в глобальный контекст. На diagnostics():
+
+    1. Лексер перезапускается только на изменённых строках - и на следующих, пока
+       не сойдётся состояние многострочного комментария (как на стыках в ParallelLexer).
+    2. Объявления режутся по тем же границам, что и в ParallelParser. Разбирается заново
+       только объявление, в котором поменялась хоть одна строка или граница.
+    3. Объявления проверяются по порядку, каждое - против глобального контекста из
+       предыдущих объявлений, но только по тем именам, что встречаются в его токенах.
+       Повторно проверяются разобранные заново объявления и те, чьи имена пересекаются
+       с изменившимися определениями. Правка тела функции, не меняющая её сигнатуру,
+       перепроверяет одну эту функцию.
+
+В отличие от компилятора, ошибки собираются по одной на объявление: после ошибки
+проверяются остальные. Модули из use линкуются и проверяются, только когда меняются
+сами use; их исходники читаются один раз (SourceManager).
+
+Все узлы AST живут в общей арене. Перед ASTArena::reset() нужно вызвать releaseAST()
+у всех документов - следующий diagnostics() разберёт и проверит их заново (без лексера).
+*/
+class IncrementalDocument
+{
+public:
+    // Сколько работы сделал последний diagnostics() - для бенчмарка
+    struct Stats {
+        size_t lexedLines = 0;
+        size_t parsedDeclarations = 0;
+        size_t checkedDeclarations = 0;
+    };
+
+    IncrementalDocument(std::string path, std::string_view text);
+    ~IncrementalDocument();
+
+    // Замена текста между (startLine, startColumn) и (endLine, endColumn); колонки - байты в строке
+    void edit(int startLine, int startColumn, int endLine, int endColumn, std::string_view text);
+    void setText(std::string_view text);
+
+    size_t lineCount() const { return lines.size(); }
+    std::string_view lineText(size_t line) const { return lines[line]->text; }
+
+    const std::vector<Diagnostic>& diagnostics();
+    const Stats& getStats() const { return stats; }
+
+    void releaseAST();
+
+private:
+    struct Line {
+        std::string text;       // Без '\n'; спаны tokens смотрят сюда
+        TokenStream tokens;     // Одна строка потока или пусто
+        std::string lexError;
+        bool startsInComment = false;
+        bool endsInComment = false;
+        bool changed = true;    // Текст или токены менялись после последнего diagnostics()
+    };
+
+    // Что объявление добавило в глобальный контекст
+    struct Definitions {
+        std::unordered_map<Symbol, NodePtr<ASTNode>> variables;
+        std::unordered_map<Symbol, NodePtr<ASTNode>> functions;
+        std::unordered_map<std::string, NodePtr<StructNode>> structs;
+    };
+
+    struct Declaration {
+        const Line* head = nullptr;     // Первая строка - по ней объявление узнаётся после правки
+        size_t firstLine = 0;           // Строки [firstLine, endLine)
+        size_t endLine = 0;
+        TokenStream tokens;             // Строки объявления; номера строк - как в документе при разборе
+        NodePtr<ProgramNode> program;   // Проверенный AST (nullptr - не разобрано)
+        std::vector<Symbol> uses;       // Имена из токенов, по id
+        Definitions definitions;
+        std::vector<Diagnostic> diagnostics; // Строки - от firstLine
+        bool needsParse = true;         // Новое или изменённое объявление
+        bool imports = false;           // Содержит use
+    };
+
+    std::string path;
+    std::string moduleName;
+    std::vector<std::unique_ptr<Line>> lines;
+    std::vector<Declaration> declarations;
+
+    std::unique_ptr<TypeSymbolVisitor> checker;
+    bool linked = false;
+    std::unique_ptr<Linker> linker;     // Между линковками: неизменённые модули из use не читаются заново
+    std::string importsText;            // Текст всех use на момент линковки
+    Definitions imported;               // Определения модулей из use
+    std::vector<std::string> importErrors; // Показываются на первом use
+
+    std::vector<Diagnostic> result;
+    Stats stats;
+
+    void relex();
+    void splitDeclarations(std::unordered_set<Symbol>& changedNames);
+    void parse(Declaration& declaration);
+    void link(std::unordered_set<Symbol>& changedNames);
+    void check(Declaration& declaration, const Definitions& visible, std::unordered_set<Symbol>& changedNames);
+
+    Diagnostic locate(const Declaration& declaration, int streamLine, int tokenIndex, const std::string& message) const;
+};
+
+#endif // INCREMENTALDOCUMENT_H
@@ -0,0 +1,71 @@
+#ifndef JSON_H
+#define JSON_H
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/*
+Минимальный JSON для языкового сервера (JSON-RPC поверх stdin/stdout).
+Объекты хранят поля в порядке добавления, числа - double. Разбор бросает
+std::runtime_error на некорректном тексте:
+
+    JsonValue request = JsonValue::parse(R"({"id": 1, "method": "shutdown"})");
+    request["method"].asString();           // "shutdown"
+    request["params"].isNull();             // true - отсутствующее поле
+
+    JsonValue response = JsonValue::object();
+    response.set("id", request["id"]);
+    response.dump();                        // {"id":1}
+*/
+class JsonValue
+{
+public:
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    JsonValue() = default;
+    JsonValue(std::nullptr_t) {}
+    JsonValue(bool value) : type(Type::Bool), boolean(value) {}
+    JsonValue(int value) : type(Type::Number), number(value) {}
+    JsonValue(size_t value) : type(Type::Number), number(static_cast<double>(value)) {}
+    JsonValue(double value) : type(Type::Number), number(value) {}
+    JsonValue(const char* value) : type(Type::String), string(value) {}
+    JsonValue(std::string value) : type(Type::String), string(std::move(value)) {}
+
+    static JsonValue array() { JsonValue value; value.type = Type::Array; return value; }
+    static JsonValue object() { JsonValue value; value.type = Type::Object; return value; }
+    static JsonValue parse(std::string_view text);
+
+    Type getType() const { return type; }
+    bool isNull() const { return type == Type::Null; }
+    bool isObject() const { return type == Type::Object; }
+
+    // Значение нужного типа или значение по умолчанию, если тип другой
+    bool asBool() const { return type == Type::Bool && boolean; }
+    double asNumber() const { return type == Type::Number ? number : 0; }
+    int asInt() const { return static_cast<int>(asNumber()); }
+    const std::string& asString() const;
+    const std::vector<JsonValue>& asArray() const;
+
+    // Поле объекта; у отсутствующего поля (и не у объекта) - null
+    const JsonValue& operator[](std::string_view key) const;
+    bool contains(std::string_view key) const;
+
+    JsonValue& set(std::string key, JsonValue value);
+    JsonValue& push(JsonValue value);
+
+    std::string dump() const;
+
+private:
+    Type type = Type::Null;
+    bool boolean = false;
+    double number = 0;
+    std::string string;
+    std::vector<JsonValue> items;                           // Array
+    std::vector<std::pair<std::string, JsonValue>> fields;  // Object
+
+    void dump(std::string& out) const;
+};
+
+#endif // JSON_H
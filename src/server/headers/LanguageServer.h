@@ -0,0 +1,53 @@
+#ifndef LANGUAGESERVER_H
+#define LANGUAGESERVER_H
+
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include "Json.h"
+#include "IncrementalDocument.h"
+
+/*
+Языковой сервер (ms lsp): Language Server Protocol поверх stdin/stdout.
+Поддерживается то, что нужно для диагностики при наборе:
+
+    initialize / initialized / shutdown / exit
+    textDocument/didOpen, didChange (целиком и диапазонами), didClose
+    → textDocument/publishDiagnostics после каждого открытия и правки
+
+Документы живут в памяти между правками (см. IncrementalDocument.h). Позиции LSP -
+в UTF-16, документы хранят байты UTF-8; перевод делается на входе и выходе.
+Пока сервер работает, std::cout молчит: отладочный вывод проходов не должен
+попасть в канал протокола.
+*/
+class LanguageServer
+{
+public:
+    // Код выхода: 0 после shutdown + exit, 1 - если exit пришёл без shutdown или вход закончился
+    int run(std::istream& input, std::ostream& output);
+
+private:
+    // Арена AST пересоздаётся, когда узлы прошлых правок занимают больше этого
+    static constexpr size_t minCompactBytes = 64 << 20;
+
+    std::ostream* output = nullptr;
+    std::unordered_map<std::string, std::unique_ptr<IncrementalDocument>> documents; // ключ - URI
+    size_t liveBytes = 0; // Арена сразу после последнего пересоздания
+    bool shutdownRequested = false;
+
+    bool readMessage(std::istream& input, std::string& body);
+    void send(const JsonValue& message);
+    void respond(const JsonValue& id, JsonValue result);
+    void respondError(const JsonValue& id, int code, const std::string& message);
+
+    // false - пришёл exit
+    bool handle(const JsonValue& message);
+    void didChange(const JsonValue& params);
+    void publishDiagnostics(const std::string& uri, IncrementalDocument& document);
+    void sendDiagnostics(const std::string& uri, JsonValue list);
+    void compactArena();
+};
+
+#endif // LANGUAGESERVER_H
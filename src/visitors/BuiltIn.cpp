@@ -1,5 +1,6 @@
 #include "headers/BuiltIn.h"
 #include "../includes/toml.hpp" // путь к toml11
+#include "../parser/headers/TypeTable.h"
 #include <iostream>
 void registerBuiltInFunctions(Registry& registry, const std::string& tomlPath) 
 {
@@ -13,20 +14,20 @@ void registerBuiltInFunctions(Registry& registry, const std::string& tomlPath)
         const auto& argsArr = toml::find<std::vector<std::string>>(func, "args");
 
         // Создаём список аргументов с именами arg1, arg2, ...
-        std::vector<std::pair<std::shared_ptr<TypeNode>, std::string>> args;
+        std::vector<std::pair<NodePtr<TypeNode>, Symbol>> args;
         for (size_t i = 0; i < argsArr.size(); ++i) {
             args.emplace_back(
-                std::make_shared<SimpleTypeNode>(argsArr[i]),
-                "arg" + std::to_string(i + 1)
+                TypeTable::getInstance().node(argsArr[i]),
+                Symbol("arg" + std::to_string(i + 1))
             );
         }
 
         registry.addBuiltinFunction(
             name,
-            std::make_shared<FunctionNode>(
+            makeNode<FunctionNode>(
                 name,
                 "",
-                std::make_shared<SimpleTypeNode>(retStr),
+                TypeTable::getInstance().node(retStr),
                 args,
                 std::vector<std::string>(),
                 nullptr
@@ -57,19 +58,19 @@ void registerBuiltInTypes(Registry& registry)
     */
 
     // Добавление встроенных типов
-    registry.addBuiltinType("i1", std::make_shared<SimpleTypeNode>("i1"));
-    registry.addBuiltinType("i8", std::make_shared<SimpleTypeNode>("i8"));
-    registry.addBuiltinType("i16", std::make_shared<SimpleTypeNode>("i16"));
-    registry.addBuiltinType("i32", std::make_shared<SimpleTypeNode>("i32"));
-    registry.addBuiltinType("i64", std::make_shared<SimpleTypeNode>("i64"));
-    registry.addBuiltinType("float", std::make_shared<SimpleTypeNode>("float"));
-    registry.addBuiltinType("string", std::make_shared<SimpleTypeNode>("string"));
-    registry.addBuiltinType("null", std::make_shared<SimpleTypeNode>("null"));
-    registry.addBuiltinType("none", std::make_shared<SimpleTypeNode>("none"));
-    registry.addBuiltinType("auto", std::make_shared<SimpleTypeNode>("auto"));
+    registry.addBuiltinType("i1", TypeTable::getInstance().node(TypeTable::I1));
+    registry.addBuiltinType("i8", TypeTable::getInstance().node(TypeTable::I8));
+    registry.addBuiltinType("i16", TypeTable::getInstance().node(TypeTable::I16));
+    registry.addBuiltinType("i32", TypeTable::getInstance().node(TypeTable::I32));
+    registry.addBuiltinType("i64", TypeTable::getInstance().node(TypeTable::I64));
+    registry.addBuiltinType("float", TypeTable::getInstance().node(TypeTable::Float));
+    registry.addBuiltinType("string", TypeTable::getInstance().node(TypeTable::String));
+    registry.addBuiltinType("null", TypeTable::getInstance().node(TypeTable::Null));
+    registry.addBuiltinType("none", TypeTable::getInstance().node(TypeTable::None));
+    registry.addBuiltinType("auto", TypeTable::getInstance().node(TypeTable::Auto));
 
     // Добавление встроенных типов массивов и карт
     // Потому что один хуй они являются base типами для GenericTypeNode
-    registry.addBuiltinType("array", std::make_shared<SimpleTypeNode>("array"));
-    registry.addBuiltinType("map", std::make_shared<SimpleTypeNode>("map"));
+    registry.addBuiltinType("array", TypeTable::getInstance().node("array"));
+    registry.addBuiltinType("map", TypeTable::getInstance().node("map"));
 }
\ No newline at end of file
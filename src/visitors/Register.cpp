@@ -1,60 +1,102 @@
 #include "headers/Register.h"
 #include "../parser/headers/AST.h"
+#include "../parser/headers/TypeTable.h"
 
-void Registry::addBuiltinType(const std::string& name, std::shared_ptr<TypeNode> type) {
+namespace
+{
+    // Цена неявного приведения аргумента к параметру: 0 - тот же тип, 1 - расширение целого,
+    // 2 - сужение целого (проверка вызова ставит implicitCastTo), -1 - приведения нет
+    int conversionCost(TypeId from, TypeId to)
+    {
+        if (from == to)
+            return 0;
+        if (TypeTable::isInteger(from) && TypeTable::isInteger(to))
+            return from < to ? 1 : 2; // У целых id растёт вместе с шириной
+        return -1;
+    }
+}
+
+TypeId Registry::signatureOf(const std::vector<NodePtr<TypeNode>>& types)
+{
+    std::vector<TypeId> ids;
+    ids.reserve(types.size());
+    for (const auto& type : types)
+        ids.push_back(type ? type->id() : TypeTable::Invalid);
+    return TypeTable::getInstance().generic("#signature", ids);
+}
+
+void Registry::addBuiltinType(const std::string& name, NodePtr<TypeNode> type) {
     builtinTypes[name] = type;
 }
 
-void Registry::addBuiltinFunction(const std::string& name, std::shared_ptr<FunctionNode> func) {
+void Registry::addBuiltinFunction(Symbol name, NodePtr<FunctionNode> func) {
     builtinFunctions[name].push_back(func);
+
+    std::vector<NodePtr<TypeNode>> parameterTypes;
+    for (const auto& parameter : func->parameters)
+        parameterTypes.push_back(parameter.first);
+    exactOverloads.emplace(overloadKey(name, signatureOf(parameterTypes)), func);
+    overloadsByArity[overloadKey(name, static_cast<uint32_t>(parameterTypes.size()))].push_back(func);
 }
 
-void Registry::addStruct(const std::string& name, std::shared_ptr<StructNode> strct) {
+void Registry::addStruct(const std::string& name, NodePtr<StructNode> strct) {
     userStructs[name] = strct;
 }
-void Registry::addClass(const std::string& name, std::shared_ptr<ClassNode> cls) {
+void Registry::addClass(const std::string& name, NodePtr<ClassNode> cls) {
     userClasses[name] = cls;
 }
-std::shared_ptr<TypeNode> Registry::findType(const std::string& name) const {
+NodePtr<TypeNode> Registry::findType(const std::string& name) const {
     auto it = builtinTypes.find(name);
     if (it != builtinTypes.end()) return it->second;
     
     return nullptr;
 }
 
-std::shared_ptr<FunctionNode> Registry::findFunction(const std::string& name) const {
+NodePtr<FunctionNode> Registry::findFunction(Symbol name) const {
     auto it = builtinFunctions.find(name);
     if (it != builtinFunctions.end() && !it->second.empty()) return it->second.front();
     
     return nullptr;
 }
 
-std::shared_ptr<FunctionNode> Registry::findFunction(const std::string& name, const std::vector<std::shared_ptr<TypeNode>>& argTypes) const {
-    auto it = builtinFunctions.find(name);
-    if (it == builtinFunctions.end()) return nullptr;
+NodePtr<FunctionNode> Registry::findFunction(Symbol name, const std::vector<NodePtr<TypeNode>>& argTypes) const {
+    auto it = exactOverloads.find(overloadKey(name, signatureOf(argTypes)));
+    if (it != exactOverloads.end()) return it->second;
 
+    return nullptr;
+}
+
+NodePtr<FunctionNode> Registry::resolveFunction(Symbol name, const std::vector<NodePtr<TypeNode>>& argTypes) const {
+    if (auto exact = findFunction(name, argTypes)) return exact;
+
+    auto it = overloadsByArity.find(overloadKey(name, static_cast<uint32_t>(argTypes.size())));
+    if (it == overloadsByArity.end()) return nullptr;
+
+    // При равной цене побеждает объявленная раньше
+    NodePtr<FunctionNode> best;
+    int bestCost = -1;
     for (const auto& func : it->second) {
-        if (func->parameters.size() != argTypes.size()) continue;
-        bool match = true;
-        for (size_t i = 0; i < argTypes.size(); ++i) {
-            if (func->parameters[i].first->toString() != argTypes[i]->toString()) {
-                match = false;
-                break;
-            }
+        int cost = 0;
+        for (size_t i = 0; i < argTypes.size() && cost >= 0; ++i) {
+            int argumentCost = argTypes[i] ? conversionCost(argTypes[i]->id(), func->parameters[i].first->id()) : -1;
+            cost = argumentCost < 0 ? -1 : cost + argumentCost;
+        }
+        if (cost >= 0 && (bestCost < 0 || cost < bestCost)) {
+            best = func;
+            bestCost = cost;
         }
-        if (match) return func;
     }
-    return nullptr;
+    return best;
 }
 
-std::shared_ptr<StructNode> Registry::findStruct(const std::string& name) const {
+NodePtr<StructNode> Registry::findStruct(const std::string& name) const {
     auto it = userStructs.find(name);
     if (it != userStructs.end()) return it->second;
     
     return nullptr;
 }
 
-std::shared_ptr<ClassNode> Registry::findClass(const std::string& name) const {
+NodePtr<ClassNode> Registry::findClass(const std::string& name) const {
     auto it = userClasses.find(name);
     if (it != userClasses.end()) return it->second;
     
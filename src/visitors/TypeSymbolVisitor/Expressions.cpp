@@ -4,123 +4,118 @@ void TypeSymbolVisitor::visit(BinaryOpNode& node) {
     node.left->accept(*this);
     node.right->accept(*this);
 
-    std::shared_ptr<TypeNode> leftType = node.left->inferredType;
-    std::shared_ptr<TypeNode> rightType = node.right->inferredType;
+    NodePtr<TypeNode> leftType = node.left->inferredType;
+    NodePtr<TypeNode> rightType = node.right->inferredType;
     
-    std::shared_ptr<BinaryOpNode> root = std::make_shared<BinaryOpNode>(node.left, node.op, node.right);
+    NodePtr<BinaryOpNode> root = makeNode<BinaryOpNode>(node.left, node.op, node.right);
    
-    // "+"
-    if (node.op == "+" || node.op == "add" || node.op == "fadd") {
-        handlePlusOperator(root, leftType, rightType);
-        node = *root;
-        return;
-    }
-
-    // "-"
-    if (node.op == "-" || node.op == "sub" || node.op == "fsub") {
-        handleMinusOperator(root, leftType, rightType);
-        node = *root;
-        return;
-    }
-
-    // "*"
-    if (node.op == "*" || node.op == "mul" || node.op == "fmul") {
-        handleMulOperator(root, leftType, rightType);
-        node = *root;
-        return;
-    }
-
-    // "/"
-    if (node.op == "/" || node.op == "sdiv" || node.op == "fdiv") {
-        handleDivOperator(root, leftType, rightType);
-        node = *root;
-        return;
-    }
-
-    // "%"
-    if (node.op == "%" || node.op == "srem" || node.op == "frem") {
-        handleModOperator(root, leftType, rightType);
-        node = *root;
-        return;
-    }
-
-    auto getCmpOp = [](const std::string& op) -> std::string {
-        if (op == "==" || op == "eq") return "eq";
-        else if (op == "!=" || op == "ne") return "ne";
-        else if (op == "<") return "slt";
-        else if (op == ">") return "sgt";
-        else if (op == "<=") return "sle";
-        else if (op == ">=") return "sge";
-        return "";
-    };
-
-    // "==", "!=", "<", ">", "<=", ">="
-    if (getCmpOp(node.op) != "") {
-        handleCompareOperator(root, leftType, rightType);
-        node = *root;
-        return;
-    }
-
-    // and, or 
-    if (node.op == "and" || node.op == "or") {
-        handleLogicalOperator(root, leftType, rightType);
-        node = *root;
-        return;
+    // Узел может прийти повторно уже с IR-операцией: арифметика и and/or разбираются заново
+    switch (node.op) {
+        // "+"
+        case BinaryOpcode::Plus:
+        case BinaryOpcode::Add:
+        case BinaryOpcode::FAdd:
+            handlePlusOperator(root, leftType, rightType);
+            break;
+        // "-"
+        case BinaryOpcode::Minus:
+        case BinaryOpcode::Sub:
+        case BinaryOpcode::FSub:
+            handleMinusOperator(root, leftType, rightType);
+            break;
+        // "*"
+        case BinaryOpcode::Star:
+        case BinaryOpcode::Mul:
+        case BinaryOpcode::FMul:
+            handleMulOperator(root, leftType, rightType);
+            break;
+        // "/"
+        case BinaryOpcode::Slash:
+        case BinaryOpcode::SDiv:
+        case BinaryOpcode::FDiv:
+            handleDivOperator(root, leftType, rightType);
+            break;
+        // "%"
+        case BinaryOpcode::Percent:
+        case BinaryOpcode::SRem:
+        case BinaryOpcode::FRem:
+            handleModOperator(root, leftType, rightType);
+            break;
+        // "==", "!=", "<", ">", "<=", ">="
+        case BinaryOpcode::Equal:
+        case BinaryOpcode::NotEqual:
+        case BinaryOpcode::Less:
+        case BinaryOpcode::Greater:
+        case BinaryOpcode::LessEqual:
+        case BinaryOpcode::GreaterEqual:
+            handleCompareOperator(root, leftType, rightType);
+            break;
+        // and, or
+        case BinaryOpcode::And:
+        case BinaryOpcode::Or:
+            handleLogicalOperator(root, leftType, rightType);
+            break;
+        default:
+            return;
     }
+    node = *root;
 }
 
 void TypeSymbolVisitor::visit(UnaryOpNode& node) {
     node.operand->accept(*this);
-    std::shared_ptr<TypeNode> operandType = node.operand->inferredType;
+    NodePtr<TypeNode> operandType = node.operand->inferredType;
 
-    if (node.op == "?")
+    if (node.op == UnaryOpcode::Question)
     {
-        if (std::dynamic_pointer_cast<CallNode>(node.operand)) {}
-        else if (std::dynamic_pointer_cast<AccessExpression>(node.operand)) {}
-        else if (std::dynamic_pointer_cast<IdentifierNode>(node.operand)) {}
-        else if (std::dynamic_pointer_cast<LambdaNode>(node.operand)) {}
-        else
-        {
-            LogError("Unsupported operand type for '?'", node.shared_from_this());
-            return;
+        switch (node.operand->kind) {
+            case NodeKind::Call:
+            case NodeKind::AccessExpression:
+            case NodeKind::Identifier:
+            case NodeKind::Lambda:
+                break;
+            default:
+                LogError("Unsupported operand type for '?'", node.self());
+                return;
         }
 
-        node.op = "nullcheck";
+        node.op = UnaryOpcode::NullCheck;
     }
-    else if (node.op == "!")
+    else if (node.op == UnaryOpcode::Exclaim)
     {
-        if (std::dynamic_pointer_cast<CallNode>(node.operand)) {}
-        else if (std::dynamic_pointer_cast<BinaryOpNode>(node.operand)) {}
-        else if (std::dynamic_pointer_cast<AccessExpression>(node.operand)) {}
-        else if (std::dynamic_pointer_cast<IdentifierNode>(node.operand)) {}
-        else if (std::dynamic_pointer_cast<LambdaNode>(node.operand)) {}
-        else
-        {
-            LogError("Unsupported operand type for '!'", node.shared_from_this());
-            return;
+        switch (node.operand->kind) {
+            case NodeKind::Call:
+            case NodeKind::BinaryOp:
+            case NodeKind::AccessExpression:
+            case NodeKind::Identifier:
+            case NodeKind::Lambda:
+                break;
+            default:
+                LogError("Unsupported operand type for '!'", node.self());
+                return;
         }
 
-        node.op = "not";
+        node.op = UnaryOpcode::Not;
     }
-    else if (node.op == "-")
+    else if (node.op == UnaryOpcode::Minus)
     {
-        if (std::dynamic_pointer_cast<CallNode>(node.operand)) {}
-        else if (std::dynamic_pointer_cast<BinaryOpNode>(node.operand)) {}
-        else if (std::dynamic_pointer_cast<AccessExpression>(node.operand)) {}
-        else if (std::dynamic_pointer_cast<IdentifierNode>(node.operand)) {}
-        else if (std::dynamic_pointer_cast<NumberNode>(node.operand)) {}
-        else if (std::dynamic_pointer_cast<FloatNumberNode>(node.operand)) {}
-        else
-        {
-            LogError("Unsupported operand type for '-'", node.shared_from_this());
-            return;
+        switch (node.operand->kind) {
+            case NodeKind::Call:
+            case NodeKind::BinaryOp:
+            case NodeKind::AccessExpression:
+            case NodeKind::Identifier:
+            case NodeKind::Number:
+            case NodeKind::FloatNumber:
+                break;
+            default:
+                LogError("Unsupported operand type for '-'", node.self());
+                return;
         }
 
-        node.op = "neg";
+        node.op = UnaryOpcode::Neg;
     }
     else
     {
-        LogError("Unsupported unary operator: " + node.op, node.shared_from_this());
+        LogError("Unsupported unary operator: " + opcodeName(node.op), node.self());
         return;
     }
 
@@ -129,7 +124,7 @@ void TypeSymbolVisitor::visit(UnaryOpNode& node) {
 
 void TypeSymbolVisitor::visit(LambdaNode &node)
 {
-    std::unordered_map<std::string, std::shared_ptr<ASTNode>> args = {};
+    std::unordered_map<std::string, NodePtr<ASTNode>> args = {};
 
     Context currentFunction = {
         .labels = {},
@@ -1,9 +1,9 @@
 #include "../headers/TypeSymbolVisitor.h"
 
-static std::shared_ptr<ASTNode> toStringHandler(std::shared_ptr<ASTNode>& node, TypeSymbolVisitor& visitor)
+static NodePtr<ASTNode> toStringHandler(NodePtr<ASTNode>& node, TypeSymbolVisitor& visitor)
 {
-    std::shared_ptr<CallNode> callNode;
-    std::shared_ptr<TypeNode> type;
+    NodePtr<CallNode> callNode;
+    NodePtr<TypeNode> type;
     node->accept(visitor);
 
     if(node->implicitCastTo)
@@ -11,58 +11,68 @@ static std::shared_ptr<ASTNode> toStringHandler(std::shared_ptr<ASTNode>& node,
     else
         type = node->inferredType;
 
-    if (auto numberNode = std::dynamic_pointer_cast<NumberNode>(node)) {
-        if(type->toString() == "i1")
-            callNode = std::make_shared<CallNode>(
-                "toString_bool",
-                std::vector<std::shared_ptr<ASTNode>>{
-                    std::make_shared<NumberNode>(numberNode->value, numberNode->inferredType)
+    switch (node->kind) {
+        case NodeKind::Number: {
+            auto numberNode = cast<NumberNode>(node);
+            callNode = makeNode<CallNode>(
+                type->id() == TypeTable::I1 ? "toString_bool" : "toString_int",
+                std::vector<NodePtr<ASTNode>>{
+                    makeNode<NumberNode>(numberNode->value, numberNode->inferredType)
                 }
             );
-        else
-            callNode = std::make_shared<CallNode>(
+            break;
+        }
+        case NodeKind::FloatNumber: {
+            auto floatNumberNode = cast<FloatNumberNode>(node);
+            callNode = makeNode<CallNode>(
+                "toString_float",
+                std::vector<NodePtr<ASTNode>>{
+                    makeNode<FloatNumberNode>(floatNumberNode->value)
+                }
+            );
+            break;
+        }
+        case NodeKind::BinaryOp: {
+            auto binaryOpNode = cast<BinaryOpNode>(node);
+            callNode = makeNode<CallNode>(
                 "toString_int",
-                std::vector<std::shared_ptr<ASTNode>>{
-                    std::make_shared<NumberNode>(numberNode->value, numberNode->inferredType)
+                std::vector<NodePtr<ASTNode>>{
+                    makeNode<BinaryOpNode>(binaryOpNode->left, binaryOpNode->op, binaryOpNode->right)
                 }
             );
-    } else if (auto floatNumberNode = std::dynamic_pointer_cast<FloatNumberNode>(node)) {
-        callNode = std::make_shared<CallNode>(
-            "toString_float",
-            std::vector<std::shared_ptr<ASTNode>>{
-                std::make_shared<FloatNumberNode>(floatNumberNode->value)
-            }
-        );
-    } else if (auto binaryOpNode = std::dynamic_pointer_cast<BinaryOpNode>(node)) {
-        callNode = std::make_shared<CallNode>(
-            "toString_int",
-            std::vector<std::shared_ptr<ASTNode>>{
-                std::make_shared<BinaryOpNode>(binaryOpNode->left, binaryOpNode->op, binaryOpNode->right)
-            }
-        );
-    } else if (auto unaryOpNode = std::dynamic_pointer_cast<UnaryOpNode>(node)) {
-        callNode = std::make_shared<CallNode>(
-            "toString_int",
-            std::vector<std::shared_ptr<ASTNode>>{
-                std::make_shared<UnaryOpNode>(unaryOpNode->op, unaryOpNode->operand)
-            }
-        );
-    } else if (auto call = std::dynamic_pointer_cast<CallNode>(node)) {
-        std::string toStringMethod;
-
-        if (type->toString() == "float")
-            toStringMethod = "toString_float";
-        else if (type->toString() == "i1")
-            toStringMethod = "toString_bool";
-        else
-            toStringMethod = "toString_int";
-
-        callNode = std::make_shared<CallNode>(
-            toStringMethod,
-            std::vector<std::shared_ptr<ASTNode>>{
-                std::make_shared<CallNode>(call->callee, call->arguments)
-            }
-        );
+            break;
+        }
+        case NodeKind::UnaryOp: {
+            auto unaryOpNode = cast<UnaryOpNode>(node);
+            callNode = makeNode<CallNode>(
+                "toString_int",
+                std::vector<NodePtr<ASTNode>>{
+                    makeNode<UnaryOpNode>(unaryOpNode->op, unaryOpNode->operand)
+                }
+            );
+            break;
+        }
+        case NodeKind::Call: {
+            auto call = cast<CallNode>(node);
+            std::string toStringMethod;
+
+            if (type->id() == TypeTable::Float)
+                toStringMethod = "toString_float";
+            else if (type->id() == TypeTable::I1)
+                toStringMethod = "toString_bool";
+            else
+                toStringMethod = "toString_int";
+
+            callNode = makeNode<CallNode>(
+                toStringMethod,
+                std::vector<NodePtr<ASTNode>>{
+                    makeNode<CallNode>(call->callee, call->arguments)
+                }
+            );
+            break;
+        }
+        default:
+            break;
     }
 
     if (!callNode) 
@@ -71,322 +81,290 @@ static std::shared_ptr<ASTNode> toStringHandler(std::shared_ptr<ASTNode>& node,
     return callNode;
 }
 
-void TypeSymbolVisitor::handlePlusOperator(std::shared_ptr<BinaryOpNode>& node, std::shared_ptr<TypeNode> leftType, std::shared_ptr<TypeNode> rightType)
+void TypeSymbolVisitor::handlePlusOperator(NodePtr<BinaryOpNode>& node, NodePtr<TypeNode> leftType, NodePtr<TypeNode> rightType)
 {
-    std::string left = leftType->toString();
-    std::string right = rightType->toString();
-
-    auto isIntType = [](const std::string& t) {
-        return t == "i32" || t == "i64" || t == "i16" || t == "i8" || t == "i1";
-    };
+    TypeId left = leftType->id();
+    TypeId right = rightType->id();
 
     // string
-    if (left == "string" || right == "string") {
-        if (checkLabels("@strict") && !(left == "string" && right == "string"))
-            LogError("Implicit type casting is not allowed for '+' in @strict mode: " + left + " and " + right, node->right->shared_from_this());
+    if (left == TypeTable::String || right == TypeTable::String) {
+        if (checkLabels("@strict") && !(left == TypeTable::String && right == TypeTable::String))
+            LogError("Implicit type casting is not allowed for '+' in @strict mode: " + leftType->toString() + " and " + rightType->toString(), node->right->self());
         
-        if (left != "string") {
+        if (left != TypeTable::String) {
             node->left = toStringHandler(node->left, *this);
         }
-        if (right != "string") {
+        if (right != TypeTable::String) {
             node->right = toStringHandler(node->right, *this);
         }
-        node = std::make_shared<BinaryOpNode>(node->left, "scat", node->right);
+        node = makeNode<BinaryOpNode>(node->left, BinaryOpcode::Scat, node->right);
         node->inferredType = registry.findType("string");
         return;
     }
 
     // float
-    if (left == "float" || right == "float") {
-        if (checkLabels("@strict") && !(left == "float" && right == "float")) {
-            bool leftImplicitFloat = node->left && node->left->implicitCastTo && node->left->implicitCastTo->toString() == "float";
-            bool rightImplicitFloat = node->right && node->right->implicitCastTo && node->right->implicitCastTo->toString() == "float";
+    if (left == TypeTable::Float || right == TypeTable::Float) {
+        if (checkLabels("@strict") && !(left == TypeTable::Float && right == TypeTable::Float)) {
+            bool leftImplicitFloat = node->left && node->left->implicitCastTo && node->left->implicitCastTo->id() == TypeTable::Float;
+            bool rightImplicitFloat = node->right && node->right->implicitCastTo && node->right->implicitCastTo->id() == TypeTable::Float;
             if (leftImplicitFloat || rightImplicitFloat)
-                LogError("Implicit te casting is not allowed for '+' in @strict mode: " + left + " and " + right, node->right->shared_from_this());
+                LogError("Implicit te casting is not allowed for '+' in @strict mode: " + leftType->toString() + " and " + rightType->toString(), node->right->self());
         }
 
-        if (left != "float") {
+        if (left != TypeTable::Float) {
             node->left->implicitCastTo = registry.findType("float");
         }
-        if (right != "float") {
+        if (right != TypeTable::Float) {
             node->right->implicitCastTo = registry.findType("float");
         }
-        node = std::make_shared<BinaryOpNode>(node->left, "fadd", node->right);
+        node = makeNode<BinaryOpNode>(node->left, BinaryOpcode::FAdd, node->right);
         node->inferredType = registry.findType("float");
         return;
     }
 
     // int(i32, i64, i8, i1)
-    if (isIntType(left) && isIntType(right)) {
-        node = std::make_shared<BinaryOpNode>(node->left, "add", node->right);
+    if (TypeTable::isInteger(left) && TypeTable::isInteger(right)) {
+        node = makeNode<BinaryOpNode>(node->left, BinaryOpcode::Add, node->right);
         node->inferredType = leftType;
         return;
     }
 
-    LogError("Unsupported operand types for '+': " + left + " and " + right, node->right->shared_from_this());
+    LogError("Unsupported operand types for '+': " + leftType->toString() + " and " + rightType->toString(), node->right->self());
 }
 
-void TypeSymbolVisitor::handleMinusOperator(std::shared_ptr<BinaryOpNode>& node, std::shared_ptr<TypeNode> leftType, std::shared_ptr<TypeNode> rightType)
+void TypeSymbolVisitor::handleMinusOperator(NodePtr<BinaryOpNode>& node, NodePtr<TypeNode> leftType, NodePtr<TypeNode> rightType)
 {
 
-    std::string left = leftType->toString();
-    std::string right = rightType->toString();
-
-    auto isIntType = [](const std::string& t) {
-        return t == "i32" || t == "i64" || t == "i16" || t == "i8" || t == "i1";
-    };
+    TypeId left = leftType->id();
+    TypeId right = rightType->id();
 
     // string
-    if (left == "string" || right == "string") {
-        LogError("Unsupported operand types for '-': " + left + " and " + right, node->right->shared_from_this());
+    if (left == TypeTable::String || right == TypeTable::String) {
+        LogError("Unsupported operand types for '-': " + leftType->toString() + " and " + rightType->toString(), node->right->self());
         return;
     }
 
     // float
-    if (left == "float" || right == "float") {
-        if (checkLabels("@strict") && !(left == "float" && right == "float")) {
-            bool leftImplicitFloat = node->left && node->left->implicitCastTo && node->left->implicitCastTo->toString() == "float";
-            bool rightImplicitFloat = node->right && node->right->implicitCastTo && node->right->implicitCastTo->toString() == "float";
+    if (left == TypeTable::Float || right == TypeTable::Float) {
+        if (checkLabels("@strict") && !(left == TypeTable::Float && right == TypeTable::Float)) {
+            bool leftImplicitFloat = node->left && node->left->implicitCastTo && node->left->implicitCastTo->id() == TypeTable::Float;
+            bool rightImplicitFloat = node->right && node->right->implicitCastTo && node->right->implicitCastTo->id() == TypeTable::Float;
             if (leftImplicitFloat || rightImplicitFloat)
-                LogError("Implicit type casting is not allowed for '-' in @strict mode: " + left + " and " + right, node->right->shared_from_this());
+                LogError("Implicit type casting is not allowed for '-' in @strict mode: " + leftType->toString() + " and " + rightType->toString(), node->right->self());
         }
 
-        if (left != "float") {
+        if (left != TypeTable::Float) {
             node->left->implicitCastTo = registry.findType("float");
         }
-        if (right != "float") {
+        if (right != TypeTable::Float) {
             node->right->implicitCastTo = registry.findType("float");
         }
-        node = std::make_shared<BinaryOpNode>(node->left, "fsub", node->right);
+        node = makeNode<BinaryOpNode>(node->left, BinaryOpcode::FSub, node->right);
         node->inferredType = registry.findType("float");
         return;
     }
 
     // int(i32, i64, i8, i1)
-    if (isIntType(left) && isIntType(right)) {
-        node = std::make_shared<BinaryOpNode>(node->left, "sub", node->right);
+    if (TypeTable::isInteger(left) && TypeTable::isInteger(right)) {
+        node = makeNode<BinaryOpNode>(node->left, BinaryOpcode::Sub, node->right);
         node->inferredType = leftType;
         return;
     }
 
-    LogError("Unsupported operand types for '+': " + left + " and " + right, node->right->shared_from_this());
+    LogError("Unsupported operand types for '+': " + leftType->toString() + " and " + rightType->toString(), node->right->self());
 }
 
-void TypeSymbolVisitor::handleMulOperator(std::shared_ptr<BinaryOpNode>& node, std::shared_ptr<TypeNode> leftType, std::shared_ptr<TypeNode> rightType)
+void TypeSymbolVisitor::handleMulOperator(NodePtr<BinaryOpNode>& node, NodePtr<TypeNode> leftType, NodePtr<TypeNode> rightType)
 {
-    std::string left = leftType->toString();
-    std::string right = rightType->toString();
-
-    auto isIntType = [](const std::string& t) {
-        return t == "i32" || t == "i64" || t == "i16" || t == "i8" || t == "i1";
-    };
+    TypeId left = leftType->id();
+    TypeId right = rightType->id();
 
     // string
-    if (left == "string" || right == "string") {
-        LogError("Unsupported operand types for '*': " + left + " and " + right, node->right->shared_from_this());
+    if (left == TypeTable::String || right == TypeTable::String) {
+        LogError("Unsupported operand types for '*': " + leftType->toString() + " and " + rightType->toString(), node->right->self());
         return;
     }
 
     // float
-    if (left == "float" || right == "float") {
-        if (checkLabels("@strict") && !(left == "float" && right == "float")) {
-            bool leftImplicitFloat = node->left && node->left->implicitCastTo && node->left->implicitCastTo->toString() == "float";
-            bool rightImplicitFloat = node->right && node->right->implicitCastTo && node->right->implicitCastTo->toString() == "float";
+    if (left == TypeTable::Float || right == TypeTable::Float) {
+        if (checkLabels("@strict") && !(left == TypeTable::Float && right == TypeTable::Float)) {
+            bool leftImplicitFloat = node->left && node->left->implicitCastTo && node->left->implicitCastTo->id() == TypeTable::Float;
+            bool rightImplicitFloat = node->right && node->right->implicitCastTo && node->right->implicitCastTo->id() == TypeTable::Float;
             if (leftImplicitFloat || rightImplicitFloat)
-                LogError("Implicit type casting is not allowed for '*' in @strict mode: " + left + " and " + right, node->right->shared_from_this());
+                LogError("Implicit type casting is not allowed for '*' in @strict mode: " + leftType->toString() + " and " + rightType->toString(), node->right->self());
         }
 
-        if (left != "float") {
+        if (left != TypeTable::Float) {
             node->left->implicitCastTo = registry.findType("float");
         }
-        if (right != "float") {
+        if (right != TypeTable::Float) {
             node->right->implicitCastTo = registry.findType("float");
         }
-        node = std::make_shared<BinaryOpNode>(node->left, "fmul", node->right);
+        node = makeNode<BinaryOpNode>(node->left, BinaryOpcode::FMul, node->right);
         node->inferredType = registry.findType("float");
         return;
     }
 
     // int(i32, i64, i8, i1)
-    if (isIntType(left) && isIntType(right)) {
-        node = std::make_shared<BinaryOpNode>(node->left, "mul", node->right);
+    if (TypeTable::isInteger(left) && TypeTable::isInteger(right)) {
+        node = makeNode<BinaryOpNode>(node->left, BinaryOpcode::Mul, node->right);
         node->inferredType = leftType;
         return;
     }
 
-    LogError("Unsupported operand types for '+': " + left + " and " + right, node->right->shared_from_this());
+    LogError("Unsupported operand types for '+': " + leftType->toString() + " and " + rightType->toString(), node->right->self());
 }
 
-void TypeSymbolVisitor::handleDivOperator(std::shared_ptr<BinaryOpNode>& node, std::shared_ptr<TypeNode> leftType, std::shared_ptr<TypeNode> rightType)
+void TypeSymbolVisitor::handleDivOperator(NodePtr<BinaryOpNode>& node, NodePtr<TypeNode> leftType, NodePtr<TypeNode> rightType)
 {
-    std::string left = leftType->toString();
-    std::string right = rightType->toString();
+    TypeId left = leftType->id();
+    TypeId right = rightType->id();
     
-    auto isIntType = [](const std::string& t) {
-        return t == "i32" || t == "i64" || t == "i16" || t == "i8" || t == "i1";
-    };
-
-    if (left == "string" || right == "string") {
-        LogError("Unsupported operand types for '/': " + left + " and " + right, node->right->shared_from_this());
+    if (left == TypeTable::String || right == TypeTable::String) {
+        LogError("Unsupported operand types for '/': " + leftType->toString() + " and " + rightType->toString(), node->right->self());
         return;
     }
 
-    if (left == "float" || right == "float") {
-        if (checkLabels("@strict") && !(left == "float" && right == "float")) {
-            bool leftImplicitFloat = node->left && node->left->implicitCastTo && node->left->implicitCastTo->toString() == "float";
-            bool rightImplicitFloat = node->right && node->right->implicitCastTo && node->right->implicitCastTo->toString() == "float";
+    if (left == TypeTable::Float || right == TypeTable::Float) {
+        if (checkLabels("@strict") && !(left == TypeTable::Float && right == TypeTable::Float)) {
+            bool leftImplicitFloat = node->left && node->left->implicitCastTo && node->left->implicitCastTo->id() == TypeTable::Float;
+            bool rightImplicitFloat = node->right && node->right->implicitCastTo && node->right->implicitCastTo->id() == TypeTable::Float;
             if (leftImplicitFloat || rightImplicitFloat)
-                LogError("Implicit type casting is not allowed for '/' in @strict mode: " + left + " and " + right, node->right->shared_from_this());
+                LogError("Implicit type casting is not allowed for '/' in @strict mode: " + leftType->toString() + " and " + rightType->toString(), node->right->self());
         }
 
-        if (left != "float") {
+        if (left != TypeTable::Float) {
             node->left->implicitCastTo = registry.findType("float");
         }
-        if (right != "float") {
+        if (right != TypeTable::Float) {
             node->right->implicitCastTo = registry.findType("float");
         }
-        node = std::make_shared<BinaryOpNode>(node->left, "fdiv", node->right);
+        node = makeNode<BinaryOpNode>(node->left, BinaryOpcode::FDiv, node->right);
         node->inferredType = registry.findType("float");
         return;
     }
 
-    if (isIntType(left) && isIntType(right)) {
-        node = std::make_shared<BinaryOpNode>(node->left, "sdiv", node->right);
+    if (TypeTable::isInteger(left) && TypeTable::isInteger(right)) {
+        node = makeNode<BinaryOpNode>(node->left, BinaryOpcode::SDiv, node->right);
         node->inferredType = leftType;
         return;
     }
 
-    LogError("Unsupported operand types for '/': " + left + " and " + right, node->right->shared_from_this());
+    LogError("Unsupported operand types for '/': " + leftType->toString() + " and " + rightType->toString(), node->right->self());
 }
 
-void TypeSymbolVisitor::handleModOperator(std::shared_ptr<BinaryOpNode>& node, std::shared_ptr<TypeNode> leftType, std::shared_ptr<TypeNode> rightType)
+void TypeSymbolVisitor::handleModOperator(NodePtr<BinaryOpNode>& node, NodePtr<TypeNode> leftType, NodePtr<TypeNode> rightType)
 {
-    std::string left = leftType->toString();
-    std::string right = rightType->toString();
-
-    auto isIntType = [](const std::string& t) {
-        return t == "i32" || t == "i64" || t == "i16" || t == "i8" || t == "i1";
-    };
+    TypeId left = leftType->id();
+    TypeId right = rightType->id();
 
-    if (left == "string" || right == "string") {
-        LogError("Unsupported operand types for '%': " + left + " and " + right, node->right->shared_from_this());
+    if (left == TypeTable::String || right == TypeTable::String) {
+        LogError("Unsupported operand types for '%': " + leftType->toString() + " and " + rightType->toString(), node->right->self());
         return;
     }
 
-    if (left == "float" || right == "float") {
-        if (checkLabels("@strict") && !(left == "float" && right == "float")) {
-            bool leftImplicitFloat = node->left && node->left->implicitCastTo && node->left->implicitCastTo->toString() == "float";
-            bool rightImplicitFloat = node->right && node->right->implicitCastTo && node->right->implicitCastTo->toString() == "float";
+    if (left == TypeTable::Float || right == TypeTable::Float) {
+        if (checkLabels("@strict") && !(left == TypeTable::Float && right == TypeTable::Float)) {
+            bool leftImplicitFloat = node->left && node->left->implicitCastTo && node->left->implicitCastTo->id() == TypeTable::Float;
+            bool rightImplicitFloat = node->right && node->right->implicitCastTo && node->right->implicitCastTo->id() == TypeTable::Float;
             if (leftImplicitFloat || rightImplicitFloat)
-                LogError("Implicit type casting is not allowed for '%' in @strict mode: " + left + " and " + right, node->right->shared_from_this());
+                LogError("Implicit type casting is not allowed for '%' in @strict mode: " + leftType->toString() + " and " + rightType->toString(), node->right->self());
         }
 
-        if (left != "float") {
+        if (left != TypeTable::Float) {
             node->left->implicitCastTo = registry.findType("float");
         }
-        if (right != "float") {
+        if (right != TypeTable::Float) {
             node->right->implicitCastTo = registry.findType("float");
         }
-        node = std::make_shared<BinaryOpNode>(node->left, "frem", node->right);
+        node = makeNode<BinaryOpNode>(node->left, BinaryOpcode::FRem, node->right);
         node->inferredType = registry.findType("float");
         return;
     }
 
-    if (isIntType(left) && isIntType(right)) {
-        node = std::make_shared<BinaryOpNode>(node->left, "srem", node->right);
+    if (TypeTable::isInteger(left) && TypeTable::isInteger(right)) {
+        node = makeNode<BinaryOpNode>(node->left, BinaryOpcode::SRem, node->right);
         node->inferredType = leftType;
         return;
     }
 
-    LogError("Unsupported operand types for '%': " + left + " and " + right, node->right->shared_from_this());
+    LogError("Unsupported operand types for '%': " + leftType->toString() + " and " + rightType->toString(), node->right->self());
 }
 
-void TypeSymbolVisitor::handleCompareOperator(std::shared_ptr<BinaryOpNode>& node, std::shared_ptr<TypeNode> leftType, std::shared_ptr<TypeNode> rightType)
+void TypeSymbolVisitor::handleCompareOperator(NodePtr<BinaryOpNode>& node, NodePtr<TypeNode> leftType, NodePtr<TypeNode> rightType)
 {
-    std::string left = leftType->toString();
-    std::string right = rightType->toString();
+    TypeId left = leftType->id();
+    TypeId right = rightType->id();
 
-    auto isIntType = [](const std::string& t) {
-        return t == "i32" || t == "i64" || t == "i16" || t == "i8" || t == "i1";
-    };
-
-    // IR-операции по node->op
-    std::string cmpOp;
-    if (node->op == "==" || node->op == "eq") cmpOp = "eq";
-    else if (node->op == "!=" || node->op == "ne") cmpOp = "ne";
-    else if (node->op == "<") cmpOp = "slt";
-    else if (node->op == ">") cmpOp = "sgt";
-    else if (node->op == "<=") cmpOp = "sle";
-    else if (node->op == ">") cmpOp = "sgt";
-    else if (node->op == ">=") cmpOp = "sge";
-    else cmpOp = ""; // неизвестный оператор
-
-    if (cmpOp.empty()) {
-        LogError("Unknown comparison operator: " + node->op, node->right->shared_from_this());
+    // IR-операции по node->op: семейства сравнений идут в том же порядке, что и Equal..GreaterEqual
+    if (!isSourceComparison(node->op)) {
+        LogError("Unknown comparison operator: " + opcodeName(node->op), node->right->self());
         return;
     }
+    int cmpOffset = static_cast<int>(node->op) - static_cast<int>(BinaryOpcode::Equal);
+    auto cmpOp = [cmpOffset](BinaryOpcode first) {
+        return static_cast<BinaryOpcode>(static_cast<int>(first) + cmpOffset);
+    };
 
     // string
-    if (left == "string" || right == "string") {
-        if (left != "string") {
-            node->left = std::make_shared<CallNode>("toString_int", std::vector{node->left});
+    if (left == TypeTable::String || right == TypeTable::String) {
+        if (left != TypeTable::String) {
+            node->left = makeNode<CallNode>("toString_int", std::vector{node->left});
             node->left->accept(*this);
         }
-        if (right != "string") {
-            node->right = std::make_shared<CallNode>("toString_int", std::vector{node->right});
+        if (right != TypeTable::String) {
+            node->right = makeNode<CallNode>("toString_int", std::vector{node->right});
             node->right->accept(*this);
         }
-        node = std::make_shared<BinaryOpNode>(node->left, "strcmp_" + cmpOp, node->right);
+        node = makeNode<BinaryOpNode>(node->left, cmpOp(BinaryOpcode::StrCmpEQ), node->right);
         node->inferredType = registry.findType("i1");
         return;
     }
 
     // float
-    if (left == "float" || right == "float") {
-        if (checkLabels("@strict") && !(left == "float" && right == "float")) {
-            bool leftImplicitFloat = node->left && node->left->implicitCastTo && node->left->implicitCastTo->toString() == "float";
-            bool rightImplicitFloat = node->right && node->right->implicitCastTo && node->right->implicitCastTo->toString() == "float";
+    if (left == TypeTable::Float || right == TypeTable::Float) {
+        if (checkLabels("@strict") && !(left == TypeTable::Float && right == TypeTable::Float)) {
+            bool leftImplicitFloat = node->left && node->left->implicitCastTo && node->left->implicitCastTo->id() == TypeTable::Float;
+            bool rightImplicitFloat = node->right && node->right->implicitCastTo && node->right->implicitCastTo->id() == TypeTable::Float;
             if (leftImplicitFloat || rightImplicitFloat)
-                LogError("Implicit type casting is not allowed for '" + node->op + "' in @strict mode: " + left + " and " + right, node->right->shared_from_this());
+                LogError("Implicit type casting is not allowed for '" + opcodeName(node->op) + "' in @strict mode: " + leftType->toString() + " and " + rightType->toString(), node->right->self());
         }
 
-        if (left != "float") node->left->implicitCastTo = registry.findType("float");
-        if (right != "float") node->right->implicitCastTo = registry.findType("float");
-        node = std::make_shared<BinaryOpNode>(node->left, "fcmp_" + cmpOp, node->right);
+        if (left != TypeTable::Float) node->left->implicitCastTo = registry.findType("float");
+        if (right != TypeTable::Float) node->right->implicitCastTo = registry.findType("float");
+        node = makeNode<BinaryOpNode>(node->left, cmpOp(BinaryOpcode::FCmpEQ), node->right);
         node->inferredType = registry.findType("i1");
         return;
     }
 
     // int(i32, i64, i8, i1)
-    if (isIntType(left) && isIntType(right)) {
-        node = std::make_shared<BinaryOpNode>(node->left, "icmp_" + cmpOp, node->right);
+    if (TypeTable::isInteger(left) && TypeTable::isInteger(right)) {
+        node = makeNode<BinaryOpNode>(node->left, cmpOp(BinaryOpcode::ICmpEQ), node->right);
         node->inferredType = registry.findType("i1");
         return;
     }
 
-    LogError("Unsupported operand types for comparison: " + left + " and " + right, node->right->shared_from_this());
+    LogError("Unsupported operand types for comparison: " + leftType->toString() + " and " + rightType->toString(), node->right->self());
 }
 
-void TypeSymbolVisitor::handleLogicalOperator(std::shared_ptr<BinaryOpNode>& node, std::shared_ptr<TypeNode> leftType, std::shared_ptr<TypeNode> rightType)
+void TypeSymbolVisitor::handleLogicalOperator(NodePtr<BinaryOpNode>& node, NodePtr<TypeNode> leftType, NodePtr<TypeNode> rightType)
 {
-    std::string left = leftType->toString();
-    std::string right = rightType->toString();
+    TypeId left = leftType->id();
+    TypeId right = rightType->id();
 
-    if (left != "i1" || right != "i1") {
-        LogError("Logical operators require boolean operands, got: " + left + " and " + right, node->right->shared_from_this());
+    if (left != TypeTable::I1 || right != TypeTable::I1) {
+        LogError("Logical operators require boolean operands, got: " + leftType->toString() + " and " + rightType->toString(), node->right->self());
         return;
     }
 
     // and, or
-    std::string op = node->op;
-    if (op == "and") op = "and";
-    else if (op == "or") op = "or";
-    else {
-        LogError("Unknown logical operator: " + node->op, node->right->shared_from_this());
+    BinaryOpcode op = node->op;
+    if (op != BinaryOpcode::And && op != BinaryOpcode::Or) {
+        LogError("Unknown logical operator: " + opcodeName(node->op), node->right->self());
         return;
     }
 
-    node = std::make_shared<BinaryOpNode>(node->left, op, node->right);
+    node = makeNode<BinaryOpNode>(node->left, op, node->right);
     node->inferredType = registry.findType("i1");
     node->implicitCastTo = registry.findType("i1");
 }
\ No newline at end of file
@@ -4,16 +4,46 @@
 
 void TypeSymbolVisitor::visit(ProgramNode &node)
 {
-    this->program = std::make_shared<ProgramNode>(node);
+    this->program = makeNode<ProgramNode>(node);
     for (const auto& statement : node.body) {
         statement->accept(*this);
     }
 }
 
+void TypeSymbolVisitor::checkDeclaration(const NodePtr<ASTNode>& declaration, Context& globals, std::unordered_map<std::string, NodePtr<StructNode>>& structs)
+{
+    contexts.assign(1, std::move(globals));
+    registry.userStructs.swap(structs);
+
+    auto restore = [&]() {
+        contexts.resize(1);
+        globals = std::move(contexts[0]);
+        registry.userStructs.swap(structs);
+    };
+
+    try {
+        declaration->accept(*this);
+    } catch (...) {
+        restore();
+        throw;
+    }
+    restore();
+}
+
+void TypeSymbolVisitor::keepSignature(const NodePtr<FunctionNode>& signature)
+{
+    // Вызовы берут типы из параметров функции, поэтому они проверяются так же, как в visit(FunctionNode)
+    for (const auto& param : signature->parameters)
+        param.first->accept(*this);
+    signature->inferredType = signature->returnType;
+
+    contexts[0].functions[signature->name] = signature;
+}
+
 void TypeSymbolVisitor::visit(FunctionNode &node)
 {
     // Проверяем, существует ли функция в реестре(в текущем контексте или глобальном)
-    if(contexts.back().functions.find(node.name) != contexts.back().functions.end()) {
+    if(contexts.back().findFunction(node.name)) {
         if(contexts[0].functions.find(node.name) != contexts[0].functions.end()) {
             LogError("Function already defined in global context: " + node.name);
         }
@@ -36,7 +66,7 @@ void TypeSymbolVisitor::visit(FunctionNode &node)
     Пока что не проверяем, что функция является методом структуры
     */
    
-    std::unordered_map<std::string, std::shared_ptr<TypeNode>> args = {};
+    std::unordered_map<Symbol, NodePtr<TypeNode>> args = {};
 
     // Проходим по параметрам функции
     for (const auto& param : node.parameters) {
@@ -59,44 +89,47 @@ void TypeSymbolVisitor::visit(FunctionNode &node)
         args[param.second] = param.first;
     }
 
-    // Если функция не является чистой, то хуярим ей все предыдущие переменные
-    std::unordered_map<std::string, std::shared_ptr<ASTNode>> variables = {};
-    std::unordered_map<std::string, std::shared_ptr<ASTNode>> functions = {};
+    // Если функция не является чистой, то хуярим ей все предыдущие переменные - через parent, без копии
+    const Context* parent = nullptr;
+    std::unordered_map<Symbol, NodePtr<ASTNode>> functions = {};
 
     if(std::find(labels.begin(), labels.end(), "@pure") == labels.end())
     {
-        variables = contexts.back().variables;
-        functions = contexts.back().functions;
+        parent = &contexts.back();
     }
     else
     {
-        for (const auto& func : contexts.back().functions) {
-            if (auto funcNode = std::dynamic_pointer_cast<FunctionNode>(func.second)) {
-                if (std::find(funcNode->labels.begin(), funcNode->labels.end(), "@pure") != funcNode->labels.end()) { // Если функция является чистой
-                    functions[func.first] = func.second;
+        // Чистой функции видны только чистые функции; ближняя область перекрывает дальнюю
+        for (const Context* scope = &contexts.back(); scope; scope = scope->parent) {
+            for (const auto& func : scope->functions) {
+                if (auto funcNode = dyn_cast<FunctionNode>(func.second)) {
+                    if (std::find(funcNode->labels.begin(), funcNode->labels.end(), "@pure") != funcNode->labels.end()) { // Если функция является чистой
+                        functions.emplace(func.first, func.second);
+                    }
                 }
             }
         }
     }
     
     if(std::find(labels.begin(), labels.end(), "@entry") != labels.end() || node.name == "main")
-        if(node.returnType->toString() != "i32" && node.returnType->toString() != "void")
+        if(node.returnType->id() != TypeTable::I32 && node.returnType->id() != TypeTable::Void)
             LogError("Function " + node.name + " must return i32 or void");
 
     // Если не вывилась ошибка, добавляем функцию в реестр
     Context currentFunction = {
         .labels = labels, // Добавляем метки функции
-        .variables = variables, // Добавляем переменные текущего контекста
-        .functions = functions, // Добавляем функции текущего контекста
+        .variables = {}, // Свои переменные - параметры и локальные
+        .functions = functions, // Для @pure - видимые чистые функции
         .currentFunctionName = node.name,       // Имя функции 
         .returnType = node.returnType,          // Тип возвращаемого значения
-        .returnedValue = false                  // Возвращаемое значение
+        .returnedValue = false,                 // Возвращаемое значение
+        .parent = parent                        // Переменные и функции текущего контекста
     };
 
     // Добавляем параметры функции в текущий контекст
     for (const auto& param : args) {
-        auto varNode = std::make_shared<VariableAssignNode>(
-            param.first, false, std::dynamic_pointer_cast<TypeNode>(param.second), nullptr);
+        auto varNode = makeNode<VariableAssignNode>(
+            param.first, false, dyn_cast<TypeNode>(param.second), nullptr);
         
         varNode->inferredType = varNode->type; // <-- инициализация inferredType
 
@@ -107,19 +140,19 @@ void TypeSymbolVisitor::visit(FunctionNode &node)
     // Если функция находится в глобальном контексте, то добавляем ее в глобальный реестр(глобальный контекст - это первый элемент в векторе)
     // Если функция не является методом класса, то добавляем ее в глобальный реестр
     if(contexts.size() == 1)
-        contexts[0].functions[node.name] = node.shared_from_this();
+        contexts[0].functions[node.name] = node.self();
     else
-        contexts.back().functions[node.name] = node.shared_from_this();
+        contexts.back().functions[node.name] = node.self();
 
-    currentFunction.functions[node.name] = node.shared_from_this(); // Добавляем функцию в текущий контекст
+    currentFunction.functions[node.name] = node.self(); // Добавляем функцию в текущий контекст
     
     // Добавляем функцию в реестр
-    contexts.push_back(currentFunction);
+    contexts.push_back(std::move(currentFunction));
 
-    // Проверяем тело функции
-    node.body->accept(*this);
+    // Проверяем тело функции (отложенное парсером разбирается здесь, при первой проверке)
+    node.requireBody()->accept(*this);
 
-    if(contexts.back().returnedValue == false && contexts.back().returnType->toString() != "void") {
+    if(contexts.back().returnedValue == false && contexts.back().returnType->id() != TypeTable::Void) {
         LogError("Function " + node.name + " must return a value of type " + contexts.back().returnType->toString());
     }
 
@@ -135,24 +168,34 @@ void TypeSymbolVisitor::visit(BlockNode &node)
     }
 }
 
-static std::string getType(std::shared_ptr<ASTNode> expression, std::string type) {
-    if (auto num = std::dynamic_pointer_cast<NumberNode>(expression)) 
-        return num->inferredType->toString();
-    else if (auto bin = std::dynamic_pointer_cast<BinaryOpNode>(expression)) 
-        if (bin->op == "and" || bin->op == "or" || bin->op == "==" || bin->op == "!=" || bin->op.rfind("icmp_", 0) == 0 || bin->op.rfind("fcmp_", 0) == 0)
+static bool isCompareOperator(BinaryOpcode op) {
+    return isICmp(op) || isFCmp(op) ||
+           op == BinaryOpcode::And || op == BinaryOpcode::Or;
+}
+
+static std::string getType(NodePtr<ASTNode> expression, std::string type) {
+    if (!expression)
+        return type;
+    switch (expression->kind) {
+        case NodeKind::Number:
+            return expression->inferredType->toString();
+        case NodeKind::BinaryOp: {
+            BinaryOpcode op = cast<BinaryOpNode>(expression)->op;
+            if (isCompareOperator(op) || op == BinaryOpcode::Equal || op == BinaryOpcode::NotEqual)
+                return "i1";
+            return type;
+        }
+        case NodeKind::UnaryOp:
             return "i1";
-        else
+        default:
             return type;
-    else if (auto unary = std::dynamic_pointer_cast<UnaryOpNode>(expression)) 
-        return "i1";
-    else
-        return type;
+    }
 };
 
 void TypeSymbolVisitor::visit(VariableAssignNode &node)
 {
     // Проверяем, существует ли переменная в реестре
-    if (contexts.back().variables.find(node.name) != contexts.back().variables.end()) {
+    if (contexts.back().findVariable(node.name)) {
         LogError("Variable already defined: " + node.name);
     }
 
@@ -166,34 +209,34 @@ void TypeSymbolVisitor::visit(VariableAssignNode &node)
         if(!isStrict)
             isAuto = true;
         else
-            LogError("auto is not allowed in strict mode", node.shared_from_this());
+            LogError("auto is not allowed in strict mode", node.self());
 
     if (
         varType == "none"
         || varType == "null"
         || varType == "void"
     ) {
-        LogError("Type cannot be " + varType, node.shared_from_this());
+        LogError("Type cannot be " + varType, node.self());
     }
 
     if (isAuto) {
-        if (auto block = std::dynamic_pointer_cast<BlockNode>(node.expression)) {
-            std::shared_ptr<TypeNode> inferredType = infer_collection_type_revised(block);
+        if (auto block = dyn_cast<BlockNode>(node.expression)) {
+            NodePtr<TypeNode> inferredType = infer_collection_type_revised(block);
 
-            if (inferredType->toString() == "auto_empty_collection") {
+            if (inferredType->id() == TypeTable::getInstance().simple("auto_empty_collection")) {
                 bool blockIsMapSyntax = false; 
 
                 if (blockIsMapSyntax) {
-                    auto mapType = std::make_shared<GenericTypeNode>("map");
-                    mapType->typeParameters.push_back(std::make_shared<SimpleTypeNode>("auto"));
-                    mapType->typeParameters.push_back(std::make_shared<SimpleTypeNode>("auto"));
+                    auto mapType = makeNode<GenericTypeNode>("map");
+                    mapType->typeParameters.push_back(TypeTable::getInstance().node(TypeTable::Auto));
+                    mapType->typeParameters.push_back(TypeTable::getInstance().node(TypeTable::Auto));
                     node.type = mapType;
                 } else {
-                    auto arrayType = std::make_shared<GenericTypeNode>("array");
-                    arrayType->typeParameters.push_back(std::make_shared<SimpleTypeNode>("auto"));
+                    auto arrayType = makeNode<GenericTypeNode>("array");
+                    arrayType->typeParameters.push_back(TypeTable::getInstance().node(TypeTable::Auto));
                     node.type = arrayType;
                 }
-                LogError("Ambiguous empty collection initializer for 'auto' variable '" + node.name + "'. Resolved based on syntax (assuming array if unclear).", node.shared_from_this());
+                LogError("Ambiguous empty collection initializer for 'auto' variable '" + node.name + "'. Resolved based on syntax (assuming array if unclear).", node.self());
             } else if (inferredType->toString().rfind("error_", 0) == 0) {
                 LogError("Failed to infer type for collection assigned to 'auto' variable '" + node.name + "': " + inferredType->toString(), node.expression);
             }
@@ -224,9 +267,9 @@ void TypeSymbolVisitor::visit(VariableAssignNode &node)
             castNumbersInBinaryTree(node.expression, isAuto ? "auto" : varType);
             if (varType != "i1" && varType != "auto")
             {
-                if (auto binaryOp = std::dynamic_pointer_cast<BinaryOpNode>(node.expression))
+                if (auto binaryOp = dyn_cast<BinaryOpNode>(node.expression))
                 {
-                    if ((binaryOp->op == "and" || binaryOp->op == "or" || binaryOp->op.rfind("icmp_", 0) == 0 || binaryOp->op.rfind("fcmp_", 0) == 0))
+                    if (isCompareOperator(binaryOp->op))
                     {
                         LogError("Type mismatch: expected i1, got " + expressionType);
                     }
@@ -239,16 +282,16 @@ void TypeSymbolVisitor::visit(VariableAssignNode &node)
 
         if (isAuto)
             if(node.expression->implicitCastTo)
-                node.type = std::make_shared<SimpleTypeNode>(getType(node.expression, node.expression->implicitCastTo->toString()));
+                node.type = TypeTable::getInstance().node(getType(node.expression, node.expression->implicitCastTo->toString()));
             else
-                node.type = std::make_shared<SimpleTypeNode>(getType(node.expression, node.expression->inferredType->toString()));
+                node.type = TypeTable::getInstance().node(getType(node.expression, node.expression->inferredType->toString()));
         else if(varType == "i1")
             if(getType(node.expression, varType) != "i1")
                 LogError("Type mismatch: expected i1, got " + expressionType);
     }
 
     // Добавляем переменную в реестр
-    auto varNode = std::make_shared<VariableAssignNode>(node.name, node.isConst, node.type, node.expression);
+    auto varNode = makeNode<VariableAssignNode>(node.name, node.isConst, node.type, node.expression);
     varNode->inferredType = node.type; // Устанавливаем тип переменной
 
     contexts.back().variables[node.name] = varNode;
@@ -258,13 +301,13 @@ void TypeSymbolVisitor::visit(ReturnNode &node)
 {
     // Проверяем, существует ли функция в реестре
     if (contexts.back().currentFunctionName.empty()) {
-        LogError("Return statement outside of function", node.shared_from_this());
+        LogError("Return statement outside of function", node.self());
     }
 
     // Проверяем тип возвращаемого значения
     if (node.expression)
     {
-        if (auto block = std::dynamic_pointer_cast<BlockNode>(node.expression))
+        if (auto block = dyn_cast<BlockNode>(node.expression))
         {
             node.expression->accept(*this);
             validateCollectionElements(contexts.back().returnType, node.expression, false);
@@ -283,7 +326,7 @@ void TypeSymbolVisitor::visit(ReturnNode &node)
 
             if (actualType != expectedType) {
                 if (!(actualType == "null" && expectedType == "void"))
-                    LogError("Return type mismatch: expected " + contexts.back().returnType->toString() + ", got " + node.expression->inferredType->toString(), node.shared_from_this());
+                    LogError("Return type mismatch: expected " + contexts.back().returnType->toString() + ", got " + node.expression->inferredType->toString(), node.self());
             }
         }
     }
@@ -291,24 +334,20 @@ void TypeSymbolVisitor::visit(ReturnNode &node)
     contexts.back().returnedValue = true; // Устанавливаем, что функция вернула значение
 }
 
-static bool isCompareOperator(const std::string& op) {
-    return op.starts_with("icmp_") || op.starts_with("fcmp_") ||
-           op == "and" || op == "or";
-}
-
 // TODO: Переделать функцию полность потому что она хуйня ебанная
 void TypeSymbolVisitor::visit(VariableReassignNode& node) {
     // Проверяем, существует ли переменная в реестре
-    if (contexts.back().variables.find(node.name) == contexts.back().variables.end()) {
-        LogError("Variable not found: " + node.name, node.shared_from_this());
+    NodePtr<ASTNode> variable = contexts.back().findVariable(node.name);
+    if (!variable) {
+        LogError("Variable not found: " + node.name, node.self());
     }
 
-    std::shared_ptr<VariableAssignNode> varAssign = std::dynamic_pointer_cast<VariableAssignNode>(contexts.back().variables[node.name]);
-    std::shared_ptr<TypeNode> varType = varAssign->inferredType;
+    NodePtr<VariableAssignNode> varAssign = dyn_cast<VariableAssignNode>(variable);
+    NodePtr<TypeNode> varType = varAssign->inferredType;
     std::string varTypeStr = varType->toString();
 
     if (varAssign->isConst) {
-        LogError("Cannot reassign constant variable: " + node.name, node.shared_from_this());
+        LogError("Cannot reassign constant variable: " + node.name, node.self());
     }
 
     std::string expressionType;
@@ -317,23 +356,23 @@ void TypeSymbolVisitor::visit(VariableReassignNode& node) {
     ) {
         node.expression->accept(*this);
         validateCollectionElements(varType, node.expression, false);
-        auto Block = std::dynamic_pointer_cast<BlockNode>(node.expression);
-        auto Generic = std::dynamic_pointer_cast<GenericTypeNode>(varType);
+        auto Block = dyn_cast<BlockNode>(node.expression);
+        auto Generic = dyn_cast<GenericTypeNode>(varType);
 
-        if (auto keyValue = std::dynamic_pointer_cast<KeyValueNode>(Block->statements[0])) {
+        if (auto keyValue = dyn_cast<KeyValueNode>(Block->statements[0])) {
             std::vector<std::string> types = { keyValue->key->inferredType->toString(), keyValue->value->inferredType->toString() };
-            if (types[0] != Generic->typeParameters[0]->toString()) {
+            if (!sameType(keyValue->key->inferredType, Generic->typeParameters[0])) {
                 LogError("Key type mismatch: expected " + Generic->typeParameters[0]->toString() + ", got " + types[0], node.expression);
             }
-            if (types[1] != Generic->typeParameters[1]->toString()) {
+            if (!sameType(keyValue->value->inferredType, Generic->typeParameters[1])) {
                 LogError("Value type mismatch: expected " + Generic->typeParameters[1]->toString() + ", got " + types[1], node.expression);
             }
             expressionType = "map<" + types[0] + ", " + types[1] + ">";
         } 
         else {
-            if (Block->statements[0]->inferredType->toString() != Generic->typeParameters[0]->toString()) {
-                if (Generic->typeParameters[0]->toString() == "i1")
-                    if (auto binaryOp = std::dynamic_pointer_cast<BinaryOpNode>(Block->statements[0])) {
+            if (!sameType(Block->statements[0]->inferredType, Generic->typeParameters[0])) {
+                if (Generic->typeParameters[0]->id() == TypeTable::I1)
+                    if (auto binaryOp = dyn_cast<BinaryOpNode>(Block->statements[0])) {
                         if (isCompareOperator(binaryOp->op)) {
                             expressionType = "array<i1>";
                         } else {
@@ -365,8 +404,8 @@ void TypeSymbolVisitor::visit(VariableReassignNode& node) {
             expressionType = getType(node.expression, expressionType);
 
             if (varTypeStr != "i1") {
-                if (auto binaryOp = std::dynamic_pointer_cast<BinaryOpNode>(node.expression)) {
-                    if ((binaryOp->op == "and" || binaryOp->op == "or" || binaryOp->op.rfind("icmp_", 0) == 0 || binaryOp->op.rfind("fcmp_", 0) == 0)) {
+                if (auto binaryOp = dyn_cast<BinaryOpNode>(node.expression)) {
+                    if (isCompareOperator(binaryOp->op)) {
                         LogError("Type mismatch: expected i1, got " + expressionType, node.expression);
                     }
                 }
@@ -381,10 +420,23 @@ void TypeSymbolVisitor::visit(VariableReassignNode& node) {
     varAssign->expression = node.expression;
 }
 
+void TypeSymbolVisitor::enterBlock(const std::string& name)
+{
+    const Context& outer = contexts.back();
+    Context block = {
+        .labels = outer.labels,
+        .currentFunctionName = name,
+        .returnType = outer.returnType,
+        .returnedValue = outer.returnedValue,
+        .parent = &outer
+    };
+    contexts.push_back(std::move(block));
+}
+
 void TypeSymbolVisitor::visit(IfNode& node) {
     // Проверяем, существует ли функция в реестре
     if (contexts.back().currentFunctionName.empty()) {
-        LogError("If statement outside of function", node.shared_from_this());
+        LogError("If statement outside of function", node.self());
     }
 
     node.condition->accept(*this);
@@ -394,17 +446,15 @@ void TypeSymbolVisitor::visit(IfNode& node) {
         LogError("If condition must be of type i1, got " + conditionType, node.condition);
     else 
     {
-        auto binaryOp = std::dynamic_pointer_cast<BinaryOpNode>(node.condition);
-        if(binaryOp && binaryOp->op != "strcmp_eq") 
+        auto binaryOp = dyn_cast<BinaryOpNode>(node.condition);
+        if(binaryOp && binaryOp->op != BinaryOpcode::StrCmpEQ) 
                 castNumbersInBinaryTree(node.condition, "auto");
         else 
                 castNumbersInBinaryTree(node.condition, "auto");
     }
 
     // Создаем новый контекст для блока if
-    contexts.push_back(contexts.back());
-
-    contexts.back().currentFunctionName = "if";
+    enterBlock("if");
 
     // Проверяем блок if
     node.thenBlock->accept(*this);
@@ -415,9 +465,7 @@ void TypeSymbolVisitor::visit(IfNode& node) {
     // Проверяем блок else
     if (node.elseBlock) {
         // Создаем новый контекст для блока else
-        contexts.push_back(contexts.back());
-
-        contexts.back().currentFunctionName = "else";
+        enterBlock("else");
 
         // Проверяем блок else
         node.elseBlock->accept(*this);
@@ -431,7 +479,7 @@ void TypeSymbolVisitor::visit(IfNode& node) {
 void TypeSymbolVisitor::visit(ForNode& node) {
     // Проверяем, существует ли функция в реестре
     if (contexts.back().currentFunctionName.empty()) {
-        LogError("For statement outside of function", node.shared_from_this());
+        LogError("For statement outside of function", node.self());
     }
 
     // Проверяем тип переменной
@@ -445,9 +493,7 @@ void TypeSymbolVisitor::visit(ForNode& node) {
     node.varType = node.iterable->inferredType; // Устанавливаем тип итератора 
 
     // Создаем новый контекст для блока for
-    contexts.push_back(contexts.back());
-
-    contexts.back().currentFunctionName = "for";
+    enterBlock("for");
 
     // Проверяем блок for
     node.body->accept(*this);
@@ -459,7 +505,7 @@ void TypeSymbolVisitor::visit(ForNode& node) {
 void TypeSymbolVisitor::visit(WhileNode& node) {
     // Проверяем, существует ли функция в реестре
     if (contexts.back().currentFunctionName.empty()) {
-        LogError("If statement outside of function", node.shared_from_this());
+        LogError("If statement outside of function", node.self());
     }
 
     node.condition->accept(*this);
@@ -469,17 +515,15 @@ void TypeSymbolVisitor::visit(WhileNode& node) {
         LogError("If condition must be of type i1, got " + conditionType, node.condition);
     else 
     {
-        auto binaryOp = std::dynamic_pointer_cast<BinaryOpNode>(node.condition);
-        if(binaryOp && binaryOp->op != "strcmp_eq") 
+        auto binaryOp = dyn_cast<BinaryOpNode>(node.condition);
+        if(binaryOp && binaryOp->op != BinaryOpcode::StrCmpEQ) 
                 castNumbersInBinaryTree(node.condition, "auto");
         else 
                 castNumbersInBinaryTree(node.condition, "auto");
     }
 
     // Создаем новый контекст для блока while
-    contexts.push_back(contexts.back());
-
-    contexts.back().currentFunctionName = "while";
+    enterBlock("while");
 
     // Проверяем блок while
     node.body->accept(*this);
@@ -491,7 +535,7 @@ void TypeSymbolVisitor::visit(WhileNode& node) {
 void TypeSymbolVisitor::visit(BreakNode& node) {
     // Проверяем, существует ли функция в реестре
     if (contexts.back().currentFunctionName.empty()) {
-        LogError("Break statement outside of function", node.shared_from_this());
+        LogError("Break statement outside of function", node.self());
     }
 
     bool inLoop = false;
@@ -503,10 +547,10 @@ void TypeSymbolVisitor::visit(BreakNode& node) {
     }
 
     if (!inLoop) {
-        LogError("Break statement outside of loop", node.shared_from_this());
+        LogError("Break statement outside of loop", node.self());
     }
 
-    node.inferredType = std::make_shared<SimpleTypeNode>("void");
+    node.inferredType = TypeTable::getInstance().node(TypeTable::Void);
 }
 
 
@@ -514,7 +558,7 @@ void TypeSymbolVisitor::visit(BreakNode& node) {
 void TypeSymbolVisitor::visit(ContinueNode& node) {
     // Проверяем, существует ли функция в реестре
     if (contexts.back().currentFunctionName.empty()) {
-        LogError("Continue statement outside of function", node.shared_from_this());
+        LogError("Continue statement outside of function", node.self());
     }
 
     bool inLoop = false;
@@ -526,14 +570,14 @@ void TypeSymbolVisitor::visit(ContinueNode& node) {
     }
 
     if (!inLoop) {
-        LogError("Continue statement outside of loop", node.shared_from_this());
+        LogError("Continue statement outside of loop", node.self());
     }
-    node.inferredType = std::make_shared<SimpleTypeNode>("void");
+    node.inferredType = TypeTable::getInstance().node(TypeTable::Void);
 }
 
 void TypeSymbolVisitor::visit(CallNode& node) { 
     // Делаем список типов аргументов
-    std::vector<std::shared_ptr<TypeNode>> argTypes;
+    std::vector<NodePtr<TypeNode>> argTypes;
     for (size_t i = 0; i < node.arguments.size(); ++i) {
         node.arguments[i]->accept(*this);
 
@@ -543,31 +587,39 @@ void TypeSymbolVisitor::visit(CallNode& node) {
             argTypes.push_back(node.arguments[i]->inferredType);
     }
 
-    // Проверяем, существует ли функция в реестре
-    if (contexts.back().functions.find(node.callee) == contexts.back().functions.end()) {
-        // Точное совпадение типов аргументов
-        if (registry.findFunction(node.callee, argTypes) != nullptr) 
-            contexts.back().functions[node.callee] = registry.findFunction(node.callee, argTypes);
+    // Своя функция видна по цепочке областей, встроенная разрешается по сигнатуре в реестре
+    NodePtr<FunctionNode> func = dyn_cast<FunctionNode>(contexts.back().findFunction(node.callee));
+    if (!func) {
+        TypeId signature = Registry::signatureOf(argTypes);
+        if (node.resolvedFunction && node.resolvedSignature == signature && node.resolvedRegistry == registry.getId())
+            func = node.resolvedFunction;
+        else {
+            // Точное совпадение или перегрузка с самым дешёвым приведением
+            func = registry.resolveFunction(node.callee, argTypes);
 
-        // Поиск функции с совпадением по имени
-        else if (registry.findFunction(node.callee) != nullptr) 
-            contexts.back().functions[node.callee] = registry.findFunction(node.callee);
+            // Поиск функции с совпадением по имени - несовпадение аргументов покажет проверка ниже
+            if (!func)
+                func = registry.findFunction(node.callee);
 
-        // Функция нихуя не найдена
-        else
-            LogError("Function not found: " + node.callee, node.shared_from_this());
+            // Функция нихуя не найдена
+            if (!func)
+                LogError("Function not found: " + node.callee, node.self());
+
+            node.resolvedFunction = func;
+            node.resolvedSignature = signature;
+            node.resolvedRegistry = registry.getId();
+        }
     }
 
     // Проверяем типы аргументов
-    std::shared_ptr<FunctionNode> func = std::dynamic_pointer_cast<FunctionNode>(contexts.back().functions[node.callee]);
 
     // Проверяем количество аргументов
     if (argTypes.size() != func->parameters.size()) {
-        LogError("Function " + node.callee + " expects " + std::to_string(func->parameters.size()) + " arguments, got " + std::to_string(argTypes.size()), node.shared_from_this());
+        LogError("Function " + node.callee + " expects " + std::to_string(func->parameters.size()) + " arguments, got " + std::to_string(argTypes.size()), node.self());
     }
 
-    auto isNumeric = [](const std::shared_ptr<TypeNode>& type) {
-        return type->toString() == "i1" || type->toString() == "i8" || type->toString() == "i16" || type->toString() == "i32" || type->toString() == "i64";
+    auto isNumeric = [](const NodePtr<TypeNode>& type) {
+        return TypeTable::isInteger(type->id());
     };
 
     // Проверяем типы аргументов
@@ -575,10 +627,10 @@ void TypeSymbolVisitor::visit(CallNode& node) {
         std::string argType = argTypes[i]->toString();
         std::string paramType = func->parameters[i].first->toString();
 
-        if (argType != paramType)
+        if (!sameType(argTypes[i], func->parameters[i].first))
             if (isNumeric(argTypes[i]) && isNumeric(func->parameters[i].first))
             {
-                if(auto binaryOp = std::dynamic_pointer_cast<BinaryOpNode>(node.arguments[i]))
+                if(auto binaryOp = dyn_cast<BinaryOpNode>(node.arguments[i]))
                 {
                     castNumbersInBinaryTree(node.arguments[i], paramType);
                     std::cout << "Casting " << argType << " to " << paramType << std::endl;
@@ -30,12 +30,11 @@ void TypeSymbolVisitor::visit(GenericTypeNode &node)
 void TypeSymbolVisitor::visit(IdentifierNode& node)
 {
     // Проверяем, существует ли переменная в реестре
-    auto it = contexts.back().variables.find(node.name);
-    if (it == contexts.back().variables.end()) {
-        LogError("Variable not found: " + node.name, node.shared_from_this());
+    NodePtr<ASTNode> varAssign = contexts.back().findVariable(node.name);
+    if (!varAssign) {
+        LogError("Variable not found: " + node.name, node.self());
     }
 
-    std::shared_ptr<ASTNode> varAssign = contexts.back().variables[node.name];
     auto result = checkForIdentifier(varAssign);
 
     if(varAssign->implicitCastTo)
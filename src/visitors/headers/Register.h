@@ -1,43 +1,62 @@
 #ifndef REGISTER_H
 #define REGISTER_H
 
+#include <atomic>
 #include <unordered_map>
 #include <memory>
 #include <string>
 #include <vector>
+#include "../../lexer/headers/Interner.h"
+
+#include "../../parser/headers/AST.h" // NodePtr
 
 // Вперёд-объявления
-struct TypeNode;
-struct FunctionNode;
-struct StructNode;
 struct ClassNode;
 
 class Registry {
 public:
     // Базовые типы
-    std::unordered_map<std::string, std::shared_ptr<TypeNode>> builtinTypes;
+    std::unordered_map<std::string, NodePtr<TypeNode>> builtinTypes;
 
     // Базовые функции
-    std::unordered_map<std::string, std::vector<std::shared_ptr<FunctionNode>>> builtinFunctions;
+    std::unordered_map<Symbol, std::vector<NodePtr<FunctionNode>>> builtinFunctions;
 
     // Пользовательские структуры
-    std::unordered_map<std::string, std::shared_ptr<StructNode>> userStructs;
+    std::unordered_map<std::string, NodePtr<StructNode>> userStructs;
 
     // Пользовательские классы
-    std::unordered_map<std::string, std::shared_ptr<ClassNode>> userClasses;
+    std::unordered_map<std::string, NodePtr<ClassNode>> userClasses;
 
     // Добавление
-    void addBuiltinType(const std::string& name, std::shared_ptr<TypeNode> type);
-    void addBuiltinFunction(const std::string& name, std::shared_ptr<FunctionNode> func);
-    void addStruct(const std::string& name, std::shared_ptr<StructNode> strct);
-    void addClass(const std::string& name, std::shared_ptr<ClassNode> cls);
+    void addBuiltinType(const std::string& name, NodePtr<TypeNode> type);
+    void addBuiltinFunction(Symbol name, NodePtr<FunctionNode> func);
+    void addStruct(const std::string& name, NodePtr<StructNode> strct);
+    void addClass(const std::string& name, NodePtr<ClassNode> cls);
 
     // Поиск
-    std::shared_ptr<TypeNode> findType(const std::string& name) const;
-    std::shared_ptr<FunctionNode> findFunction(const std::string& name) const;
-    std::shared_ptr<FunctionNode> findFunction(const std::string& name, const std::vector<std::shared_ptr<TypeNode>>& args) const;
-    std::shared_ptr<StructNode> findStruct(const std::string& name) const;
-    std::shared_ptr<ClassNode> findClass(const std::string& name) const;
+    NodePtr<TypeNode> findType(const std::string& name) const;
+    NodePtr<FunctionNode> findFunction(Symbol name) const;
+    NodePtr<FunctionNode> findFunction(Symbol name, const std::vector<NodePtr<TypeNode>>& args) const; // Точное совпадение сигнатуры
+    // Точное совпадение, иначе перегрузка той же арности с самым дешёвым неявным приведением аргументов
+    NodePtr<FunctionNode> resolveFunction(Symbol name, const std::vector<NodePtr<TypeNode>>& args) const;
+    NodePtr<StructNode> findStruct(const std::string& name) const;
+    NodePtr<ClassNode> findClass(const std::string& name) const;
+
+    // Каноническая сигнатура - id списка типов в TypeTable (арность входит в сигнатуру)
+    static TypeId signatureOf(const std::vector<NodePtr<TypeNode>>& types);
+
+    // Номер реестра: кэш разрешения в CallNode действителен только для того реестра, что его заполнил
+    uint32_t getId() const { return id; }
+
+private:
+    static uint64_t overloadKey(Symbol name, uint32_t second) { return (uint64_t(name.getId()) << 32) | second; }
+
+    // Индекс перегрузок встроенных функций
+    std::unordered_map<uint64_t, NodePtr<FunctionNode>> exactOverloads;                 // (имя, сигнатура) -> первая объявленная
+    std::unordered_map<uint64_t, std::vector<NodePtr<FunctionNode>>> overloadsByArity;  // (имя, арность) -> кандидаты в порядке объявления
+
+    static inline std::atomic<uint32_t> nextId{1};
+    uint32_t id = nextId.fetch_add(1, std::memory_order_relaxed);
 };
 
 #endif // REGISTER_H
\ No newline at end of file
@@ -7,15 +7,38 @@
 #include "../../includes/icecream.hpp"
 #include "Register.h"
 #include "BuiltIn.h"
+#include "../../parser/headers/TypeTable.h"
+#include <deque>
 #include <fstream>
 
+/*
+Область видимости. Вложенная область не копирует таблицы внешней, а ссылается на неё:
+вход в блок - O(1), поиск идёт по короткой цепочке parent, запись - в свою область
+и пропадает вместе с ней. Области без parent (глобальная, @pure, структура, лямбда)
+видят только свои таблицы.
+*/
 struct Context {
     std::vector<std::string> labels;
-    std::unordered_map<std::string, std::shared_ptr<ASTNode>> variables;
-    std::unordered_map<std::string, std::shared_ptr<ASTNode>> functions;
+    std::unordered_map<Symbol, NodePtr<ASTNode>> variables; // Имена этой области; ключ - интернированное имя
+    std::unordered_map<Symbol, NodePtr<ASTNode>> functions;
     std::string currentFunctionName;
-    std::shared_ptr<TypeNode> returnType;
+    NodePtr<TypeNode> returnType;
     bool returnedValue = false;
+    const Context* parent = nullptr; // Внешняя область; живёт дольше вложенной (стек contexts)
+
+    // Ближайшее по цепочке объявление или nullptr
+    NodePtr<ASTNode> findVariable(Symbol name) const {
+        for (const Context* scope = this; scope; scope = scope->parent)
+            if (auto it = scope->variables.find(name); it != scope->variables.end())
+                return it->second;
+        return nullptr;
+    }
+    NodePtr<ASTNode> findFunction(Symbol name) const {
+        for (const Context* scope = this; scope; scope = scope->parent)
+            if (auto it = scope->functions.find(name); it != scope->functions.end())
+                return it->second;
+        return nullptr;
+    }
 };
 
 class TypeSymbolVisitor : public ASTNodeVisitor {
@@ -23,13 +46,16 @@ class TypeSymbolVisitor : public ASTNodeVisitor {
 private:
     std::unique_ptr<ErrorEngine>                                    errorEngine;
 
-    std::vector<Context>                                            contexts;
+    std::deque<Context>                                             contexts; // deque: push/pop не двигают области, на которые ссылается parent
+
+    // Вложенная область блока (if, else, for, while) с доступом ко всему внешнему
+    void                                                            enterBlock(const std::string& name);
 
     std::vector<std::string>                                        types;
 
     Registry                                                        registry;
 
-    std::shared_ptr<ProgramNode>                                    program; // Только для отладки
+    NodePtr<ProgramNode>                                    program; // Только для отладки
 
     std::string                                                     currentModuleName;
 
@@ -37,60 +63,60 @@ private:
     Проверяет, существует ли переменная в реестре(если переданный node является идентификатором)
     */
    
-    std::shared_ptr<TypeNode>                                       checkForIdentifier(std::shared_ptr<ASTNode>& node);
+    NodePtr<TypeNode>                                       checkForIdentifier(NodePtr<ASTNode>& node);
 
     void                                                            castNumbersInBinaryTree(
-                                                                        std::shared_ptr<ASTNode>& node, 
+                                                                        NodePtr<ASTNode>& node, 
                                                                         const std::string& expectedType);
     
     void                                                            validateCollectionElements(
-                                                                        const std::shared_ptr<TypeNode>& expectedType,
-                                                                        const std::shared_ptr<ASTNode>& expr,
+                                                                        const NodePtr<TypeNode>& expectedType,
+                                                                        const NodePtr<ASTNode>& expr,
                                                                         bool isAuto);
 
     void                                                            applyImplicitCastToNumeric(
-                                                                        const std::shared_ptr<TypeNode>& expectedType,
-                                                                        const std::shared_ptr<ASTNode>& expr,
+                                                                        const NodePtr<TypeNode>& expectedType,
+                                                                        const NodePtr<ASTNode>& expr,
                                                                         int maxRank,
                                                                         bool isAuto);
 
     void                                                            handlePlusOperator(
-                                                                        std::shared_ptr<BinaryOpNode>& node, 
-                                                                        std::shared_ptr<TypeNode> leftType, 
-                                                                        std::shared_ptr<TypeNode> rightType);
+                                                                        NodePtr<BinaryOpNode>& node, 
+                                                                        NodePtr<TypeNode> leftType, 
+                                                                        NodePtr<TypeNode> rightType);
 
     void                                                            handleMinusOperator(
-                                                                            std::shared_ptr<BinaryOpNode>& node, 
-                                                                            std::shared_ptr<TypeNode> leftType, 
-                                                                            std::shared_ptr<TypeNode> rightType);
+                                                                            NodePtr<BinaryOpNode>& node, 
+                                                                            NodePtr<TypeNode> leftType, 
+                                                                            NodePtr<TypeNode> rightType);
 
     void                                                            handleMulOperator(
-                                                                            std::shared_ptr<BinaryOpNode>& node, 
-                                                                            std::shared_ptr<TypeNode> leftType, 
-                                                                            std::shared_ptr<TypeNode> rightType);
+                                                                            NodePtr<BinaryOpNode>& node, 
+                                                                            NodePtr<TypeNode> leftType, 
+                                                                            NodePtr<TypeNode> rightType);
                                                                             
     void                                                            handleDivOperator(
-                                                                            std::shared_ptr<BinaryOpNode>& node, 
-                                                                            std::shared_ptr<TypeNode> leftType, 
-                                                                            std::shared_ptr<TypeNode> rightType);
+                                                                            NodePtr<BinaryOpNode>& node, 
+                                                                            NodePtr<TypeNode> leftType, 
+                                                                            NodePtr<TypeNode> rightType);
 
     void                                                            handleModOperator(
-                                                                            std::shared_ptr<BinaryOpNode>& node, 
-                                                                            std::shared_ptr<TypeNode> leftType, 
-                                                                            std::shared_ptr<TypeNode> rightType);
+                                                                            NodePtr<BinaryOpNode>& node, 
+                                                                            NodePtr<TypeNode> leftType, 
+                                                                            NodePtr<TypeNode> rightType);
     
     void                                                            handleCompareOperator(
-                                                                            std::shared_ptr<BinaryOpNode>& node, 
-                                                                            std::shared_ptr<TypeNode> leftType, 
-                                                                            std::shared_ptr<TypeNode> rightType);
+                                                                            NodePtr<BinaryOpNode>& node, 
+                                                                            NodePtr<TypeNode> leftType, 
+                                                                            NodePtr<TypeNode> rightType);
 
     void                                                            handleLogicalOperator(
-                                                                            std::shared_ptr<BinaryOpNode>& node, 
-                                                                            std::shared_ptr<TypeNode> leftType, 
-                                                                            std::shared_ptr<TypeNode> rightType);
+                                                                            NodePtr<BinaryOpNode>& node, 
+                                                                            NodePtr<TypeNode> leftType, 
+                                                                            NodePtr<TypeNode> rightType);
 
     void                                                            castAndValidate(
-                                                                            const std::shared_ptr<ASTNode>& node, 
+                                                                            const NodePtr<ASTNode>& node, 
                                                                             const std::string& targetType, 
                                                                             TypeSymbolVisitor* visitor);
 
@@ -98,24 +124,26 @@ private:
                                                                             const std::string& label);
 
     void                                                            findMaxRank(
-                                                                            const std::shared_ptr<ASTNode>& node, 
+                                                                            const NodePtr<ASTNode>& node, 
                                                                             int& maxRank);
 
     int                                                             getTypeRank(
                                                                         const std::string& type);
+    int                                                             getTypeRank(
+                                                                        const NodePtr<TypeNode>& type); // Без toString: ранг i1..float равен id типа
 
     std::string                                                     getTypeByRank(
                                                                         int rank);
     
     void                                                            castAllNumbersToType(
-                                                                        const std::shared_ptr<ASTNode>& node, 
+                                                                        const NodePtr<ASTNode>& node, 
                                                                         const std::string& targetType); 
 
-    std::shared_ptr<TypeNode>                                       get_common_type_from_list(
-                                                                            std::vector<std::shared_ptr<TypeNode>>& types,
-                                                                            std::shared_ptr<ASTNode> error_context_node, // Для LogError в правильном контексте
+    NodePtr<TypeNode>                                       get_common_type_from_list(
+                                                                            std::vector<NodePtr<TypeNode>>& types,
+                                                                            NodePtr<ASTNode> error_context_node, // Для LogError в правильном контексте
                                                                             bool allow_numeric_promotion_for_simple_types);
-    std::shared_ptr<TypeNode>                                       infer_collection_type_revised(std::shared_ptr<BlockNode> block);
+    NodePtr<TypeNode>                                       infer_collection_type_revised(NodePtr<BlockNode> block);
 
 public:
                                                                     TypeSymbolVisitor()
@@ -143,9 +171,28 @@ public:
                                                                         registerBuiltInFunctions(registry, TOML_path);
                                                                     };
 
+    /*
+    Проверка одного объявления верхнего уровня для инкрементального режима (ms lsp).
+    Глобальный контекст и пользовательские структуры передаёт вызывающий, а после проверки
+    в них остаётся то, что объявление добавило. Встроенные функции загружаются один раз
+    в конструкторе, поэтому один визитор проверяет объявления документа по очереди.
+    Ошибка пробрасывается дальше, но стек контекстов возвращается к глобальному.
+    */
+    void                                                            checkDeclaration(
+                                                                        const NodePtr<ASTNode>& declaration,
+                                                                        Context& globals,
+                                                                        std::unordered_map<std::string, NodePtr<StructNode>>& structs);
+
+    /*
+    Потоковая компиляция (--stream): функция проверена и сгенерирована, её AST освобождается.
+    В глобальном контексте вместо неё остаётся сигнатура без тела (Parser::parseFunctionSignature),
+    которой хватает для проверки вызовов в следующих функциях.
+    */
+    void                                                            keepSignature(const NodePtr<FunctionNode>& signature);
+
     void                                                            debugContexts();
     
-    void                                                            LogError(const std::string& message, std::shared_ptr<ASTNode> node = nullptr);
+    void                                                            LogError(const std::string& message, NodePtr<ASTNode> node = nullptr);
 
     void                                                            visit(SimpleTypeNode& node) override;
     void                                                            visit(GenericTypeNode& node) override;